@@ -158,7 +158,7 @@ nk_d3d11_render(ID3D11DeviceContext *context, enum nk_anti_aliasing AA)
 
         ID3D11DeviceContext_PSSetShaderResources(context, 0, 1, &texture_view);
         ID3D11DeviceContext_RSSetScissorRects(context, 1, &scissor);
-        ID3D11DeviceContext_DrawIndexed(context, (UINT)cmd->elem_count, offset, 0);
+        ID3D11DeviceContext_DrawIndexed(context, (UINT)cmd->elem_count, offset, (INT)cmd->vertex_offset);
         offset += cmd->elem_count;
     }
     nk_clear(&d3d11.ctx);}
@@ -126,6 +126,8 @@ nk_glfw3_render(enum nk_anti_aliasing AA)
         /* convert from command queue into draw list and draw to screen */
         const struct nk_draw_command *cmd;
         const nk_draw_index *offset = NULL;
+        unsigned int vertex_offset = (unsigned int)-1;
+        const nk_byte *vertices;
         struct nk_buffer vbuf, ebuf;
 
         /* fill convert configuration */
@@ -153,17 +155,20 @@ nk_glfw3_render(enum nk_anti_aliasing AA)
         nk_buffer_init_default(&ebuf);
         nk_convert(&glfw.ctx, &dev->cmds, &vbuf, &ebuf, &config);
 
-        /* setup vertex buffer pointer */
-        {const void *vertices = nk_buffer_memory_const(&vbuf);
-        glVertexPointer(2, GL_FLOAT, vs, (const void*)((const nk_byte*)vertices + vp));
-        glTexCoordPointer(2, GL_FLOAT, vs, (const void*)((const nk_byte*)vertices + vt));
-        glColorPointer(4, GL_UNSIGNED_BYTE, vs, (const void*)((const nk_byte*)vertices + vc));}
-
         /* iterate over and execute each draw command */
+        vertices = (const nk_byte*)nk_buffer_memory_const(&vbuf);
         offset = (const nk_draw_index*)nk_buffer_memory_const(&ebuf);
         nk_draw_foreach(cmd, &glfw.ctx, &dev->cmds)
         {
             if (!cmd->elem_count) continue;
+            if (cmd->vertex_offset != vertex_offset) {
+                /* indices of split draw commands start at `vertex_offset` */
+                const nk_byte *base = vertices + (size_t)cmd->vertex_offset * (size_t)vs;
+                glVertexPointer(2, GL_FLOAT, vs, (const void*)(base + vp));
+                glTexCoordPointer(2, GL_FLOAT, vs, (const void*)(base + vt));
+                glColorPointer(4, GL_UNSIGNED_BYTE, vs, (const void*)(base + vc));
+                vertex_offset = cmd->vertex_offset;
+            }
             glBindTexture(GL_TEXTURE_2D, (GLuint)cmd->texture.id);
             glScissor(
                 (GLint)(cmd->clip_rect.x * glfw.fb_scale.x),
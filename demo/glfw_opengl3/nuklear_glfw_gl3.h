@@ -56,6 +56,7 @@ NK_API void                 nk_glfw3_mouse_button_callback(GLFWwindow *win, int
 
 struct nk_glfw_device {
     struct nk_buffer cmds;
+    struct nk_buffer instances;
     struct nk_draw_null_texture null;
     GLuint vbo, vao, ebo;
     GLuint prog;
@@ -64,8 +65,18 @@ struct nk_glfw_device {
     GLint attrib_pos;
     GLint attrib_uv;
     GLint attrib_col;
+    GLint attrib_shape;
     GLint uniform_tex;
     GLint uniform_proj;
+    GLuint inst_vbo, inst_vao;
+    GLuint inst_prog;
+    GLuint inst_vert_shdr;
+    GLint inst_attrib_rect;
+    GLint inst_attrib_params;
+    GLint inst_attrib_col;
+    GLint inst_attrib_type;
+    GLint inst_uniform_tex;
+    GLint inst_uniform_proj;
     GLuint font_tex;
 };
 
@@ -73,6 +84,7 @@ struct nk_glfw_vertex {
     float position[2];
     float uv[2];
     nk_byte col[4];
+    float shape[4];
 };
 
 static struct nk_glfw {
@@ -107,26 +119,84 @@ nk_glfw3_device_create(void)
         "in vec2 Position;\n"
         "in vec2 TexCoord;\n"
         "in vec4 Color;\n"
+        "in vec4 Shape;\n"
         "out vec2 Frag_UV;\n"
         "out vec4 Frag_Color;\n"
+        "out vec4 Frag_Shape;\n"
         "void main() {\n"
         "   Frag_UV = TexCoord;\n"
         "   Frag_Color = Color;\n"
+        "   Frag_Shape = Shape;\n"
         "   gl_Position = ProjMtx * vec4(Position.xy, 0, 1);\n"
         "}\n";
+    /* expands one `nk_draw_instance` into a quad drawn as triangle strip.
+     * Shapes pass their local position and extent to the same SDF
+     * evaluation the fragment shader does for triangles */
+    static const GLchar *instance_shader =
+        NK_SHADER_VERSION
+        "uniform mat4 ProjMtx;\n"
+        "in vec4 Rect;\n"
+        "in vec4 Params;\n"
+        "in vec4 Color;\n"
+        "in uint Type;\n"
+        "out vec2 Frag_UV;\n"
+        "out vec4 Frag_Color;\n"
+        "out vec4 Frag_Shape;\n"
+        "void main() {\n"
+        "   vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));\n"
+        "   vec2 pos;\n"
+        "   Frag_Color = Color;\n"
+        "   if (Type >= 3u) {\n"
+        "      pos = Rect.xy + corner * Rect.zw;\n"
+        "      Frag_UV = mix(Params.xy, Params.zw, corner);\n"
+        "      Frag_Shape = vec4(0.0);\n"
+        "   } else {\n"
+        "      vec2 center, axis = vec2(1.0, 0.0), ext;\n"
+        "      float r = 0.0, t = Params.y > 0.0 ? max(Params.y, 1.0) : 0.0;\n"
+        "      if (Type == 2u) {\n"
+        "         vec2 d = Rect.zw - Rect.xy;\n"
+        "         float len = length(d);\n"
+        "         if (len > 0.0) axis = d / len;\n"
+        "         center = (Rect.xy + Rect.zw) * 0.5;\n"
+        "         ext = vec2(len * 0.5, max(Params.y, 1.0) * 0.5);\n"
+        "         t = 0.0;\n"
+        "      } else if (Type == 1u) {\n"
+        "         ext = vec2(Rect.z * 0.5);\n"
+        "         center = Rect.xy + vec2(ext.x, Rect.w * 0.5);\n"
+        "         r = ext.x;\n"
+        "      } else {\n"
+        "         ext = Rect.zw * 0.5;\n"
+        "         center = Rect.xy + ext;\n"
+        "         r = clamp(Params.x, 0.0, min(ext.x, ext.y));\n"
+        "      }\n"
+        /* room for thickness and anti-aliasing, empty shapes collapse */
+        "      Frag_UV = (corner * 2.0 - 1.0) * (min(ext.x, ext.y) > 0.0 ? ext + t * 0.5 + 1.0 : vec2(0.0));\n"
+        "      Frag_Shape = vec4(ext, r, t);\n"
+        "      pos = center + axis * Frag_UV.x + vec2(-axis.y, axis.x) * Frag_UV.y;\n"
+        "   }\n"
+        "   gl_Position = ProjMtx * vec4(pos, 0, 1);\n"
+        "}\n";
     static const GLchar *fragment_shader =
         NK_SHADER_VERSION
-        "precision mediump float;\n"
+        "precision highp float;\n"
         "uniform sampler2D Texture;\n"
         "in vec2 Frag_UV;\n"
         "in vec4 Frag_Color;\n"
+        "in vec4 Frag_Shape;\n"
         "out vec4 Out_Color;\n"
         "void main(){\n"
-        "   Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
+        "   if (Frag_Shape.x > 0.0) {\n"
+        "      vec2 q = abs(Frag_UV) - Frag_Shape.xy + Frag_Shape.z;\n"
+        "      float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - Frag_Shape.z;\n"
+        "      if (Frag_Shape.w > 0.0) d = abs(d) - Frag_Shape.w * 0.5;\n"
+        "      d /= length(dFdx(Frag_UV));\n"
+        "      Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * clamp(0.5 - d, 0.0, 1.0));\n"
+        "   } else Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
         "}\n";
 
     struct nk_glfw_device *dev = &glfw.ogl;
     nk_buffer_init_default(&dev->cmds);
+    nk_buffer_init_default(&dev->instances);
     dev->prog = glCreateProgram();
     dev->vert_shdr = glCreateShader(GL_VERTEX_SHADER);
     dev->frag_shdr = glCreateShader(GL_FRAGMENT_SHADER);
@@ -149,6 +219,27 @@ nk_glfw3_device_create(void)
     dev->attrib_pos = glGetAttribLocation(dev->prog, "Position");
     dev->attrib_uv = glGetAttribLocation(dev->prog, "TexCoord");
     dev->attrib_col = glGetAttribLocation(dev->prog, "Color");
+    dev->attrib_shape = glGetAttribLocation(dev->prog, "Shape");
+
+    /* instanced program sharing the fragment shader */
+    dev->inst_prog = glCreateProgram();
+    dev->inst_vert_shdr = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(dev->inst_vert_shdr, 1, &instance_shader, 0);
+    glCompileShader(dev->inst_vert_shdr);
+    glGetShaderiv(dev->inst_vert_shdr, GL_COMPILE_STATUS, &status);
+    assert(status == GL_TRUE);
+    glAttachShader(dev->inst_prog, dev->inst_vert_shdr);
+    glAttachShader(dev->inst_prog, dev->frag_shdr);
+    glLinkProgram(dev->inst_prog);
+    glGetProgramiv(dev->inst_prog, GL_LINK_STATUS, &status);
+    assert(status == GL_TRUE);
+
+    dev->inst_uniform_tex = glGetUniformLocation(dev->inst_prog, "Texture");
+    dev->inst_uniform_proj = glGetUniformLocation(dev->inst_prog, "ProjMtx");
+    dev->inst_attrib_rect = glGetAttribLocation(dev->inst_prog, "Rect");
+    dev->inst_attrib_params = glGetAttribLocation(dev->inst_prog, "Params");
+    dev->inst_attrib_col = glGetAttribLocation(dev->inst_prog, "Color");
+    dev->inst_attrib_type = glGetAttribLocation(dev->inst_prog, "Type");
 
     {
         /* buffer setup */
@@ -156,6 +247,7 @@ nk_glfw3_device_create(void)
         size_t vp = offsetof(struct nk_glfw_vertex, position);
         size_t vt = offsetof(struct nk_glfw_vertex, uv);
         size_t vc = offsetof(struct nk_glfw_vertex, col);
+        size_t vsh = offsetof(struct nk_glfw_vertex, shape);
 
         glGenBuffers(1, &dev->vbo);
         glGenBuffers(1, &dev->ebo);
@@ -168,10 +260,30 @@ nk_glfw3_device_create(void)
         glEnableVertexAttribArray((GLuint)dev->attrib_pos);
         glEnableVertexAttribArray((GLuint)dev->attrib_uv);
         glEnableVertexAttribArray((GLuint)dev->attrib_col);
+        glEnableVertexAttribArray((GLuint)dev->attrib_shape);
 
         glVertexAttribPointer((GLuint)dev->attrib_pos, 2, GL_FLOAT, GL_FALSE, vs, (void*)vp);
         glVertexAttribPointer((GLuint)dev->attrib_uv, 2, GL_FLOAT, GL_FALSE, vs, (void*)vt);
         glVertexAttribPointer((GLuint)dev->attrib_col, 4, GL_UNSIGNED_BYTE, GL_TRUE, vs, (void*)vc);
+        glVertexAttribPointer((GLuint)dev->attrib_shape, 4, GL_FLOAT, GL_FALSE, vs, (void*)vsh);
+    }
+    {
+        /* instance buffer setup, pointers are set for every draw command */
+        glGenBuffers(1, &dev->inst_vbo);
+        glGenVertexArrays(1, &dev->inst_vao);
+
+        glBindVertexArray(dev->inst_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, dev->inst_vbo);
+
+        glEnableVertexAttribArray((GLuint)dev->inst_attrib_rect);
+        glEnableVertexAttribArray((GLuint)dev->inst_attrib_params);
+        glEnableVertexAttribArray((GLuint)dev->inst_attrib_col);
+        glEnableVertexAttribArray((GLuint)dev->inst_attrib_type);
+
+        glVertexAttribDivisor((GLuint)dev->inst_attrib_rect, 1);
+        glVertexAttribDivisor((GLuint)dev->inst_attrib_params, 1);
+        glVertexAttribDivisor((GLuint)dev->inst_attrib_col, 1);
+        glVertexAttribDivisor((GLuint)dev->inst_attrib_type, 1);
     }
 
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -201,10 +313,18 @@ nk_glfw3_device_destroy(void)
     glDeleteShader(dev->vert_shdr);
     glDeleteShader(dev->frag_shdr);
     glDeleteProgram(dev->prog);
+    glDetachShader(dev->inst_prog, dev->inst_vert_shdr);
+    glDetachShader(dev->inst_prog, dev->frag_shdr);
+    glDeleteShader(dev->inst_vert_shdr);
+    glDeleteProgram(dev->inst_prog);
     glDeleteTextures(1, &dev->font_tex);
     glDeleteBuffers(1, &dev->vbo);
     glDeleteBuffers(1, &dev->ebo);
+    glDeleteBuffers(1, &dev->inst_vbo);
+    glDeleteVertexArrays(1, &dev->vao);
+    glDeleteVertexArrays(1, &dev->inst_vao);
     nk_buffer_free(&dev->cmds);
+    nk_buffer_free(&dev->instances);
 }
 
 NK_API void
@@ -230,7 +350,10 @@ nk_glfw3_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element
     glEnable(GL_SCISSOR_TEST);
     glActiveTexture(GL_TEXTURE0);
 
-    /* setup program */
+    /* setup programs */
+    glUseProgram(dev->inst_prog);
+    glUniform1i(dev->inst_uniform_tex, 0);
+    glUniformMatrix4fv(dev->inst_uniform_proj, 1, GL_FALSE, &ortho[0][0]);
     glUseProgram(dev->prog);
     glUniform1i(dev->uniform_tex, 0);
     glUniformMatrix4fv(dev->uniform_proj, 1, GL_FALSE, &ortho[0][0]);
@@ -240,6 +363,7 @@ nk_glfw3_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element
         const struct nk_draw_command *cmd;
         void *vertices, *elements;
         const nk_draw_index *offset = NULL;
+        int instanced = 0;
 
         /* allocate vertex and element buffer */
         glBindVertexArray(dev->vao);
@@ -259,6 +383,7 @@ nk_glfw3_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element
                 {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_glfw_vertex, position)},
                 {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_glfw_vertex, uv)},
                 {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct nk_glfw_vertex, col)},
+                {NK_VERTEX_SHAPE, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_glfw_vertex, shape)},
                 {NK_VERTEX_LAYOUT_END}
             };
             NK_MEMSET(&config, 0, sizeof(config));
@@ -272,27 +397,60 @@ nk_glfw3_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element
             config.global_alpha = 1.0f;
             config.shape_AA = AA;
             config.line_AA = AA;
+            config.shape_mode = NK_DRAW_SHAPE_SDF;
 
             /* setup buffers to load vertices and elements */
             nk_buffer_init_fixed(&vbuf, vertices, (size_t)max_vertex_buffer);
             nk_buffer_init_fixed(&ebuf, elements, (size_t)max_element_buffer);
-            nk_convert(&glfw.ctx, &dev->cmds, &vbuf, &ebuf, &config);
+            nk_buffer_clear(&dev->instances);
+            nk_convert_instanced(&glfw.ctx, &dev->cmds, &vbuf, &ebuf, &dev->instances, &config);
         }
         glUnmapBuffer(GL_ARRAY_BUFFER);
         glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
 
+        /* upload rectangles, circles, lines, glyphs and images */
+        glBindBuffer(GL_ARRAY_BUFFER, dev->inst_vbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)dev->instances.allocated,
+            nk_buffer_memory_const(&dev->instances), GL_STREAM_DRAW);
+
         /* iterate over and execute each draw command */
         nk_draw_foreach(cmd, &glfw.ctx, &dev->cmds)
         {
-            if (!cmd->elem_count) continue;
+            if (!cmd->elem_count && !cmd->instance_count) continue;
             glBindTexture(GL_TEXTURE_2D, (GLuint)cmd->texture.id);
             glScissor(
                 (GLint)(cmd->clip_rect.x * glfw.fb_scale.x),
                 (GLint)((glfw.height - (GLint)(cmd->clip_rect.y + cmd->clip_rect.h)) * glfw.fb_scale.y),
                 (GLint)(cmd->clip_rect.w * glfw.fb_scale.x),
                 (GLint)(cmd->clip_rect.h * glfw.fb_scale.y));
-            glDrawElements(GL_TRIANGLES, (GLsizei)cmd->elem_count, GL_UNSIGNED_SHORT, offset);
-            offset += cmd->elem_count;
+            if (cmd->instance_count) {
+                /* point the per instance attributes at the first record */
+                GLsizei is = sizeof(struct nk_draw_instance);
+                size_t base = (size_t)cmd->instance_offset * sizeof(struct nk_draw_instance);
+                if (!instanced) {
+                    glUseProgram(dev->inst_prog);
+                    glBindVertexArray(dev->inst_vao);
+                    instanced = 1;
+                }
+                glVertexAttribPointer((GLuint)dev->inst_attrib_rect, 4, GL_FLOAT, GL_FALSE, is,
+                    (void*)(base + offsetof(struct nk_draw_instance, rect)));
+                glVertexAttribPointer((GLuint)dev->inst_attrib_params, 4, GL_FLOAT, GL_FALSE, is,
+                    (void*)(base + offsetof(struct nk_draw_instance, params)));
+                glVertexAttribPointer((GLuint)dev->inst_attrib_col, 4, GL_UNSIGNED_BYTE, GL_TRUE, is,
+                    (void*)(base + offsetof(struct nk_draw_instance, color)));
+                glVertexAttribIPointer((GLuint)dev->inst_attrib_type, 1, GL_UNSIGNED_INT, is,
+                    (void*)(base + offsetof(struct nk_draw_instance, type)));
+                glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)cmd->instance_count);
+            } else {
+                if (instanced) {
+                    glUseProgram(dev->prog);
+                    glBindVertexArray(dev->vao);
+                    instanced = 0;
+                }
+                glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)cmd->elem_count, GL_UNSIGNED_SHORT,
+                    offset, (GLint)cmd->vertex_offset);
+                offset += cmd->elem_count;
+            }
         }
         nk_clear(&glfw.ctx);
     }
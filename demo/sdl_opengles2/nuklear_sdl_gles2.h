@@ -51,17 +51,20 @@ struct nk_sdl_device {
     GLint attrib_pos;
     GLint attrib_uv;
     GLint attrib_col;
+    GLint attrib_shape;
     GLint uniform_tex;
     GLint uniform_proj;
+    GLint uniform_scale;
     GLuint font_tex;
     GLsizei vs;
-    size_t vp, vt, vc;
+    size_t vp, vt, vc, vsh;
 };
 
 struct nk_sdl_vertex {
     GLfloat position[2];
     GLfloat uv[2];
     nk_byte col[4];
+    GLfloat shape[4];
 };
 
 static struct nk_sdl {
@@ -85,21 +88,35 @@ nk_sdl_device_create(void)
         "attribute vec2 Position;\n"
         "attribute vec2 TexCoord;\n"
         "attribute vec4 Color;\n"
+        "attribute vec4 Shape;\n"
         "varying vec2 Frag_UV;\n"
         "varying vec4 Frag_Color;\n"
+        "varying vec4 Frag_Shape;\n"
         "void main() {\n"
         "   Frag_UV = TexCoord;\n"
         "   Frag_Color = Color;\n"
+        "   Frag_Shape = Shape;\n"
         "   gl_Position = ProjMtx * vec4(Position.xy, 0, 1);\n"
         "}\n";
     static const GLchar *fragment_shader =
         NK_SHADER_VERSION
+        "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+        "precision highp float;\n"
+        "#else\n"
         "precision mediump float;\n"
+        "#endif\n"
         "uniform sampler2D Texture;\n"
+        "uniform float Scale;\n"
         "varying vec2 Frag_UV;\n"
         "varying vec4 Frag_Color;\n"
+        "varying vec4 Frag_Shape;\n"
         "void main(){\n"
-        "   gl_FragColor = Frag_Color * texture2D(Texture, Frag_UV);\n"
+        "   if (Frag_Shape.x > 0.0) {\n"
+        "      vec2 q = abs(Frag_UV) - Frag_Shape.xy + Frag_Shape.z;\n"
+        "      float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - Frag_Shape.z;\n"
+        "      if (Frag_Shape.w > 0.0) d = abs(d) - Frag_Shape.w * 0.5;\n"
+        "      gl_FragColor = vec4(Frag_Color.rgb, Frag_Color.a * clamp(0.5 - d * Scale, 0.0, 1.0));\n"
+        "   } else gl_FragColor = Frag_Color * texture2D(Texture, Frag_UV);\n"
         "}\n";
 
     struct nk_sdl_device *dev = &sdl.ogl;
@@ -125,14 +142,17 @@ nk_sdl_device_create(void)
 
     dev->uniform_tex = glGetUniformLocation(dev->prog, "Texture");
     dev->uniform_proj = glGetUniformLocation(dev->prog, "ProjMtx");
+    dev->uniform_scale = glGetUniformLocation(dev->prog, "Scale");
     dev->attrib_pos = glGetAttribLocation(dev->prog, "Position");
     dev->attrib_uv = glGetAttribLocation(dev->prog, "TexCoord");
     dev->attrib_col = glGetAttribLocation(dev->prog, "Color");
+    dev->attrib_shape = glGetAttribLocation(dev->prog, "Shape");
     {
         dev->vs = sizeof(struct nk_sdl_vertex);
         dev->vp = offsetof(struct nk_sdl_vertex, position);
         dev->vt = offsetof(struct nk_sdl_vertex, uv);
         dev->vc = offsetof(struct nk_sdl_vertex, col);
+        dev->vsh = offsetof(struct nk_sdl_vertex, shape);
         
         /* Allocate buffers */
         glGenBuffers(1, &dev->vbo);
@@ -205,11 +225,15 @@ nk_sdl_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element_b
     glUseProgram(dev->prog);
     glUniform1i(dev->uniform_tex, 0);
     glUniformMatrix4fv(dev->uniform_proj, 1, GL_FALSE, &ortho[0][0]);
+    /* derivatives are an extension in OpenGL ES 2, so the anti-aliasing
+     * fringe of shapes is scaled to one pixel of the drawable instead */
+    glUniform1f(dev->uniform_scale, (scale.x + scale.y) * 0.5f);
     {
         /* convert from command queue into draw list and draw to screen */
         const struct nk_draw_command *cmd;
         void *vertices, *elements;
         const nk_draw_index *offset = NULL;
+        unsigned int vertex_offset = (unsigned int)-1;
 
         /* Bind buffers */
         glBindBuffer(GL_ARRAY_BUFFER, dev->vbo);
@@ -220,10 +244,7 @@ nk_sdl_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element_b
             glEnableVertexAttribArray((GLuint)dev->attrib_pos);
             glEnableVertexAttribArray((GLuint)dev->attrib_uv);
             glEnableVertexAttribArray((GLuint)dev->attrib_col);
-
-            glVertexAttribPointer((GLuint)dev->attrib_pos, 2, GL_FLOAT, GL_FALSE, dev->vs, (void*)dev->vp);
-            glVertexAttribPointer((GLuint)dev->attrib_uv, 2, GL_FLOAT, GL_FALSE, dev->vs, (void*)dev->vt);
-            glVertexAttribPointer((GLuint)dev->attrib_col, 4, GL_UNSIGNED_BYTE, GL_TRUE, dev->vs, (void*)dev->vc);
+            glEnableVertexAttribArray((GLuint)dev->attrib_shape);
         }
 
         glBufferData(GL_ARRAY_BUFFER, max_vertex_buffer, NULL, GL_STREAM_DRAW);
@@ -239,6 +260,7 @@ nk_sdl_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element_b
                 {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_sdl_vertex, position)},
                 {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_sdl_vertex, uv)},
                 {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct nk_sdl_vertex, col)},
+                {NK_VERTEX_SHAPE, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_sdl_vertex, shape)},
                 {NK_VERTEX_LAYOUT_END}
             };
             NK_MEMSET(&config, 0, sizeof(config));
@@ -252,6 +274,7 @@ nk_sdl_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element_b
             config.global_alpha = 1.0f;
             config.shape_AA = AA;
             config.line_AA = AA;
+            config.shape_mode = NK_DRAW_SHAPE_SDF;
 
             /* setup buffers to load vertices and elements */
             {struct nk_buffer vbuf, ebuf;
@@ -267,6 +290,15 @@ nk_sdl_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element_b
         /* iterate over and execute each draw command */
         nk_draw_foreach(cmd, &sdl.ctx, &dev->cmds) {
             if (!cmd->elem_count) continue;
+            if (cmd->vertex_offset != vertex_offset) {
+                /* GLES2 has no base vertex so split draw commands move the attributes */
+                size_t base = (size_t)cmd->vertex_offset * (size_t)dev->vs;
+                glVertexAttribPointer((GLuint)dev->attrib_pos, 2, GL_FLOAT, GL_FALSE, dev->vs, (void*)(base + dev->vp));
+                glVertexAttribPointer((GLuint)dev->attrib_uv, 2, GL_FLOAT, GL_FALSE, dev->vs, (void*)(base + dev->vt));
+                glVertexAttribPointer((GLuint)dev->attrib_col, 4, GL_UNSIGNED_BYTE, GL_TRUE, dev->vs, (void*)(base + dev->vc));
+                glVertexAttribPointer((GLuint)dev->attrib_shape, 4, GL_FLOAT, GL_FALSE, dev->vs, (void*)(base + dev->vsh));
+                vertex_offset = cmd->vertex_offset;
+            }
             glBindTexture(GL_TEXTURE_2D, (GLuint)cmd->texture.id);
             glScissor((GLint)(cmd->clip_rect.x * scale.x),
                 (GLint)((height - (GLint)(cmd->clip_rect.y + cmd->clip_rect.h)) * scale.y),
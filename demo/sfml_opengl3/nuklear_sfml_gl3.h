@@ -51,6 +51,7 @@ struct nk_sfml_device {
     GLint attrib_pos;
     GLint attrib_uv;
     GLint attrib_col;
+    GLint attrib_shape;
     GLint uniform_tex;
     GLint uniform_proj;
     GLuint font_tex;
@@ -59,6 +60,7 @@ struct nk_sfml_vertex {
     float position[2];
     float uv[2];
     nk_byte col[4];
+    float shape[4];
 };
 static struct nk_sfml {
     sf::Window* window;
@@ -83,22 +85,32 @@ nk_sfml_device_create(void)
         "in vec2 Position;\n"
         "in vec2 TexCoord;\n"
         "in vec4 Color;\n"
+        "in vec4 Shape;\n"
         "out vec2 Frag_UV;\n"
         "out vec4 Frag_Color;\n"
+        "out vec4 Frag_Shape;\n"
         "void main() {\n"
         "   Frag_UV = TexCoord;\n"
         "   Frag_Color = Color;\n"
+        "   Frag_Shape = Shape;\n"
         "   gl_Position = ProjMtx * vec4(Position.xy, 0, 1);\n"
         "}\n";
     static const GLchar *fragment_shader =
         NK_SHADER_VERSION
-        "precision mediump float;\n"
+        "precision highp float;\n"
         "uniform sampler2D Texture;\n"
         "in vec2 Frag_UV;\n"
         "in vec4 Frag_Color;\n"
+        "in vec4 Frag_Shape;\n"
         "out vec4 Out_Color;\n"
         "void main(){\n"
-        "   Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
+        "   if (Frag_Shape.x > 0.0) {\n"
+        "      vec2 q = abs(Frag_UV) - Frag_Shape.xy + Frag_Shape.z;\n"
+        "      float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - Frag_Shape.z;\n"
+        "      if (Frag_Shape.w > 0.0) d = abs(d) - Frag_Shape.w * 0.5;\n"
+        "      d /= length(dFdx(Frag_UV));\n"
+        "      Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * clamp(0.5 - d, 0.0, 1.0));\n"
+        "   } else Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
         "}\n";
 
     struct nk_sfml_device* dev = &sfml.ogl;
@@ -131,12 +143,14 @@ nk_sfml_device_create(void)
     dev->attrib_pos = glGetAttribLocation(dev->prog, "Position");
     dev->attrib_uv = glGetAttribLocation(dev->prog, "TexCoord");
     dev->attrib_col = glGetAttribLocation(dev->prog, "Color");
+    dev->attrib_shape = glGetAttribLocation(dev->prog, "Shape");
     {
         /* buffer setup */
         GLsizei vs = sizeof(struct nk_sfml_vertex);
         size_t vp = offsetof(struct nk_sfml_vertex, position);
         size_t vt = offsetof(struct nk_sfml_vertex, uv);
         size_t vc = offsetof(struct nk_sfml_vertex, col);
+        size_t vsh = offsetof(struct nk_sfml_vertex, shape);
 
         glGenBuffers(1, &dev->vbo);
         glGenBuffers(1, &dev->ebo);
@@ -149,10 +163,12 @@ nk_sfml_device_create(void)
         glEnableVertexAttribArray((GLuint)dev->attrib_pos);
         glEnableVertexAttribArray((GLuint)dev->attrib_uv);
         glEnableVertexAttribArray((GLuint)dev->attrib_col);
+        glEnableVertexAttribArray((GLuint)dev->attrib_shape);
 
         glVertexAttribPointer((GLuint)dev->attrib_pos, 2, GL_FLOAT, GL_FALSE, vs, (void*)vp);
         glVertexAttribPointer((GLuint)dev->attrib_uv, 2, GL_FLOAT, GL_FALSE, vs, (void*)vt);
         glVertexAttribPointer((GLuint)dev->attrib_col, 4, GL_UNSIGNED_BYTE, GL_TRUE, vs, (void*)vc);
+        glVertexAttribPointer((GLuint)dev->attrib_shape, 4, GL_FLOAT, GL_FALSE, vs, (void*)vsh);
     }
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -241,6 +257,7 @@ nk_sfml_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element_
                 {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_sfml_vertex, position)},
                 {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_sfml_vertex, uv)},
                 {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct nk_sfml_vertex, col)},
+                {NK_VERTEX_SHAPE, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_sfml_vertex, shape)},
                 {NK_VERTEX_LAYOUT_END}
             };
 
@@ -255,6 +272,7 @@ nk_sfml_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element_
             config.global_alpha = 1.0f;
             config.shape_AA = AA;
             config.line_AA = AA;
+            config.shape_mode = NK_DRAW_SHAPE_SDF;
 
             /* setup buffers to load vertices and elements */
             struct nk_buffer vbuf, ebuf;
@@ -275,7 +293,8 @@ nk_sfml_render(enum nk_anti_aliasing AA, int max_vertex_buffer, int max_element_
                 (GLint)((window_height - (GLint)(cmd->clip_rect.y + cmd->clip_rect.h))),
                 (GLint)(cmd->clip_rect.w),
                 (GLint)(cmd->clip_rect.h));
-            glDrawElements(GL_TRIANGLES, (GLsizei)cmd->elem_count, GL_UNSIGNED_SHORT, offset);
+            glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)cmd->elem_count, GL_UNSIGNED_SHORT,
+                offset, (GLint)cmd->vertex_offset);
             offset += cmd->elem_count;
         }
         nk_clear(&sfml.ctx);
@@ -54,6 +54,9 @@ NK_API void                 nk_xfont_del(Display *dpy, XFont *font);
 #include <unistd.h>
 #include <time.h>
 
+#ifndef NK_XLIB_MAX_DAMAGE
+#define NK_XLIB_MAX_DAMAGE 16
+#endif
 
 #ifdef NK_XLIB_IMPLEMENT_STB_IMAGE
 #define STB_IMAGE_IMPLEMENTATION
@@ -88,6 +91,7 @@ struct XSurface {
     Window root;
     Drawable drawable;
     unsigned int w, h;
+    XRectangle damage;
 };
 struct XImageWithAlpha {
     XImage* ximage;
@@ -110,6 +114,7 @@ static struct  {
     Display *dpy;
     Window root;
     long last_button_click;
+    int redraw;
 } xlib;
 
 NK_INTERN long
@@ -161,10 +166,14 @@ NK_INTERN void
 nk_xsurf_scissor(XSurface *surf, float x, float y, float w, float h)
 {
     XRectangle clip_rect;
-    clip_rect.x = (short)(x-1);
-    clip_rect.y = (short)(y-1);
-    clip_rect.width = (unsigned short)(w+2);
-    clip_rect.height = (unsigned short)(h+2);
+    const XRectangle *d = &surf->damage;
+    float x0 = NK_MAX(x-1, (float)d->x), y0 = NK_MAX(y-1, (float)d->y);
+    float x1 = NK_MIN(x+w+1, (float)(d->x + d->width));
+    float y1 = NK_MIN(y+h+1, (float)(d->y + d->height));
+    clip_rect.x = (short)x0;
+    clip_rect.y = (short)y0;
+    clip_rect.width = (unsigned short)NK_MAX(x1 - x0, 0);
+    clip_rect.height = (unsigned short)NK_MAX(y1 - y0, 0);
     XSetClipRectangles(surf->dpy, surf->gc, 0, 0, &clip_rect, 1, Unsorted);
 }
 
@@ -523,14 +532,32 @@ nk_xsurf_image_free(struct nk_image* image)
 NK_INTERN void
 nk_xsurf_clear(XSurface *surf, unsigned long color)
 {
+    const XRectangle *d = &surf->damage;
+    XSetClipMask(surf->dpy, surf->gc, None);
     XSetForeground(surf->dpy, surf->gc, color);
-    XFillRectangle(surf->dpy, surf->drawable, surf->gc, 0, 0, surf->w, surf->h);
+    XFillRectangle(surf->dpy, surf->drawable, surf->gc, d->x, d->y, d->width, d->height);
+}
+
+NK_INTERN void
+nk_xsurf_blit(Drawable target, XSurface *surf)
+{
+    const XRectangle *d = &surf->damage;
+    XSetClipMask(surf->dpy, surf->gc, None);
+    XCopyArea(surf->dpy, surf->drawable, target, surf->gc,
+        d->x, d->y, d->width, d->height, d->x, d->y);
 }
 
 NK_INTERN void
-nk_xsurf_blit(Drawable target, XSurface *surf, unsigned int w, unsigned int h)
+nk_xsurf_damage(XSurface *surf, struct nk_rect r)
 {
-    XCopyArea(surf->dpy, surf->drawable, target, surf->gc, 0, 0, w, h, 0, 0);
+    /* restrict drawing to the damaged area clamped to the surface */
+    float x0 = NK_MAX(r.x, 0), y0 = NK_MAX(r.y, 0);
+    float x1 = NK_MIN(r.x + r.w, (float)surf->w);
+    float y1 = NK_MIN(r.y + r.h, (float)surf->h);
+    surf->damage.x = (short)x0;
+    surf->damage.y = (short)y0;
+    surf->damage.width = (unsigned short)NK_MAX(x1 - x0, 0);
+    surf->damage.height = (unsigned short)NK_MAX(y1 - y0, 0);
 }
 
 NK_INTERN void
@@ -632,6 +659,7 @@ nk_xlib_init(XFont *xfont, Display *dpy, int screen, Window root,
     XFreePixmap(dpy, blank);}
 
     xlib.surf = nk_xsurf_create(screen, w, h);
+    xlib.redraw = nk_true;
     nk_init_default(&xlib.ctx, font);
     return &xlib.ctx;
 }
@@ -795,6 +823,7 @@ nk_xlib_handle_event(Display *dpy, int screen, Window win, XEvent *evt)
         width = (unsigned int)attr.width;
         height = (unsigned int)attr.height;
         nk_xsurf_resize(xlib.surf, width, height);
+        xlib.redraw = nk_true;
         return 1;
     } else if (evt->type == KeymapNotify) {
         XRefreshKeyboardMapping(&evt->xmapping);
@@ -872,85 +901,98 @@ nk_xlib_render(Drawable screen, struct nk_color clear)
     const struct nk_command *cmd;
     struct nk_context *ctx = &xlib.ctx;
     XSurface *surf = xlib.surf;
-
-    nk_xsurf_clear(xlib.surf, nk_color_from_byte(&clear.r));
-    nk_foreach(cmd, &xlib.ctx)
-    {
-        switch (cmd->type) {
-        case NK_COMMAND_NOP: break;
-        case NK_COMMAND_SCISSOR: {
-            const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
-            nk_xsurf_scissor(surf, s->x, s->y, s->w, s->h);
-        } break;
-        case NK_COMMAND_LINE: {
-            const struct nk_command_line *l = (const struct nk_command_line *)cmd;
-            nk_xsurf_stroke_line(surf, l->begin.x, l->begin.y, l->end.x,
-                l->end.y, l->line_thickness, l->color);
-        } break;
-        case NK_COMMAND_RECT: {
-            const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
-            nk_xsurf_stroke_rect(surf, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->line_thickness, r->color);
-        } break;
-        case NK_COMMAND_RECT_FILLED: {
-            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
-            nk_xsurf_fill_rect(surf, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->color);
-        } break;
-        case NK_COMMAND_CIRCLE: {
-            const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
-            nk_xsurf_stroke_circle(surf, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
-        } break;
-        case NK_COMMAND_CIRCLE_FILLED: {
-            const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-            nk_xsurf_fill_circle(surf, c->x, c->y, c->w, c->h, c->color);
-        } break;
-        case NK_COMMAND_TRIANGLE: {
-            const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
-            nk_xsurf_stroke_triangle(surf, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->line_thickness, t->color);
-        } break;
-        case NK_COMMAND_TRIANGLE_FILLED: {
-            const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
-            nk_xsurf_fill_triangle(surf, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->color);
-        } break;
-        case NK_COMMAND_POLYGON: {
-            const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
-            nk_xsurf_stroke_polygon(surf, p->points, p->point_count, p->line_thickness,p->color);
-        } break;
-        case NK_COMMAND_POLYGON_FILLED: {
-            const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
-            nk_xsurf_fill_polygon(surf, p->points, p->point_count, p->color);
-        } break;
-        case NK_COMMAND_POLYLINE: {
-            const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
-            nk_xsurf_stroke_polyline(surf, p->points, p->point_count, p->line_thickness, p->color);
-        } break;
-        case NK_COMMAND_TEXT: {
-            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
-            nk_xsurf_draw_text(surf, t->x, t->y, t->w, t->h,
-                (const char*)t->string, t->length,
-                (XFont*)t->font->userdata.ptr,
-                t->background, t->foreground);
-        } break;
-        case NK_COMMAND_CURVE: {
-            const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
-            nk_xsurf_stroke_curve(surf, q->begin, q->ctrl[0], q->ctrl[1],
-                q->end, 22, q->line_thickness, q->color);
-        } break;
-        case NK_COMMAND_IMAGE: {
-            const struct nk_command_image *i = (const struct nk_command_image *)cmd;
-            nk_xsurf_draw_image(surf, i->x, i->y, i->w, i->h, i->img, i->col);
-        } break;
-        case NK_COMMAND_RECT_MULTI_COLOR:
-        case NK_COMMAND_ARC:
-        case NK_COMMAND_ARC_FILLED:
-        case NK_COMMAND_CUSTOM:
-        default: break;
+    struct nk_rect damage[NK_XLIB_MAX_DAMAGE];
+    int n, count;
+
+    /* only redraw and copy the parts of the screen which changed */
+    count = nk_damage(ctx, damage, NK_XLIB_MAX_DAMAGE);
+    if (xlib.redraw) {
+        damage[0] = nk_rect(0, 0, (float)surf->w, (float)surf->h);
+        count = 1;
+        xlib.redraw = nk_false;
+    }
+    for (n = 0; n < count; ++n) {
+        nk_xsurf_damage(surf, damage[n]);
+        nk_xsurf_clear(surf, nk_color_from_byte(&clear.r));
+        nk_xsurf_scissor(surf, 0, 0, (float)surf->w, (float)surf->h);
+        nk_foreach(cmd, &xlib.ctx)
+        {
+            switch (cmd->type) {
+            case NK_COMMAND_NOP: break;
+            case NK_COMMAND_SCISSOR: {
+                const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
+                nk_xsurf_scissor(surf, s->x, s->y, s->w, s->h);
+            } break;
+            case NK_COMMAND_LINE: {
+                const struct nk_command_line *l = (const struct nk_command_line *)cmd;
+                nk_xsurf_stroke_line(surf, l->begin.x, l->begin.y, l->end.x,
+                    l->end.y, l->line_thickness, l->color);
+            } break;
+            case NK_COMMAND_RECT: {
+                const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
+                nk_xsurf_stroke_rect(surf, r->x, r->y, r->w, r->h,
+                    (unsigned short)r->rounding, r->line_thickness, r->color);
+            } break;
+            case NK_COMMAND_RECT_FILLED: {
+                const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
+                nk_xsurf_fill_rect(surf, r->x, r->y, r->w, r->h,
+                    (unsigned short)r->rounding, r->color);
+            } break;
+            case NK_COMMAND_CIRCLE: {
+                const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
+                nk_xsurf_stroke_circle(surf, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
+            } break;
+            case NK_COMMAND_CIRCLE_FILLED: {
+                const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+                nk_xsurf_fill_circle(surf, c->x, c->y, c->w, c->h, c->color);
+            } break;
+            case NK_COMMAND_TRIANGLE: {
+                const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
+                nk_xsurf_stroke_triangle(surf, t->a.x, t->a.y, t->b.x, t->b.y,
+                    t->c.x, t->c.y, t->line_thickness, t->color);
+            } break;
+            case NK_COMMAND_TRIANGLE_FILLED: {
+                const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
+                nk_xsurf_fill_triangle(surf, t->a.x, t->a.y, t->b.x, t->b.y,
+                    t->c.x, t->c.y, t->color);
+            } break;
+            case NK_COMMAND_POLYGON: {
+                const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
+                nk_xsurf_stroke_polygon(surf, p->points, p->point_count, p->line_thickness,p->color);
+            } break;
+            case NK_COMMAND_POLYGON_FILLED: {
+                const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
+                nk_xsurf_fill_polygon(surf, p->points, p->point_count, p->color);
+            } break;
+            case NK_COMMAND_POLYLINE: {
+                const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
+                nk_xsurf_stroke_polyline(surf, p->points, p->point_count, p->line_thickness, p->color);
+            } break;
+            case NK_COMMAND_TEXT: {
+                const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+                nk_xsurf_draw_text(surf, t->x, t->y, t->w, t->h,
+                    (const char*)t->string, t->length,
+                    (XFont*)t->font->userdata.ptr,
+                    t->background, t->foreground);
+            } break;
+            case NK_COMMAND_CURVE: {
+                const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
+                nk_xsurf_stroke_curve(surf, q->begin, q->ctrl[0], q->ctrl[1],
+                    q->end, 22, q->line_thickness, q->color);
+            } break;
+            case NK_COMMAND_IMAGE: {
+                const struct nk_command_image *i = (const struct nk_command_image *)cmd;
+                nk_xsurf_draw_image(surf, i->x, i->y, i->w, i->h, i->img, i->col);
+            } break;
+            case NK_COMMAND_RECT_MULTI_COLOR:
+            case NK_COMMAND_ARC:
+            case NK_COMMAND_ARC_FILLED:
+            case NK_COMMAND_CUSTOM:
+            default: break;
+            }
         }
+        nk_xsurf_blit(screen, surf);
     }
     nk_clear(ctx);
-    nk_xsurf_blit(screen, surf, surf->w, surf->h);
 }
 #endif
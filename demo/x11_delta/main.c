@@ -0,0 +1,342 @@
+/*
+ * Thin client demo for nk_delta_encode and nk_delta_decode.
+ *
+ * The process forks into a headless server building the user interface and a
+ * client only forwarding input and drawing received frames with the software
+ * rasterizer of the x11_rawfb demo. Both talk over a local UNIX socket pair
+ * and the server only sends windows which changed since the previous frame.
+ *
+ * Based on x11_rawfb/main.c.
+ */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <time.h>
+
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_IMPLEMENTATION
+#define NK_XLIBSHM_IMPLEMENTATION
+#define NK_RAWFB_IMPLEMENTATION
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#define NK_INCLUDE_SOFTWARE_FONT
+
+#include "../../nuklear.h"
+#include "../x11_rawfb/nuklear_rawfb.h"
+#include "../x11_rawfb/nuklear_xlib.h"
+
+#define DTIME           20
+#define WINDOW_WIDTH    800
+#define WINDOW_HEIGHT   600
+
+#define UNUSED(a) (void)a
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#define MAX(a,b) ((a) < (b) ? (b) : (a))
+#define LEN(a) (sizeof(a)/sizeof(a)[0])
+
+typedef struct XWindow XWindow;
+struct XWindow {
+    Display *dpy;
+    Window root;
+    Visual *vis;
+    Colormap cmap;
+    XWindowAttributes attr;
+    XSetWindowAttributes swa;
+    Window win;
+    int screen;
+    unsigned int width;
+    unsigned int height;
+};
+
+static void
+die(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputs("\n", stderr);
+    exit(EXIT_FAILURE);
+}
+
+static long
+timestamp(void)
+{
+    struct timeval tv;
+    if (gettimeofday(&tv, NULL) < 0) return 0;
+    return (long)((long)tv.tv_sec * 1000 + (long)tv.tv_usec/1000);
+}
+
+static void
+sleep_for(long t)
+{
+    struct timespec req;
+    const time_t sec = (int)(t/1000);
+    const long ms = t - (sec * 1000);
+    req.tv_sec = sec;
+    req.tv_nsec = ms * 1000000L;
+    while(-1 == nanosleep(&req, &req));
+}
+
+static int
+read_all(int fd, void *memory, size_t size)
+{
+    char *p = (char*)memory;
+    while (size) {
+        ssize_t n = read(fd, p, size);
+        if (n <= 0) return 0;
+        p += n; size -= (size_t)n;
+    }
+    return 1;
+}
+
+static int
+write_all(int fd, const void *memory, size_t size)
+{
+    const char *p = (const char*)memory;
+    while (size) {
+        ssize_t n = write(fd, p, size);
+        if (n <= 0) return 0;
+        p += n; size -= (size_t)n;
+    }
+    return 1;
+}
+
+/* ===============================================================
+ *
+ *                          EXAMPLE
+ *
+ * ===============================================================*/
+/* This are some code examples to provide a small overview of what can be
+ * done with this library. To try out an example uncomment the defines */
+/*#define INCLUDE_ALL */
+/*#define INCLUDE_STYLE */
+/*#define INCLUDE_CALCULATOR */
+/*#define INCLUDE_OVERVIEW */
+/*#define INCLUDE_NODE_EDITOR */
+
+#ifdef INCLUDE_ALL
+  #define INCLUDE_STYLE
+  #define INCLUDE_CALCULATOR
+  #define INCLUDE_OVERVIEW
+  #define INCLUDE_NODE_EDITOR
+#endif
+
+#ifdef INCLUDE_STYLE
+  #include "../style.c"
+#endif
+#ifdef INCLUDE_CALCULATOR
+  #include "../calculator.c"
+#endif
+#ifdef INCLUDE_OVERVIEW
+  #include "../overview.c"
+#endif
+#ifdef INCLUDE_NODE_EDITOR
+  #include "../node_editor.c"
+#endif
+
+/* ===============================================================
+ *
+ *                          SERVER
+ *
+ * ===============================================================*/
+static void
+server(int fd, struct nk_context *ctx)
+{
+    struct nk_delta_encoder encoder;
+    struct nk_buffer message;
+    nk_uint size;
+
+    nk_delta_encoder_init(&encoder);
+    nk_buffer_init_default(&message);
+    #ifdef INCLUDE_STYLE
+    /*set_style(ctx, THEME_WHITE);*/
+    /*set_style(ctx, THEME_RED);*/
+    /*set_style(ctx, THEME_BLUE);*/
+    /*set_style(ctx, THEME_DARK);*/
+    #endif
+
+    /* the client sends its input state for each frame */
+    while (read_all(fd, &ctx->input, sizeof(ctx->input))) {
+        /* GUI */
+        if (nk_begin(ctx, "Demo", nk_rect(50, 50, 200, 200),
+            NK_WINDOW_BORDER|NK_WINDOW_MOVABLE|
+            NK_WINDOW_CLOSABLE|NK_WINDOW_MINIMIZABLE|NK_WINDOW_TITLE)) {
+            enum {EASY, HARD};
+            static int op = EASY;
+            static int property = 20;
+
+            nk_layout_row_static(ctx, 30, 80, 1);
+            if (nk_button_label(ctx, "button"))
+                fprintf(stdout, "button pressed\n");
+            nk_layout_row_dynamic(ctx, 30, 2);
+            if (nk_option_label(ctx, "easy", op == EASY)) op = EASY;
+            if (nk_option_label(ctx, "hard", op == HARD)) op = HARD;
+            nk_layout_row_dynamic(ctx, 25, 1);
+            nk_property_int(ctx, "Compression:", 0, &property, 100, 10, 1);
+        }
+        nk_end(ctx);
+        if (nk_window_is_closed(ctx, "Demo")) break;
+
+        /* -------------- EXAMPLES ---------------- */
+        #ifdef INCLUDE_CALCULATOR
+          calculator(ctx);
+        #endif
+        #ifdef INCLUDE_OVERVIEW
+          overview(ctx);
+        #endif
+        #ifdef INCLUDE_NODE_EDITOR
+          node_editor(ctx);
+        #endif
+        /* ----------------------------------------- */
+
+        /* send changes since the previous frame prefixed by their size */
+        nk_buffer_clear(&message);
+        if (!nk_delta_encode(&encoder, ctx, &message))
+            break;
+        nk_clear(ctx);
+        size = (nk_uint)message.allocated;
+        if (!write_all(fd, &size, sizeof(size)) ||
+            !write_all(fd, nk_buffer_memory(&message), message.allocated))
+            break;
+    }
+    /* zero sized message tells the client to quit */
+    size = 0;
+    write_all(fd, &size, sizeof(size));
+    nk_buffer_free(&message);
+}
+
+/* ===============================================================
+ *
+ *                          CLIENT
+ *
+ * ===============================================================*/
+int
+main(void)
+{
+    long dt;
+    long started;
+    int running = 1;
+    int status;
+    int fds[2];
+    pid_t pid;
+    XWindow xw;
+    struct rawfb_context *rawfb;
+    struct nk_delta_decoder decoder;
+    struct nk_replay replay;
+    void *fb = NULL;
+    unsigned char tex_scratch[512 * 512];
+    void *message = NULL;
+    nk_uint message_size = 0;
+
+    /* X11 */
+    memset(&xw, 0, sizeof xw);
+    xw.dpy = XOpenDisplay(NULL);
+    if (!xw.dpy) die("Could not open a display; perhaps $DISPLAY is not set?");
+    xw.root = DefaultRootWindow(xw.dpy);
+    xw.screen = XDefaultScreen(xw.dpy);
+    xw.vis = XDefaultVisual(xw.dpy, xw.screen);
+    xw.cmap = XCreateColormap(xw.dpy,xw.root,xw.vis,AllocNone);
+    xw.swa.colormap = xw.cmap;
+    xw.swa.event_mask =
+        ExposureMask | KeyPressMask | KeyReleaseMask |
+        ButtonPress | ButtonReleaseMask| ButtonMotionMask |
+        Button1MotionMask | Button3MotionMask | Button4MotionMask | Button5MotionMask|
+        PointerMotionMask | KeymapStateMask | EnterWindowMask | LeaveWindowMask;
+    xw.win = XCreateWindow(xw.dpy, xw.root, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, 0,
+        XDefaultDepth(xw.dpy, xw.screen), InputOutput,
+        xw.vis, CWEventMask | CWColormap, &xw.swa);
+
+    XStoreName(xw.dpy, xw.win, "X11 delta");
+    XMapWindow(xw.dpy, xw.win);
+    XGetWindowAttributes(xw.dpy, xw.win, &xw.attr);
+    xw.width = (unsigned int)xw.attr.width;
+    xw.height = (unsigned int)xw.attr.height;
+
+    /* Framebuffer emulator */
+    status = nk_xlib_init(xw.dpy, xw.vis, xw.screen, xw.win, xw.width, xw.height, &fb);
+    if (!status || !fb)
+        return 0;
+
+    /* GUI */
+    rawfb = nk_rawfb_init(fb, tex_scratch, xw.width, xw.height, xw.width * 4);
+    if (!rawfb) return 0;
+
+    /* Server shares the baked fonts since it is forked after setup */
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+        die("Could not create socket pair");
+    pid = fork();
+    if (pid < 0) die("Could not fork server");
+    if (pid == 0) {
+        close(fds[0]);
+        server(fds[1], &rawfb->ctx);
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    nk_delta_decoder_init_default(&decoder);
+
+    while (running) {
+        /* Input */
+        XEvent evt;
+        started = timestamp();
+        nk_input_begin(&rawfb->ctx);
+        while (XCheckWindowEvent(xw.dpy, xw.win, xw.swa.event_mask, &evt)) {
+            if (XFilterEvent(&evt, xw.win)) continue;
+            nk_xlib_handle_event(xw.dpy, xw.screen, xw.win, &evt, rawfb);
+        }
+        nk_input_end(&rawfb->ctx);
+        if (!write_all(fds[0], &rawfb->ctx.input, sizeof(rawfb->ctx.input)))
+            break;
+
+        /* Receive frame */
+        {nk_uint size;
+        if (!read_all(fds[0], &size, sizeof(size)) || !size) break;
+        if (size > message_size) {
+            free(message);
+            message = malloc(size);
+            message_size = size;
+            if (!message) die("Out of memory");
+        }
+        if (!read_all(fds[0], message, size)) break;
+        if (!nk_delta_decode(&decoder, &replay, message, size))
+            die("Could not decode frame");
+        nk_replay_load(&rawfb->ctx, &replay, NULL);}
+
+        /* Draw framebuffer */
+        nk_rawfb_render(rawfb, nk_rgb(30,30,30), 1);
+
+        /* Emulate framebuffer */
+        nk_xlib_render(xw.win, rawfb);
+        XFlush(xw.dpy);
+
+        /* Timing */
+        dt = timestamp() - started;
+        if (dt < DTIME)
+            sleep_for(DTIME - dt);
+    }
+
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+    free(message);
+    nk_delta_decoder_free(&decoder);
+    nk_rawfb_shutdown(rawfb);
+    nk_xlib_shutdown();
+    XUnmapWindow(xw.dpy, xw.win);
+    XFreeColormap(xw.dpy, xw.cmap);
+    XDestroyWindow(xw.dpy, xw.win);
+    XCloseDisplay(xw.dpy);
+    return 0;
+}
@@ -27,7 +27,7 @@
 #define WINDOW_HEIGHT 800
 
 #define MAX_VERTEX_BUFFER 512 * 1024
-#define MAX_ELEMENT_BUFFER 128 * 1024
+#define MAX_ELEMENT_BUFFER 256 * 1024
 
 /* ===============================================================
  *
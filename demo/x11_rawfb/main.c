@@ -242,8 +242,7 @@ main(void)
         nk_rawfb_render(rawfb, nk_rgb(30,30,30), 1);
 
         /* Emulate framebuffer */
-        XClearWindow(xw.dpy, xw.win);
-        nk_xlib_render(xw.win);
+        nk_xlib_render(xw.win, rawfb);
         XFlush(xw.dpy);
 
         /* Timing */
@@ -49,6 +49,10 @@ NK_API void                  nk_rawfb_resize_fb(struct rawfb_context *rawfb, voi
  */
 #ifdef NK_RAWFB_IMPLEMENTATION
 
+#ifndef NK_RAWFB_MAX_DAMAGE
+#define NK_RAWFB_MAX_DAMAGE 16
+#endif
+
 struct rawfb_image {
     void *pixels;
     int w, h, pitch;
@@ -57,6 +61,11 @@ struct rawfb_image {
 struct rawfb_context {
     struct nk_context ctx;
     struct nk_rect scissors;
+    struct nk_rect damage;
+    int redraw;
+    /* framebuffer areas redrawn by the last `nk_rawfb_render` */
+    struct nk_rect dirty[NK_RAWFB_MAX_DAMAGE];
+    int dirty_count;
     struct rawfb_image fb;
     struct rawfb_image font_tex;
     struct nk_font_atlas atlas;
@@ -185,10 +194,23 @@ nk_rawfb_scissor(struct rawfb_context *rawfb,
                  const float w,
                  const float h)
 {
-    rawfb->scissors.x = MIN(MAX(x, 0), rawfb->fb.w);
-    rawfb->scissors.y = MIN(MAX(y, 0), rawfb->fb.h);
-    rawfb->scissors.w = MIN(MAX(w + x, 0), rawfb->fb.w);
-    rawfb->scissors.h = MIN(MAX(h + y, 0), rawfb->fb.h);
+    /* scissors are always limited to the currently redrawn area */
+    const struct nk_rect *d = &rawfb->damage;
+    rawfb->scissors.x = MIN(MAX(x, d->x), d->x + d->w);
+    rawfb->scissors.y = MIN(MAX(y, d->y), d->y + d->h);
+    rawfb->scissors.w = MAX(MIN(w + x, d->x + d->w), rawfb->scissors.x);
+    rawfb->scissors.h = MAX(MIN(h + y, d->y + d->h), rawfb->scissors.y);
+}
+
+static void
+nk_rawfb_damage(struct rawfb_context *rawfb, const struct nk_rect r)
+{
+    /* whole pixels so the area can be presented as is */
+    rawfb->damage.x = MIN(MAX((float)nk_ifloorf(r.x), 0), rawfb->fb.w);
+    rawfb->damage.y = MIN(MAX((float)nk_ifloorf(r.y), 0), rawfb->fb.h);
+    rawfb->damage.w = MIN(MAX((float)nk_iceilf(r.x + r.w), 0), rawfb->fb.w) - rawfb->damage.x;
+    rawfb->damage.h = MIN(MAX((float)nk_iceilf(r.y + r.h), 0), rawfb->fb.h) - rawfb->damage.y;
+    nk_rawfb_scissor(rawfb, 0, 0, rawfb->fb.w, rawfb->fb.h);
 }
 
 static void
@@ -685,7 +707,8 @@ nk_rawfb_stroke_curve(const struct rawfb_context *rawfb,
 static void
 nk_rawfb_clear(const struct rawfb_context *rawfb, const struct nk_color col)
 {
-    nk_rawfb_fill_rect(rawfb, 0, 0, rawfb->fb.w, rawfb->fb.h, 0, col);
+    nk_rawfb_fill_rect(rawfb, rawfb->damage.x, rawfb->damage.y,
+        rawfb->damage.w, rawfb->damage.h, 0, col);
 }
 
 NK_API struct rawfb_context*
@@ -734,7 +757,8 @@ nk_rawfb_init(void *fb, void *tex_mem, const unsigned int w, const unsigned int
     if (rawfb->atlas.default_font)
         nk_style_set_font(&rawfb->ctx, &rawfb->atlas.default_font->handle);
     nk_style_load_all_cursors(&rawfb->ctx, rawfb->atlas.cursors);
-    nk_rawfb_scissor(rawfb, 0, 0, rawfb->fb.w, rawfb->fb.h);
+    nk_rawfb_damage(rawfb, nk_rect(0, 0, rawfb->fb.w, rawfb->fb.h));
+    rawfb->redraw = nk_true;
     return rawfb;
 }
 
@@ -874,6 +898,7 @@ NK_API void
 nk_rawfb_shutdown(struct rawfb_context *rawfb)
 {
     nk_free(&rawfb->ctx);
+    nk_font_atlas_clear(&rawfb->atlas);
     nk_memset(rawfb, 0, sizeof(struct rawfb_context));
     free(rawfb);
 }
@@ -889,6 +914,7 @@ nk_rawfb_resize_fb(struct rawfb_context *rawfb,
     rawfb->fb.h = h;
     rawfb->fb.pixels = fb;
     rawfb->fb.pitch = pitch;
+    rawfb->redraw = nk_true;
 }
 
 NK_API void
@@ -897,83 +923,101 @@ nk_rawfb_render(const struct rawfb_context *rawfb,
                 const unsigned char enable_clear)
 {
     const struct nk_command *cmd;
-    if (enable_clear)
-        nk_rawfb_clear(rawfb, clear);
-
-    nk_foreach(cmd, (struct nk_context*)&rawfb->ctx) {
-        switch (cmd->type) {
-        case NK_COMMAND_NOP: break;
-        case NK_COMMAND_SCISSOR: {
-            const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
-            nk_rawfb_scissor((struct rawfb_context *)rawfb, s->x, s->y, s->w, s->h);
-        } break;
-        case NK_COMMAND_LINE: {
-            const struct nk_command_line *l = (const struct nk_command_line *)cmd;
-            nk_rawfb_stroke_line(rawfb, l->begin.x, l->begin.y, l->end.x,
-                l->end.y, l->line_thickness, l->color);
-        } break;
-        case NK_COMMAND_RECT: {
-            const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
-            nk_rawfb_stroke_rect(rawfb, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->line_thickness, r->color);
-        } break;
-        case NK_COMMAND_RECT_FILLED: {
-            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
-            nk_rawfb_fill_rect(rawfb, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->color);
-        } break;
-        case NK_COMMAND_CIRCLE: {
-            const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
-            nk_rawfb_stroke_circle(rawfb, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
-        } break;
-        case NK_COMMAND_CIRCLE_FILLED: {
-            const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-            nk_rawfb_fill_circle(rawfb, c->x, c->y, c->w, c->h, c->color);
-        } break;
-        case NK_COMMAND_TRIANGLE: {
-            const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
-            nk_rawfb_stroke_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->line_thickness, t->color);
-        } break;
-        case NK_COMMAND_TRIANGLE_FILLED: {
-            const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
-            nk_rawfb_fill_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->color);
-        } break;
-        case NK_COMMAND_POLYGON: {
-            const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
-            nk_rawfb_stroke_polygon(rawfb, p->points, p->point_count, p->line_thickness,p->color);
-        } break;
-        case NK_COMMAND_POLYGON_FILLED: {
-            const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
-            nk_rawfb_fill_polygon(rawfb, p->points, p->point_count, p->color);
-        } break;
-        case NK_COMMAND_POLYLINE: {
-            const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
-            nk_rawfb_stroke_polyline(rawfb, p->points, p->point_count, p->line_thickness, p->color);
-        } break;
-        case NK_COMMAND_TEXT: {
-            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
-            nk_rawfb_draw_text(rawfb, t->font, nk_rect(t->x, t->y, t->w, t->h),
-                t->string, t->length, t->height, t->foreground);
-        } break;
-        case NK_COMMAND_CURVE: {
-            const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
-            nk_rawfb_stroke_curve(rawfb, q->begin, q->ctrl[0], q->ctrl[1],
-                q->end, 22, q->line_thickness, q->color);
-        } break;
-        case NK_COMMAND_RECT_MULTI_COLOR:
-        case NK_COMMAND_IMAGE: {
-            const struct nk_command_image *q = (const struct nk_command_image *)cmd;
-            nk_rawfb_drawimage(rawfb, q->x, q->y, q->w, q->h, &q->img, &q->col);
-        } break;
-        case NK_COMMAND_ARC: {
-            assert(0 && "NK_COMMAND_ARC not implemented\n");
-        } break;
-        case NK_COMMAND_ARC_FILLED: {
-            assert(0 && "NK_COMMAND_ARC_FILLED not implemented\n");
-        } break;
-        default: break;
+    struct rawfb_context *fb = (struct rawfb_context*)rawfb;
+    struct nk_rect damage[NK_RAWFB_MAX_DAMAGE];
+    int n, count;
+
+    /* only redraw the parts of the framebuffer which changed. Without
+     * clearing the caller owns the background so everything is redrawn */
+    count = nk_damage(&fb->ctx, damage, NK_RAWFB_MAX_DAMAGE);
+    if (rawfb->redraw || !enable_clear) {
+        damage[0] = nk_rect(0, 0, rawfb->fb.w, rawfb->fb.h);
+        count = 1;
+        fb->redraw = nk_false;
+    }
+    fb->dirty_count = 0;
+    for (n = 0; n < count; ++n) {
+        nk_rawfb_damage(fb, damage[n]);
+        if (rawfb->damage.w <= 0 || rawfb->damage.h <= 0) continue;
+        fb->dirty[fb->dirty_count++] = rawfb->damage;
+        if (enable_clear)
+            nk_rawfb_clear(rawfb, clear);
+
+        nk_foreach(cmd, (struct nk_context*)&rawfb->ctx) {
+            switch (cmd->type) {
+            case NK_COMMAND_NOP: break;
+            case NK_COMMAND_SCISSOR: {
+                const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
+                nk_rawfb_scissor((struct rawfb_context *)rawfb, s->x, s->y, s->w, s->h);
+            } break;
+            case NK_COMMAND_LINE: {
+                const struct nk_command_line *l = (const struct nk_command_line *)cmd;
+                nk_rawfb_stroke_line(rawfb, l->begin.x, l->begin.y, l->end.x,
+                    l->end.y, l->line_thickness, l->color);
+            } break;
+            case NK_COMMAND_RECT: {
+                const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
+                nk_rawfb_stroke_rect(rawfb, r->x, r->y, r->w, r->h,
+                    (unsigned short)r->rounding, r->line_thickness, r->color);
+            } break;
+            case NK_COMMAND_RECT_FILLED: {
+                const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
+                nk_rawfb_fill_rect(rawfb, r->x, r->y, r->w, r->h,
+                    (unsigned short)r->rounding, r->color);
+            } break;
+            case NK_COMMAND_CIRCLE: {
+                const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
+                nk_rawfb_stroke_circle(rawfb, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
+            } break;
+            case NK_COMMAND_CIRCLE_FILLED: {
+                const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+                nk_rawfb_fill_circle(rawfb, c->x, c->y, c->w, c->h, c->color);
+            } break;
+            case NK_COMMAND_TRIANGLE: {
+                const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
+                nk_rawfb_stroke_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
+                    t->c.x, t->c.y, t->line_thickness, t->color);
+            } break;
+            case NK_COMMAND_TRIANGLE_FILLED: {
+                const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
+                nk_rawfb_fill_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
+                    t->c.x, t->c.y, t->color);
+            } break;
+            case NK_COMMAND_POLYGON: {
+                const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
+                nk_rawfb_stroke_polygon(rawfb, p->points, p->point_count, p->line_thickness,p->color);
+            } break;
+            case NK_COMMAND_POLYGON_FILLED: {
+                const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
+                nk_rawfb_fill_polygon(rawfb, p->points, p->point_count, p->color);
+            } break;
+            case NK_COMMAND_POLYLINE: {
+                const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
+                nk_rawfb_stroke_polyline(rawfb, p->points, p->point_count, p->line_thickness, p->color);
+            } break;
+            case NK_COMMAND_TEXT: {
+                const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+                nk_rawfb_draw_text(rawfb, t->font, nk_rect(t->x, t->y, t->w, t->h),
+                    t->string, t->length, t->height, t->foreground);
+            } break;
+            case NK_COMMAND_CURVE: {
+                const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
+                nk_rawfb_stroke_curve(rawfb, q->begin, q->ctrl[0], q->ctrl[1],
+                    q->end, 22, q->line_thickness, q->color);
+            } break;
+            case NK_COMMAND_RECT_MULTI_COLOR:
+            case NK_COMMAND_IMAGE: {
+                const struct nk_command_image *q = (const struct nk_command_image *)cmd;
+                nk_rawfb_drawimage(rawfb, q->x, q->y, q->w, q->h, &q->img, &q->col);
+            } break;
+            case NK_COMMAND_ARC: {
+                assert(0 && "NK_COMMAND_ARC not implemented\n");
+            } break;
+            case NK_COMMAND_ARC_FILLED: {
+                assert(0 && "NK_COMMAND_ARC_FILLED not implemented\n");
+            } break;
+            default: break;
+            }
         }
     } nk_clear((struct nk_context*)&rawfb->ctx);
 }
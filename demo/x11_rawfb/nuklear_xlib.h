@@ -37,7 +37,7 @@
 
 NK_API int  nk_xlib_init(Display *dpy, Visual *vis, int screen, Window root, unsigned int w, unsigned int h, void **fb);
 NK_API int  nk_xlib_handle_event(Display *dpy, int screen, Window win, XEvent *evt, struct rawfb_context *rawfb);
-NK_API void nk_xlib_render(Drawable screen);
+NK_API void nk_xlib_render(Drawable screen, const struct rawfb_context *rawfb);
 NK_API void nk_xlib_shutdown(void);
 
 #endif
@@ -271,13 +271,18 @@ nk_xlib_shutdown(void)
 }
 
 NK_API void
-nk_xlib_render(Drawable screen)
+nk_xlib_render(Drawable screen, const struct rawfb_context *rawfb)
 {
-    if (xlib.fallback)
-        XPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg,
-            0, 0, 0, 0, xlib.ximg->width, xlib.ximg->height);
-    else XShmPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg,
-            0, 0, 0, 0, xlib.ximg->width, xlib.ximg->height, False);
+    /* only present the framebuffer areas which were redrawn */
+    int i;
+    for (i = 0; i < rawfb->dirty_count; ++i) {
+        const struct nk_rect *d = &rawfb->dirty[i];
+        const int x = (int)d->x, y = (int)d->y;
+        const unsigned int w = (unsigned int)d->w, h = (unsigned int)d->h;
+        if (xlib.fallback)
+            XPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg, x, y, x, y, w, h);
+        else XShmPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg, x, y, x, y, w, h, False);
+    }
 }
 #endif
 
@@ -101,6 +101,8 @@
 /// NK_INCLUDE_COMMAND_USERDATA     | Defining this adds a userdata pointer into each command. Can be useful for example if you want to provide custom shaders depending on the used widget. Can be combined with the style structures.
 /// NK_BUTTON_TRIGGER_ON_RELEASE    | Different platforms require button clicks occurring either on buttons being pressed (up to down) or released (down to up). By default this library will react on buttons being pressed, but if you define this it will only trigger if a button is released.
 /// NK_ZERO_COMMAND_MEMORY          | Defining this will zero out memory for each drawing command added to a drawing queue (inside nk_command_buffer_push). Zeroing command memory is very useful for fast checking (using memcmp) if command buffers are equal and avoid drawing frames when nothing on screen has changed since previous frame.
+/// NK_OCCLUSION_CULLING            | Defining this will skip drawing windows which are completely hidden behind windows with opaque header and background drawn above them. Only works if colors stay opaque while drawing, so do not define it in combination with a `global_alpha` below 1 in `nk_convert`.
+/// NK_ZERO_COPY_TEXT               | Defining this will let text draw commands reference the drawn string instead of copying it into the command buffer. Text passed to widgets therefore has to stay valid and unchanged until `nk_clear` is called. Formatted labels and tooltips, window titles as well as edit and property text are still copied. Referenced strings are not zero terminated so backends have to use `length` of `nk_command_text`.
 ///
 /// !!! WARNING
 ///     The following flags will pull in the standard C library:
@@ -118,6 +120,7 @@
 ///     - NK_INCLUDE_DEFAULT_FONT
 ///     - NK_INCLUDE_STANDARD_VARARGS
 ///     - NK_INCLUDE_COMMAND_USERDATA
+///     - NK_ZERO_COPY_TEXT
 ///
 /// ### Constants
 /// Define                          | Description
@@ -125,12 +128,20 @@
 /// NK_BUFFER_DEFAULT_INITIAL_SIZE  | Initial buffer size allocated by all buffers while using the default allocator functions included by defining NK_INCLUDE_DEFAULT_ALLOCATOR. If you don't want to allocate the default 4k memory then redefine it.
 /// NK_MAX_NUMBER_BUFFER            | Maximum buffer size for the conversion buffer between float and string Under normal circumstances this should be more than sufficient.
 /// NK_INPUT_MAX                    | Defines the max number of bytes which can be added as text input in one frame. Under normal circumstances this should be more than sufficient.
+/// NK_WINDOW_INDEX_SIZE            | Number of slots in the hash index used to look up windows by name. Needs to be a power of two. Up to three quarters of the slots are used before lookups fall back to scanning the window list. Defaults to 1024, which keeps up to 768 windows on the hash path; increase it if you have more windows open at once.
+/// NK_RECORD_MAX_FONTS             | Maximum number of different fonts used in one frame recorded by `nk_record` or encoded by `nk_delta_encode`.
+/// NK_DELTA_MAX_WINDOWS            | Maximum number of windows, popups and overlays per frame `nk_delta_encode` remembers to send as reference if unchanged. Any further window is always sent in full.
+/// NK_CONVERT_CACHE_WINDOWS        | Number of windows, popups and overlays a `nk_convert_cache` keeps converted vertices for. Any further window is converted each frame.
+/// NK_DRAW_SHAPE_MAX_POINTS        | Maximum number of points of a circle the draw list caches tessellated outlines and normals for. Circles with more segments are tessellated each time they are drawn.
 ///
 /// !!! WARNING
 ///     The following constants if defined need to be defined for both header and implementation:
 ///     - NK_MAX_NUMBER_BUFFER
 ///     - NK_BUFFER_DEFAULT_INITIAL_SIZE
 ///     - NK_INPUT_MAX
+///     - NK_WINDOW_INDEX_SIZE
+///     - NK_RECORD_MAX_FONTS
+///     - NK_DELTA_MAX_WINDOWS
 ///
 /// ### Dependencies
 /// Function    | Description
@@ -231,6 +242,18 @@ extern "C" {
 #ifndef NK_SCROLLBAR_HIDING_TIMEOUT
   #define NK_SCROLLBAR_HIDING_TIMEOUT 4.0f
 #endif
+#ifndef NK_RECORD_MAX_FONTS
+  #define NK_RECORD_MAX_FONTS 16
+#endif
+#ifndef NK_DELTA_MAX_WINDOWS
+  #define NK_DELTA_MAX_WINDOWS 64
+#endif
+#ifndef NK_DRAW_SHAPE_MAX_POINTS
+  #define NK_DRAW_SHAPE_MAX_POINTS 64
+#endif
+#ifndef NK_CONVERT_CACHE_WINDOWS
+  #define NK_CONVERT_CACHE_WINDOWS 16
+#endif
 /*
  * ==============================================================
  *
@@ -522,6 +545,12 @@ enum nk_symbol_type {
 /// __nk_init_custom__  | Initializes context from two buffers. One for draw commands the other for window/panel/table allocations
 /// __nk_clear__        | Called at the end of the frame to reset and prepare the context for the next frame
 /// __nk_free__         | Shutdown and free all memory allocated inside the context
+/// __nk_trim__         | Returns unused window/panel/table memory pages back to the allocator
+/// __nk_page_info__    | Retrieves window/panel/table memory usage and high-water mark
+/// __nk_context_info__ | Retrieves draw command, memory and vertex statistics of the current frame
+/// __nk_window_command_info__ | Retrieves draw command statistics of a single window
+/// __nk_worker_begin__ | Prepares a worker context to build windows on another thread
+/// __nk_worker_merge__ | Merges all windows built by a worker context into the context
 /// __nk_set_user_data__| Utility function to pass user data to draw command
  */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
@@ -631,6 +660,134 @@ NK_API void nk_clear(struct nk_context*);
 /// __ctx__     | Must point to a previously initialized `nk_context` struct
 */
 NK_API void nk_free(struct nk_context*);
+/*/// #### nk_trim
+/// Returns all memory pages holding windows, panels and tables which are
+/// completely unused back to the allocator. Memory pages are otherwise only
+/// freed inside `nk_free`, so long running applications can call this
+/// after `nk_clear` to bound memory after a burst of popups or tables.
+/// Does nothing if the context was initialized with `nk_init_fixed` or
+/// with a fixed pool buffer in `nk_init_custom`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API nk_size nk_trim(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns the number of bytes returned to the allocator.
+*/
+NK_API nk_size nk_trim(struct nk_context*);
+/*/// #### nk_page_info
+/// Retrieves memory usage of page elements used to store windows, panels and
+/// tables as well as the maximum number of page elements used at once.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API void nk_page_info(struct nk_page_status *status, struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __status__  | Must point to a `nk_page_status` struct to be filled
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+struct nk_page_status {
+    nk_size element_size;
+    /* size of one page element in bytes */
+    unsigned int elements;
+    /* number of page elements currently in use */
+    unsigned int elements_free;
+    /* number of unused page elements ready to be reused */
+    unsigned int elements_peak;
+    /* maximum number of page elements in use at once */
+    unsigned int pages;
+    /* number of memory pages allocated from the pool allocator */
+    nk_size allocated;
+    /* total number of bytes currently held for page elements */
+};
+NK_API void nk_page_info(struct nk_page_status*, struct nk_context*);
+/*/// #### nk_context_info
+/// Retrieves per frame statistics of the whole context. This includes number and
+/// size of all draw commands per `enum nk_command_type`, state tables and page
+/// elements, draw command memory and the vertex output of `nk_convert` as
+/// well as peak values over all frames. Useful to size memory for `nk_init_fixed`.
+/// Needs to be called after all windows are finished and before `nk_clear`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API void nk_context_info(struct nk_context_stats *stats, struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __stats__   | Must point to a `nk_context_stats` struct to be filled
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+struct nk_context_stats;
+NK_API void nk_context_info(struct nk_context_stats*, struct nk_context*);
+/*/// #### nk_window_command_info
+/// Retrieves number and size of all draw commands of the window with given
+/// name in the current frame per `enum nk_command_type`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API void nk_window_command_info(struct nk_command_stats *stats, struct nk_context *ctx, const char *name);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __stats__   | Must point to a `nk_command_stats` struct to be filled
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __name__    | Name of the window to retrieve draw command statistics for
+*/
+struct nk_command_stats;
+NK_API void nk_window_command_info(struct nk_command_stats*, struct nk_context*, const char *name);
+/*/// #### nk_worker_begin
+/// Prepares a worker context to build windows on another thread. Worker contexts
+/// are initialized like any other context and own the state of all windows they
+/// build. Before each frame the worker gets a copy of input, style and time of the
+/// main context. Mouse input is only passed on if the mouse is over one of the
+/// worker windows or no window at all and keyboard input only if a worker window
+/// is active. Worker windows are drawn active or inactive like in the context.
+/// Font and clipboard callbacks are shared and need to be thread safe.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_input_end(&ctx);
+/// for (i = 0; i < THREADS; ++i)
+///     nk_worker_begin(&workers[i], &ctx);
+/// // [...] build windows with `workers[i]` on thread `i` and `ctx` on this thread
+/// for (i = 0; i < THREADS; ++i) {
+///     nk_worker_merge(&ctx, &workers[i]);
+///     nk_clear(&workers[i]);
+/// }
+/// // [...] draw `ctx`
+/// nk_clear(&ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __worker__  | Must point to a previously initialized `nk_context` struct only used to build windows
+/// __ctx__     | Must point to a previously initialized `nk_context` struct after `nk_input_end`
+*/
+NK_API void nk_worker_begin(struct nk_context *worker, const struct nk_context *ctx);
+/*/// #### nk_worker_merge
+/// Copies the draw commands of all windows built by a worker context this frame
+/// into the context. Each merged window keeps its place in the window stack of
+/// the context so drawing order only depends on window focus and not on thread
+/// timing. Has to be called after the worker finished building all its windows
+/// and before drawing the context. The worker context still needs to be cleared
+/// by `nk_clear` afterwards. Popups opened by a worker window are carried over
+/// as well so they take part in focus handling and `nk_damage` of the context.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API void nk_worker_merge(struct nk_context *ctx, struct nk_context *worker);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __worker__  | Must point to a worker context prepared by `nk_worker_begin`
+*/
+NK_API void nk_worker_merge(struct nk_context *ctx, struct nk_context *worker);
 #ifdef NK_INCLUDE_COMMAND_USERDATA
 /*/// #### nk_set_user_data
 /// Sets the currently passed userdata passed down into each draw command.
@@ -1051,6 +1208,30 @@ NK_API void nk_input_end(struct nk_context*);
 /// nk_free(&ctx);
 /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 ///
+/// Instead of comparing the whole command buffer it is also possible to ask nuklear
+/// which parts of the screen actually changed since the last frame. `nk_damage`
+/// compares the draw commands of each window with the previous call and returns
+/// a list of screen rectangles which need to be redrawn. Backends can then
+/// restrict drawing and presenting to these rectangles.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// struct nk_rect damage[8];
+/// while (1) {
+///     // [...input...]
+///     // [...ui...]
+///     int i, count = nk_damage(&ctx, damage, 8);
+///     for (i = 0; i < count; ++i) {
+///         your_set_clip_rect(damage[i]);
+///         your_clear_rect(damage[i]);
+///         nk_foreach(cmd, &ctx) {
+///             // [...]
+///         }
+///         your_present_rect(damage[i]);
+///     }
+///     nk_clear(&ctx);
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
 /// Finally while using draw commands makes sense for higher abstracted platforms like
 /// X11 and Win32 or drawing libraries it is often desirable to use graphics
 /// hardware directly. Therefore it is possible to just define
@@ -1096,25 +1277,95 @@ NK_API void nk_input_end(struct nk_context*);
 /// nk_buffer_free(&idx);
 /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 ///
+/// By default vertex indices are 16 bit `nk_draw_index` values. Frames with more
+/// than 65536 vertices are split into several vertex draw commands and each one
+/// stores the first vertex its indices refer to in `vertex_offset`. Backends have to
+/// pass it as base vertex (for example `glDrawElementsBaseVertex` or the
+/// `BaseVertexLocation` of `DrawIndexed`). It stays zero for smaller frames.
+/// Alternatively setting `index_type` to `NK_DRAW_INDEX_UINT` writes 32 bit indices
+/// into the element buffer which never need a base vertex.
+///
+/// Circles, arcs and curves are split into the fixed number of segments set in
+/// `circle_segment_count`, `arc_segment_count` and `curve_segment_count` regardless
+/// of their size. Setting `segment_tolerance` to a distance in pixels (for example
+/// 0.25f) instead derives the number of segments of each shape from its size, so
+/// that no segment is farther away from the exact shape than the tolerance. Small
+/// shapes then use a lot less vertices while large ones stay round.
+///
+/// Every change of the clipping rectangle starts a new vertex draw command which
+/// has to be drawn with its own scissor rectangle. Setting `clipping` to
+/// `NK_DRAW_CLIP_GEOMETRY` instead clips the geometry on the CPU, so consecutive
+/// commands with the same texture end up in one vertex draw command with a
+/// `clip_rect` covering the whole screen. Glyphs and images are cut together with
+/// their texture coordinates, shapes crossing the clipping rectangle are cut
+/// triangle by triangle and shapes outside of it are dropped. Shapes still get a
+/// vertex draw command with their own `clip_rect` for vertex layouts other than
+/// float position and texture coordinates with 8 bit colors and for
+/// `NK_COMMAND_CUSTOM` callbacks.
+///
+/// Anti-aliased rectangles, circles and lines are built out of a lot of triangles
+/// for their rounded corners and their anti-aliasing fringe. Setting `shape_mode`
+/// to `NK_DRAW_SHAPE_SDF` instead emits each of them as a single quad and leaves
+/// the shape to the fragment shader. This requires a `NK_VERTEX_SHAPE` attribute
+/// of four values in the vertex layout: half width, half height, corner radius and
+/// stroke thickness (zero for filled shapes). The texture coordinate of these quads
+/// holds the position relative to the center of the shape. For all other vertices
+/// the shape attribute is zero and they are drawn with the texture as before:
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// if (Frag_Shape.x > 0.0) {
+///     vec2 q = abs(Frag_UV) - Frag_Shape.xy + Frag_Shape.z;
+///     float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - Frag_Shape.z;
+///     if (Frag_Shape.w > 0.0) d = abs(d) - Frag_Shape.w * 0.5;
+///     d /= length(dFdx(Frag_UV));
+///     Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * clamp(0.5 - d, 0.0, 1.0));
+/// } else Out_Color = Frag_Color * texture(Texture, Frag_UV);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Dividing the distance by the size of a pixel in texture coordinates keeps the
+/// anti-aliased edge one pixel wide on framebuffers scaled for high DPI displays.
+///
+/// Shapes are still built out of triangles without anti-aliasing and if the vertex
+/// layout has no `NK_VERTEX_SHAPE` attribute. The OpenGL 3 and OpenGL ES 2 demos
+/// contain complete shaders.
+///
 /// #### Reference
 /// Function            | Description
 /// --------------------|-------------------------------------------------------
 /// __nk__begin__       | Returns the first draw command in the context draw command list to be drawn
 /// __nk__next__        | Increments the draw command iterator to the next command inside the context draw command list
 /// __nk_foreach__      | Iterates over each draw command inside the context draw command list
+/// __nk_optimize__     | Removes draw commands without visible effect from the context draw command list
+/// __nk_damage__       | Returns screen rectangles which changed since the last call
+/// __nk_record__       | Appends the draw commands of the current frame to a binary recording
+/// __nk_replay_init__  | Starts reading a binary recording at its first frame
+/// __nk_replay_next__  | Moves a recording reader to the next frame
+/// __nk_replay_load__  | Loads the draw commands of a recorded frame into a context
+/// __nk_replay_foreach__ | Iterates over each draw command of a recorded frame without copying
+/// __nk_delta_encode__ | Encodes the draw commands of the current frame relative to the previous frame
+/// __nk_delta_decode__ | Reconstructs a recorded frame out of an encoded frame and the previous frame
 /// __nk_convert__      | Converts from the abstract draw commands list into a hardware accessible vertex format
+/// __nk_convert_begin__| Splits the draw commands list into tasks to be converted in parallel
+/// __nk_convert_task__ | Converts the draw commands of one task into vertices
+/// __nk_convert_end__  | Joins the vertices of all tasks in draw order
+/// __nk_convert_cached__ | Converts the draw commands list while reusing the vertices of unchanged windows
+/// __nk_convert_instanced__ | Converts the draw commands list into instance records for shapes, glyphs and images
 /// __nk_draw_begin__   | Returns the first vertex command in the context vertex draw list to be executed
 /// __nk__draw_next__   | Increments the vertex command iterator to the next command inside the context vertex command list
 /// __nk__draw_end__    | Returns the end of the vertex draw list
 /// __nk_draw_foreach__ | Iterates over each vertex draw command inside the vertex draw list
 */
 enum nk_anti_aliasing {NK_ANTI_ALIASING_OFF, NK_ANTI_ALIASING_ON};
+enum nk_draw_index_type {NK_DRAW_INDEX_USHORT, NK_DRAW_INDEX_UINT};
+enum nk_draw_clipping {NK_DRAW_CLIP_SCISSOR, NK_DRAW_CLIP_GEOMETRY};
+enum nk_draw_shape_mode {NK_DRAW_SHAPE_TRIANGLES, NK_DRAW_SHAPE_SDF};
 enum nk_convert_result {
     NK_CONVERT_SUCCESS = 0,
     NK_CONVERT_INVALID_PARAM = 1,
     NK_CONVERT_COMMAND_BUFFER_FULL = NK_FLAG(1),
     NK_CONVERT_VERTEX_BUFFER_FULL = NK_FLAG(2),
-    NK_CONVERT_ELEMENT_BUFFER_FULL = NK_FLAG(3)
+    NK_CONVERT_ELEMENT_BUFFER_FULL = NK_FLAG(3),
+    NK_CONVERT_INSTANCE_BUFFER_FULL = NK_FLAG(4)
 };
 struct nk_draw_null_texture {
     nk_handle texture; /* texture handle to a texture with a white pixel */
@@ -1131,6 +1382,10 @@ struct nk_convert_config {
     const struct nk_draw_vertex_layout_element *vertex_layout; /* describes the vertex output format and packing */
     nk_size vertex_size; /* sizeof one vertex for vertex packing */
     nk_size vertex_alignment; /* vertex alignment: Can be obtained by NK_ALIGNOF */
+    enum nk_draw_index_type index_type; /* element index width: 16 bit `nk_draw_index` by default */
+    float segment_tolerance; /* maximum distance in pixels between circles, arcs or curves and their segments. Overrides the fixed segment counts if above zero */
+    enum nk_draw_clipping clipping; /* clip by scissor rectangle per vertex draw command (default) or by clipping geometry on the CPU */
+    enum nk_draw_shape_mode shape_mode; /* build rectangles, circles and lines out of triangles (default) or as one quad each for a signed distance shader */
 };
 /*/// #### nk__begin
 /// Returns a draw command list iterator to iterate all draw
@@ -1177,6 +1432,255 @@ NK_API const struct nk_command* nk__next(struct nk_context*, const struct nk_com
 /// Returns draw command pointer pointing to the next command inside the draw command list
 */
 #define nk_foreach(c, ctx) for((c) = nk__begin(ctx); (c) != 0; (c) = nk__next(ctx,c))
+/*/// #### nk_optimize
+/// Removes draw commands without visible effect from the draw command list of
+/// the current frame. Scissor commands which are never used or do not change the
+/// scissor rectangle, commands without area, fully transparent or outside the
+/// scissor rectangle and commands hidden below a later opaque filled rectangle
+/// are removed. Adjacent filled rectangles with the same color are merged into
+/// one. Removed commands are unlinked from the list and only remain as
+/// `NK_COMMAND_NOP` if they start or end the commands of a window. Has to be
+/// called after building all windows and before `nk_foreach`, `nk_convert` or
+/// `nk_damage`. Opaque rectangles are expected to stay opaque, so do not combine
+/// with a `global_alpha` below 1 in `nk_convert`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API void nk_optimize(struct nk_context *ctx, struct nk_optimize_stats *stats);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __stats__   | Optional struct to be filled with the number of removed commands. Can be NULL
+*/
+struct nk_optimize_stats {
+    unsigned int scissors;
+    /* scissor commands without effect */
+    unsigned int invisible;
+    /* commands without area, fully transparent or outside the scissor rectangle */
+    unsigned int covered;
+    /* commands hidden below a later opaque filled rectangle */
+    unsigned int merged;
+    /* filled rectangles merged into an adjacent filled rectangle */
+    unsigned int commands;
+    /* draw commands left after optimizing */
+};
+NK_API void nk_optimize(struct nk_context*, struct nk_optimize_stats*);
+/*/// #### nk_damage
+/// Compares the draw commands and bounds of each window as well as the
+/// cursor overlay against the last call and returns the screen rectangles
+/// which need to be redrawn. Windows which changed contribute both their
+/// previous and current area and overlapping rectangles are merged. If more
+/// than __max__ rectangles are damaged the remaining ones are merged into the
+/// last rectangle. The first call returns the area of all windows.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API int nk_damage(struct nk_context *ctx, struct nk_rect *rects, int max);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __rects__   | Must point to an array of at least __max__ rectangles to be filled
+/// __max__     | Maximum number of rectangles to return. Needs to be at least one
+///
+/// Returns the number of damaged rectangles or 0 if nothing changed on screen
+*/
+NK_API int nk_damage(struct nk_context*, struct nk_rect *rects, int max);
+/*/// #### nk_record
+/// Appends all draw commands of the current frame in drawing order to a binary
+/// recording. The recording starts with a header holding a version as well as
+/// pointer and command sizes, followed by one block per frame with the bounds of
+/// all windows, a table of used fonts and all draw commands. Text commands
+/// reference fonts by table index and fonts are stored by user data handle and
+/// height to be resolved again on replay. Custom draw commands are skipped since
+/// their callbacks cannot be replayed. The buffer can be written to a file as is.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_record(&ctx, &recording);
+/// fwrite(nk_buffer_memory(&recording), 1, recording.allocated, file);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __out__     | Must point to a previously initialized fixed or dynamic buffer with memory aligned for draw commands
+///
+/// Returns `true(1)` if the frame was recorded or `false(0)` if out of memory
+/// or more than `NK_RECORD_MAX_FONTS` fonts were used
+*/
+NK_API int nk_record(struct nk_context*, struct nk_buffer *out);
+/*/// #### nk_replay_init
+/// Starts reading a binary recording created by `nk_record`. The recording is
+/// never copied and can for example directly point to a memory mapped file,
+/// which has to stay valid while it is read.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API int nk_replay_init(struct nk_replay *replay, const void *memory, nk_size size);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __replay__  | Must point to a `nk_replay` struct to be initialized
+/// __memory__  | Must point to a recording aligned for draw commands
+/// __size__    | Size of the recording in bytes
+///
+/// Returns `true(1)` if the recording is valid and has at least one frame and
+/// `false(0)` if it is empty, damaged or was recorded by an incompatible build
+*/
+struct nk_replay {
+    const void *memory;
+    nk_size size;
+    nk_size offset;
+    /* offset of the current frame inside the recording */
+    unsigned int frame;
+    /* index of the current frame */
+};
+NK_API int nk_replay_init(struct nk_replay*, const void *memory, nk_size size);
+/*/// #### nk_replay_next
+/// Moves a recording reader to the next recorded frame
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API int nk_replay_next(struct nk_replay *replay);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __replay__  | Must point to a by `nk_replay_init` initialized `nk_replay` struct
+///
+/// Returns `true(1)` if there is another frame or `false(0)` at the end of the recording
+*/
+NK_API int nk_replay_next(struct nk_replay*);
+/*/// #### nk_replay_load
+/// Loads the draw commands of the current recorded frame into a context as a
+/// background window called "nk_replay", which can then be drawn by any backend
+/// with `nk_foreach` or `nk_convert`. Has to be called between frames instead of
+/// building windows. Fonts are resolved by the `font` callback and image handles
+/// are replaced by the `image` callback. Without callbacks the context font is
+/// used and image handles are kept as recorded.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// struct nk_replay replay;
+/// if (nk_replay_init(&replay, memory, size)) {
+///     do {
+///         nk_replay_load(&ctx, &replay, &config);
+///         // [...] draw `ctx`
+///         nk_clear(&ctx);
+///     } while (nk_replay_next(&replay));
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct
+/// __replay__  | Must point to a by `nk_replay_init` initialized `nk_replay` struct
+/// __config__  | Optional callbacks to resolve recorded fonts and images. Can be NULL
+///
+/// Returns `true(1)` if the frame was loaded or `false(0)` otherwise
+*/
+struct nk_replay_config {
+    nk_handle userdata;
+    const struct nk_user_font*(*font)(nk_handle userdata, nk_handle font, float height);
+    nk_handle (*image)(nk_handle userdata, nk_handle image);
+};
+NK_API int nk_replay_load(struct nk_context*, const struct nk_replay*, const struct nk_replay_config*);
+/*/// #### nk_replay_foreach
+/// Iterates over each draw command of the current recorded frame directly
+/// inside the recording memory. Text command fonts hold the font table index
+/// instead of a font pointer, so use `nk_replay_load` to actually draw a frame.
+/// With `NK_ZERO_COPY_TEXT` the text command string pointer is NULL while the
+/// string itself follows directly behind the command.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// #define nk_replay_foreach(c, replay)
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __c__       | Command pointer initialized to NULL
+/// __replay__  | Must point to a by `nk_replay_init` initialized `nk_replay` struct
+*/
+NK_API const struct nk_command* nk__replay_begin(const struct nk_replay*);
+NK_API const struct nk_command* nk__replay_next(const struct nk_replay*, const struct nk_command*);
+#define nk_replay_foreach(c, replay) for((c) = nk__replay_begin(replay); (c) != 0; (c) = nk__replay_next(replay,c))
+/*/// #### nk_delta_encode
+/// Appends the draw commands of the current frame to `out` as one message,
+/// which only holds commands of windows, popups and the cursor overlay that
+/// changed since the previous encoded frame. Unchanged ones are sent as a
+/// reference into the previous frame, so for mostly static user interfaces a
+/// message only has a few hundred bytes. Messages have to be decoded in
+/// order by `nk_delta_decode` on the other side. Initializing the encoder with
+/// `nk_delta_encoder_init` again forces the next message to be a key frame
+/// without any references, for example if a client (re)connects or lost a message.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// struct nk_delta_encoder encoder;
+/// nk_delta_encoder_init(&encoder);
+/// // [...] each frame
+/// nk_buffer_clear(&message);
+/// nk_delta_encode(&encoder, &ctx, &message);
+/// send(socket, nk_buffer_memory(&message), message.allocated, 0);
+/// nk_clear(&ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __encoder__ | Must point to a by `nk_delta_encoder_init` initialized `nk_delta_encoder` struct
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __out__     | Must point to a previously initialized fixed or dynamic buffer with memory aligned for draw commands
+///
+/// Returns `true(1)` if the frame was encoded or `false(0)` if out of memory
+/// or more than `NK_RECORD_MAX_FONTS` fonts were used
+*/
+struct nk_delta_window {
+    nk_hash id;
+    nk_hash hash;
+    nk_size offset;
+    /* offset of the commands inside the decoded frame */
+    nk_uint size;
+    nk_uint commands;
+};
+struct nk_delta_encoder {
+    struct nk_delta_window windows[NK_DELTA_MAX_WINDOWS];
+    const struct nk_user_font *fonts[NK_RECORD_MAX_FONTS];
+    nk_uint window_count;
+    nk_uint font_count;
+    nk_uint sequence;
+};
+NK_API void nk_delta_encoder_init(struct nk_delta_encoder*);
+NK_API int nk_delta_encode(struct nk_delta_encoder*, struct nk_context*, struct nk_buffer *out);
+/*/// #### nk_delta_decode
+/// Decodes a message created by `nk_delta_encode` into a recording of a single
+/// frame owned by the decoder and starts `replay` on it. The frame can then be
+/// drawn with `nk_replay_load` or read with `nk_replay_foreach` like any other
+/// recording and stays valid until the next message is decoded. Messages
+/// referencing a frame the decoder has not seen are rejected until the next key frame.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// struct nk_delta_decoder decoder;
+/// nk_delta_decoder_init_default(&decoder);
+/// // [...] for each received message
+/// if (nk_delta_decode(&decoder, &replay, memory, size))
+///     nk_replay_load(&ctx, &replay, &config);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __decoder__ | Must point to a by `nk_delta_decoder_init_xxx` initialized `nk_delta_decoder` struct
+/// __replay__  | Must point to a `nk_replay` struct to be initialized with the decoded frame
+/// __memory__  | Must point to one complete message aligned for draw commands
+/// __size__    | Size of the message in bytes
+///
+/// Returns `true(1)` if the message was decoded and `false(0)` if it is damaged,
+/// out of order, was encoded by an incompatible build or out of memory
+*/
+struct nk_delta_decoder;
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_delta_decoder_init_default(struct nk_delta_decoder*);
+#endif
+NK_API void nk_delta_decoder_init(struct nk_delta_decoder*, const struct nk_allocator*);
+NK_API void nk_delta_decoder_free(struct nk_delta_decoder*);
+NK_API int nk_delta_decode(struct nk_delta_decoder*, struct nk_replay*, const void *memory, nk_size size);
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
 /*/// #### nk_convert
 /// Converts all internal draw commands into vertex draw commands and fills
@@ -1206,8 +1710,171 @@ NK_API const struct nk_command* nk__next(struct nk_context*, const struct nk_com
 /// NK_CONVERT_COMMAND_BUFFER_FULL  | The provided buffer for storing draw commands is full or failed to allocate more memory
 /// NK_CONVERT_VERTEX_BUFFER_FULL   | The provided buffer for storing vertices is full or failed to allocate more memory
 /// NK_CONVERT_ELEMENT_BUFFER_FULL  | The provided buffer for storing indicies is full or failed to allocate more memory
+///
+/// With 16 bit indices a single shape needing more than 65536 vertices is not drawn.
 */
 NK_API nk_flags nk_convert(struct nk_context*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/*/// #### nk_convert_begin
+/// Splits the draw commands of the current frame into ranges of about the same
+/// amount of tessellation work to be converted in parallel. Each range is converted
+/// by calling `nk_convert_task` with its task on any thread. Tasks only read the
+/// context, so they can run at the same time, but font queries and custom draw
+/// callbacks are then called from several threads and need to be thread safe.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// struct nk_convert_task tasks[THREADS];
+/// for (i = 0; i < THREADS; ++i)
+///     nk_convert_task_init_default(&tasks[i]);
+/// // [...] each frame
+/// n = nk_convert_begin(&ctx, tasks, THREADS, &cfg);
+/// // [...] call `nk_convert_task(&ctx, &tasks[i])` on thread `i` for all `i < n`
+/// nk_convert_end(&ctx, &cmds, &verts, &idx, tasks, n);
+/// nk_draw_foreach(cmd, &ctx, &cmds) {
+///     //[...]
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __tasks__   | Must point to an array of by `nk_convert_task_init_xxx` initialized `nk_convert_task` structs
+/// __count__   | Number of tasks in the array
+/// __config__  | Must point to a filled out `nk_config` struct to configure the conversion process
+///
+/// Returns the number of tasks used for the frame, which can be less than `count`
+/// for frames with only a few draw commands
+*/
+struct nk_convert_task;
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_convert_task_init_default(struct nk_convert_task*);
+#endif
+NK_API void nk_convert_task_init(struct nk_convert_task*, const struct nk_allocator*);
+NK_API void nk_convert_task_free(struct nk_convert_task*);
+NK_API int nk_convert_begin(struct nk_context*, struct nk_convert_task *tasks, int count, const struct nk_convert_config*);
+/*/// #### nk_convert_task
+/// Converts the range of draw commands assigned to a task by `nk_convert_begin`
+/// into vertices and vertex draw commands owned by the task
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API nk_flags nk_convert_task(const struct nk_context *ctx, struct nk_convert_task *task);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to the context passed to `nk_convert_begin`
+/// __task__    | Must point to one of the tasks prepared by `nk_convert_begin`
+///
+/// Returns one of enum nk_convert_result error codes
+*/
+NK_API nk_flags nk_convert_task(const struct nk_context*, struct nk_convert_task*);
+/*/// #### nk_convert_end
+/// Joins the output of all tasks into the vertex, element and vertex draw command
+/// buffers in draw order. Element indices are moved to the position of the task
+/// vertices inside the vertex buffer, so the result can be drawn exactly like the
+/// output of `nk_convert`. Empty vertex draw commands are dropped and adjacent ones
+/// with the same state merged, so the number of draw commands can be smaller than
+/// with `nk_convert`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// NK_API nk_flags nk_convert_end(struct nk_context *ctx, struct nk_buffer *cmds,
+//      struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_task *tasks, int count);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to the context passed to `nk_convert_begin`
+/// __cmds__    | Must point to a previously initialized buffer to hold converted vertex draw commands
+/// __vertices__| Must point to a previously initialized buffer to hold all produced vertices
+/// __elements__| Must point to a previously initialized buffer to hold all produced vertex indices
+/// __tasks__   | Must point to the tasks passed to `nk_convert_begin` after all of them finished
+/// __count__   | Number of tasks returned by `nk_convert_begin`
+///
+/// Returns one of enum nk_convert_result error codes including errors of all tasks
+*/
+NK_API nk_flags nk_convert_end(struct nk_context*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_task *tasks, int count);
+/*/// #### nk_convert_cached
+/// Converts the draw commands of the current frame like `nk_convert` but keeps the
+/// vertices of each window, popup and the overlay in `cache`. Windows with the same
+/// draw commands as in the last call copy their stored vertices instead of being
+/// converted again. Like with `nk_convert_end` adjacent vertex draw commands with
+/// the same state are merged. The cache is dropped whenever the configuration
+/// changes but not if fonts or textures change, so call `nk_convert_cache_clear`
+/// after updating any of them. Windows with `NK_COMMAND_CUSTOM` commands are
+/// converted every call since their callbacks can draw something different for
+/// the same command. The cache only keeps the converted vertex draw commands,
+/// vertices and elements of each window while all other windows are converted
+/// one after another in a single scratch draw list.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// struct nk_convert_cache cache;
+/// nk_convert_cache_init_default(&cache);
+/// // [...] each frame
+/// nk_convert_cached(&ctx, &cache, &cmds, &verts, &idx, &cfg);
+/// nk_draw_foreach(cmd, &ctx, &cmds) {
+///     //[...]
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __cache__   | Must point to a by `nk_convert_cache_init_xxx` initialized `nk_convert_cache` struct
+/// __cmds__    | Must point to a previously initialized buffer to hold converted vertex draw commands
+/// __vertices__| Must point to a previously initialized buffer to hold all produced vertices
+/// __elements__| Must point to a previously initialized buffer to hold all produced vertex indices
+/// __config__  | Must point to a filled out `nk_config` struct to configure the conversion process
+///
+/// Returns one of enum nk_convert_result error codes
+*/
+struct nk_convert_cache;
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_convert_cache_init_default(struct nk_convert_cache*);
+#endif
+NK_API void nk_convert_cache_init(struct nk_convert_cache*, const struct nk_allocator*);
+NK_API void nk_convert_cache_clear(struct nk_convert_cache*);
+NK_API void nk_convert_cache_free(struct nk_convert_cache*);
+NK_API nk_flags nk_convert_cached(struct nk_context*, struct nk_convert_cache*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, const struct nk_convert_config*);
+/*/// #### nk_convert_instanced
+/// Converts the draw commands of the current frame like `nk_convert` but writes
+/// rectangles, circles, lines, glyphs and images as one `nk_draw_instance` record
+/// each instead of triangles. Vertex draw commands with a non zero `instance_count`
+/// draw `instance_count` records starting at `instance_offset` with one instanced
+/// draw call, using their `clip_rect` as scissor rectangle and their `texture` for
+/// glyphs and images. All other commands like triangles, polygons, arcs, curves
+/// and custom callbacks are still converted into vertices and indices with
+/// `elem_count` set as usual. Draw commands have either instances or elements and
+/// have to be drawn in order.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_convert_instanced(&ctx, &cmds, &verts, &idx, &instances, &cfg);
+/// nk_draw_foreach(cmd, &ctx, &cmds) {
+///     if (cmd->instance_count) {
+///         // draw a unit quad `cmd->instance_count` times starting with
+///         // record `cmd->instance_offset` of `instances`
+///     } else if (cmd->elem_count) {
+///         // draw `cmd->elem_count` indices like after `nk_convert`
+///     }
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// The vertex shader places the quad at `rect`, which holds position and size of
+/// rectangles, circles, glyphs and images and both end points of lines. Rounding
+/// and thickness of shapes and the texture region of glyphs and images are stored
+/// in `params`. The fragment shader evaluates the shape with its anti-aliasing.
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to an previously initialized `nk_context` struct at the end of a frame
+/// __cmds__    | Must point to a previously initialized buffer to hold converted vertex draw commands
+/// __vertices__| Must point to a previously initialized buffer to hold all produced vertices
+/// __elements__| Must point to a previously initialized buffer to hold all produced vertex indices
+/// __instances__| Must point to a previously initialized buffer to hold all produced `nk_draw_instance` records
+/// __config__  | Must point to a filled out `nk_config` struct to configure the conversion process
+///
+/// Returns one of enum nk_convert_result error codes. `NK_CONVERT_INSTANCE_BUFFER_FULL`
+/// signals that the buffer for instances is full or failed to allocate more memory.
+*/
+NK_API nk_flags nk_convert_instanced(struct nk_context*, struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements, struct nk_buffer *instances, const struct nk_convert_config*);
 /*/// #### nk__draw_begin
 /// Returns a draw vertex command buffer iterator to iterate each the vertex draw command buffer
 ///
@@ -1390,6 +2057,10 @@ NK_API const struct nk_draw_command* nk__draw_next(const struct nk_draw_command*
 /// nk_window_collapse_if               | Collapses the window with given window name if the given condition was met
 /// nk_window_show                      | Hides a visible or reshows a hidden window
 /// nk_window_show_if                   | Hides/shows a window depending on condition
+//
+/// nk_window_is_dirty                  | Returns if the window with given name needs to be rebuilt this frame
+/// nk_window_invalidate                | Forces the window with given name to be rebuilt next frame
+/// nk_window_reuse                     | Reuses the draw commands of the last frame for an unchanged window instead of rebuilding it
 */
 /*
 /// #### enum nk_panel_flags
@@ -1406,6 +2077,7 @@ NK_API const struct nk_draw_command* nk__draw_next(const struct nk_draw_command*
 /// NK_WINDOW_BACKGROUND        | Always keep window in the background
 /// NK_WINDOW_SCALE_LEFT        | Puts window scaler in the left-ottom corner instead right-bottom
 /// NK_WINDOW_NO_INPUT          | Prevents window of scaling, moving or getting focus
+/// NK_WINDOW_RETAINED          | Keeps a copy of the window draw commands which can be reused by `nk_window_reuse` while the window does not change
 */
 enum nk_panel_flags {
     NK_WINDOW_BORDER            = NK_FLAG(0),
@@ -1418,7 +2090,8 @@ enum nk_panel_flags {
     NK_WINDOW_SCROLL_AUTO_HIDE  = NK_FLAG(7),
     NK_WINDOW_BACKGROUND        = NK_FLAG(8),
     NK_WINDOW_SCALE_LEFT        = NK_FLAG(9),
-    NK_WINDOW_NO_INPUT          = NK_FLAG(10)
+    NK_WINDOW_NO_INPUT          = NK_FLAG(10),
+    NK_WINDOW_RETAINED          = NK_FLAG(11)
 };
 /*  nk_begin - starts a new window; needs to be called every frame for every window (unless hidden) or otherwise the window gets removed
  *  Parameters:
@@ -1640,6 +2313,40 @@ NK_API void nk_window_show(struct nk_context*, const char *name, enum nk_show_st
  *      @state with either visible or hidden to modify the window with
  *      @condition that has to be true to actually commit the visible state change */
 NK_API void nk_window_show_if(struct nk_context*, const char *name, enum nk_show_states, int cond);
+/*  nk_window_is_dirty - checks if a window with flag `NK_WINDOW_RETAINED` has to be rebuilt
+ *  because it has no stored draw commands, was invalidated, changed its bounds,
+ *  flags or focus, is hovered or receives keyboard input.
+ *  Parameters:
+ *      @ctx must point to an previously initialized `nk_context` struct
+ *      @name of the window to check
+ *  Return values:
+ *      returns `true(1)` if the window has to be rebuilt or `false(0)` otherwise */
+NK_API int nk_window_is_dirty(struct nk_context*, const char *name);
+/*  nk_window_invalidate - drops the stored draw commands of a window. Needs to be
+ *  called if the content of a `NK_WINDOW_RETAINED` window changed without user
+ *  input, for example after updating values or changing the style.
+ *  Parameters:
+ *      @ctx must point to an previously initialized `nk_context` struct
+ *      @name of the window to invalidate */
+NK_API void nk_window_invalidate(struct nk_context*, const char *name);
+/*  nk_window_reuse - copies the draw commands of the last frame into the current frame
+ *  for a `NK_WINDOW_RETAINED` window which is not dirty. Replaces the `nk_begin`/`nk_end`
+ *  pair for this frame and keeps the window alive and in its current drawing order.
+ *  Only windows of contexts initialized with an allocator store their draw commands.
+ *
+ *      if (!nk_window_reuse(ctx, "Legend")) {
+ *          if (nk_begin(ctx, "Legend", bounds, NK_WINDOW_RETAINED|...)) {
+ *              [... widgets ...]
+ *          }
+ *          nk_end(ctx);
+ *      }
+ *
+ *  Parameters:
+ *      @ctx must point to an previously initialized `nk_context` struct
+ *      @name of the window to reuse
+ *  Return values:
+ *      returns `true(1)` if the window was reused or `false(0)` if it has to be built */
+NK_API int nk_window_reuse(struct nk_context*, const char *name);
 /* =============================================================================
  *
  *                                  LAYOUT
@@ -2929,6 +3636,13 @@ struct nk_font_glyph {
     float u0, v0, u1, v1;
 };
 
+struct nk_font_glyph_range {
+    nk_rune first, last;
+    /* codepoints covered by this range */
+    nk_rune glyph;
+    /* index of the glyph of `first` inside the font glyph array */
+};
+
 struct nk_font {
     struct nk_font *next;
     struct nk_user_font handle;
@@ -2939,6 +3653,11 @@ struct nk_font {
     nk_rune fallback_codepoint;
     nk_handle texture;
     struct nk_font_config *config;
+    const struct nk_font_glyph *latin[256];
+    /* glyphs of the first 256 codepoints or the fallback glyph */
+    struct nk_font_glyph_range *ranges;
+    int range_count;
+    /* sorted non overlapping codepoint ranges above `latin` or null */
 };
 
 enum nk_font_atlas_format {
@@ -3028,6 +3747,13 @@ NK_API void nk_font_atlas_clear(struct nk_font_atlas*);
     NK_INCLUDE_DEFAULT_ALLOCATOR which uses the standard library memory
     allocation functions malloc and free and takes over complete control over
     memory in this library.
+
+    For draw command memory passed to `nk_init_custom` there is also a chunked
+    allocator based buffer. Instead of reallocating and copying all memory once
+    full it allocates another chunk and continues there, so growing never
+    copies already allocated memory. Chunked buffers only support front
+    allocations and their memory is not contiguous, so `nk_buffer_memory`
+    cannot be used to access them.
 */
 struct nk_memory_status {
     void *memory;
@@ -3036,11 +3762,13 @@ struct nk_memory_status {
     nk_size allocated;
     nk_size needed;
     nk_size calls;
+    nk_size grows;
 };
 
 enum nk_allocation_type {
     NK_BUFFER_FIXED,
-    NK_BUFFER_DYNAMIC
+    NK_BUFFER_DYNAMIC,
+    NK_BUFFER_CHUNKED
 };
 
 enum nk_buffer_allocation_type {
@@ -3074,6 +3802,10 @@ struct nk_buffer {
     /* number of allocation calls */
     nk_size size;
     /* current size of the buffer */
+    nk_size grows;
+    /* number of times dynamic memory had to be reallocated */
+    nk_size chunk_size;
+    /* size of each memory chunk of a chunked buffer */
 };
 
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
@@ -3081,6 +3813,7 @@ NK_API void nk_buffer_init_default(struct nk_buffer*);
 #endif
 NK_API void nk_buffer_init(struct nk_buffer*, const struct nk_allocator*, nk_size size);
 NK_API void nk_buffer_init_fixed(struct nk_buffer*, void *memory, nk_size size);
+NK_API void nk_buffer_init_chunked(struct nk_buffer*, const struct nk_allocator*, nk_size chunk_size);
 NK_API void nk_buffer_info(struct nk_memory_status*, struct nk_buffer*);
 NK_API void nk_buffer_push(struct nk_buffer*, enum nk_buffer_allocation_type type, const void *memory, nk_size size, nk_size align);
 NK_API void nk_buffer_mark(struct nk_buffer*, enum nk_buffer_allocation_type type);
@@ -3491,7 +4224,12 @@ struct nk_command_text {
     unsigned short w, h;
     float height;
     int length;
+#ifdef NK_ZERO_COPY_TEXT
+    const char *string;
+    /* caller owned text or a copy stored directly behind the command */
+#else
     char string[1];
+#endif
 };
 
 enum nk_command_clipping {
@@ -3505,11 +4243,64 @@ struct nk_command_buffer {
     int use_clipping;
     nk_handle userdata;
     nk_size begin, end, last;
+#ifdef NK_ZERO_COPY_TEXT
+    int copy_text;
+    /* copies text into draw commands while above zero */
+#endif
 };
 
-/* shape outlines */
-NK_API void nk_stroke_line(struct nk_command_buffer *b, float x0, float y0, float x1, float y1, float line_thickness, struct nk_color);
-NK_API void nk_stroke_curve(struct nk_command_buffer*, float, float, float, float, float, float, float, float, float line_thickness, struct nk_color);
+/* draw command statistics filled by `nk_context_info` and `nk_window_command_info` */
+#define NK_COMMAND_TYPE_COUNT (NK_COMMAND_CUSTOM+1)
+struct nk_command_stats {
+    nk_size bytes;
+    /* total size of all draw commands including alignment */
+    unsigned int count;
+    /* total number of draw commands */
+    nk_size type_bytes[NK_COMMAND_TYPE_COUNT];
+    /* size of draw commands for each `enum nk_command_type` */
+    unsigned int type_count[NK_COMMAND_TYPE_COUNT];
+    /* number of draw commands for each `enum nk_command_type` */
+};
+
+struct nk_context_stats {
+    struct nk_command_stats commands;
+    /* draw commands of all windows and the overlay of the current frame */
+    nk_size command_bytes_peak;
+    unsigned int command_count_peak;
+    /* largest command size and count seen by `nk_context_info` */
+    unsigned int windows;
+    /* number of windows drawn in the current frame */
+    unsigned int windows_occluded;
+    /* number of windows skipped by `NK_OCCLUSION_CULLING` in the current frame */
+    unsigned int tables;
+    unsigned int tables_peak;
+    /* number of state table pages in use */
+    struct nk_page_status pages;
+    /* page elements used for windows, panels and tables */
+    struct nk_memory_status memory;
+    /* draw command memory of the current frame */
+    nk_size memory_peak;
+    nk_size memory_needed_peak;
+    /* largest amount of draw command memory used and needed in one frame */
+    unsigned int vertices;
+    unsigned int elements;
+    unsigned int draw_commands;
+    /* vertex output of the last `nk_convert` call */
+    unsigned int vertices_peak;
+    unsigned int elements_peak;
+    unsigned int draw_commands_peak;
+    /* largest vertex output of all `nk_convert` calls */
+    nk_size convert_grows;
+    /* number of times vertex, element or draw command buffers had to grow inside `nk_convert` */
+    unsigned int vertices_reused;
+    /* vertices of unchanged windows copied by the last `nk_convert_cached` call */
+    unsigned int instances;
+    /* instance records written by the last `nk_convert_instanced` call */
+};
+
+/* shape outlines */
+NK_API void nk_stroke_line(struct nk_command_buffer *b, float x0, float y0, float x1, float y1, float line_thickness, struct nk_color);
+NK_API void nk_stroke_curve(struct nk_command_buffer*, float, float, float, float, float, float, float, float, float line_thickness, struct nk_color);
 NK_API void nk_stroke_rect(struct nk_command_buffer*, struct nk_rect, float rounding, float line_thickness, struct nk_color);
 NK_API void nk_stroke_circle(struct nk_command_buffer*, struct nk_rect, float line_thickness, struct nk_color);
 NK_API void nk_stroke_arc(struct nk_command_buffer*, float cx, float cy, float radius, float a_min, float a_max, float line_thickness, struct nk_color);
@@ -3614,6 +4405,8 @@ enum nk_draw_vertex_layout_attribute {
     NK_VERTEX_POSITION,
     NK_VERTEX_COLOR,
     NK_VERTEX_TEXCOORD,
+    NK_VERTEX_SHAPE,
+    /* half size, corner radius and stroke thickness of `NK_DRAW_SHAPE_SDF` quads */
     NK_VERTEX_ATTRIBUTE_COUNT
 };
 
@@ -3655,18 +4448,64 @@ struct nk_draw_vertex_layout_element {
 struct nk_draw_command {
     unsigned int elem_count;
     /* number of elements in the current draw batch */
+    unsigned int vertex_offset;
+    /* base vertex added to every element index of the current draw batch */
     struct nk_rect clip_rect;
     /* current screen clipping rectangle */
     nk_handle texture;
     /* current texture to set */
+    unsigned int instance_offset;
+    /* first `nk_draw_instance` of an instanced draw batch */
+    unsigned int instance_count;
+    /* number of instances to draw instead of elements, zero for triangle lists */
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     nk_handle userdata;
 #endif
 };
 
+enum nk_draw_instance_type {
+    NK_DRAW_INSTANCE_RECT,
+    /* rounded rectangle, filled if its thickness is zero */
+    NK_DRAW_INSTANCE_CIRCLE,
+    /* circle fitted into `rect`, filled if its thickness is zero */
+    NK_DRAW_INSTANCE_LINE,
+    /* line from `rect[0..1]` to `rect[2..3]` */
+    NK_DRAW_INSTANCE_GLYPH,
+    /* quad with the texture alpha of the font atlas */
+    NK_DRAW_INSTANCE_IMAGE
+    /* quad with the texture color */
+};
+
+struct nk_draw_instance {
+    float rect[4];
+    /* x, y, width and height or begin and end point for lines */
+    float params[4];
+    /* rounding and thickness of shapes or texture region (u0, v0, u1, v1) */
+    nk_byte color[4];
+    /* R8G8B8A8 color with `global_alpha` applied to shapes and glyphs */
+    nk_uint type;
+    /* `enum nk_draw_instance_type` */
+};
+
+struct nk_draw_shape {
+    unsigned int count;
+    /* number of points of the shape, zero if unused */
+    struct nk_vec2 points[NK_DRAW_SHAPE_MAX_POINTS];
+    /* outline of the shape with unit radius */
+    struct nk_vec2 normals[NK_DRAW_SHAPE_MAX_POINTS];
+    /* averaged and miter scaled normal of each point */
+};
+
 struct nk_draw_list {
     struct nk_rect clip_rect;
     struct nk_vec2 circle_vtx[12];
+    struct nk_vec2 rect_normals[4];
+    /* point normals of rectangles without rounding */
+    struct nk_vec2 rounded_rect_normals[16];
+    /* point normals of rounded rectangles with straight edges */
+    struct nk_draw_shape circles[4];
+    /* cached circle outlines by segment count */
+    unsigned int circle_next;
     struct nk_convert_config config;
 
     struct nk_buffer *buffer;
@@ -3677,6 +4516,7 @@ struct nk_draw_list {
     unsigned int vertex_count;
     unsigned int cmd_count;
     nk_size cmd_offset;
+    unsigned int cmd_vertex_offset;
 
     unsigned int path_count;
     unsigned int path_offset;
@@ -3684,6 +4524,19 @@ struct nk_draw_list {
     enum nk_anti_aliasing line_AA;
     enum nk_anti_aliasing shape_AA;
 
+    int vertex_writer;
+    /* vertex writer specialized for the configured vertex layout */
+    nk_size vertex_offset[NK_VERTEX_ATTRIBUTE_COUNT];
+    /* position, texture coordinate, color and shape offsets for specialized writers */
+    int vertex_shape;
+    /* vertex layout contains a `NK_VERTEX_SHAPE` attribute */
+
+    struct nk_buffer *instances;
+    /* `nk_draw_instance` output of `nk_convert_instanced` or zero */
+    unsigned int instance_count;
+    int instance_textured;
+    /* last vertex draw command holds glyph or image instances */
+
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     nk_handle userdata;
 #endif
@@ -3732,6 +4585,50 @@ NK_API void nk_draw_list_add_text(struct nk_draw_list*, const struct nk_user_fon
 NK_API void nk_draw_list_push_userdata(struct nk_draw_list*, nk_handle userdata);
 #endif
 
+/* parallel conversion */
+struct nk_convert_task {
+    struct nk_draw_list list;
+    struct nk_buffer cmds;
+    struct nk_buffer vertices;
+    struct nk_buffer elements;
+    const struct nk_command *begin;
+    /* first draw command to convert */
+    nk_size count;
+    /* number of draw commands to convert */
+    struct nk_rect clip;
+    /* scissor rectangle active before the first draw command */
+};
+
+struct nk_convert_window {
+    nk_hash id;
+    nk_hash hash;
+    /* hash of the converted draw commands */
+    nk_size size;
+    /* memory range of the converted draw commands */
+    nk_size count;
+    /* number of converted draw commands */
+    struct nk_rect clip;
+    /* scissor rectangle active before the first draw command */
+    void *memory;
+    nk_size capacity;
+    /* vertex draw commands, elements and vertices of the converted window */
+    unsigned int command_count;
+    unsigned int element_count;
+    unsigned int vertex_count;
+    unsigned int seq;
+    /* last `nk_convert_cached` call using the window */
+    int valid;
+};
+
+struct nk_convert_cache {
+    struct nk_convert_window windows[NK_CONVERT_CACHE_WINDOWS];
+    struct nk_convert_task task;
+    /* converts every window which could not be reused */
+    struct nk_allocator alloc;
+    struct nk_convert_config config;
+    unsigned int seq;
+};
+
 #endif
 
 /* ===============================================================
@@ -4209,6 +5106,9 @@ struct nk_chart_slot {
     int count;
     struct nk_vec2 last;
     int index;
+    nk_size line;
+    int line_capacity;
+    /* polyline command drawing the trace of a line chart */
 };
 
 struct nk_chart {
@@ -4286,21 +5186,25 @@ struct nk_panel {
 
 struct nk_table;
 enum nk_window_flags {
-    NK_WINDOW_PRIVATE       = NK_FLAG(11),
+    NK_WINDOW_PRIVATE       = NK_FLAG(12),
     NK_WINDOW_DYNAMIC       = NK_WINDOW_PRIVATE,
     /* special window type growing up in height while being filled to a certain maximum height */
-    NK_WINDOW_ROM           = NK_FLAG(12),
+    NK_WINDOW_ROM           = NK_FLAG(13),
     /* sets window widgets into a read only mode and does not allow input changes */
     NK_WINDOW_NOT_INTERACTIVE = NK_WINDOW_ROM|NK_WINDOW_NO_INPUT,
     /* prevents all interaction caused by input to either window or widgets inside */
-    NK_WINDOW_HIDDEN        = NK_FLAG(13),
+    NK_WINDOW_HIDDEN        = NK_FLAG(14),
     /* Hides window and stops any window interaction and drawing */
-    NK_WINDOW_CLOSED        = NK_FLAG(14),
+    NK_WINDOW_CLOSED        = NK_FLAG(15),
     /* Directly closes and frees the window at the end of the frame */
-    NK_WINDOW_MINIMIZED     = NK_FLAG(15),
+    NK_WINDOW_MINIMIZED     = NK_FLAG(16),
     /* marks the window as minimized */
-    NK_WINDOW_REMOVE_ROM    = NK_FLAG(16)
+    NK_WINDOW_REMOVE_ROM    = NK_FLAG(17),
     /* Removes read only mode at the end of the window */
+    NK_WINDOW_MERGED        = NK_FLAG(18),
+    /* draw commands are copied from a window of a worker context */
+    NK_WINDOW_OCCLUDED      = NK_FLAG(19)
+    /* completely hidden behind opaque windows and skipped while drawing */
 };
 
 struct nk_popup_state {
@@ -4341,6 +5245,16 @@ struct nk_property_state {
     int state;
 };
 
+struct nk_window_cache {
+    void *memory;
+    nk_size size, last, capacity;
+    struct nk_rect bounds;
+    nk_flags flags;
+    const struct nk_user_font *font;
+    int active;
+    int valid;
+};
+
 struct nk_window {
     unsigned int seq;
     nk_hash name;
@@ -4348,6 +5262,8 @@ struct nk_window {
     nk_flags flags;
 
     struct nk_rect bounds;
+    struct nk_rect opaque;
+    /* area completely covered by opaque header and background */
     struct nk_scroll scrollbar;
     struct nk_command_buffer buffer;
     struct nk_panel *layout;
@@ -4360,8 +5276,17 @@ struct nk_window {
     unsigned int scrolled;
 
     struct nk_table *tables;
+    struct nk_table *table_last;
+    struct nk_table *table_root;
     unsigned int table_count;
 
+    /* draw commands hash and screen area at the last `nk_damage` call */
+    nk_hash damage_hash;
+    struct nk_rect damage_area;
+
+    /* draw commands of the last frame for `NK_WINDOW_RETAINED` windows */
+    struct nk_window_cache cache;
+
     /* window list hooks */
     struct nk_window *next;
     struct nk_window *prev;
@@ -4459,18 +5384,47 @@ struct nk_configuration_stacks {
     struct nk_config_stack_button_behavior button_behaviors;
 };
 
+/*==============================================================
+ *                          DELTA
+ * =============================================================*/
+struct nk_delta_decoder {
+    struct nk_buffer frames[2];
+    /* previous and current decoded frame */
+    struct nk_delta_window windows[2][NK_DELTA_MAX_WINDOWS];
+    nk_uint window_count[2];
+    nk_uint sequence;
+    int current;
+    int valid;
+    /* previous frame can be referenced */
+};
+
 /*==============================================================
  *                          CONTEXT
  * =============================================================*/
+#define NK_VALUE_PAGE_FANOUT 16
 #define NK_VALUE_PAGE_CAPACITY \
-    (((NK_MAX(sizeof(struct nk_window),sizeof(struct nk_panel)) / sizeof(nk_uint))) / 2)
-
+    (((NK_MAX(sizeof(struct nk_window),sizeof(struct nk_panel)) - \
+    NK_VALUE_PAGE_FANOUT * sizeof(void*)) / sizeof(nk_uint)) / 2)
+#ifndef NK_WINDOW_INDEX_SIZE
+#define NK_WINDOW_INDEX_SIZE 1024
+#endif
+NK_STATIC_ASSERT(!(NK_WINDOW_INDEX_SIZE & (NK_WINDOW_INDEX_SIZE-1)));
+
+/* Window state tables are organized as a hash trie. Each table page holds
+ * up to NK_VALUE_PAGE_CAPACITY values and once full new keys are stored
+ * in the child page selected by the next four bits of the key hash.
+ * Lookup therefore only visits the pages along the path of one key.
+ * Tables used in the current frame are moved to the front of the window
+ * table list together with all their parents so unused tables collect at
+ * the back with children always behind their parent. */
 struct nk_table {
     unsigned int seq;
     unsigned int size;
     nk_hash keys[NK_VALUE_PAGE_CAPACITY];
     nk_uint values[NK_VALUE_PAGE_CAPACITY];
     struct nk_table *next, *prev;
+    struct nk_table *parent;
+    struct nk_table *children[NK_VALUE_PAGE_FANOUT];
 };
 
 union nk_page_data {
@@ -4479,14 +5433,17 @@ union nk_page_data {
     struct nk_window win;
 };
 
+struct nk_page;
 struct nk_page_element {
     union nk_page_data data;
     struct nk_page_element *next;
     struct nk_page_element *prev;
+    struct nk_page *page;
 };
 
 struct nk_page {
     unsigned int size;
+    unsigned int live;
     struct nk_page *next;
     struct nk_page_element win[1];
 };
@@ -4529,6 +5486,12 @@ struct nk_context {
     struct nk_text_edit text_edit;
     /* draw buffer used for overlay drawing operation like cursor */
     struct nk_command_buffer overlay;
+    nk_hash overlay_damage_hash;
+    struct nk_rect overlay_damage_area;
+    /* combined screen area of windows freed since the last `nk_damage` call */
+    struct nk_rect damage_freed;
+    /* peak values and `nk_convert` output for `nk_context_info` */
+    struct nk_context_stats stats;
 
     /* windows */
     int build;
@@ -4539,8 +5502,18 @@ struct nk_context {
     struct nk_window *active;
     struct nk_window *current;
     struct nk_page_element *freelist;
+    unsigned int freelist_count;
+    unsigned int element_count;
+    unsigned int element_peak;
     unsigned int count;
     unsigned int seq;
+
+    /* open addressing hash index over all windows inside the window list
+     * keyed by window name hash. Windows which did not fit into the
+     * index are counted in `window_index_missed` and found by a list scan */
+    struct nk_window *window_index[NK_WINDOW_INDEX_SIZE];
+    unsigned int window_index_count;
+    unsigned int window_index_missed;
 };
 
 /* ==============================================================
@@ -4906,6 +5879,23 @@ nk_pad_rect(struct nk_rect r, struct nk_vec2 pad)
     return r;
 }
 
+NK_INTERN struct nk_rect
+nk_rect_union(struct nk_rect a, struct nk_rect b)
+{
+    struct nk_rect res;
+    res.x = NK_MIN(a.x, b.x);
+    res.y = NK_MIN(a.y, b.y);
+    res.w = NK_MAX(a.x + a.w, b.x + b.w) - res.x;
+    res.h = NK_MAX(a.y + a.h, b.y + b.h) - res.y;
+    return res;
+}
+
+NK_INTERN int
+nk_rect_equal(struct nk_rect a, struct nk_rect b)
+{
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
 NK_API struct nk_vec2
 nk_vec2(float x, float y)
 {
@@ -6960,6 +7950,124 @@ nk_buffer_init_fixed(struct nk_buffer *b, void *m, nk_size size)
     b->size = size;
 }
 
+/* Chunked buffers keep a table with the memory of every chunk. Allocations
+ * larger than one chunk get a block spanning multiple table entries, with
+ * only the first entry owning the block. Offsets stay stable on growth and
+ * map to chunk `offset / chunk_size` at `offset % chunk_size`. */
+struct nk_buffer_chunk {
+    nk_byte *memory;
+    nk_size owned;
+};
+
+NK_INTERN int
+nk_buffer_chunk_grow(struct nk_buffer *b, nk_size count)
+{
+    struct nk_buffer_chunk *chunks = (struct nk_buffer_chunk*)b->memory.ptr;
+    nk_size used = b->memory.size / b->chunk_size;
+    nk_size capacity = used ? nk_round_up_pow2((nk_uint)used): 0;
+    nk_byte *memory;
+    nk_size i;
+
+    /* only the small chunk table is ever copied */
+    if (used + count > capacity) {
+        struct nk_buffer_chunk *table;
+        capacity = nk_round_up_pow2((nk_uint)(used + count));
+        table = (struct nk_buffer_chunk*)b->pool.alloc(b->pool.userdata, 0,
+            capacity * sizeof(struct nk_buffer_chunk));
+        NK_ASSERT(table);
+        if (!table) return nk_false;
+        if (chunks) {
+            NK_MEMCPY(table, chunks, used * sizeof(struct nk_buffer_chunk));
+            b->pool.free(b->pool.userdata, chunks);
+        }
+        b->memory.ptr = chunks = table;
+    }
+    memory = (nk_byte*)b->pool.alloc(b->pool.userdata, 0, count * b->chunk_size);
+    NK_ASSERT(memory);
+    if (!memory) return nk_false;
+    for (i = 0; i < count; ++i) {
+        chunks[used + i].memory = memory + i * b->chunk_size;
+        chunks[used + i].owned = 0;
+    }
+    chunks[used].owned = count * b->chunk_size;
+    b->memory.size += count * b->chunk_size;
+    b->size = b->memory.size;
+    b->grows++;
+    return nk_true;
+}
+
+NK_INTERN int
+nk_buffer_chunk_contiguous(const struct nk_buffer *b, nk_size first, nk_size count)
+{
+    const struct nk_buffer_chunk *chunks = (const struct nk_buffer_chunk*)b->memory.ptr;
+    nk_size i;
+    if (first + count > b->memory.size / b->chunk_size)
+        return nk_false;
+    for (i = 1; i < count; ++i)
+        if (chunks[first + i].owned) return nk_false;
+    return nk_true;
+}
+
+NK_INTERN void*
+nk_buffer_chunk_alloc(struct nk_buffer *b, nk_size size, nk_size align)
+{
+    /* space at the end of every chunk for draw commands to link to the next chunk */
+    NK_STORAGE const nk_size reserve = sizeof(struct nk_command) + NK_ALIGNOF(struct nk_command);
+    const nk_size chunk = b->chunk_size;
+    nk_size slot = b->allocated / chunk;
+    nk_size begin = b->allocated;
+    const struct nk_buffer_chunk *chunks;
+
+    if (align) begin = ((begin + align - 1) / align) * align;
+    if (begin + size + reserve > (slot + 1) * chunk) {
+        /* does not fit into the current chunk so continue in the next one */
+        nk_size count = (size + reserve + chunk - 1) / chunk;
+        nk_size used = b->memory.size / chunk;
+        /* skip chunks until enough contiguous memory is found */
+        for (slot = slot + 1; slot + count <= used; ++slot)
+            if (nk_buffer_chunk_contiguous(b, slot, count)) break;
+        if (slot + count > used) {
+            slot = used;
+            if (!nk_buffer_chunk_grow(b, count))
+                return 0;
+        }
+        begin = slot * chunk;
+    }
+    b->needed += size + (begin - b->allocated);
+    b->allocated = begin + size;
+    b->calls++;
+    chunks = (const struct nk_buffer_chunk*)b->memory.ptr;
+    return chunks[slot].memory + (begin - slot * chunk);
+}
+
+NK_INTERN void*
+nk_buffer_at(const struct nk_buffer *b, nk_size offset)
+{
+    if (b->type == NK_BUFFER_CHUNKED) {
+        const struct nk_buffer_chunk *chunks = (const struct nk_buffer_chunk*)b->memory.ptr;
+        return chunks[offset / b->chunk_size].memory + (offset % b->chunk_size);
+    }
+    return (nk_byte*)b->memory.ptr + offset;
+}
+
+NK_API void
+nk_buffer_init_chunked(struct nk_buffer *b, const struct nk_allocator *a,
+    nk_size chunk_size)
+{
+    NK_ASSERT(b);
+    NK_ASSERT(a);
+    NK_ASSERT(chunk_size);
+    if (!b || !a || !chunk_size) return;
+
+    nk_zero(b, sizeof(*b));
+    b->type = NK_BUFFER_CHUNKED;
+    b->pool = *a;
+    /* chunks need to hold at least a few commands and keep them aligned */
+    b->chunk_size = nk_round_up_pow2((nk_uint)NK_MAX(chunk_size, 256));
+    nk_buffer_chunk_grow(b, 1);
+    b->grows = 0;
+}
+
 NK_INTERN void*
 nk_buffer_align(void *unaligned, nk_size align, nk_size *alignment,
     enum nk_buffer_allocation_type type)
@@ -7041,6 +8149,11 @@ nk_buffer_alloc(struct nk_buffer *b, enum nk_buffer_allocation_type type,
     NK_ASSERT(b);
     NK_ASSERT(size);
     if (!b || !size) return 0;
+    if (b->type == NK_BUFFER_CHUNKED) {
+        NK_ASSERT(type == NK_BUFFER_FRONT && "chunked buffers only support front allocations");
+        if (type != NK_BUFFER_FRONT) return 0;
+        return nk_buffer_chunk_alloc(b, size, align);
+    }
     b->needed += size;
 
     /* calculate total size with needed alignment + size */
@@ -7067,6 +8180,7 @@ nk_buffer_alloc(struct nk_buffer *b, enum nk_buffer_allocation_type type,
         capacity = NK_MAX(capacity, nk_round_up_pow2((nk_uint)(b->allocated + size)));
         b->memory.ptr = nk_buffer_realloc(b, capacity, &b->memory.size);
         if (!b->memory.ptr) return 0;
+        b->grows++;
 
         /* align newly allocated pointer */
         if (type == NK_BUFFER_FRONT)
@@ -7143,6 +8257,14 @@ nk_buffer_free(struct nk_buffer *b)
     if (b->type == NK_BUFFER_FIXED) return;
     if (!b->pool.free) return;
     NK_ASSERT(b->pool.free);
+    if (b->type == NK_BUFFER_CHUNKED) {
+        struct nk_buffer_chunk *chunks = (struct nk_buffer_chunk*)b->memory.ptr;
+        nk_size i, count = b->memory.size / b->chunk_size;
+        for (i = 0; i < count; ++i) {
+            if (chunks[i].owned)
+                b->pool.free(b->pool.userdata, chunks[i].memory);
+        }
+    }
     b->pool.free(b->pool.userdata, b->memory.ptr);
 }
 
@@ -7157,6 +8279,7 @@ nk_buffer_info(struct nk_memory_status *s, struct nk_buffer *b)
     s->needed = b->needed;
     s->memory = b->memory.ptr;
     s->calls = b->calls;
+    s->grows = b->grows;
 }
 
 NK_API void*
@@ -7682,6 +8805,9 @@ nk_command_buffer_init(struct nk_command_buffer *cmdbuf,
     cmdbuf->begin = buffer->allocated;
     cmdbuf->end = buffer->allocated;
     cmdbuf->last = buffer->allocated;
+#ifdef NK_ZERO_COPY_TEXT
+    cmdbuf->copy_text = 0;
+#endif
 }
 
 NK_INTERN void
@@ -7713,9 +8839,19 @@ nk_command_buffer_push(struct nk_command_buffer* b,
     if (!b) return 0;
     cmd = (struct nk_command*)nk_buffer_alloc(b->base,NK_BUFFER_FRONT,size,align);
     if (!cmd) return 0;
+    b->last = b->base->allocated - size;
+    if (b->base->type == NK_BUFFER_CHUNKED && b->last != b->end) {
+        /* command continues in another chunk so link to it from the
+         * space each chunk keeps reserved after the previous command */
+        struct nk_command *link = (struct nk_command*)nk_buffer_at(b->base, b->end);
+        link->type = NK_COMMAND_NOP;
+        link->next = b->last;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+        link->userdata = b->userdata;
+#endif
+    }
 
     /* make sure the offset to the next command is aligned */
-    b->last = (nk_size)((nk_byte*)cmd - (nk_byte*)b->base->memory.ptr);
     unaligned = (nk_byte*)cmd + size;
     memory = NK_ALIGN_PTR(unaligned, align);
     alignment = (nk_size)((nk_byte*)memory - (nk_byte*)unaligned);
@@ -8061,6 +9197,12 @@ nk_stroke_polyline(struct nk_command_buffer *b, float *points, int point_count,
 
     NK_ASSERT(b);
     if (!b || col.a == 0 || line_thickness <= 0) return;
+    while (point_count > NK_USHORT_MAX) {
+        /* split long polylines into commands sharing their end points */
+        nk_stroke_polyline(b, points, NK_USHORT_MAX, line_thickness, col);
+        points += (NK_USHORT_MAX - 1) * 2;
+        point_count -= NK_USHORT_MAX - 1;
+    }
     size = sizeof(*cmd) + sizeof(short) * 2 * (nk_size)point_count;
     cmd = (struct nk_command_polyline*) nk_command_buffer_push(b, NK_COMMAND_POLYLINE, size);
     if (!cmd) return;
@@ -8147,9 +9289,32 @@ nk_draw_text(struct nk_command_buffer *b, struct nk_rect r,
     }
 
     if (!length) return;
+#ifdef NK_ZERO_COPY_TEXT
+    if (!b->copy_text) {
+        /* reference caller owned text which stays valid until `nk_clear` */
+        cmd = (struct nk_command_text*)
+            nk_command_buffer_push(b, NK_COMMAND_TEXT, sizeof(*cmd));
+        if (!cmd) return;
+        cmd->string = string;
+    } else {
+        /* copied text is stored behind the command and resolved by `nk_build`
+         * since the command buffer can still move while growing */
+        char *copy;
+        cmd = (struct nk_command_text*)
+            nk_command_buffer_push(b, NK_COMMAND_TEXT, sizeof(*cmd) + (nk_size)(length + 1));
+        if (!cmd) return;
+        copy = (char*)(cmd + 1);
+        NK_MEMCPY(copy, string, (nk_size)length);
+        copy[length] = '\0';
+        cmd->string = 0;
+    }
+#else
     cmd = (struct nk_command_text*)
         nk_command_buffer_push(b, NK_COMMAND_TEXT, sizeof(*cmd) + (nk_size)(length + 1));
     if (!cmd) return;
+    NK_MEMCPY(cmd->string, string, (nk_size)length);
+    cmd->string[length] = '\0';
+#endif
     cmd->x = (short)r.x;
     cmd->y = (short)r.y;
     cmd->w = (unsigned short)r.w;
@@ -8159,8 +9324,282 @@ nk_draw_text(struct nk_command_buffer *b, struct nk_rect r,
     cmd->font = font;
     cmd->length = length;
     cmd->height = font->height;
-    NK_MEMCPY(cmd->string, string, (nk_size)length);
-    cmd->string[length] = '\0';
+}
+
+NK_INTERN void
+nk_draw_text_copy(struct nk_command_buffer *b, int enable)
+{
+    /* text drawn between enabling and disabling is copied into the draw
+     * commands. Used for text which does not outlive the drawing widget */
+#ifdef NK_ZERO_COPY_TEXT
+    if (b) b->copy_text += (enable) ? 1: -1;
+#else
+    NK_UNUSED(b);
+    NK_UNUSED(enable);
+#endif
+}
+
+NK_INTERN const char*
+nk_command_text_string(const struct nk_command_text *t)
+{
+#ifdef NK_ZERO_COPY_TEXT
+    if (!t->string) return (const char*)(t + 1);
+#endif
+    return t->string;
+}
+
+NK_INTERN nk_hash
+nk_hash_uint(nk_hash h, nk_uint v)
+{
+    h ^= v;
+    h *= 0x5bd1e995;
+    return h ^ (h >> 15);
+}
+#define nk_hash_short2(h, a, b)\
+    nk_hash_uint(h, ((nk_uint)(nk_ushort)(a) << 16) | (nk_uint)(nk_ushort)(b))
+#define nk_hash_vec2i(h, v) nk_hash_short2(h, (v).x, (v).y)
+#define nk_hash_color(h, c) nk_hash_uint(h, nk_color_u32(c))
+
+NK_INTERN nk_hash
+nk_hash_float(nk_hash h, float f)
+{
+    union {float f; nk_uint u;} conv;
+    conv.f = f;
+    return nk_hash_uint(h, conv.u);
+}
+
+NK_INTERN nk_hash
+nk_hash_ptr(nk_hash h, const void *ptr)
+{
+    nk_ptr p = (nk_ptr)ptr;
+    h = nk_hash_uint(h, (nk_uint)p);
+    return nk_hash_uint(h, (nk_uint)((p >> 16) >> 16));
+}
+
+NK_INTERN nk_hash
+nk_command_hash(nk_hash h, const struct nk_command *cmd)
+{
+    /* hashes all fields of a draw command but not its header, since the
+     * offset to the next command changes from frame to frame and
+     * alignment padding between fields is not initialized */
+    h = nk_hash_uint(h, (nk_uint)cmd->type);
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    h = nk_hash_ptr(h, cmd->userdata.ptr);
+#endif
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+        h = nk_hash_short2(h, s->x, s->y);
+        h = nk_hash_short2(h, s->w, s->h);
+    } break;
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line*)cmd;
+        h = nk_hash_uint(h, l->line_thickness);
+        h = nk_hash_vec2i(h, l->begin);
+        h = nk_hash_vec2i(h, l->end);
+        h = nk_hash_color(h, l->color);
+    } break;
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
+        h = nk_hash_uint(h, q->line_thickness);
+        h = nk_hash_vec2i(h, q->begin);
+        h = nk_hash_vec2i(h, q->end);
+        h = nk_hash_vec2i(h, q->ctrl[0]);
+        h = nk_hash_vec2i(h, q->ctrl[1]);
+        h = nk_hash_color(h, q->color);
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        h = nk_hash_short2(h, r->rounding, r->line_thickness);
+        h = nk_hash_short2(h, r->x, r->y);
+        h = nk_hash_short2(h, r->w, r->h);
+        h = nk_hash_color(h, r->color);
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        h = nk_hash_uint(h, r->rounding);
+        h = nk_hash_short2(h, r->x, r->y);
+        h = nk_hash_short2(h, r->w, r->h);
+        h = nk_hash_color(h, r->color);
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
+        h = nk_hash_short2(h, r->x, r->y);
+        h = nk_hash_short2(h, r->w, r->h);
+        h = nk_hash_color(h, r->left);
+        h = nk_hash_color(h, r->top);
+        h = nk_hash_color(h, r->bottom);
+        h = nk_hash_color(h, r->right);
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        h = nk_hash_short2(h, c->x, c->y);
+        h = nk_hash_short2(h, c->w, c->h);
+        h = nk_hash_uint(h, c->line_thickness);
+        h = nk_hash_color(h, c->color);
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled*)cmd;
+        h = nk_hash_short2(h, c->x, c->y);
+        h = nk_hash_short2(h, c->w, c->h);
+        h = nk_hash_color(h, c->color);
+    } break;
+    case NK_COMMAND_ARC: {
+        const struct nk_command_arc *a = (const struct nk_command_arc*)cmd;
+        h = nk_hash_short2(h, a->cx, a->cy);
+        h = nk_hash_short2(h, a->r, a->line_thickness);
+        h = nk_hash_float(h, a->a[0]);
+        h = nk_hash_float(h, a->a[1]);
+        h = nk_hash_color(h, a->color);
+    } break;
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled*)cmd;
+        h = nk_hash_short2(h, a->cx, a->cy);
+        h = nk_hash_uint(h, a->r);
+        h = nk_hash_float(h, a->a[0]);
+        h = nk_hash_float(h, a->a[1]);
+        h = nk_hash_color(h, a->color);
+    } break;
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
+        h = nk_hash_uint(h, t->line_thickness);
+        h = nk_hash_vec2i(h, t->a);
+        h = nk_hash_vec2i(h, t->b);
+        h = nk_hash_vec2i(h, t->c);
+        h = nk_hash_color(h, t->color);
+    } break;
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
+        h = nk_hash_vec2i(h, t->a);
+        h = nk_hash_vec2i(h, t->b);
+        h = nk_hash_vec2i(h, t->c);
+        h = nk_hash_color(h, t->color);
+    } break;
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *p = (const struct nk_command_polygon*)cmd;
+        h = nk_hash_color(h, p->color);
+        h = nk_hash_short2(h, p->line_thickness, p->point_count);
+        h = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(struct nk_vec2i)), h);
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+        h = nk_hash_color(h, p->color);
+        h = nk_hash_uint(h, p->point_count);
+        h = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(struct nk_vec2i)), h);
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+        h = nk_hash_color(h, p->color);
+        h = nk_hash_short2(h, p->line_thickness, p->point_count);
+        h = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(struct nk_vec2i)), h);
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        h = nk_hash_ptr(h, t->font);
+        h = nk_hash_color(h, t->background);
+        h = nk_hash_color(h, t->foreground);
+        h = nk_hash_short2(h, t->x, t->y);
+        h = nk_hash_short2(h, t->w, t->h);
+        h = nk_hash_float(h, t->height);
+        h = nk_murmur_hash(nk_command_text_string(t), t->length, h);
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+        h = nk_hash_short2(h, i->x, i->y);
+        h = nk_hash_short2(h, i->w, i->h);
+        h = nk_hash_ptr(h, i->img.handle.ptr);
+        h = nk_hash_short2(h, i->img.w, i->img.h);
+        h = nk_hash_short2(h, i->img.region[0], i->img.region[1]);
+        h = nk_hash_short2(h, i->img.region[2], i->img.region[3]);
+        h = nk_hash_color(h, i->col);
+    } break;
+    case NK_COMMAND_CUSTOM: {
+        const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
+        union {nk_command_custom_callback fn; nk_ptr p;} callback;
+        callback.p = 0;
+        callback.fn = c->callback;
+        h = nk_hash_short2(h, c->x, c->y);
+        h = nk_hash_short2(h, c->w, c->h);
+        h = nk_hash_ptr(h, c->callback_data.ptr);
+        h = nk_hash_ptr(h, (const void*)callback.p);
+    } break;
+    }
+    return h;
+}
+
+NK_INTERN nk_hash
+nk_command_list_hash(nk_hash h, const struct nk_buffer *buffer,
+    nk_size begin, nk_size last, nk_size end)
+{
+    /* hashes a command list from `begin` up to and including `last`
+     * while stopping at any link leaving the memory range [begin,end) */
+    nk_size offset = begin;
+    while (offset >= begin && offset < end) {
+        const struct nk_command *cmd;
+        cmd = (const struct nk_command*)nk_buffer_at(buffer, offset);
+        if (cmd->type != NK_COMMAND_NOP)
+            h = nk_command_hash(h, cmd);
+        if (offset == last || cmd->next <= offset) break;
+        offset = cmd->next;
+    }
+    return h;
+}
+
+struct nk_command_range {
+    nk_hash id;
+    nk_size begin, last, end;
+};
+struct nk_command_range_iterator {
+    const struct nk_window *win;
+    int state;
+};
+
+NK_INTERN int
+nk_command_range_next(const struct nk_context *ctx, struct nk_command_range_iterator *it,
+    struct nk_command_range *range)
+{
+    /* visits windows, popups and the overlay in the order `nk_build` links them */
+    if (it->state == 0) {
+        while (it->win) {
+            const struct nk_window *win = it->win;
+            it->win = win->next;
+            if (win->buffer.last == win->buffer.begin || win->seq != ctx->seq ||
+                (win->flags & (NK_WINDOW_HIDDEN|NK_WINDOW_OCCLUDED)))
+                continue;
+            range->id = win->name;
+            range->begin = win->buffer.begin;
+            range->last = win->buffer.last;
+            range->end = win->buffer.end;
+            return nk_true;
+        }
+        it->win = ctx->begin;
+        it->state = 1;
+    }
+    if (it->state == 1) {
+        while (it->win) {
+            const struct nk_window *win = it->win;
+            it->win = win->next;
+            if (!win->popup.buf.active) continue;
+            range->id = ~win->name;
+            range->begin = win->popup.buf.begin;
+            range->last = win->popup.buf.last;
+            range->end = win->popup.buf.end;
+            return nk_true;
+        }
+        it->state = 2;
+    }
+    if (it->state == 2) {
+        it->state = 3;
+        if (ctx->overlay.end != ctx->overlay.begin) {
+            range->id = 0;
+            range->begin = ctx->overlay.begin;
+            range->last = ctx->overlay.last;
+            range->end = ctx->overlay.end;
+            return nk_true;
+        }
+    }
+    return nk_false;
 }
 
 /* ==============================================================
@@ -8169,10 +9608,49 @@ nk_draw_text(struct nk_command_buffer *b, struct nk_rect r,
  *
  * ===============================================================*/
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+NK_INTERN struct nk_vec2
+nk_draw_list_edge_normal(struct nk_vec2 p0, struct nk_vec2 p1)
+{
+    struct nk_vec2 diff = nk_vec2_sub(p1, p0);
+    float len = nk_vec2_len_sqr(diff);
+    if (len != 0.0f)
+        len = nk_inv_sqrt(len);
+    else len = 1.0f;
+    diff = nk_vec2_muls(diff, len);
+    return nk_vec2(diff.y, -diff.x);
+}
+
+NK_INTERN void
+nk_draw_list_shape_normals(struct nk_vec2 *normals,
+    const struct nk_vec2 *points, unsigned int count)
+{
+    /* averages the normals of both edges of each point of a closed path the
+     * same way the polygon functions do. Only depends on the edge directions
+     * so it can be reused for every scaled copy of the path */
+    unsigned int i0, i1;
+    struct nk_vec2 n0 = nk_draw_list_edge_normal(points[count-1], points[0]);
+    for (i0 = 0; i0 < count; ++i0) {
+        struct nk_vec2 n1, dm;
+        float dmr2;
+        i1 = (i0 + 1 == count) ? 0: i0 + 1;
+        n1 = nk_draw_list_edge_normal(points[i0], points[i1]);
+        dm = nk_vec2_muls(nk_vec2_add(n0, n1), 0.5f);
+        dmr2 = dm.x*dm.x + dm.y*dm.y;
+        if (dmr2 > 0.000001f) {
+            float scale = 1.0f / dmr2;
+            scale = NK_MIN(scale, 100.0f);
+            dm = nk_vec2_muls(dm, scale);
+        }
+        normals[i0] = dm;
+        n0 = n1;
+    }
+}
+
 NK_API void
 nk_draw_list_init(struct nk_draw_list *list)
 {
     nk_size i = 0;
+    struct nk_vec2 points[16];
     NK_ASSERT(list);
     if (!list) return;
     nk_zero(list, sizeof(*list));
@@ -8181,6 +9659,64 @@ nk_draw_list_init(struct nk_draw_list *list)
         list->circle_vtx[i].x = (float)NK_COS(a);
         list->circle_vtx[i].y = (float)NK_SIN(a);
     }
+
+    /* rectangle normals do not depend on size or rounding */
+    points[0] = nk_vec2(0,0); points[1] = nk_vec2(1,0);
+    points[2] = nk_vec2(1,1); points[3] = nk_vec2(0,1);
+    nk_draw_list_shape_normals(list->rect_normals, points, 4);
+    for (i = 0; i < NK_LEN(points); ++i) {
+        const nk_size corner = i / 4;
+        const struct nk_vec2 c = list->circle_vtx[(6 + corner*3 + (i%4)) % NK_LEN(list->circle_vtx)];
+        points[i].x = ((corner == 1 || corner == 2) ? 3.0f: 1.0f) + c.x;
+        points[i].y = ((corner == 2 || corner == 3) ? 3.0f: 1.0f) + c.y;
+    }
+    nk_draw_list_shape_normals(list->rounded_rect_normals, points, 16);
+}
+
+enum nk_draw_vertex_writer {
+    NK_DRAW_VERTEX_GENERIC,
+    NK_DRAW_VERTEX_RGBA8,
+    /* float position, float texture coordinate and R8G8B8A8 color */
+    NK_DRAW_VERTEX_BGRA8
+    /* float position, float texture coordinate and B8G8R8A8 color */
+};
+
+NK_INTERN int
+nk_draw_vertex_writer(const struct nk_convert_config *config, nk_size *offset)
+{
+    /* almost every backend uses the same vertex layout which can be written
+     * without walking the layout and converting each attribute separately */
+    const struct nk_draw_vertex_layout_element *layout = config->vertex_layout;
+    int writer = NK_DRAW_VERTEX_GENERIC;
+    int found = 0;
+    if (!layout) return NK_DRAW_VERTEX_GENERIC;
+    /* floats are stored directly so every vertex has to be float aligned */
+    if (config->vertex_size % sizeof(float) ||
+        config->vertex_alignment % NK_ALIGNOF(float) || !config->vertex_alignment)
+        return NK_DRAW_VERTEX_GENERIC;
+    for (; layout->attribute != NK_VERTEX_ATTRIBUTE_COUNT &&
+        layout->format != NK_FORMAT_COUNT; ++layout) {
+        switch (layout->attribute) {
+        case NK_VERTEX_POSITION:
+        case NK_VERTEX_TEXCOORD:
+        case NK_VERTEX_SHAPE:
+            if (layout->format != NK_FORMAT_FLOAT || (found & (1 << layout->attribute)) ||
+                layout->offset % sizeof(float))
+                return NK_DRAW_VERTEX_GENERIC;
+            break;
+        case NK_VERTEX_COLOR:
+            if (layout->format == NK_FORMAT_R8G8B8A8) writer = NK_DRAW_VERTEX_RGBA8;
+            else if (layout->format == NK_FORMAT_B8G8R8A8) writer = NK_DRAW_VERTEX_BGRA8;
+            else return NK_DRAW_VERTEX_GENERIC;
+            if (found & (1 << layout->attribute))
+                return NK_DRAW_VERTEX_GENERIC;
+            break;
+        default: return NK_DRAW_VERTEX_GENERIC;
+        }
+        found |= 1 << layout->attribute;
+        offset[layout->attribute] = layout->offset;
+    }
+    return ((found & 7) == 7) ? writer: NK_DRAW_VERTEX_GENERIC;
 }
 
 NK_API void
@@ -8203,6 +9739,17 @@ nk_draw_list_setup(struct nk_draw_list *canvas, const struct nk_convert_config *
     canvas->line_AA = line_aa;
     canvas->shape_AA = shape_aa;
     canvas->clip_rect = nk_null_rect;
+    canvas->vertex_writer = nk_draw_vertex_writer(config, canvas->vertex_offset);
+    canvas->vertex_shape = nk_false;
+    canvas->instances = 0;
+    canvas->instance_count = 0;
+    canvas->instance_textured = nk_false;
+    if (config->vertex_layout) {
+        const struct nk_draw_vertex_layout_element *layout = config->vertex_layout;
+        for (; layout->attribute != NK_VERTEX_ATTRIBUTE_COUNT &&
+            layout->format != NK_FORMAT_COUNT; ++layout)
+            canvas->vertex_shape |= layout->attribute == NK_VERTEX_SHAPE;
+    }
 }
 
 NK_API const struct nk_draw_command*
@@ -8274,6 +9821,7 @@ nk_draw_list_clear(struct nk_draw_list *list)
     list->vertex_count = 0;
     list->cmd_offset = 0;
     list->cmd_count = 0;
+    list->cmd_vertex_offset = 0;
     list->path_count = 0;
     list->vertices = 0;
     list->elements = 0;
@@ -8332,14 +9880,17 @@ nk_draw_list_push_command(struct nk_draw_list *list, struct nk_rect clip,
     }
 
     cmd->elem_count = 0;
+    cmd->vertex_offset = list->cmd_vertex_offset;
     cmd->clip_rect = clip;
     cmd->texture = texture;
+    cmd->instance_offset = list->instance_count;
+    cmd->instance_count = 0;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     cmd->userdata = list->userdata;
 #endif
 
+    list->instance_textured = nk_false;
     list->cmd_count++;
-    list->clip_rect = clip;
     return cmd;
 }
 
@@ -8362,11 +9913,16 @@ nk_draw_list_add_clip(struct nk_draw_list *list, struct nk_rect rect)
 {
     NK_ASSERT(list);
     if (!list) return;
-    if (!list->cmd_count) {
+    list->clip_rect = rect;
+    if (list->config.clipping == NK_DRAW_CLIP_GEOMETRY) {
+        /* shapes are clipped against `clip_rect` while converting */
+        if (!list->cmd_count)
+            nk_draw_list_push_command(list, nk_null_rect, list->config.null.texture);
+    } else if (!list->cmd_count) {
         nk_draw_list_push_command(list, rect, list->config.null.texture);
     } else {
         struct nk_draw_command *prev = nk_draw_list_command_last(list);
-        if (prev->elem_count == 0)
+        if (prev->elem_count == 0 && prev->instance_count == 0)
             prev->clip_rect = rect;
         nk_draw_list_push_command(list, rect, prev->texture);
     }
@@ -8381,12 +9937,12 @@ nk_draw_list_push_image(struct nk_draw_list *list, nk_handle texture)
         nk_draw_list_push_command(list, nk_null_rect, texture);
     } else {
         struct nk_draw_command *prev = nk_draw_list_command_last(list);
-        if (prev->elem_count == 0) {
+        if (prev->elem_count == 0 && prev->instance_count == 0) {
             prev->texture = texture;
         #ifdef NK_INCLUDE_COMMAND_USERDATA
             prev->userdata = list->userdata;
         #endif
-    } else if (prev->texture.id != texture.id
+    } else if (prev->instance_count || prev->texture.id != texture.id
         #ifdef NK_INCLUDE_COMMAND_USERDATA
             || prev->userdata.id != list->userdata.id
         #endif
@@ -8394,6 +9950,56 @@ nk_draw_list_push_image(struct nk_draw_list *list, nk_handle texture)
     }
 }
 
+NK_INTERN void
+nk_draw_list_push_instance(struct nk_draw_list *list, enum nk_draw_instance_type type,
+    const float *rect, const float *params, struct nk_color color, nk_handle texture)
+{
+    /* appends an instance record to the last vertex draw command if it only
+     * holds instances with the same clipping rectangle. Shapes ignore the
+     * texture, so only glyphs and images of another texture start a new one */
+    NK_STORAGE const nk_size inst_align = NK_ALIGNOF(struct nk_draw_instance);
+    NK_STORAGE const nk_size inst_size = sizeof(struct nk_draw_instance);
+    const int textured = (type == NK_DRAW_INSTANCE_GLYPH || type == NK_DRAW_INSTANCE_IMAGE);
+    struct nk_draw_command *cmd = 0;
+    struct nk_draw_instance *inst;
+
+    NK_ASSERT(list);
+    NK_ASSERT(list->instances);
+    if (!list || !list->instances) return;
+    if (list->cmd_count)
+        cmd = nk_draw_list_command_last(list);
+    if (cmd && !cmd->elem_count && !cmd->instance_count) {
+        cmd->clip_rect = list->clip_rect;
+        cmd->instance_offset = list->instance_count;
+    #ifdef NK_INCLUDE_COMMAND_USERDATA
+        cmd->userdata = list->userdata;
+    #endif
+    } else if (!cmd || cmd->elem_count || !nk_rect_equal(cmd->clip_rect, list->clip_rect) ||
+        (textured && list->instance_textured && cmd->texture.id != texture.id)
+    #ifdef NK_INCLUDE_COMMAND_USERDATA
+        || cmd->userdata.id != list->userdata.id
+    #endif
+    ) {
+        cmd = nk_draw_list_push_command(list, list->clip_rect,
+            (cmd) ? cmd->texture: list->config.null.texture);
+        if (!cmd) return;
+    }
+    inst = (struct nk_draw_instance*)nk_buffer_alloc(list->instances,
+        NK_BUFFER_FRONT, inst_size, inst_align);
+    if (!inst) return;
+    NK_MEMCPY(inst->rect, rect, sizeof(inst->rect));
+    NK_MEMCPY(inst->params, params, sizeof(inst->params));
+    inst->color[0] = color.r; inst->color[1] = color.g;
+    inst->color[2] = color.b; inst->color[3] = color.a;
+    inst->type = (nk_uint)type;
+    if (textured) {
+        cmd->texture = texture;
+        list->instance_textured = nk_true;
+    }
+    cmd->instance_count++;
+    list->instance_count++;
+}
+
 #ifdef NK_INCLUDE_COMMAND_USERDATA
 NK_API void
 nk_draw_list_push_userdata(struct nk_draw_list *list, nk_handle userdata)
@@ -8415,18 +10021,58 @@ nk_draw_list_alloc_vertices(struct nk_draw_list *list, nk_size count)
     return vtx;
 }
 
-NK_INTERN nk_draw_index*
+NK_INTERN int
+nk_draw_list_vertex_index(struct nk_draw_list *list, nk_size count, nk_size *index)
+{
+    /* Returns the element index of the next vertex inside the last draw
+     * command. With 16 bit indices a new draw command with the same state
+     * is started once `count` more vertices would not be addressable from
+     * the base vertex of the current one. Returns false(0) if `count`
+     * vertices do not fit into a single draw command. */
+    struct nk_draw_command *cmd;
+    NK_ASSERT(list);
+    NK_ASSERT(index);
+    if (!list || !index) return nk_false;
+
+    cmd = nk_draw_list_command_last(list);
+    if (list->config.index_type == NK_DRAW_INDEX_USHORT) {
+        const nk_size max = (nk_size)NK_USHORT_MAX + 1;
+        if (count > max) return nk_false;
+        if (list->vertex_count - cmd->vertex_offset + count > max) {
+            struct nk_rect clip = cmd->clip_rect;
+            nk_handle texture = cmd->texture;
+        #ifdef NK_INCLUDE_COMMAND_USERDATA
+            nk_handle userdata = list->userdata;
+            list->userdata = cmd->userdata;
+        #endif
+            list->cmd_vertex_offset = list->vertex_count;
+            if (cmd->elem_count) cmd = nk_draw_list_push_command(list, clip, texture);
+            else cmd->vertex_offset = list->cmd_vertex_offset;
+        #ifdef NK_INCLUDE_COMMAND_USERDATA
+            list->userdata = userdata;
+        #endif
+            if (!cmd) return nk_false;
+        }
+    }
+    *index = list->vertex_count - cmd->vertex_offset;
+    return nk_true;
+}
+
+NK_INTERN void*
 nk_draw_list_alloc_elements(struct nk_draw_list *list, nk_size count)
 {
-    nk_draw_index *ids;
+    void *ids;
     struct nk_draw_command *cmd;
-    NK_STORAGE const nk_size elem_align = NK_ALIGNOF(nk_draw_index);
-    NK_STORAGE const nk_size elem_size = sizeof(nk_draw_index);
+    nk_size elem_align = NK_ALIGNOF(nk_draw_index);
+    nk_size elem_size = sizeof(nk_draw_index);
     NK_ASSERT(list);
     if (!list) return 0;
 
-    ids = (nk_draw_index*)
-        nk_buffer_alloc(list->elements, NK_BUFFER_FRONT, elem_size*count, elem_align);
+    if (list->config.index_type == NK_DRAW_INDEX_UINT) {
+        elem_align = NK_ALIGNOF(nk_uint);
+        elem_size = sizeof(nk_uint);
+    }
+    ids = nk_buffer_alloc(list->elements, NK_BUFFER_FRONT, elem_size*count, elem_align);
     if (!ids) return 0;
     cmd = nk_draw_list_command_last(list);
     list->element_count += (unsigned int)count;
@@ -8434,6 +10080,25 @@ nk_draw_list_alloc_elements(struct nk_draw_list *list, nk_size count)
     return ids;
 }
 
+NK_INTERN void*
+nk_draw_list_write_elements(const struct nk_draw_list *list, void *dst,
+    const nk_uint *ids, int count)
+{
+    /* stores element indices in the configured index width */
+    int i;
+    if (list->config.index_type == NK_DRAW_INDEX_UINT) {
+        nk_uint *elements = (nk_uint*)dst;
+        for (i = 0; i < count; ++i)
+            elements[i] = ids[i];
+        return elements + count;
+    } else {
+        nk_draw_index *elements = (nk_draw_index*)dst;
+        for (i = 0; i < count; ++i)
+            elements[i] = (nk_draw_index)ids[i];
+        return elements + count;
+    }
+}
+
 NK_INTERN int
 nk_draw_vertex_layout_element_is_end_of_layout(
     const struct nk_draw_vertex_layout_element *element)
@@ -8573,12 +10238,48 @@ nk_draw_vertex_element(void *dst, const float *values, int value_count,
     }
 }
 
+NK_INTERN void
+nk_draw_vertex_pack_color(const struct nk_draw_list *list, struct nk_colorf color,
+    nk_byte *col)
+{
+    /* same conversion as `nk_draw_vertex_color` for the known vertex layouts */
+    nk_byte r = (nk_byte)(NK_SATURATE(color.r) * 255.0f);
+    nk_byte b = (nk_byte)(NK_SATURATE(color.b) * 255.0f);
+    col[0] = (list->vertex_writer == NK_DRAW_VERTEX_RGBA8) ? r: b;
+    col[1] = (nk_byte)(NK_SATURATE(color.g) * 255.0f);
+    col[2] = (list->vertex_writer == NK_DRAW_VERTEX_RGBA8) ? b: r;
+    col[3] = (nk_byte)(NK_SATURATE(color.a) * 255.0f);
+}
+
+NK_INTERN void*
+nk_draw_vertex_packed(void *dst, const struct nk_draw_list *list,
+    struct nk_vec2 pos, struct nk_vec2 uv, const nk_byte *color)
+{
+    /* writes a vertex of a known vertex layout with an already packed color */
+    float *position = (float*)(void*)((char*)dst + list->vertex_offset[NK_VERTEX_POSITION]);
+    float *texcoord = (float*)(void*)((char*)dst + list->vertex_offset[NK_VERTEX_TEXCOORD]);
+    position[0] = pos.x;
+    position[1] = pos.y;
+    texcoord[0] = uv.x;
+    texcoord[1] = uv.y;
+    NK_MEMCPY((nk_byte*)dst + list->vertex_offset[NK_VERTEX_COLOR], color, 4);
+    if (list->vertex_shape)
+        NK_MEMSET((char*)dst + list->vertex_offset[NK_VERTEX_SHAPE], 0, sizeof(float)*4);
+    return (void*)((char*)dst + list->config.vertex_size);
+}
+
 NK_INTERN void*
-nk_draw_vertex(void *dst, const struct nk_convert_config *config,
+nk_draw_vertex(void *dst, const struct nk_draw_list *list,
     struct nk_vec2 pos, struct nk_vec2 uv, struct nk_colorf color)
 {
+    const struct nk_convert_config *config = &list->config;
     void *result = (void*)((char*)dst + config->vertex_size);
     const struct nk_draw_vertex_layout_element *elem_iter = config->vertex_layout;
+    if (list->vertex_writer != NK_DRAW_VERTEX_GENERIC) {
+        nk_byte col[4];
+        nk_draw_vertex_pack_color(list, color, col);
+        return nk_draw_vertex_packed(dst, list, pos, uv, col);
+    }
     while (!nk_draw_vertex_layout_element_is_end_of_layout(elem_iter)) {
         void *address = (void*)((char*)dst + elem_iter->offset);
         switch (elem_iter->attribute) {
@@ -8587,21 +10288,232 @@ nk_draw_vertex(void *dst, const struct nk_convert_config *config,
         case NK_VERTEX_POSITION: nk_draw_vertex_element(address, &pos.x, 2, elem_iter->format); break;
         case NK_VERTEX_TEXCOORD: nk_draw_vertex_element(address, &uv.x, 2, elem_iter->format); break;
         case NK_VERTEX_COLOR: nk_draw_vertex_color(address, &color.r, elem_iter->format); break;
+        case NK_VERTEX_SHAPE: {
+            const float shape[4] = {0,0,0,0};
+            nk_draw_vertex_element(address, shape, 4, elem_iter->format);
+        } break;
         }
         elem_iter++;
     }
     return result;
 }
 
-NK_API void
-nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *points,
-    const unsigned int points_count, struct nk_color color, enum nk_draw_list_stroke closed,
-    float thickness, enum nk_anti_aliasing aliasing)
+NK_INTERN void
+nk_draw_vertex_shape(void *dst, const struct nk_draw_list *list, const float *shape)
 {
-    nk_size count;
-    int thick_line;
-    struct nk_colorf col;
-    struct nk_colorf col_trans;
+    const struct nk_draw_vertex_layout_element *elem_iter = list->config.vertex_layout;
+    if (list->vertex_writer != NK_DRAW_VERTEX_GENERIC) {
+        NK_MEMCPY((char*)dst + list->vertex_offset[NK_VERTEX_SHAPE], shape, sizeof(float)*4);
+        return;
+    }
+    for (; !nk_draw_vertex_layout_element_is_end_of_layout(elem_iter); ++elem_iter) {
+        if (elem_iter->attribute == NK_VERTEX_SHAPE)
+            nk_draw_vertex_element((char*)dst + elem_iter->offset, shape, 4, elem_iter->format);
+    }
+}
+
+NK_INTERN struct nk_vec2
+nk_draw_list_segment_normal(struct nk_vec2 a, struct nk_vec2 b)
+{
+    struct nk_vec2 diff = nk_vec2_sub(b, a);
+    float len = nk_vec2_len_sqr(diff);
+    if (len != 0.0f)
+        len = nk_inv_sqrt(len);
+    else len = 1.0f;
+    return nk_vec2(diff.y * len, -diff.x * len);
+}
+
+NK_INTERN void*
+nk_draw_list_write_strip_elements(const struct nk_draw_list *list, void *dst,
+    const nk_uint *pattern, nk_size count, nk_size index, nk_size stride,
+    nk_size segments)
+{
+    /* stores the element indices of `segments` segments of a strip at once.
+     * Each segment repeats `pattern` offset by `stride` vertices */
+    nk_size s, i;
+    if (list->config.index_type == NK_DRAW_INDEX_UINT) {
+        nk_uint *elements = (nk_uint*)dst;
+        for (s = 0; s < segments; ++s, index += stride, elements += count)
+            for (i = 0; i < count; ++i)
+                elements[i] = (nk_uint)(index + pattern[i]);
+        return elements;
+    } else {
+        nk_draw_index *elements = (nk_draw_index*)dst;
+        for (s = 0; s < segments; ++s, index += stride, elements += count)
+            for (i = 0; i < count; ++i)
+                elements[i] = (nk_draw_index)(index + pattern[i]);
+        return elements;
+    }
+}
+
+NK_INTERN void*
+nk_draw_list_write_fan_elements(const struct nk_draw_list *list, void *dst,
+    nk_size index, nk_size stride, nk_size count)
+{
+    /* stores the element indices of a triangle fan around vertex `index`
+     * over `count` vertices that lie `stride` vertices apart */
+    nk_size i;
+    if (list->config.index_type == NK_DRAW_INDEX_UINT) {
+        nk_uint *elements = (nk_uint*)dst;
+        for (i = 2; i < count; ++i, elements += 3) {
+            elements[0] = (nk_uint)index;
+            elements[1] = (nk_uint)(index + (i-1) * stride);
+            elements[2] = (nk_uint)(index + i * stride);
+        }
+        return elements;
+    } else {
+        nk_draw_index *elements = (nk_draw_index*)dst;
+        for (i = 2; i < count; ++i, elements += 3) {
+            elements[0] = (nk_draw_index)index;
+            elements[1] = (nk_draw_index)(index + (i-1) * stride);
+            elements[2] = (nk_draw_index)(index + i * stride);
+        }
+        return elements;
+    }
+}
+
+NK_INTERN void*
+nk_draw_vertex_strip(void *dst, const struct nk_draw_list *list,
+    struct nk_vec2 pos, struct nk_colorf color, const nk_byte *packed)
+{
+    /* writes a vertex of a strip with the color packed once for all of them */
+    if (list->vertex_writer == NK_DRAW_VERTEX_GENERIC)
+        return nk_draw_vertex(dst, list, pos, list->config.null.uv, color);
+    return nk_draw_vertex_packed(dst, list, pos, list->config.null.uv, packed);
+}
+
+NK_INTERN void
+nk_draw_list_stroke_poly_strip(struct nk_draw_list *list, const struct nk_vec2 *points,
+    const nk_size points_count, struct nk_colorf col, struct nk_colorf col_trans,
+    float thickness, enum nk_anti_aliasing aliasing)
+{
+    /* Tessellates an open polyline in a single pass without temporary
+     * normals. Each point only depends on its neighbours, so long polylines
+     * are written in chunks which fit into one draw command and share their
+     * last point with the next chunk. Element indices of a chunk only
+     * depend on its first vertex and are written in bulk, colors are only
+     * packed once. Lines of one pixel or less skip miter joins and offset
+     * each point along the normal between its neighbours instead */
+    NK_STORAGE const nk_uint thin_ids[] = {3,0,2, 2,5,3, 4,1,0, 0,3,4};
+    NK_STORAGE const nk_uint thick_ids[] = {5,1,2, 2,6,5, 5,1,0, 0,4,5, 6,2,3, 3,7,6};
+    NK_STORAGE const nk_uint quad_ids[] = {0,1,2, 0,2,3};
+    const float AA_SIZE = 1.0f;
+    const int thick_line = thickness > 1.0f;
+    const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
+    const nk_uint *ids;
+    nk_size vtx_per_point, idx_per_segment, max_points, first;
+    nk_byte opaque[4], trans[4];
+
+    if (aliasing != NK_ANTI_ALIASING_ON) {
+        /* every segment is a separate quad */
+        ids = quad_ids;
+        vtx_per_point = 4;
+        idx_per_segment = NK_LEN(quad_ids);
+    } else if (thick_line) {
+        ids = thick_ids;
+        vtx_per_point = 4;
+        idx_per_segment = NK_LEN(thick_ids);
+    } else {
+        ids = thin_ids;
+        vtx_per_point = 3;
+        idx_per_segment = NK_LEN(thin_ids);
+    }
+    nk_draw_vertex_pack_color(list, col, opaque);
+    nk_draw_vertex_pack_color(list, col_trans, trans);
+    max_points = points_count;
+    if (list->config.index_type == NK_DRAW_INDEX_USHORT)
+        max_points = NK_MIN(max_points, ((nk_size)NK_USHORT_MAX + 1) / vtx_per_point);
+
+    for (first = 0; first + 1 < points_count; first += max_points - 1) {
+        const nk_size last = NK_MIN(first + max_points, points_count) - 1;
+        const nk_size segments = last - first;
+        const nk_size vtx_count = (aliasing == NK_ANTI_ALIASING_ON) ?
+            (segments + 1) * vtx_per_point: segments * vtx_per_point;
+        struct nk_vec2 n_in;
+        nk_size index, i;
+        void *vtx, *elements;
+
+        if (!nk_draw_list_vertex_index(list, vtx_count, &index)) return;
+        vtx = nk_draw_list_alloc_vertices(list, vtx_count);
+        elements = nk_draw_list_alloc_elements(list, segments * idx_per_segment);
+        if (!vtx || !elements) return;
+        nk_draw_list_write_strip_elements(list, elements, ids, idx_per_segment,
+            index, vtx_per_point, segments);
+
+        if (aliasing != NK_ANTI_ALIASING_ON) {
+            /* NON ANTI-ALIASED STROKE */
+            for (i = first; i < last; ++i) {
+                const struct nk_vec2 n = nk_draw_list_segment_normal(points[i], points[i+1]);
+                const float dx = -n.y * (thickness * 0.5f);
+                const float dy = n.x * (thickness * 0.5f);
+                const struct nk_vec2 p1 = points[i];
+                const struct nk_vec2 p2 = points[i+1];
+
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2(p1.x + dy, p1.y - dx), col, opaque);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2(p2.x + dy, p2.y - dx), col, opaque);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2(p2.x - dy, p2.y + dx), col, opaque);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2(p1.x - dy, p1.y + dx), col, opaque);
+            }
+            continue;
+        }
+
+        /* ANTI-ALIASED STROKE */
+        n_in = (first) ? nk_draw_list_segment_normal(points[first-1], points[first]):
+            nk_draw_list_segment_normal(points[0], points[1]);
+        for (i = first; i <= last; ++i) {
+            struct nk_vec2 dm;
+            if (i == 0 || i + 1 == points_count) {
+                /* end points use the normal of their only segment */
+                dm = (i) ? nk_draw_list_segment_normal(points[i-1], points[i]): n_in;
+            } else if (!thick_line) {
+                /* thin lines are offset along the normal between their
+                 * neighbours since a miter can spike on jagged plots */
+                dm = nk_draw_list_segment_normal(points[i-1], points[i+1]);
+                if (dm.x == 0.0f && dm.y == 0.0f)
+                    dm = nk_draw_list_segment_normal(points[i-1], points[i]);
+            } else {
+                /* average normals */
+                const struct nk_vec2 n_out = nk_draw_list_segment_normal(points[i], points[i+1]);
+                float dmr2;
+                dm = nk_vec2_muls(nk_vec2_add(n_in, n_out), 0.5f);
+                dmr2 = dm.x * dm.x + dm.y * dm.y;
+                if (dmr2 > 0.000001f) {
+                    float scale = 1.0f/dmr2;
+                    scale = NK_MIN(100.0f, scale);
+                    dm = nk_vec2_muls(dm, scale);
+                }
+                n_in = n_out;
+            }
+
+            if (!thick_line) {
+                dm = nk_vec2_muls(dm, AA_SIZE);
+                vtx = nk_draw_vertex_strip(vtx, list, points[i], col, opaque);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2_add(points[i], dm), col_trans, trans);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2_sub(points[i], dm), col_trans, trans);
+            } else {
+                const struct nk_vec2 dm_out = nk_vec2_muls(dm, half_inner_thickness + AA_SIZE);
+                const struct nk_vec2 dm_in = nk_vec2_muls(dm, half_inner_thickness);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2_add(points[i], dm_out), col_trans, trans);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2_add(points[i], dm_in), col, opaque);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2_sub(points[i], dm_in), col, opaque);
+                vtx = nk_draw_vertex_strip(vtx, list, nk_vec2_sub(points[i], dm_out), col_trans, trans);
+            }
+        }
+    }
+}
+
+NK_INTERN void
+nk_draw_list_stroke_poly(struct nk_draw_list *list, const struct nk_vec2 *points,
+    const struct nk_vec2 *vertex_normals, const unsigned int points_count,
+    struct nk_color color, enum nk_draw_list_stroke closed, float thickness,
+    enum nk_anti_aliasing aliasing)
+{
+    /* `vertex_normals` optionally holds the averaged normal of each point of a
+     * closed path to skip computing them */
+    nk_size count;
+    int thick_line;
+    struct nk_colorf col;
+    struct nk_colorf col_trans;
     NK_ASSERT(list);
     if (!list || points_count < 2) return;
 
@@ -8619,6 +10531,11 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
     col_trans = col;
     col_trans.a = 0;
 
+    if (!closed && !vertex_normals) {
+        nk_draw_list_stroke_poly_strip(list, points, points_count, col,
+            col_trans, thickness, aliasing);
+        return;
+    }
     if (aliasing == NK_ANTI_ALIASING_ON) {
         /* ANTI-ALIASED STROKE */
         const float AA_SIZE = 1.0f;
@@ -8628,17 +10545,19 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
         /* allocate vertices and elements  */
         nk_size i1 = 0;
         nk_size vertex_offset;
-        nk_size index = list->vertex_count;
+        nk_size index;
 
         const nk_size idx_count = (thick_line) ?  (count * 18) : (count * 12);
         const nk_size vtx_count = (thick_line) ? (points_count * 4): (points_count *3);
 
-        void *vtx = nk_draw_list_alloc_vertices(list, vtx_count);
-        nk_draw_index *ids = nk_draw_list_alloc_elements(list, idx_count);
-
+        void *vtx, *elements;
+        nk_uint ids[18];
         nk_size size;
         struct nk_vec2 *normals, *temp;
-        if (!vtx || !ids) return;
+        if (!nk_draw_list_vertex_index(list, vtx_count, &index)) return;
+        vtx = nk_draw_list_alloc_vertices(list, vtx_count);
+        elements = nk_draw_list_alloc_elements(list, idx_count);
+        if (!vtx || !elements) return;
 
         /* temporary allocate normals + points */
         vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
@@ -8653,7 +10572,7 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
         vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
 
         /* calculate normals */
-        for (i1 = 0; i1 < count; ++i1) {
+        for (i1 = 0; i1 < count && !vertex_normals; ++i1) {
             const nk_size i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
             struct nk_vec2 diff = nk_vec2_sub(points[i2], points[i1]);
             float len;
@@ -8683,43 +10602,47 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
                 temp[(points_count-1) * 2 + 1] = nk_vec2_sub(points[points_count-1], d);
             }
 
-            /* fill elements */
-            idx1 = index;
+            /* fill elements, the last segment of a closed path ends at the first point */
+            {NK_STORAGE const nk_uint pattern[] = {3,0,2,2,5,3,4,1,0,0,3,4};
+            const nk_size segments = closed ? count - 1: count;
+            elements = nk_draw_list_write_strip_elements(list, elements, pattern, 12, index, 3, segments);
+            if (closed) {
+                idx1 = index + segments * 3;
+                for (i = 0; i < 12; ++i)
+                    ids[i] = (nk_uint)((pattern[i] < 3) ? idx1 + pattern[i]: index + pattern[i] - 3);
+                nk_draw_list_write_elements(list, elements, ids, 12);
+            }}
+
+            /* fill normals */
             for (i1 = 0; i1 < count; i1++) {
                 struct nk_vec2 dm;
                 float dmr2;
                 nk_size i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
-                nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 3);
 
                 /* average normals */
-                dm = nk_vec2_muls(nk_vec2_add(normals[i1], normals[i2]), 0.5f);
-                dmr2 = dm.x * dm.x + dm.y* dm.y;
-                if (dmr2 > 0.000001f) {
-                    float scale = 1.0f/dmr2;
-                    scale = NK_MIN(100.0f, scale);
-                    dm = nk_vec2_muls(dm, scale);
+                if (vertex_normals) {
+                    dm = vertex_normals[i2];
+                } else {
+                    dm = nk_vec2_muls(nk_vec2_add(normals[i1], normals[i2]), 0.5f);
+                    dmr2 = dm.x * dm.x + dm.y* dm.y;
+                    if (dmr2 > 0.000001f) {
+                        float scale = 1.0f/dmr2;
+                        scale = NK_MIN(100.0f, scale);
+                        dm = nk_vec2_muls(dm, scale);
+                    }
                 }
 
                 dm = nk_vec2_muls(dm, AA_SIZE);
                 temp[i2*2+0] = nk_vec2_add(points[i2], dm);
                 temp[i2*2+1] = nk_vec2_sub(points[i2], dm);
-
-                ids[0] = (nk_draw_index)(idx2 + 0); ids[1] = (nk_draw_index)(idx1+0);
-                ids[2] = (nk_draw_index)(idx1 + 2); ids[3] = (nk_draw_index)(idx1+2);
-                ids[4] = (nk_draw_index)(idx2 + 2); ids[5] = (nk_draw_index)(idx2+0);
-                ids[6] = (nk_draw_index)(idx2 + 1); ids[7] = (nk_draw_index)(idx1+1);
-                ids[8] = (nk_draw_index)(idx1 + 0); ids[9] = (nk_draw_index)(idx1+0);
-                ids[10]= (nk_draw_index)(idx2 + 0); ids[11]= (nk_draw_index)(idx2+1);
-                ids += 12;
-                idx1 = idx2;
             }
 
             /* fill vertices */
             for (i = 0; i < points_count; ++i) {
                 const struct nk_vec2 uv = list->config.null.uv;
-                vtx = nk_draw_vertex(vtx, &list->config, points[i], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*2+0], uv, col_trans);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*2+1], uv, col_trans);
+                vtx = nk_draw_vertex(vtx, list, points[i], uv, col);
+                vtx = nk_draw_vertex(vtx, list, temp[i*2+0], uv, col_trans);
+                vtx = nk_draw_vertex(vtx, list, temp[i*2+1], uv, col_trans);
             }
         } else {
             nk_size idx1, i;
@@ -8742,20 +10665,35 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
                 temp[(points_count-1)*4+3] = nk_vec2_sub(points[points_count-1], d1);
             }
 
-            /* add all elements */
-            idx1 = index;
+            /* add all elements, the last segment of a closed path ends at the first point */
+            {NK_STORAGE const nk_uint pattern[] = {5,1,2,2,6,5,5,1,0,0,4,5,6,2,3,3,7,6};
+            const nk_size segments = closed ? count - 1: count;
+            elements = nk_draw_list_write_strip_elements(list, elements, pattern, 18, index, 4, segments);
+            if (closed) {
+                idx1 = index + segments * 4;
+                for (i = 0; i < 18; ++i)
+                    ids[i] = (nk_uint)((pattern[i] < 4) ? idx1 + pattern[i]: index + pattern[i] - 4);
+                nk_draw_list_write_elements(list, elements, ids, 18);
+            }}
+
+            /* add all normals */
             for (i1 = 0; i1 < count; ++i1) {
                 struct nk_vec2 dm_out, dm_in;
                 const nk_size i2 = ((i1+1) == points_count) ? 0: (i1 + 1);
-                nk_size idx2 = ((i1+1) == points_count) ? index: (idx1 + 4);
 
                 /* average normals */
-                struct nk_vec2 dm = nk_vec2_muls(nk_vec2_add(normals[i1], normals[i2]), 0.5f);
-                float dmr2 = dm.x * dm.x + dm.y* dm.y;
-                if (dmr2 > 0.000001f) {
-                    float scale = 1.0f/dmr2;
-                    scale = NK_MIN(100.0f, scale);
-                    dm = nk_vec2_muls(dm, scale);
+                struct nk_vec2 dm;
+                if (vertex_normals) {
+                    dm = vertex_normals[i2];
+                } else {
+                    float dmr2;
+                    dm = nk_vec2_muls(nk_vec2_add(normals[i1], normals[i2]), 0.5f);
+                    dmr2 = dm.x * dm.x + dm.y* dm.y;
+                    if (dmr2 > 0.000001f) {
+                        float scale = 1.0f/dmr2;
+                        scale = NK_MIN(100.0f, scale);
+                        dm = nk_vec2_muls(dm, scale);
+                    }
                 }
 
                 dm_out = nk_vec2_muls(dm, ((half_inner_thickness) + AA_SIZE));
@@ -8764,28 +10702,15 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
                 temp[i2*4+1] = nk_vec2_add(points[i2], dm_in);
                 temp[i2*4+2] = nk_vec2_sub(points[i2], dm_in);
                 temp[i2*4+3] = nk_vec2_sub(points[i2], dm_out);
-
-                /* add indexes */
-                ids[0] = (nk_draw_index)(idx2 + 1); ids[1] = (nk_draw_index)(idx1+1);
-                ids[2] = (nk_draw_index)(idx1 + 2); ids[3] = (nk_draw_index)(idx1+2);
-                ids[4] = (nk_draw_index)(idx2 + 2); ids[5] = (nk_draw_index)(idx2+1);
-                ids[6] = (nk_draw_index)(idx2 + 1); ids[7] = (nk_draw_index)(idx1+1);
-                ids[8] = (nk_draw_index)(idx1 + 0); ids[9] = (nk_draw_index)(idx1+0);
-                ids[10]= (nk_draw_index)(idx2 + 0); ids[11] = (nk_draw_index)(idx2+1);
-                ids[12]= (nk_draw_index)(idx2 + 2); ids[13] = (nk_draw_index)(idx1+2);
-                ids[14]= (nk_draw_index)(idx1 + 3); ids[15] = (nk_draw_index)(idx1+3);
-                ids[16]= (nk_draw_index)(idx2 + 3); ids[17] = (nk_draw_index)(idx2+2);
-                ids += 18;
-                idx1 = idx2;
             }
 
             /* add vertices */
             for (i = 0; i < points_count; ++i) {
                 const struct nk_vec2 uv = list->config.null.uv;
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+0], uv, col_trans);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+1], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+2], uv, col);
-                vtx = nk_draw_vertex(vtx, &list->config, temp[i*4+3], uv, col_trans);
+                vtx = nk_draw_vertex(vtx, list, temp[i*4+0], uv, col_trans);
+                vtx = nk_draw_vertex(vtx, list, temp[i*4+1], uv, col);
+                vtx = nk_draw_vertex(vtx, list, temp[i*4+2], uv, col);
+                vtx = nk_draw_vertex(vtx, list, temp[i*4+3], uv, col_trans);
             }
         }
         /* free temporary normals + points */
@@ -8793,12 +10718,16 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
     } else {
         /* NON ANTI-ALIASED STROKE */
         nk_size i1 = 0;
-        nk_size idx = list->vertex_count;
+        nk_size idx;
         const nk_size idx_count = count * 6;
         const nk_size vtx_count = count * 4;
-        void *vtx = nk_draw_list_alloc_vertices(list, vtx_count);
-        nk_draw_index *ids = nk_draw_list_alloc_elements(list, idx_count);
-        if (!vtx || !ids) return;
+        void *vtx, *elements;
+        NK_STORAGE const nk_uint quad[] = {0,1,2,0,2,3};
+        if (!nk_draw_list_vertex_index(list, vtx_count, &idx)) return;
+        vtx = nk_draw_list_alloc_vertices(list, vtx_count);
+        elements = nk_draw_list_alloc_elements(list, idx_count);
+        if (!vtx || !elements) return;
+        nk_draw_list_write_strip_elements(list, elements, quad, 6, idx, 4, count);
 
         for (i1 = 0; i1 < count; ++i1) {
             float dx, dy;
@@ -8820,26 +10749,30 @@ nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *p
             dx = diff.x * (thickness * 0.5f);
             dy = diff.y * (thickness * 0.5f);
 
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p1.x + dy, p1.y - dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p2.x + dy, p2.y - dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p2.x - dy, p2.y + dx), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(p1.x - dy, p1.y + dx), uv, col);
-
-            ids[0] = (nk_draw_index)(idx+0); ids[1] = (nk_draw_index)(idx+1);
-            ids[2] = (nk_draw_index)(idx+2); ids[3] = (nk_draw_index)(idx+0);
-            ids[4] = (nk_draw_index)(idx+2); ids[5] = (nk_draw_index)(idx+3);
-
-            ids += 6;
-            idx += 4;
+            vtx = nk_draw_vertex(vtx, list, nk_vec2(p1.x + dy, p1.y - dx), uv, col);
+            vtx = nk_draw_vertex(vtx, list, nk_vec2(p2.x + dy, p2.y - dx), uv, col);
+            vtx = nk_draw_vertex(vtx, list, nk_vec2(p2.x - dy, p2.y + dx), uv, col);
+            vtx = nk_draw_vertex(vtx, list, nk_vec2(p1.x - dy, p1.y + dx), uv, col);
         }
     }
 }
 
 NK_API void
-nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
-    const struct nk_vec2 *points, const unsigned int points_count,
+nk_draw_list_stroke_poly_line(struct nk_draw_list *list, const struct nk_vec2 *points,
+    const unsigned int points_count, struct nk_color color, enum nk_draw_list_stroke closed,
+    float thickness, enum nk_anti_aliasing aliasing)
+{
+    nk_draw_list_stroke_poly(list, points, 0, points_count, color, closed,
+        thickness, aliasing);
+}
+
+NK_INTERN void
+nk_draw_list_fill_poly(struct nk_draw_list *list, const struct nk_vec2 *points,
+    const struct nk_vec2 *vertex_normals, const unsigned int points_count,
     struct nk_color color, enum nk_anti_aliasing aliasing)
 {
+    /* `vertex_normals` optionally holds the averaged normal of each point
+     * to skip computing them */
     struct nk_colorf col;
     struct nk_colorf col_trans;
 
@@ -8858,45 +10791,57 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
     col_trans.a = 0;
 
     if (aliasing == NK_ANTI_ALIASING_ON) {
-        nk_size i = 0;
         nk_size i0 = 0;
         nk_size i1 = 0;
 
         const float AA_SIZE = 1.0f;
         nk_size vertex_offset = 0;
-        nk_size index = list->vertex_count;
+        nk_size index;
 
         const nk_size idx_count = (points_count-2)*3 + points_count*6;
         const nk_size vtx_count = (points_count*2);
 
-        void *vtx = nk_draw_list_alloc_vertices(list, vtx_count);
-        nk_draw_index *ids = nk_draw_list_alloc_elements(list, idx_count);
+        void *vtx, *elements;
+        nk_uint ids[6];
 
         nk_size size = 0;
         struct nk_vec2 *normals = 0;
-        unsigned int vtx_inner_idx = (unsigned int)(index + 0);
-        unsigned int vtx_outer_idx = (unsigned int)(index + 1);
-        if (!vtx || !ids) return;
+        unsigned int vtx_inner_idx;
+        unsigned int vtx_outer_idx;
+        if (!nk_draw_list_vertex_index(list, vtx_count, &index)) return;
+        vtx = nk_draw_list_alloc_vertices(list, vtx_count);
+        elements = nk_draw_list_alloc_elements(list, idx_count);
+        if (!vtx || !elements) return;
+        vtx_inner_idx = (unsigned int)(index + 0);
+        vtx_outer_idx = (unsigned int)(index + 1);
 
         /* temporary allocate normals */
-        vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
-        nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
-        size = pnt_size * points_count;
-        normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
-        NK_ASSERT(normals);
-        if (!normals) return;
-        vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
-
-        /* add elements */
-        for (i = 2; i < points_count; i++) {
-            ids[0] = (nk_draw_index)(vtx_inner_idx);
-            ids[1] = (nk_draw_index)(vtx_inner_idx + ((i-1) << 1));
-            ids[2] = (nk_draw_index)(vtx_inner_idx + (i << 1));
-            ids += 3;
+        if (!vertex_normals) {
+            vertex_offset = (nk_size)((nk_byte*)vtx - (nk_byte*)list->vertices->memory.ptr);
+            nk_buffer_mark(list->vertices, NK_BUFFER_FRONT);
+            size = pnt_size * points_count;
+            normals = (struct nk_vec2*) nk_buffer_alloc(list->vertices, NK_BUFFER_FRONT, size, pnt_align);
+            NK_ASSERT(normals);
+            if (!normals) return;
+            vtx = (void*)((nk_byte*)list->vertices->memory.ptr + vertex_offset);
         }
 
+        /* add elements of the inner fan and of the edges between inner and
+         * outer vertices, starting with the edge that closes the polygon */
+        {NK_STORAGE const nk_uint edge[] = {2,0,1,1,3,2};
+        i0 = points_count-1;
+        elements = nk_draw_list_write_fan_elements(list, elements, vtx_inner_idx, 2, points_count);
+        ids[0] = (nk_uint)(vtx_inner_idx);
+        ids[1] = (nk_uint)(vtx_inner_idx+(i0<<1));
+        ids[2] = (nk_uint)(vtx_outer_idx+(i0<<1));
+        ids[3] = (nk_uint)(vtx_outer_idx+(i0<<1));
+        ids[4] = (nk_uint)(vtx_outer_idx);
+        ids[5] = (nk_uint)(vtx_inner_idx);
+        elements = nk_draw_list_write_elements(list, elements, ids, 6);
+        nk_draw_list_write_strip_elements(list, elements, edge, 6, vtx_inner_idx, 2, points_count-1);}
+
         /* compute normals */
-        for (i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++) {
+        for (i0 = points_count-1, i1 = 0; i1 < points_count && normals; i0 = i1++) {
             struct nk_vec2 p0 = points[i0];
             struct nk_vec2 p1 = points[i1];
             struct nk_vec2 diff = nk_vec2_sub(p1, p0);
@@ -8915,52 +10860,53 @@ nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
         /* add vertices + indexes */
         for (i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++) {
             const struct nk_vec2 uv = list->config.null.uv;
-            struct nk_vec2 n0 = normals[i0];
-            struct nk_vec2 n1 = normals[i1];
-            struct nk_vec2 dm = nk_vec2_muls(nk_vec2_add(n0, n1), 0.5f);
-            float dmr2 = dm.x*dm.x + dm.y*dm.y;
-            if (dmr2 > 0.000001f) {
-                float scale = 1.0f / dmr2;
-                scale = NK_MIN(scale, 100.0f);
-                dm = nk_vec2_muls(dm, scale);
+            struct nk_vec2 dm;
+            if (vertex_normals) {
+                dm = vertex_normals[i1];
+            } else {
+                float dmr2;
+                dm = nk_vec2_muls(nk_vec2_add(normals[i0], normals[i1]), 0.5f);
+                dmr2 = dm.x*dm.x + dm.y*dm.y;
+                if (dmr2 > 0.000001f) {
+                    float scale = 1.0f / dmr2;
+                    scale = NK_MIN(scale, 100.0f);
+                    dm = nk_vec2_muls(dm, scale);
+                }
             }
             dm = nk_vec2_muls(dm, AA_SIZE * 0.5f);
 
             /* add vertices */
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2_sub(points[i1], dm), uv, col);
-            vtx = nk_draw_vertex(vtx, &list->config, nk_vec2_add(points[i1], dm), uv, col_trans);
-
-            /* add indexes */
-            ids[0] = (nk_draw_index)(vtx_inner_idx+(i1<<1));
-            ids[1] = (nk_draw_index)(vtx_inner_idx+(i0<<1));
-            ids[2] = (nk_draw_index)(vtx_outer_idx+(i0<<1));
-            ids[3] = (nk_draw_index)(vtx_outer_idx+(i0<<1));
-            ids[4] = (nk_draw_index)(vtx_outer_idx+(i1<<1));
-            ids[5] = (nk_draw_index)(vtx_inner_idx+(i1<<1));
-            ids += 6;
+            vtx = nk_draw_vertex(vtx, list, nk_vec2_sub(points[i1], dm), uv, col);
+            vtx = nk_draw_vertex(vtx, list, nk_vec2_add(points[i1], dm), uv, col_trans);
         }
         /* free temporary normals + points */
-        nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
+        if (normals)
+            nk_buffer_reset(list->vertices, NK_BUFFER_FRONT);
     } else {
         nk_size i = 0;
-        nk_size index = list->vertex_count;
+        nk_size index;
         const nk_size idx_count = (points_count-2)*3;
         const nk_size vtx_count = points_count;
-        void *vtx = nk_draw_list_alloc_vertices(list, vtx_count);
-        nk_draw_index *ids = nk_draw_list_alloc_elements(list, idx_count);
+        void *vtx, *elements;
 
-        if (!vtx || !ids) return;
+        if (!nk_draw_list_vertex_index(list, vtx_count, &index)) return;
+        vtx = nk_draw_list_alloc_vertices(list, vtx_count);
+        elements = nk_draw_list_alloc_elements(list, idx_count);
+        if (!vtx || !elements) return;
         for (i = 0; i < vtx_count; ++i)
-            vtx = nk_draw_vertex(vtx, &list->config, points[i], list->config.null.uv, col);
-        for (i = 2; i < points_count; ++i) {
-            ids[0] = (nk_draw_index)index;
-            ids[1] = (nk_draw_index)(index+ i - 1);
-            ids[2] = (nk_draw_index)(index+i);
-            ids += 3;
-        }
+            vtx = nk_draw_vertex(vtx, list, points[i], list->config.null.uv, col);
+        nk_draw_list_write_fan_elements(list, elements, index, 1, points_count);
     }
 }
 
+NK_API void
+nk_draw_list_fill_poly_convex(struct nk_draw_list *list,
+    const struct nk_vec2 *points, const unsigned int points_count,
+    struct nk_color color, enum nk_anti_aliasing aliasing)
+{
+    nk_draw_list_fill_poly(list, points, 0, points_count, color, aliasing);
+}
+
 NK_API void
 nk_draw_list_path_clear(struct nk_draw_list *list)
 {
@@ -8971,21 +10917,26 @@ nk_draw_list_path_clear(struct nk_draw_list *list)
     list->path_offset = 0;
 }
 
-NK_API void
-nk_draw_list_path_line_to(struct nk_draw_list *list, struct nk_vec2 pos)
+NK_INTERN struct nk_vec2*
+nk_draw_list_path_reserve(struct nk_draw_list *list, unsigned int count)
 {
-    struct nk_vec2 *points = 0;
     struct nk_draw_command *cmd = 0;
-    NK_ASSERT(list);
-    if (!list) return;
     if (!list->cmd_count)
         nk_draw_list_add_clip(list, nk_null_rect);
 
     cmd = nk_draw_list_command_last(list);
     if (cmd && cmd->texture.ptr != list->config.null.texture.ptr)
         nk_draw_list_push_image(list, list->config.null.texture);
+    return nk_draw_list_alloc_path(list, (int)count);
+}
 
-    points = nk_draw_list_alloc_path(list, 1);
+NK_API void
+nk_draw_list_path_line_to(struct nk_draw_list *list, struct nk_vec2 pos)
+{
+    struct nk_vec2 *points = 0;
+    NK_ASSERT(list);
+    if (!list) return;
+    points = nk_draw_list_path_reserve(list, 1);
     if (!points) return;
     points[0] = pos;
 }
@@ -9129,12 +11080,175 @@ nk_draw_list_path_stroke(struct nk_draw_list *list, struct nk_color color,
     nk_draw_list_path_clear(list);
 }
 
+NK_INTERN const struct nk_vec2*
+nk_draw_list_path_rect_shape(struct nk_draw_list *list, struct nk_vec2 a,
+    struct nk_vec2 b, float rounding)
+{
+    /* adds a rectangle path and returns the cached normals of its points.
+     * Returns null and falls back to `nk_draw_list_path_rect_to` for
+     * rectangles which would not have the same edge directions */
+    float r;
+    unsigned int i = 0;
+    struct nk_vec2 *points;
+    struct nk_vec2 corner[4];
+
+    r = rounding;
+    r = NK_MIN(r, b.x-a.x);
+    r = NK_MIN(r, b.y-a.y);
+    if (list->path_count || !(b.x > a.x) || !(b.y > a.y) || r < 0.0f ||
+        (r > 0.0f && (!(b.x-a.x > 2*r) || !(b.y-a.y > 2*r)))) {
+        nk_draw_list_path_rect_to(list, a, b, rounding);
+        return 0;
+    }
+
+    if (r == 0.0f) {
+        points = nk_draw_list_path_reserve(list, 4);
+        if (!points) return 0;
+        points[0] = a;
+        points[1] = nk_vec2(b.x,a.y);
+        points[2] = b;
+        points[3] = nk_vec2(a.x,b.y);
+        return list->rect_normals;
+    }
+
+    points = nk_draw_list_path_reserve(list, 16);
+    if (!points) return 0;
+    corner[0] = nk_vec2(a.x + r, a.y + r);
+    corner[1] = nk_vec2(b.x - r, a.y + r);
+    corner[2] = nk_vec2(b.x - r, b.y - r);
+    corner[3] = nk_vec2(a.x + r, b.y - r);
+    for (i = 0; i < 16; ++i) {
+        const struct nk_vec2 c = list->circle_vtx[(6 + (i/4)*3 + (i%4)) % NK_LEN(list->circle_vtx)];
+        points[i].x = corner[i/4].x + c.x * r;
+        points[i].y = corner[i/4].y + c.y * r;
+    }
+    return list->rounded_rect_normals;
+}
+
+NK_INTERN const struct nk_vec2*
+nk_draw_list_path_circle_shape(struct nk_draw_list *list, struct nk_vec2 center,
+    float radius, unsigned int segs)
+{
+    /* adds a circle path from the cached outline for its segment count and
+     * returns the cached normals of its points */
+    unsigned int i = 0;
+    struct nk_vec2 *points;
+    struct nk_draw_shape *shape = 0;
+    const float a_max = NK_PI * 2.0f * ((float)segs - 1.0f) / (float)segs;
+
+    if (list->path_count || !(radius > 0.0f) || segs < 3 ||
+        segs + 1 > NK_DRAW_SHAPE_MAX_POINTS) {
+        nk_draw_list_path_arc_to(list, center, radius, 0.0f, a_max, segs);
+        return 0;
+    }
+    for (i = 0; i < NK_LEN(list->circles); ++i) {
+        if (list->circles[i].count == segs + 1)
+            shape = &list->circles[i];
+    }
+    if (!shape) {
+        /* same rotation as `nk_draw_list_path_arc_to` on the unit circle */
+        const float d_angle = a_max / (float)segs;
+        const float sin_d = (float)NK_SIN(d_angle);
+        const float cos_d = (float)NK_COS(d_angle);
+        float cx = 1.0f, cy = 0.0f;
+
+        shape = &list->circles[list->circle_next];
+        list->circle_next = (list->circle_next + 1) % NK_LEN(list->circles);
+        shape->count = segs + 1;
+        for (i = 0; i < shape->count; ++i) {
+            float new_cx, new_cy;
+            shape->points[i] = nk_vec2(cx, cy);
+            new_cx = cx * cos_d - cy * sin_d;
+            new_cy = cy * cos_d + cx * sin_d;
+            cx = new_cx;
+            cy = new_cy;
+        }
+        nk_draw_list_shape_normals(shape->normals, shape->points, shape->count);
+    }
+
+    points = nk_draw_list_path_reserve(list, shape->count);
+    if (!points) return 0;
+    for (i = 0; i < shape->count; ++i) {
+        points[i].x = center.x + shape->points[i].x * radius;
+        points[i].y = center.y + shape->points[i].y * radius;
+    }
+    return shape->normals;
+}
+
+NK_INTERN int
+nk_draw_list_shape_sdf(const struct nk_draw_list *list, enum nk_anti_aliasing aliasing)
+{
+    return list->config.shape_mode == NK_DRAW_SHAPE_SDF && list->vertex_shape &&
+        aliasing == NK_ANTI_ALIASING_ON;
+}
+
+NK_INTERN void
+nk_draw_list_push_shape(struct nk_draw_list *list, struct nk_vec2 center,
+    struct nk_vec2 axis, struct nk_vec2 half, float radius, float thickness,
+    struct nk_color color)
+{
+    /* one quad covering the shape, its stroke and the anti-aliasing fringe.
+     * Texture coordinates hold the position relative to `center` along
+     * `axis` and its normal to evaluate the distance to the shape */
+    struct nk_vec2 ext, u, v;
+    struct nk_colorf col;
+    float shape[4];
+    void *vtx;
+    void *elements;
+    nk_uint idx[6];
+    nk_size index;
+    int i;
+
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    nk_draw_list_push_userdata(list, list->userdata);
+#endif
+    nk_draw_list_push_image(list, list->config.null.texture);
+    if (!nk_draw_list_vertex_index(list, 4, &index)) return;
+    vtx = nk_draw_list_alloc_vertices(list, 4);
+    elements = nk_draw_list_alloc_elements(list, 6);
+    if (!vtx || !elements) return;
+
+    idx[0] = (nk_uint)(index+0); idx[1] = (nk_uint)(index+1);
+    idx[2] = (nk_uint)(index+2); idx[3] = (nk_uint)(index+0);
+    idx[4] = (nk_uint)(index+2); idx[5] = (nk_uint)(index+3);
+    nk_draw_list_write_elements(list, elements, idx, 6);
+
+    color.a = (nk_byte)((float)color.a * list->config.global_alpha);
+    nk_color_fv(&col.r, color);
+    shape[0] = half.x; shape[1] = half.y;
+    shape[2] = radius; shape[3] = thickness;
+    ext.x = half.x + thickness * 0.5f + 1.0f;
+    ext.y = half.y + thickness * 0.5f + 1.0f;
+    u = nk_vec2(axis.x * ext.x, axis.y * ext.x);
+    v = nk_vec2(-axis.y * ext.y, axis.x * ext.y);
+    for (i = 0; i < 4; ++i) {
+        const float sx = (i == 1 || i == 2) ? 1.0f: -1.0f;
+        const float sy = (i >= 2) ? 1.0f: -1.0f;
+        struct nk_vec2 pos;
+        void *dst = vtx;
+        pos.x = center.x + u.x * sx + v.x * sy;
+        pos.y = center.y + u.y * sx + v.y * sy;
+        vtx = nk_draw_vertex(vtx, list, pos, nk_vec2(ext.x * sx, ext.y * sy), col);
+        nk_draw_vertex_shape(dst, list, shape);
+    }
+}
+
 NK_API void
 nk_draw_list_stroke_line(struct nk_draw_list *list, struct nk_vec2 a,
     struct nk_vec2 b, struct nk_color col, float thickness)
 {
     NK_ASSERT(list);
     if (!list || !col.a) return;
+    if (nk_draw_list_shape_sdf(list, list->config.line_AA)) {
+        /* lines are filled rectangles along their direction */
+        struct nk_vec2 d = nk_vec2_sub(b, a);
+        float len = NK_SQRT(d.x*d.x + d.y*d.y);
+        if (len <= 0.0f) return;
+        d = nk_vec2_muls(d, 1.0f/len);
+        nk_draw_list_push_shape(list, nk_vec2((a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f),
+            d, nk_vec2(len * 0.5f, NK_MAX(thickness, 1.0f) * 0.5f), 0, 0, col);
+        return;
+    }
     if (list->line_AA == NK_ANTI_ALIASING_ON) {
         nk_draw_list_path_line_to(list, a);
         nk_draw_list_path_line_to(list, b);
@@ -9149,31 +11263,56 @@ NK_API void
 nk_draw_list_fill_rect(struct nk_draw_list *list, struct nk_rect rect,
     struct nk_color col, float rounding)
 {
+    const struct nk_vec2 *normals;
+    struct nk_vec2 *points;
     NK_ASSERT(list);
     if (!list || !col.a) return;
+    if (nk_draw_list_shape_sdf(list, list->config.shape_AA) && rect.w > 0 && rect.h > 0) {
+        rounding = NK_CLAMP(0.0f, rounding, NK_MIN(rect.w, rect.h) * 0.5f);
+        nk_draw_list_push_shape(list, nk_vec2(rect.x + rect.w * 0.5f, rect.y + rect.h * 0.5f),
+            nk_vec2(1,0), nk_vec2(rect.w * 0.5f, rect.h * 0.5f), rounding, 0, col);
+        return;
+    }
 
     if (list->line_AA == NK_ANTI_ALIASING_ON) {
-        nk_draw_list_path_rect_to(list, nk_vec2(rect.x, rect.y),
+        normals = nk_draw_list_path_rect_shape(list, nk_vec2(rect.x, rect.y),
             nk_vec2(rect.x + rect.w, rect.y + rect.h), rounding);
     } else {
-        nk_draw_list_path_rect_to(list, nk_vec2(rect.x-0.5f, rect.y-0.5f),
+        normals = nk_draw_list_path_rect_shape(list, nk_vec2(rect.x-0.5f, rect.y-0.5f),
             nk_vec2(rect.x + rect.w, rect.y + rect.h), rounding);
-    } nk_draw_list_path_fill(list,  col);
+    }
+    points = (struct nk_vec2*)nk_buffer_memory(list->buffer);
+    nk_draw_list_fill_poly(list, points, normals, list->path_count, col,
+        list->config.shape_AA);
+    nk_draw_list_path_clear(list);
 }
 
 NK_API void
 nk_draw_list_stroke_rect(struct nk_draw_list *list, struct nk_rect rect,
     struct nk_color col, float rounding, float thickness)
 {
+    const struct nk_vec2 *normals;
+    struct nk_vec2 *points;
     NK_ASSERT(list);
     if (!list || !col.a) return;
+    if (nk_draw_list_shape_sdf(list, list->config.line_AA) && rect.w > 0 && rect.h > 0) {
+        rounding = NK_CLAMP(0.0f, rounding, NK_MIN(rect.w, rect.h) * 0.5f);
+        nk_draw_list_push_shape(list, nk_vec2(rect.x + rect.w * 0.5f, rect.y + rect.h * 0.5f),
+            nk_vec2(1,0), nk_vec2(rect.w * 0.5f, rect.h * 0.5f), rounding,
+            NK_MAX(thickness, 1.0f), col);
+        return;
+    }
     if (list->line_AA == NK_ANTI_ALIASING_ON) {
-        nk_draw_list_path_rect_to(list, nk_vec2(rect.x, rect.y),
+        normals = nk_draw_list_path_rect_shape(list, nk_vec2(rect.x, rect.y),
             nk_vec2(rect.x + rect.w, rect.y + rect.h), rounding);
     } else {
-        nk_draw_list_path_rect_to(list, nk_vec2(rect.x-0.5f, rect.y-0.5f),
+        normals = nk_draw_list_path_rect_shape(list, nk_vec2(rect.x-0.5f, rect.y-0.5f),
             nk_vec2(rect.x + rect.w, rect.y + rect.h), rounding);
-    } nk_draw_list_path_stroke(list,  col, NK_STROKE_CLOSED, thickness);
+    }
+    points = (struct nk_vec2*)nk_buffer_memory(list->buffer);
+    nk_draw_list_stroke_poly(list, points, normals, list->path_count, col,
+        NK_STROKE_CLOSED, thickness, list->config.line_AA);
+    nk_draw_list_path_clear(list);
 }
 
 NK_API void
@@ -9184,8 +11323,9 @@ nk_draw_list_fill_rect_multi_color(struct nk_draw_list *list, struct nk_rect rec
     void *vtx;
     struct nk_colorf col_left, col_top;
     struct nk_colorf col_right, col_bottom;
-    nk_draw_index *idx;
-    nk_draw_index index;
+    void *elements;
+    nk_uint idx[6];
+    nk_size index;
 
     nk_color_fv(&col_left.r, left);
     nk_color_fv(&col_right.r, right);
@@ -9196,19 +11336,20 @@ nk_draw_list_fill_rect_multi_color(struct nk_draw_list *list, struct nk_rect rec
     if (!list) return;
 
     nk_draw_list_push_image(list, list->config.null.texture);
-    index = (nk_draw_index)list->vertex_count;
+    if (!nk_draw_list_vertex_index(list, 4, &index)) return;
     vtx = nk_draw_list_alloc_vertices(list, 4);
-    idx = nk_draw_list_alloc_elements(list, 6);
-    if (!vtx || !idx) return;
+    elements = nk_draw_list_alloc_elements(list, 6);
+    if (!vtx || !elements) return;
 
-    idx[0] = (nk_draw_index)(index+0); idx[1] = (nk_draw_index)(index+1);
-    idx[2] = (nk_draw_index)(index+2); idx[3] = (nk_draw_index)(index+0);
-    idx[4] = (nk_draw_index)(index+2); idx[5] = (nk_draw_index)(index+3);
+    idx[0] = (nk_uint)(index+0); idx[1] = (nk_uint)(index+1);
+    idx[2] = (nk_uint)(index+2); idx[3] = (nk_uint)(index+0);
+    idx[4] = (nk_uint)(index+2); idx[5] = (nk_uint)(index+3);
+    nk_draw_list_write_elements(list, elements, idx, 6);
 
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x, rect.y), list->config.null.uv, col_left);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x + rect.w, rect.y), list->config.null.uv, col_top);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x + rect.w, rect.y + rect.h), list->config.null.uv, col_right);
-    vtx = nk_draw_vertex(vtx, &list->config, nk_vec2(rect.x, rect.y + rect.h), list->config.null.uv, col_bottom);
+    vtx = nk_draw_vertex(vtx, list, nk_vec2(rect.x, rect.y), list->config.null.uv, col_left);
+    vtx = nk_draw_vertex(vtx, list, nk_vec2(rect.x + rect.w, rect.y), list->config.null.uv, col_top);
+    vtx = nk_draw_vertex(vtx, list, nk_vec2(rect.x + rect.w, rect.y + rect.h), list->config.null.uv, col_right);
+    vtx = nk_draw_vertex(vtx, list, nk_vec2(rect.x, rect.y + rect.h), list->config.null.uv, col_bottom);
 }
 
 NK_API void
@@ -9239,24 +11380,40 @@ NK_API void
 nk_draw_list_fill_circle(struct nk_draw_list *list, struct nk_vec2 center,
     float radius, struct nk_color col, unsigned int segs)
 {
-    float a_max;
+    const struct nk_vec2 *normals;
+    struct nk_vec2 *points;
     NK_ASSERT(list);
     if (!list || !col.a) return;
-    a_max = NK_PI * 2.0f * ((float)segs - 1.0f) / (float)segs;
-    nk_draw_list_path_arc_to(list, center, radius, 0.0f, a_max, segs);
-    nk_draw_list_path_fill(list, col);
+    if (nk_draw_list_shape_sdf(list, list->config.shape_AA) && radius > 0) {
+        nk_draw_list_push_shape(list, center, nk_vec2(1,0),
+            nk_vec2(radius, radius), radius, 0, col);
+        return;
+    }
+    normals = nk_draw_list_path_circle_shape(list, center, radius, segs);
+    points = (struct nk_vec2*)nk_buffer_memory(list->buffer);
+    nk_draw_list_fill_poly(list, points, normals, list->path_count, col,
+        list->config.shape_AA);
+    nk_draw_list_path_clear(list);
 }
 
 NK_API void
 nk_draw_list_stroke_circle(struct nk_draw_list *list, struct nk_vec2 center,
     float radius, struct nk_color col, unsigned int segs, float thickness)
 {
-    float a_max;
+    const struct nk_vec2 *normals;
+    struct nk_vec2 *points;
     NK_ASSERT(list);
     if (!list || !col.a) return;
-    a_max = NK_PI * 2.0f * ((float)segs - 1.0f) / (float)segs;
-    nk_draw_list_path_arc_to(list, center, radius, 0.0f, a_max, segs);
-    nk_draw_list_path_stroke(list, col, NK_STROKE_CLOSED, thickness);
+    if (nk_draw_list_shape_sdf(list, list->config.line_AA) && radius > 0) {
+        nk_draw_list_push_shape(list, center, nk_vec2(1,0),
+            nk_vec2(radius, radius), radius, NK_MAX(thickness, 1.0f), col);
+        return;
+    }
+    normals = nk_draw_list_path_circle_shape(list, center, radius, segs);
+    points = (struct nk_vec2*)nk_buffer_memory(list->buffer);
+    nk_draw_list_stroke_poly(list, points, normals, list->path_count, col,
+        NK_STROKE_CLOSED, thickness, list->config.line_AA);
+    nk_draw_list_path_clear(list);
 }
 
 NK_API void
@@ -9283,30 +11440,46 @@ nk_draw_list_push_rect_uv(struct nk_draw_list *list, struct nk_vec2 a,
     struct nk_vec2 d;
 
     struct nk_colorf col;
-    nk_draw_index *idx;
-    nk_draw_index index;
+    void *elements;
+    nk_uint idx[6];
+    nk_size index;
     NK_ASSERT(list);
     if (!list) return;
 
+    if (list->config.clipping == NK_DRAW_CLIP_GEOMETRY) {
+        /* cut the quad and its texture coordinates at the clipping rectangle */
+        const struct nk_rect clip = list->clip_rect;
+        struct nk_vec2 p0, p1, uv0 = uva, uv1 = uvc;
+        p0.x = NK_MAX(a.x, clip.x); p0.y = NK_MAX(a.y, clip.y);
+        p1.x = NK_MIN(c.x, clip.x + clip.w); p1.y = NK_MIN(c.y, clip.y + clip.h);
+        if (p0.x >= p1.x || p0.y >= p1.y) return;
+        if (p0.x > a.x) uv0.x = uva.x + (uvc.x - uva.x) * (p0.x - a.x) / (c.x - a.x);
+        if (p0.y > a.y) uv0.y = uva.y + (uvc.y - uva.y) * (p0.y - a.y) / (c.y - a.y);
+        if (p1.x < c.x) uv1.x = uva.x + (uvc.x - uva.x) * (p1.x - a.x) / (c.x - a.x);
+        if (p1.y < c.y) uv1.y = uva.y + (uvc.y - uva.y) * (p1.y - a.y) / (c.y - a.y);
+        a = p0; c = p1; uva = uv0; uvc = uv1;
+    }
+
     nk_color_fv(&col.r, color);
     uvb = nk_vec2(uvc.x, uva.y);
     uvd = nk_vec2(uva.x, uvc.y);
     b = nk_vec2(c.x, a.y);
     d = nk_vec2(a.x, c.y);
 
-    index = (nk_draw_index)list->vertex_count;
+    if (!nk_draw_list_vertex_index(list, 4, &index)) return;
     vtx = nk_draw_list_alloc_vertices(list, 4);
-    idx = nk_draw_list_alloc_elements(list, 6);
-    if (!vtx || !idx) return;
+    elements = nk_draw_list_alloc_elements(list, 6);
+    if (!vtx || !elements) return;
 
-    idx[0] = (nk_draw_index)(index+0); idx[1] = (nk_draw_index)(index+1);
-    idx[2] = (nk_draw_index)(index+2); idx[3] = (nk_draw_index)(index+0);
-    idx[4] = (nk_draw_index)(index+2); idx[5] = (nk_draw_index)(index+3);
+    idx[0] = (nk_uint)(index+0); idx[1] = (nk_uint)(index+1);
+    idx[2] = (nk_uint)(index+2); idx[3] = (nk_uint)(index+0);
+    idx[4] = (nk_uint)(index+2); idx[5] = (nk_uint)(index+3);
+    nk_draw_list_write_elements(list, elements, idx, 6);
 
-    vtx = nk_draw_vertex(vtx, &list->config, a, uva, col);
-    vtx = nk_draw_vertex(vtx, &list->config, b, uvb, col);
-    vtx = nk_draw_vertex(vtx, &list->config, c, uvc, col);
-    vtx = nk_draw_vertex(vtx, &list->config, d, uvd, col);
+    vtx = nk_draw_vertex(vtx, list, a, uva, col);
+    vtx = nk_draw_vertex(vtx, list, b, uvb, col);
+    vtx = nk_draw_vertex(vtx, list, c, uvc, col);
+    vtx = nk_draw_vertex(vtx, list, d, uvd, col);
 }
 
 NK_API void
@@ -9315,6 +11488,18 @@ nk_draw_list_add_image(struct nk_draw_list *list, struct nk_image texture,
 {
     NK_ASSERT(list);
     if (!list) return;
+    if (list->instances) {
+        float r[4], uv[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+        r[0] = rect.x; r[1] = rect.y; r[2] = rect.w; r[3] = rect.h;
+        if (nk_image_is_subimage(&texture)) {
+            uv[0] = (float)texture.region[0]/(float)texture.w;
+            uv[1] = (float)texture.region[1]/(float)texture.h;
+            uv[2] = (float)(texture.region[0] + texture.region[2])/(float)texture.w;
+            uv[3] = (float)(texture.region[1] + texture.region[3])/(float)texture.h;
+        }
+        nk_draw_list_push_instance(list, NK_DRAW_INSTANCE_IMAGE, r, uv, color, texture.handle);
+        return;
+    }
     /* push new command with given texture */
     nk_draw_list_push_image(list, texture.handle);
     if (nk_image_is_subimage(&texture)) {
@@ -9349,7 +11534,8 @@ nk_draw_list_add_text(struct nk_draw_list *list, const struct nk_user_font *font
     if (!NK_INTERSECT(rect.x, rect.y, rect.w, rect.h,
         list->clip_rect.x, list->clip_rect.y, list->clip_rect.w, list->clip_rect.h)) return;
 
-    nk_draw_list_push_image(list, font->texture);
+    if (!list->instances)
+        nk_draw_list_push_image(list, font->texture);
     x = rect.x;
     glyph_len = nk_utf_decode(text, &unicode, len);
     if (!glyph_len) return;
@@ -9371,7 +11557,13 @@ nk_draw_list_add_text(struct nk_draw_list *list, const struct nk_user_font *font
         gy = rect.y + g.offset.y;
         gw = g.width; gh = g.height;
         char_width = g.xadvance;
-        nk_draw_list_push_rect_uv(list, nk_vec2(gx,gy), nk_vec2(gx + gw, gy+ gh),
+        if (list->instances) {
+            float r[4], uv[4];
+            r[0] = gx; r[1] = gy; r[2] = gw; r[3] = gh;
+            uv[0] = g.uv[0].x; uv[1] = g.uv[0].y;
+            uv[2] = g.uv[1].x; uv[3] = g.uv[1].y;
+            nk_draw_list_push_instance(list, NK_DRAW_INSTANCE_GLYPH, r, uv, fg, font->texture);
+        } else nk_draw_list_push_rect_uv(list, nk_vec2(gx,gy), nk_vec2(gx + gw, gy+ gh),
             g.uv[0], g.uv[1], fg);
 
         /* offset next glyph */
@@ -9382,1240 +11574,2362 @@ nk_draw_list_add_text(struct nk_draw_list *list, const struct nk_user_font *font
     }
 }
 
-NK_API nk_flags
-nk_convert(struct nk_context *ctx, struct nk_buffer *cmds,
-    struct nk_buffer *vertices, struct nk_buffer *elements,
-    const struct nk_convert_config *config)
+NK_INTERN nk_flags
+nk_convert_result(const struct nk_draw_list *list)
 {
+    const struct nk_buffer *cmds = list->buffer;
     nk_flags res = NK_CONVERT_SUCCESS;
-    const struct nk_command *cmd;
-    NK_ASSERT(ctx);
-    NK_ASSERT(cmds);
-    NK_ASSERT(vertices);
-    NK_ASSERT(elements);
-    NK_ASSERT(config);
-    NK_ASSERT(config->vertex_layout);
-    NK_ASSERT(config->vertex_size);
-    if (!ctx || !cmds || !vertices || !elements || !config || !config->vertex_layout)
-        return NK_CONVERT_INVALID_PARAM;
+    res |= (cmds->needed > cmds->allocated + (cmds->memory.size - cmds->size)) ? NK_CONVERT_COMMAND_BUFFER_FULL: 0;
+    res |= (list->vertices->needed > list->vertices->allocated) ? NK_CONVERT_VERTEX_BUFFER_FULL: 0;
+    res |= (list->elements->needed > list->elements->allocated) ? NK_CONVERT_ELEMENT_BUFFER_FULL: 0;
+    if (list->instances)
+        res |= (list->instances->needed > list->instances->allocated) ? NK_CONVERT_INSTANCE_BUFFER_FULL: 0;
+    return res;
+}
 
-    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
-        config->line_AA, config->shape_AA);
-    nk_foreach(cmd, ctx)
-    {
-#ifdef NK_INCLUDE_COMMAND_USERDATA
-        ctx->draw_list.userdata = cmd->userdata;
-#endif
-        switch (cmd->type) {
-        case NK_COMMAND_NOP: break;
-        case NK_COMMAND_SCISSOR: {
-            const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
-            nk_draw_list_add_clip(&ctx->draw_list, nk_rect(s->x, s->y, s->w, s->h));
-        } break;
-        case NK_COMMAND_LINE: {
-            const struct nk_command_line *l = (const struct nk_command_line*)cmd;
-            nk_draw_list_stroke_line(&ctx->draw_list, nk_vec2(l->begin.x, l->begin.y),
-                nk_vec2(l->end.x, l->end.y), l->color, l->line_thickness);
-        } break;
-        case NK_COMMAND_CURVE: {
-            const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
-            nk_draw_list_stroke_curve(&ctx->draw_list, nk_vec2(q->begin.x, q->begin.y),
-                nk_vec2(q->ctrl[0].x, q->ctrl[0].y), nk_vec2(q->ctrl[1].x,
-                q->ctrl[1].y), nk_vec2(q->end.x, q->end.y), q->color,
-                config->curve_segment_count, q->line_thickness);
-        } break;
-        case NK_COMMAND_RECT: {
-            const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
-            nk_draw_list_stroke_rect(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->color, (float)r->rounding, r->line_thickness);
-        } break;
-        case NK_COMMAND_RECT_FILLED: {
-            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
-            nk_draw_list_fill_rect(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->color, (float)r->rounding);
-        } break;
-        case NK_COMMAND_RECT_MULTI_COLOR: {
-            const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
-            nk_draw_list_fill_rect_multi_color(&ctx->draw_list, nk_rect(r->x, r->y, r->w, r->h),
-                r->left, r->top, r->right, r->bottom);
-        } break;
-        case NK_COMMAND_CIRCLE: {
-            const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
-            nk_draw_list_stroke_circle(&ctx->draw_list, nk_vec2((float)c->x + (float)c->w/2,
-                (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
-                config->circle_segment_count, c->line_thickness);
-        } break;
-        case NK_COMMAND_CIRCLE_FILLED: {
-            const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-            nk_draw_list_fill_circle(&ctx->draw_list, nk_vec2((float)c->x + (float)c->w/2,
-                (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
-                config->circle_segment_count);
-        } break;
-        case NK_COMMAND_ARC: {
+NK_INTERN float
+nk_convert_circle_segments(float radius, float tolerance)
+{
+    /* a segment with angle `a` deviates r*(1-cos(a/2)) ~ r*a*a/8 from the circle */
+    if (!(radius > 0.0f)) return 0.0f;
+    return NK_PI * NK_SQRT(radius / (2.0f * tolerance));
+}
+
+NK_INTERN unsigned
+nk_convert_segments(const struct nk_convert_config *config, const struct nk_command *cmd)
+{
+    /* number of segments circles, arcs and curves are split into */
+    NK_STORAGE const float max_segments = 512.0f;
+    const float tolerance = config->segment_tolerance;
+    float segs = 0.0f, min_segs = 1.0f;
+    unsigned count;
+
+    switch (cmd->type) {
+    case NK_COMMAND_CIRCLE:
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const float w = (cmd->type == NK_COMMAND_CIRCLE) ?
+            (float)((const struct nk_command_circle*)cmd)->w:
+            (float)((const struct nk_command_circle_filled*)cmd)->w;
+        if (!(tolerance > 0.0f)) return config->circle_segment_count;
+        segs = nk_convert_circle_segments(w/2, tolerance);
+        min_segs = 4.0f;
+    } break;
+    case NK_COMMAND_ARC:
+    case NK_COMMAND_ARC_FILLED: {
+        float r, a0, a1;
+        if (!(tolerance > 0.0f)) return config->arc_segment_count;
+        if (cmd->type == NK_COMMAND_ARC) {
             const struct nk_command_arc *c = (const struct nk_command_arc*)cmd;
-            nk_draw_list_path_line_to(&ctx->draw_list, nk_vec2(c->cx, c->cy));
-            nk_draw_list_path_arc_to(&ctx->draw_list, nk_vec2(c->cx, c->cy), c->r,
-                c->a[0], c->a[1], config->arc_segment_count);
-            nk_draw_list_path_stroke(&ctx->draw_list, c->color, NK_STROKE_CLOSED, c->line_thickness);
-        } break;
-        case NK_COMMAND_ARC_FILLED: {
+            r = (float)c->r; a0 = c->a[0]; a1 = c->a[1];
+        } else {
             const struct nk_command_arc_filled *c = (const struct nk_command_arc_filled*)cmd;
-            nk_draw_list_path_line_to(&ctx->draw_list, nk_vec2(c->cx, c->cy));
-            nk_draw_list_path_arc_to(&ctx->draw_list, nk_vec2(c->cx, c->cy), c->r,
-                c->a[0], c->a[1], config->arc_segment_count);
-            nk_draw_list_path_fill(&ctx->draw_list, c->color);
-        } break;
-        case NK_COMMAND_TRIANGLE: {
-            const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
-            nk_draw_list_stroke_triangle(&ctx->draw_list, nk_vec2(t->a.x, t->a.y),
-                nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color,
-                t->line_thickness);
-        } break;
-        case NK_COMMAND_TRIANGLE_FILLED: {
-            const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
-            nk_draw_list_fill_triangle(&ctx->draw_list, nk_vec2(t->a.x, t->a.y),
-                nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color);
-        } break;
-        case NK_COMMAND_POLYGON: {
-            int i;
-            const struct nk_command_polygon*p = (const struct nk_command_polygon*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
-            }
-            nk_draw_list_path_stroke(&ctx->draw_list, p->color, NK_STROKE_CLOSED, p->line_thickness);
-        } break;
-        case NK_COMMAND_POLYGON_FILLED: {
-            int i;
-            const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
-            }
-            nk_draw_list_path_fill(&ctx->draw_list, p->color);
-        } break;
-        case NK_COMMAND_POLYLINE: {
-            int i;
-            const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
-            for (i = 0; i < p->point_count; ++i) {
-                struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
-                nk_draw_list_path_line_to(&ctx->draw_list, pnt);
-            }
-            nk_draw_list_path_stroke(&ctx->draw_list, p->color, NK_STROKE_OPEN, p->line_thickness);
-        } break;
-        case NK_COMMAND_TEXT: {
-            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
-            nk_draw_list_add_text(&ctx->draw_list, t->font, nk_rect(t->x, t->y, t->w, t->h),
-                t->string, t->length, t->height, t->foreground);
-        } break;
-        case NK_COMMAND_IMAGE: {
-            const struct nk_command_image *i = (const struct nk_command_image*)cmd;
-            nk_draw_list_add_image(&ctx->draw_list, i->img, nk_rect(i->x, i->y, i->w, i->h), i->col);
-        } break;
-        case NK_COMMAND_CUSTOM: {
-            const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
-            c->callback(&ctx->draw_list, c->x, c->y, c->w, c->h, c->callback_data);
-        } break;
-        default: break;
+            r = (float)c->r; a0 = c->a[0]; a1 = c->a[1];
         }
+        segs = nk_convert_circle_segments(r, tolerance);
+        segs *= NK_ABS(a1 - a0) / (2.0f * NK_PI);
+    } break;
+    case NK_COMMAND_CURVE: {
+        /* Wang's formula for cubic bezier curves */
+        const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
+        struct nk_vec2 d0, d1;
+        float m;
+        if (!(tolerance > 0.0f)) return config->curve_segment_count;
+        d0.x = (float)(q->begin.x - 2*q->ctrl[0].x + q->ctrl[1].x);
+        d0.y = (float)(q->begin.y - 2*q->ctrl[0].y + q->ctrl[1].y);
+        d1.x = (float)(q->ctrl[0].x - 2*q->ctrl[1].x + q->end.x);
+        d1.y = (float)(q->ctrl[0].y - 2*q->ctrl[1].y + q->end.y);
+        m = NK_MAX(nk_vec2_len_sqr(d0), nk_vec2_len_sqr(d1));
+        if (m > 0.0f) segs = NK_SQRT(0.75f * NK_SQRT(m) / tolerance);
+    } break;
+    default: return 0;
     }
-    res |= (cmds->needed > cmds->allocated + (cmds->memory.size - cmds->size)) ? NK_CONVERT_COMMAND_BUFFER_FULL: 0;
-    res |= (vertices->needed > vertices->allocated) ? NK_CONVERT_VERTEX_BUFFER_FULL: 0;
-    res |= (elements->needed > elements->allocated) ? NK_CONVERT_ELEMENT_BUFFER_FULL: 0;
-    return res;
+    segs = NK_CLAMP(min_segs, segs, max_segments);
+    count = (unsigned)segs;
+    return ((float)count < segs) ? count + 1: count;
 }
-NK_API const struct nk_draw_command*
-nk__draw_begin(const struct nk_context *ctx,
-    const struct nk_buffer *buffer)
-{return nk__draw_list_begin(&ctx->draw_list, buffer);}
-
-NK_API const struct nk_draw_command*
-nk__draw_end(const struct nk_context *ctx, const struct nk_buffer *buffer)
-{return nk__draw_list_end(&ctx->draw_list, buffer);}
-
-NK_API const struct nk_draw_command*
-nk__draw_next(const struct nk_draw_command *cmd,
-    const struct nk_buffer *buffer, const struct nk_context *ctx)
-{return nk__draw_list_next(cmd, buffer, &ctx->draw_list);}
-
-#endif
-
-/*
- * ==============================================================
- *
- *                          FONT HANDLING
- *
- * ===============================================================
- */
-#ifdef NK_INCLUDE_FONT_BAKING
-/* -------------------------------------------------------------
- *
- *                          RECT PACK
- *
- * --------------------------------------------------------------*/
-/* stb_rect_pack.h - v0.05 - public domain - rectangle packing */
-/* Sean Barrett 2014 */
-#define NK_RP__MAXVAL  0xffff
-typedef unsigned short nk_rp_coord;
-
-struct nk_rp_rect {
-    /* reserved for your use: */
-    int id;
-    /* input: */
-    nk_rp_coord w, h;
-    /* output: */
-    nk_rp_coord x, y;
-    int was_packed;
-    /* non-zero if valid packing */
-}; /* 16 bytes, nominally */
 
-struct nk_rp_node {
-    nk_rp_coord  x,y;
-    struct nk_rp_node  *next;
-};
+NK_INTERN void
+nk_convert_shape(struct nk_draw_list *list, const struct nk_command *cmd)
+{
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+        nk_draw_list_add_clip(list, nk_rect(s->x, s->y, s->w, s->h));
+    } break;
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line*)cmd;
+        nk_draw_list_stroke_line(list, nk_vec2(l->begin.x, l->begin.y),
+            nk_vec2(l->end.x, l->end.y), l->color, l->line_thickness);
+    } break;
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve*)cmd;
+        nk_draw_list_stroke_curve(list, nk_vec2(q->begin.x, q->begin.y),
+            nk_vec2(q->ctrl[0].x, q->ctrl[0].y), nk_vec2(q->ctrl[1].x,
+            q->ctrl[1].y), nk_vec2(q->end.x, q->end.y), q->color,
+            nk_convert_segments(&list->config, cmd), q->line_thickness);
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        nk_draw_list_stroke_rect(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->color, (float)r->rounding, r->line_thickness);
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        nk_draw_list_fill_rect(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->color, (float)r->rounding);
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
+        nk_draw_list_fill_rect_multi_color(list, nk_rect(r->x, r->y, r->w, r->h),
+            r->left, r->top, r->right, r->bottom);
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        nk_draw_list_stroke_circle(list, nk_vec2((float)c->x + (float)c->w/2,
+            (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
+            nk_convert_segments(&list->config, cmd), c->line_thickness);
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+        nk_draw_list_fill_circle(list, nk_vec2((float)c->x + (float)c->w/2,
+            (float)c->y + (float)c->h/2), (float)c->w/2, c->color,
+            nk_convert_segments(&list->config, cmd));
+    } break;
+    case NK_COMMAND_ARC: {
+        const struct nk_command_arc *c = (const struct nk_command_arc*)cmd;
+        nk_draw_list_path_line_to(list, nk_vec2(c->cx, c->cy));
+        nk_draw_list_path_arc_to(list, nk_vec2(c->cx, c->cy), c->r,
+            c->a[0], c->a[1], nk_convert_segments(&list->config, cmd));
+        nk_draw_list_path_stroke(list, c->color, NK_STROKE_CLOSED, c->line_thickness);
+    } break;
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *c = (const struct nk_command_arc_filled*)cmd;
+        nk_draw_list_path_line_to(list, nk_vec2(c->cx, c->cy));
+        nk_draw_list_path_arc_to(list, nk_vec2(c->cx, c->cy), c->r,
+            c->a[0], c->a[1], nk_convert_segments(&list->config, cmd));
+        nk_draw_list_path_fill(list, c->color);
+    } break;
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
+        nk_draw_list_stroke_triangle(list, nk_vec2(t->a.x, t->a.y),
+            nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color,
+            t->line_thickness);
+    } break;
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
+        nk_draw_list_fill_triangle(list, nk_vec2(t->a.x, t->a.y),
+            nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color);
+    } break;
+    case NK_COMMAND_POLYGON: {
+        int i;
+        const struct nk_command_polygon*p = (const struct nk_command_polygon*)cmd;
+        for (i = 0; i < p->point_count; ++i) {
+            struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+            nk_draw_list_path_line_to(list, pnt);
+        }
+        nk_draw_list_path_stroke(list, p->color, NK_STROKE_CLOSED, p->line_thickness);
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        int i;
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+        for (i = 0; i < p->point_count; ++i) {
+            struct nk_vec2 pnt = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+            nk_draw_list_path_line_to(list, pnt);
+        }
+        nk_draw_list_path_fill(list, p->color);
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        int i;
+        const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+        struct nk_vec2 *pnt = nk_draw_list_path_reserve(list, p->point_count);
+        if (!pnt) break;
+        for (i = 0; i < p->point_count; ++i)
+            pnt[i] = nk_vec2((float)p->points[i].x, (float)p->points[i].y);
+        nk_draw_list_path_stroke(list, p->color, NK_STROKE_OPEN, p->line_thickness);
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        nk_draw_list_add_text(list, t->font, nk_rect(t->x, t->y, t->w, t->h),
+            t->string, t->length, t->height, t->foreground);
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+        nk_draw_list_add_image(list, i->img, nk_rect(i->x, i->y, i->w, i->h), i->col);
+    } break;
+    case NK_COMMAND_CUSTOM: {
+        const struct nk_command_custom *c = (const struct nk_command_custom*)cmd;
+        c->callback(list, c->x, c->y, c->w, c->h, c->callback_data);
+    } break;
+    default: break;
+    }
+}
 
-struct nk_rp_context {
-    int width;
-    int height;
-    int align;
-    int init_mode;
-    int heuristic;
-    int num_nodes;
-    struct nk_rp_node *active_head;
-    struct nk_rp_node *free_head;
-    struct nk_rp_node extra[2];
-    /* we allocate two extra nodes so optimal user-node-count is 'width' not 'width+2' */
+struct nk_draw_list_mark {
+    unsigned int vertex_count;
+    unsigned int element_count;
+    unsigned int cmd_count;
+    unsigned int cmd_elem_count;
+    unsigned int cmd_vertex_offset;
+    /* last vertex draw command before the shape */
+    unsigned int list_vertex_offset;
+    nk_size vertices_allocated;
+    nk_size vertices_needed;
+    nk_size elements_allocated;
+    nk_size elements_needed;
+    nk_size commands_size;
+    /* memory used by vertex draw commands at the back of the command buffer */
 };
 
-struct nk_rp__findresult {
-    int x,y;
-    struct nk_rp_node **prev_link;
-};
+NK_INTERN void
+nk_draw_list_mark_shape(struct nk_draw_list *list, struct nk_draw_list_mark *mark)
+{
+    const struct nk_draw_command *cmd = nk_draw_list_command_last(list);
+    mark->vertex_count = list->vertex_count;
+    mark->element_count = list->element_count;
+    mark->cmd_count = list->cmd_count;
+    mark->cmd_elem_count = cmd->elem_count;
+    mark->cmd_vertex_offset = cmd->vertex_offset;
+    mark->list_vertex_offset = list->cmd_vertex_offset;
+    mark->vertices_allocated = list->vertices->allocated;
+    mark->vertices_needed = list->vertices->needed;
+    mark->elements_allocated = list->elements->allocated;
+    mark->elements_needed = list->elements->needed;
+    mark->commands_size = list->buffer->memory.size - list->buffer->size;
+}
 
-enum NK_RP_HEURISTIC {
-    NK_RP_HEURISTIC_Skyline_default=0,
-    NK_RP_HEURISTIC_Skyline_BL_sortHeight = NK_RP_HEURISTIC_Skyline_default,
-    NK_RP_HEURISTIC_Skyline_BF_sortHeight
-};
-enum NK_RP_INIT_STATE{NK_RP__INIT_skyline = 1};
+NK_INTERN struct nk_draw_command*
+nk_draw_list_command_at(struct nk_draw_list *list, unsigned int index)
+{
+    /* vertex draw commands are stored back to front */
+    NK_ASSERT(index < list->cmd_count);
+    return nk_draw_list_command_last(list) + (list->cmd_count - 1 - index);
+}
 
 NK_INTERN void
-nk_rp_setup_allow_out_of_mem(struct nk_rp_context *context, int allow_out_of_mem)
+nk_draw_list_drop_elements(struct nk_draw_list *list, const struct nk_draw_list_mark *mark)
 {
-    if (allow_out_of_mem)
-        /* if it's ok to run out of memory, then don't bother aligning them; */
-        /* this gives better packing, but may fail due to OOM (even though */
-        /* the rectangles easily fit). @TODO a smarter approach would be to only */
-        /* quantize once we've hit OOM, then we could get rid of this parameter. */
-        context->align = 1;
-    else {
-        /* if it's not ok to run out of memory, then quantize the widths */
-        /* so that num_nodes is always enough nodes. */
-        /* */
-        /* I.e. num_nodes * align >= width */
-        /*                  align >= width / num_nodes */
-        /*                  align = ceil(width/num_nodes) */
-        context->align = (context->width + context->num_nodes-1) / context->num_nodes;
+    /* removes all elements and vertex draw commands added since `mark` */
+    struct nk_buffer *buffer = list->buffer;
+    const nk_size size = buffer->memory.size - buffer->size;
+    struct nk_draw_command *cmd;
+    if (size > mark->commands_size) {
+        buffer->size += size - mark->commands_size;
+        buffer->needed -= size - mark->commands_size;
     }
+    list->cmd_count = mark->cmd_count;
+    list->cmd_vertex_offset = mark->list_vertex_offset;
+    cmd = nk_draw_list_command_last(list);
+    cmd->elem_count = mark->cmd_elem_count;
+    cmd->vertex_offset = mark->cmd_vertex_offset;
+    list->element_count = mark->element_count;
+    list->elements->allocated = mark->elements_allocated;
+    list->elements->needed = mark->elements_needed;
+}
+
+NK_INTERN int
+nk_draw_list_clip_contains(struct nk_rect a, struct nk_rect b)
+{
+    return b.x >= a.x && b.y >= a.y && b.x + b.w <= a.x + a.w && b.y + b.h <= a.y + a.h;
 }
 
 NK_INTERN void
-nk_rp_init_target(struct nk_rp_context *context, int width, int height,
-    struct nk_rp_node *nodes, int num_nodes)
+nk_draw_list_clip_command(struct nk_draw_list *list, struct nk_rect clip)
 {
-    int i;
-#ifndef STBRP_LARGE_RECTS
-    NK_ASSERT(width <= 0xffff && height <= 0xffff);
-#endif
+    /* continues with a vertex draw command using `clip` as scissor rectangle */
+    struct nk_draw_command *cmd = nk_draw_list_command_last(list);
+    if (nk_rect_equal(cmd->clip_rect, clip)) return;
+    if (cmd->elem_count || cmd->instance_count) {
+        nk_draw_list_push_command(list, clip, cmd->texture);
+    } else {
+        cmd->clip_rect = clip;
+    #ifdef NK_INCLUDE_COMMAND_USERDATA
+        cmd->userdata = list->userdata;
+    #endif
+    }
+}
 
-    for (i=0; i < num_nodes-1; ++i)
-        nodes[i].next = &nodes[i+1];
-    nodes[i].next = 0;
-    context->init_mode = NK_RP__INIT_skyline;
-    context->heuristic = NK_RP_HEURISTIC_Skyline_default;
-    context->free_head = &nodes[0];
-    context->active_head = &context->extra[0];
-    context->width = width;
-    context->height = height;
-    context->num_nodes = num_nodes;
-    nk_rp_setup_allow_out_of_mem(context, 0);
+struct nk_draw_clip_vertex {
+    struct nk_vec2 pos;
+    struct nk_vec2 uv;
+    float col[4];
+    int index;
+    /* element index of an unchanged vertex or -1 for a new one */
+};
 
-    /* node 0 is the full width, node 1 is the sentinel (lets us not store width explicitly) */
-    context->extra[0].x = 0;
-    context->extra[0].y = 0;
-    context->extra[0].next = &context->extra[1];
-    context->extra[1].x = (nk_rp_coord) width;
-    context->extra[1].y = 65535;
-    context->extra[1].next = 0;
+NK_INTERN int
+nk_draw_list_shape_bounds(struct nk_draw_list *list,
+    const struct nk_draw_list_mark *mark, struct nk_rect *bounds)
+{
+    /* Calculates the bounds of all vertices added since `mark`. Returns
+     * false(0) if vertex positions can not be read back. */
+    const nk_size stride = list->config.vertex_size;
+    const unsigned int n = list->vertex_count - mark->vertex_count;
+    const nk_byte *vtx;
+    const float *pos;
+    struct nk_vec2 min, max;
+    unsigned int i;
+    if (list->vertex_writer == NK_DRAW_VERTEX_GENERIC || !n) return nk_false;
+
+    vtx = (const nk_byte*)nk_buffer_memory(list->vertices) + list->vertices->allocated -
+        stride * n + list->vertex_offset[NK_VERTEX_POSITION];
+    pos = (const float*)(const void*)vtx;
+    min.x = max.x = pos[0];
+    min.y = max.y = pos[1];
+    for (i = 1; i < n; ++i) {
+        pos = (const float*)(const void*)(vtx + stride * i);
+        min.x = NK_MIN(min.x, pos[0]); max.x = NK_MAX(max.x, pos[0]);
+        min.y = NK_MIN(min.y, pos[1]); max.y = NK_MAX(max.y, pos[1]);
+    }
+    *bounds = nk_rect(min.x, min.y, max.x - min.x, max.y - min.y);
+    return nk_true;
 }
 
-/* find minimum y position if it starts at x1 */
 NK_INTERN int
-nk_rp__skyline_find_min_y(struct nk_rp_context *c, struct nk_rp_node *first,
-    int x0, int width, int *pwaste)
+nk_draw_list_clip_polygon(struct nk_draw_clip_vertex *dst,
+    const struct nk_draw_clip_vertex *src, int count, int axis, float limit, float side)
 {
-    struct nk_rp_node *node = first;
-    int x1 = x0 + width;
-    int min_y, visited_width, waste_area;
-    NK_ASSERT(first->x <= x0);
-    NK_UNUSED(c);
-
-    NK_ASSERT(node->next->x > x0);
-    /* we ended up handling this in the caller for efficiency */
-    NK_ASSERT(node->x <= x0);
-
-    min_y = 0;
-    waste_area = 0;
-    visited_width = 0;
-    while (node->x < x1)
-    {
-        if (node->y > min_y) {
-            /* raise min_y higher. */
-            /* we've accounted for all waste up to min_y, */
-            /* but we'll now add more waste for everything we've visited */
-            waste_area += visited_width * (node->y - min_y);
-            min_y = node->y;
-            /* the first time through, visited_width might be reduced */
-            if (node->x < x0)
-            visited_width += node->next->x - x0;
-            else
-            visited_width += node->next->x - node->x;
-        } else {
-            /* add waste area */
-            int under_width = node->next->x - node->x;
-            if (under_width + visited_width > width)
-            under_width = width - visited_width;
-            waste_area += under_width * (min_y - node->y);
-            visited_width += under_width;
+    /* Sutherland-Hodgman: keeps the part of a convex polygon with
+     * `side * (position[axis] - limit) >= 0` and returns its vertex count */
+    int i, j, n = 0;
+    for (i = 0; i < count; ++i) {
+        const struct nk_draw_clip_vertex *a = &src[i];
+        const struct nk_draw_clip_vertex *b = &src[(i + 1) % count];
+        const float da = side * ((axis ? a->pos.y: a->pos.x) - limit);
+        const float db = side * ((axis ? b->pos.y: b->pos.x) - limit);
+        if (da >= 0) dst[n++] = *a;
+        if ((da >= 0) != (db >= 0)) {
+            struct nk_draw_clip_vertex *v = &dst[n++];
+            const float t = da / (da - db);
+            v->pos.x = axis ? a->pos.x + (b->pos.x - a->pos.x) * t: limit;
+            v->pos.y = axis ? limit: a->pos.y + (b->pos.y - a->pos.y) * t;
+            v->uv.x = a->uv.x + (b->uv.x - a->uv.x) * t;
+            v->uv.y = a->uv.y + (b->uv.y - a->uv.y) * t;
+            for (j = 0; j < 4; ++j)
+                v->col[j] = a->col[j] + (b->col[j] - a->col[j]) * t;
+            v->index = -1;
         }
-        node = node->next;
     }
-    *pwaste = waste_area;
-    return min_y;
+    return n;
 }
 
-NK_INTERN struct nk_rp__findresult
-nk_rp__skyline_find_best_pos(struct nk_rp_context *c, int width, int height)
-{
-    int best_waste = (1<<30), best_x, best_y = (1 << 30);
-    struct nk_rp__findresult fr;
-    struct nk_rp_node **prev, *node, *tail, **best = 0;
+NK_INTERN int
+nk_draw_list_clip_triangles(struct nk_draw_list *list, const struct nk_draw_list_mark *mark)
+{
+    /* Cuts every triangle of the last shape at the clipping rectangle. Cut
+     * triangles get new vertices and all elements of the shape are written
+     * again, with 16 bit indices into as many vertex draw commands as the
+     * shape was split into. Returns false(0) without changes if the shape
+     * can not be cut. */
+    const struct nk_rect clip = list->clip_rect;
+    const nk_size stride = list->config.vertex_size;
+    const nk_size max = (nk_size)NK_USHORT_MAX + 1;
+    const unsigned int count = list->element_count - mark->element_count;
+    const int wide = list->config.index_type == NK_DRAW_INDEX_UINT;
+    struct nk_draw_command *cmd;
+    const nk_byte *elements;
+    nk_size begin;
+    nk_uint *ids;
+    nk_uint idx[96];
+    void *dst;
+    unsigned int i, k;
+    int j, written = 0;
 
-    /* align to multiple of c->align */
-    width = (width + c->align - 1);
-    width -= width % c->align;
-    NK_ASSERT(width % c->align == 0);
+    if (list->vertex_writer == NK_DRAW_VERTEX_GENERIC)
+        return nk_false;
 
-    node = c->active_head;
-    prev = &c->active_head;
-    while (node->x + width <= c->width) {
-        int y,waste;
-        y = nk_rp__skyline_find_min_y(c, node, node->x, width, &waste);
-        /* actually just want to test BL */
-        if (c->heuristic == NK_RP_HEURISTIC_Skyline_BL_sortHeight) {
-            /* bottom left */
-            if (y < best_y) {
-            best_y = y;
-            best = prev;
-            }
-        } else {
-            /* best-fit */
-            if (y + height <= c->height) {
-                /* can only use it if it first vertically */
-                if (y < best_y || (y == best_y && waste < best_waste)) {
-                    best_y = y;
-                    best_waste = waste;
-                    best = prev;
-                }
-            }
+    /* copy the elements of the shape as vertex indices into the path memory */
+    ids = (nk_uint*)nk_buffer_alloc(list->buffer, NK_BUFFER_FRONT,
+        sizeof(nk_uint) * count, NK_ALIGNOF(nk_uint));
+    if (!ids) return nk_false;
+    elements = (const nk_byte*)nk_buffer_memory(list->elements) + mark->elements_allocated;
+    for (i = 0, k = mark->cmd_count - 1; k < list->cmd_count; ++k) {
+        unsigned int n;
+        cmd = nk_draw_list_command_at(list, k);
+        n = cmd->elem_count - ((k + 1 == mark->cmd_count) ? mark->cmd_elem_count: 0);
+        for (; n > 0 && i < count; --n, ++i) {
+            if (wide) ids[i] = ((const nk_uint*)(const void*)elements)[i];
+            else ids[i] = ((const nk_draw_index*)(const void*)elements)[i];
+            ids[i] += cmd->vertex_offset;
         }
-        prev = &node->next;
-        node = node->next;
     }
-    best_x = (best == 0) ? 0 : (*best)->x;
+    nk_draw_list_drop_elements(list, mark);
+    cmd = nk_draw_list_command_last(list);
 
-    /* if doing best-fit (BF), we also have to try aligning right edge to each node position */
-    /* */
-    /* e.g, if fitting */
-    /* */
-    /*     ____________________ */
-    /*    |____________________| */
-    /* */
-    /*            into */
-    /* */
-    /*   |                         | */
-    /*   |             ____________| */
-    /*   |____________| */
-    /* */
-    /* then right-aligned reduces waste, but bottom-left BL is always chooses left-aligned */
-    /* */
-    /* This makes BF take about 2x the time */
-    if (c->heuristic == NK_RP_HEURISTIC_Skyline_BF_sortHeight)
-    {
-        tail = c->active_head;
-        node = c->active_head;
-        prev = &c->active_head;
-        /* find first node that's admissible */
-        while (tail->x < width)
-            tail = tail->next;
-        while (tail)
-        {
-            int xpos = tail->x - width;
-            int y,waste;
-            NK_ASSERT(xpos >= 0);
-            /* find the left position that matches this */
-            while (node->next->x <= xpos) {
-                prev = &node->next;
-                node = node->next;
+    begin = list->vertices->allocated - list->vertex_count * stride;
+    for (i = 0; i + 2 < count; i += 3) {
+        struct nk_draw_clip_vertex a[8], b[8];
+        struct nk_draw_clip_vertex *poly = a, *out = b, *swap;
+        const nk_byte *vtx[3];
+        float shape[4];
+        int inside, left = 0, right = 0, above = 0, below = 0;
+        int n = 3;
+        for (j = 0; j < 3; ++j) {
+            const float *pos;
+            vtx[j] = (const nk_byte*)nk_buffer_memory(list->vertices) +
+                begin + ids[i+(unsigned)j] * stride;
+            pos = (const float*)(const void*)(vtx[j] + list->vertex_offset[NK_VERTEX_POSITION]);
+            a[j].pos = nk_vec2(pos[0], pos[1]);
+            a[j].index = (int)ids[i+(unsigned)j];
+            left += pos[0] < clip.x; right += pos[0] > clip.x + clip.w;
+            above += pos[1] < clip.y; below += pos[1] > clip.y + clip.h;
+        }
+        inside = !(left || right || above || below);
+        if (left == 3 || right == 3 || above == 3 || below == 3) continue;
+        if (!inside) {
+            for (j = 0; j < 3; ++j) {
+                const float *uv = (const float*)(const void*)(vtx[j] + list->vertex_offset[NK_VERTEX_TEXCOORD]);
+                const nk_byte *col = vtx[j] + list->vertex_offset[NK_VERTEX_COLOR];
+                a[j].uv = nk_vec2(uv[0], uv[1]);
+                a[j].col[0] = col[0]; a[j].col[1] = col[1];
+                a[j].col[2] = col[2]; a[j].col[3] = col[3];
             }
-            NK_ASSERT(node->next->x > xpos && node->x <= xpos);
-            y = nk_rp__skyline_find_min_y(c, node, xpos, width, &waste);
-            if (y + height < c->height) {
-                if (y <= best_y) {
-                    if (y < best_y || waste < best_waste || (waste==best_waste && xpos < best_x)) {
-                        best_x = xpos;
-                        NK_ASSERT(y <= best_y);
-                        best_y = y;
-                        best_waste = waste;
-                        best = prev;
-                    }
+            if (list->vertex_shape) {
+                /* shape parameters are the same for all vertices of a quad */
+                NK_MEMCPY(shape, vtx[0] + list->vertex_offset[NK_VERTEX_SHAPE], sizeof(shape));
+            }
+            /* only cut at edges of the clipping rectangle which are crossed */
+            if (left) {
+                n = nk_draw_list_clip_polygon(out, poly, n, 0, clip.x, 1.0f);
+                swap = poly; poly = out; out = swap;
+            }
+            if (right) {
+                n = nk_draw_list_clip_polygon(out, poly, n, 0, clip.x + clip.w, -1.0f);
+                swap = poly; poly = out; out = swap;
+            }
+            if (above) {
+                n = nk_draw_list_clip_polygon(out, poly, n, 1, clip.y, 1.0f);
+                swap = poly; poly = out; out = swap;
+            }
+            if (below) {
+                n = nk_draw_list_clip_polygon(out, poly, n, 1, clip.y + clip.h, -1.0f);
+                swap = poly; poly = out; out = swap;
+            }
+        }
+        if (n < 3) continue;
+
+        if (!inside) {
+            /* append the vertices created by cutting the triangle */
+            nk_byte *dst_vtx;
+            nk_uint first = list->vertex_count;
+            int created = 0;
+            for (j = 0; j < n; ++j) {
+                created += poly[j].index < 0;
+                if (poly[j].index >= 0) first = NK_MIN(first, (nk_uint)poly[j].index);
+            }
+            if (!wide && list->vertex_count + (nk_uint)created - first > max) {
+                /* 16 bit indices can not reach back to the remaining vertices */
+                for (j = 0; j < n; ++j) poly[j].index = -1;
+                created = n;
+            }
+            dst_vtx = created ? (nk_byte*)nk_draw_list_alloc_vertices(list, (nk_size)created): 0;
+            if (created && !dst_vtx) break;
+            for (j = 0; j < n; ++j) {
+                float *pos, *uv;
+                nk_byte *col;
+                if (poly[j].index >= 0) continue;
+                poly[j].index = (int)list->vertex_count - created--;
+                NK_MEMSET(dst_vtx, 0, stride);
+                pos = (float*)(void*)(dst_vtx + list->vertex_offset[NK_VERTEX_POSITION]);
+                uv = (float*)(void*)(dst_vtx + list->vertex_offset[NK_VERTEX_TEXCOORD]);
+                col = dst_vtx + list->vertex_offset[NK_VERTEX_COLOR];
+                pos[0] = poly[j].pos.x; pos[1] = poly[j].pos.y;
+                uv[0] = poly[j].uv.x; uv[1] = poly[j].uv.y;
+                col[0] = (nk_byte)(poly[j].col[0] + 0.5f); col[1] = (nk_byte)(poly[j].col[1] + 0.5f);
+                col[2] = (nk_byte)(poly[j].col[2] + 0.5f); col[3] = (nk_byte)(poly[j].col[3] + 0.5f);
+                if (list->vertex_shape)
+                    NK_MEMCPY(dst_vtx + list->vertex_offset[NK_VERTEX_SHAPE], shape, sizeof(shape));
+                dst_vtx += stride;
+            }
+        }
+        if (!wide) {
+            /* start a new vertex draw command if the current one can not
+             * address all vertices of the triangle */
+            nk_uint lo = (nk_uint)poly[0].index, hi = lo;
+            for (j = 1; j < n; ++j) {
+                lo = NK_MIN(lo, (nk_uint)poly[j].index);
+                hi = NK_MAX(hi, (nk_uint)poly[j].index);
+            }
+            if (lo < cmd->vertex_offset || hi - cmd->vertex_offset >= max) {
+                if (written) {
+                    dst = nk_draw_list_alloc_elements(list, (nk_size)written);
+                    if (!dst) break;
+                    nk_draw_list_write_elements(list, dst, idx, written);
+                    written = 0;
                 }
+                list->cmd_vertex_offset = lo;
+                if (cmd->elem_count)
+                    cmd = nk_draw_list_push_command(list, cmd->clip_rect, cmd->texture);
+                else cmd->vertex_offset = lo;
+                if (!cmd) break;
             }
-            tail = tail->next;
+        }
+        if ((nk_size)written + 15 > NK_LEN(idx)) {
+            dst = nk_draw_list_alloc_elements(list, (nk_size)written);
+            if (!dst) break;
+            nk_draw_list_write_elements(list, dst, idx, written);
+            written = 0;
+        }
+        for (j = 2; j < n; ++j) {
+            idx[written++] = (nk_uint)poly[0].index - cmd->vertex_offset;
+            idx[written++] = (nk_uint)poly[j-1].index - cmd->vertex_offset;
+            idx[written++] = (nk_uint)poly[j].index - cmd->vertex_offset;
         }
     }
-    fr.prev_link = best;
-    fr.x = best_x;
-    fr.y = best_y;
-    return fr;
+    if (written) {
+        dst = nk_draw_list_alloc_elements(list, (nk_size)written);
+        if (dst) nk_draw_list_write_elements(list, dst, idx, written);
+    }
+    nk_draw_list_path_clear(list);
+    return nk_true;
 }
 
-NK_INTERN struct nk_rp__findresult
-nk_rp__skyline_pack_rectangle(struct nk_rp_context *context, int width, int height)
-{
-    /* find best position according to heuristic */
-    struct nk_rp__findresult res = nk_rp__skyline_find_best_pos(context, width, height);
-    struct nk_rp_node *node, *cur;
+NK_INTERN void
+nk_draw_list_clip_scissor(struct nk_draw_list *list, const struct nk_draw_list_mark *mark,
+    struct nk_rect scissor)
+{
+    /* uses `scissor` for all vertex draw commands of the last shape. The
+     * elements of the shape are moved into their own vertex draw command if
+     * they share one with previous shapes */
+    struct nk_draw_command *cmd = nk_draw_list_command_at(list, mark->cmd_count - 1);
+    unsigned int i;
+    if (mark->cmd_elem_count && cmd->elem_count > mark->cmd_elem_count &&
+        !nk_rect_equal(cmd->clip_rect, scissor)) {
+        const unsigned int moved = list->cmd_count - mark->cmd_count;
+        struct nk_draw_command *split;
+        split = nk_draw_list_push_command(list, scissor, cmd->texture);
+        if (!split) return;
+        /* commands are stored back to front so later ones move down */
+        cmd = nk_draw_list_command_at(list, mark->cmd_count - 1);
+        split = cmd - 1;
+        for (i = moved; i > 0; --i)
+            split[-(int)i] = split[-(int)i + 1];
+        *split = *cmd;
+        split->elem_count = cmd->elem_count - mark->cmd_elem_count;
+        split->instance_offset = cmd->instance_offset + cmd->instance_count;
+        split->instance_count = 0;
+        cmd->elem_count = mark->cmd_elem_count;
+    }
+    for (i = mark->cmd_count - 1; i < list->cmd_count; ++i) {
+        cmd = nk_draw_list_command_at(list, i);
+        if (i + 1 == mark->cmd_count && mark->cmd_elem_count) continue;
+        cmd->clip_rect = scissor;
+    }
+}
 
-    /* bail if: */
-    /*    1. it failed */
-    /*    2. the best node doesn't fit (we don't always check this) */
-    /*    3. we're out of memory */
-    if (res.prev_link == 0 || res.y + height > context->height || context->free_head == 0) {
-        res.prev_link = 0;
-        return res;
+NK_INTERN void
+nk_draw_list_clip_shape(struct nk_draw_list *list, const struct nk_draw_list_mark *mark)
+{
+    /* Drops the last shape if it is outside of the clipping rectangle and
+     * cuts it if it crosses it. The scissor rectangle of the vertex draw
+     * commands is only used for shapes which can not be cut. */
+    const struct nk_rect clip = list->clip_rect;
+    struct nk_rect scissor = clip;
+    struct nk_rect bounds;
+    unsigned int i;
+    if (list->element_count == mark->element_count) return;
+
+    if (nk_draw_list_shape_bounds(list, mark, &bounds)) {
+        if (bounds.x + bounds.w <= clip.x || bounds.y + bounds.h <= clip.y ||
+            bounds.x >= clip.x + clip.w || bounds.y >= clip.y + clip.h) {
+            /* not visible at all */
+            nk_draw_list_drop_elements(list, mark);
+            list->vertex_count = mark->vertex_count;
+            list->vertices->allocated = mark->vertices_allocated;
+            list->vertices->needed = mark->vertices_needed;
+            return;
+        }
+        if (!nk_draw_list_clip_contains(clip, bounds) && nk_draw_list_clip_triangles(list, mark)) {
+            bounds = clip;
+            if (list->element_count == mark->element_count) return;
+        }
+        if (nk_draw_list_clip_contains(clip, bounds)) {
+            for (i = mark->cmd_count - 1; i < list->cmd_count; ++i) {
+                const struct nk_draw_command *cmd = nk_draw_list_command_at(list, i);
+                if (!nk_draw_list_clip_contains(cmd->clip_rect, bounds)) break;
+            }
+            if (i == list->cmd_count) return;
+            scissor = nk_null_rect;
+        }
     }
+    nk_draw_list_clip_scissor(list, mark, scissor);
+}
 
-    /* on success, create new node */
-    node = context->free_head;
-    node->x = (nk_rp_coord) res.x;
-    node->y = (nk_rp_coord) (res.y + height);
+NK_INTERN void
+nk_convert_command(struct nk_draw_list *list, const struct nk_command *cmd)
+{
+    struct nk_draw_list_mark mark;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    list->userdata = cmd->userdata;
+#endif
+    if (list->config.clipping != NK_DRAW_CLIP_GEOMETRY ||
+        cmd->type == NK_COMMAND_NOP || cmd->type == NK_COMMAND_SCISSOR) {
+        nk_convert_shape(list, cmd);
+        return;
+    }
+    if (!list->cmd_count)
+        nk_draw_list_push_command(list, nk_null_rect, list->config.null.texture);
+    if (!list->cmd_count) return;
+
+    switch (cmd->type) {
+    case NK_COMMAND_TEXT:
+    case NK_COMMAND_IMAGE:
+        /* quads are cut at the clipping rectangle */
+        if (!nk_draw_list_clip_contains(nk_draw_list_command_last(list)->clip_rect, list->clip_rect))
+            nk_draw_list_clip_command(list, nk_null_rect);
+        nk_convert_shape(list, cmd);
+        return;
+    case NK_COMMAND_CUSTOM:
+        /* callbacks may draw anything and rely on the scissor rectangle */
+        nk_draw_list_clip_command(list, list->clip_rect);
+        nk_convert_shape(list, cmd);
+        return;
+    default: break;
+    }
+    nk_draw_list_mark_shape(list, &mark);
+    nk_convert_shape(list, cmd);
+    nk_draw_list_clip_shape(list, &mark);
+}
 
-    context->free_head = node->next;
+NK_INTERN void
+nk_convert_stats(struct nk_context *ctx, nk_size grows)
+{
+    /* `grows` holds the buffer grow count before converting */
+    const struct nk_draw_list *list = &ctx->draw_list;
+    struct nk_context_stats *stats = &ctx->stats;
+    stats->vertices = list->vertex_count;
+    stats->elements = list->element_count;
+    stats->draw_commands = list->cmd_count;
+    stats->instances = list->instance_count;
+    stats->vertices_peak = NK_MAX(stats->vertices_peak, stats->vertices);
+    stats->elements_peak = NK_MAX(stats->elements_peak, stats->elements);
+    stats->draw_commands_peak = NK_MAX(stats->draw_commands_peak, stats->draw_commands);
+    stats->convert_grows += list->buffer->grows + list->vertices->grows +
+        list->elements->grows - grows;
+}
 
-    /* insert the new node into the right starting point, and */
-    /* let 'cur' point to the remaining nodes needing to be */
-    /* stitched back in */
-    cur = *res.prev_link;
-    if (cur->x < res.x) {
-        /* preserve the existing one, so start testing with the next one */
-        struct nk_rp_node *next = cur->next;
-        cur->next = node;
-        cur = next;
-    } else {
-        *res.prev_link = node;
-    }
+NK_API nk_flags
+nk_convert(struct nk_context *ctx, struct nk_buffer *cmds,
+    struct nk_buffer *vertices, struct nk_buffer *elements,
+    const struct nk_convert_config *config)
+{
+    nk_flags res = NK_CONVERT_SUCCESS;
+    const struct nk_command *cmd;
+    nk_size grows;
+    NK_ASSERT(ctx);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+        return NK_CONVERT_INVALID_PARAM;
 
-    /* from here, traverse cur and free the nodes, until we get to one */
-    /* that shouldn't be freed */
-    while (cur->next && cur->next->x <= res.x + width) {
-        struct nk_rp_node *next = cur->next;
-        /* move the current node to the free list */
-        cur->next = context->free_head;
-        context->free_head = cur;
-        cur = next;
-    }
-    /* stitch the list back in */
-    node->next = cur;
+    grows = cmds->grows + vertices->grows + elements->grows;
+    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+        config->line_AA, config->shape_AA);
+    nk_foreach(cmd, ctx)
+        nk_convert_command(&ctx->draw_list, cmd);
+    res |= nk_convert_result(&ctx->draw_list);
 
-    if (cur->x < res.x + width)
-        cur->x = (nk_rp_coord) (res.x + width);
+    nk_convert_stats(ctx, grows);
     return res;
 }
 
-NK_INTERN int
-nk_rect_height_compare(const void *a, const void *b)
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_convert_task_init_default(struct nk_convert_task *task)
 {
-    const struct nk_rp_rect *p = (const struct nk_rp_rect *) a;
-    const struct nk_rp_rect *q = (const struct nk_rp_rect *) b;
-    if (p->h > q->h)
-        return -1;
-    if (p->h < q->h)
-        return  1;
-    return (p->w > q->w) ? -1 : (p->w < q->w);
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_convert_task_init(task, &alloc);
 }
+#endif
 
-NK_INTERN int
-nk_rect_original_order(const void *a, const void *b)
+NK_API void
+nk_convert_task_init(struct nk_convert_task *task, const struct nk_allocator *alloc)
 {
-    const struct nk_rp_rect *p = (const struct nk_rp_rect *) a;
-    const struct nk_rp_rect *q = (const struct nk_rp_rect *) b;
-    return (p->was_packed < q->was_packed) ? -1 : (p->was_packed > q->was_packed);
+    NK_ASSERT(task);
+    NK_ASSERT(alloc);
+    if (!task || !alloc) return;
+    nk_zero(task, sizeof(*task));
+    nk_draw_list_init(&task->list);
+    nk_buffer_init(&task->cmds, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&task->vertices, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&task->elements, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
 }
 
-NK_INTERN void
-nk_rp_qsort(struct nk_rp_rect *array, unsigned int len, int(*cmp)(const void*,const void*))
+NK_API void
+nk_convert_task_free(struct nk_convert_task *task)
 {
-    /* iterative quick sort */
-    #define NK_MAX_SORT_STACK 64
-    unsigned right, left = 0, stack[NK_MAX_SORT_STACK], pos = 0;
-    unsigned seed = len/2 * 69069+1;
-    for (;;) {
-        for (; left+1 < len; len++) {
-            struct nk_rp_rect pivot, tmp;
-            if (pos == NK_MAX_SORT_STACK) len = stack[pos = 0];
-            pivot = array[left+seed%(len-left)];
-            seed = seed * 69069 + 1;
-            stack[pos++] = len;
-            for (right = left-1;;) {
-                while (cmp(&array[++right], &pivot) < 0);
-                while (cmp(&pivot, &array[--len]) < 0);
-                if (right >= len) break;
-                tmp = array[right];
-                array[right] = array[len];
-                array[len] = tmp;
-            }
-        }
-        if (pos == 0) break;
-        left = len;
-        len = stack[--pos];
+    NK_ASSERT(task);
+    if (!task) return;
+    nk_buffer_free(&task->cmds);
+    nk_buffer_free(&task->vertices);
+    nk_buffer_free(&task->elements);
+}
+
+NK_INTERN nk_size
+nk_convert_cost(const struct nk_command *cmd, const struct nk_convert_config *config)
+{
+    /* rough number of vertices a draw command is tessellated into */
+    switch (cmd->type) {
+    case NK_COMMAND_NOP:
+    case NK_COMMAND_SCISSOR: return 1;
+    case NK_COMMAND_CURVE:
+    case NK_COMMAND_CIRCLE:
+    case NK_COMMAND_CIRCLE_FILLED:
+    case NK_COMMAND_ARC:
+    case NK_COMMAND_ARC_FILLED: return nk_convert_segments(config, cmd) * 3;
+    case NK_COMMAND_POLYGON:
+    case NK_COMMAND_POLYGON_FILLED:
+    case NK_COMMAND_POLYLINE:
+        return (nk_size)((const struct nk_command_polygon*)cmd)->point_count * 3;
+    case NK_COMMAND_TEXT: return (nk_size)((const struct nk_command_text*)cmd)->length * 4;
+    default: return 8;
     }
-    #undef NK_MAX_SORT_STACK
 }
 
-NK_INTERN void
-nk_rp_pack_rects(struct nk_rp_context *context, struct nk_rp_rect *rects, int num_rects)
+NK_API int
+nk_convert_begin(struct nk_context *ctx, struct nk_convert_task *tasks, int count,
+    const struct nk_convert_config *config)
 {
-    int i;
-    /* we use the 'was_packed' field internally to allow sorting/unsorting */
-    for (i=0; i < num_rects; ++i) {
-        rects[i].was_packed = i;
-    }
+    const struct nk_command *cmd;
+    struct nk_convert_task *task = 0;
+    struct nk_rect clip = nk_null_rect;
+    nk_size total = 0, done = 0;
+    int used = 0;
 
-    /* sort according to heuristic */
-    nk_rp_qsort(rects, (unsigned)num_rects, nk_rect_height_compare);
+    NK_ASSERT(ctx);
+    NK_ASSERT(tasks);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !tasks || count <= 0 || !config || !config->vertex_layout)
+        return 0;
 
-    for (i=0; i < num_rects; ++i) {
-        struct nk_rp__findresult fr = nk_rp__skyline_pack_rectangle(context, rects[i].w, rects[i].h);
-        if (fr.prev_link) {
-            rects[i].x = (nk_rp_coord) fr.x;
-            rects[i].y = (nk_rp_coord) fr.y;
-        } else {
-            rects[i].x = rects[i].y = NK_RP__MAXVAL;
+    /* split the draw command list at about the same tessellation cost */
+    nk_foreach(cmd, ctx)
+        total += nk_convert_cost(cmd, config);
+    nk_foreach(cmd, ctx) {
+        if (used < count && done >= total / (nk_size)count * (nk_size)used) {
+            task = &tasks[used++];
+            nk_draw_list_setup(&task->list, config, &task->cmds, &task->vertices,
+                &task->elements, config->line_AA, config->shape_AA);
+            task->begin = cmd;
+            task->count = 0;
+            task->clip = clip;
+        }
+        if (cmd->type == NK_COMMAND_SCISSOR) {
+            const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+            clip = nk_rect(s->x, s->y, s->w, s->h);
         }
+        done += nk_convert_cost(cmd, config);
+        task->count++;
     }
+    if (!used) {
+        /* frame without draw commands */
+        task = &tasks[used++];
+        nk_draw_list_setup(&task->list, config, &task->cmds, &task->vertices,
+            &task->elements, config->line_AA, config->shape_AA);
+        task->begin = 0;
+        task->count = 0;
+        task->clip = clip;
+    }
+    return used;
+}
 
-    /* unsort */
-    nk_rp_qsort(rects, (unsigned)num_rects, nk_rect_original_order);
+NK_API nk_flags
+nk_convert_task(const struct nk_context *ctx, struct nk_convert_task *task)
+{
+    const struct nk_command *cmd;
+    nk_size i;
+    NK_ASSERT(ctx);
+    NK_ASSERT(task);
+    if (!ctx || !task)
+        return NK_CONVERT_INVALID_PARAM;
 
-    /* set was_packed flags */
-    for (i=0; i < num_rects; ++i)
-        rects[i].was_packed = !(rects[i].x == NK_RP__MAXVAL && rects[i].y == NK_RP__MAXVAL);
+    /* continue with the scissor rectangle of the previous task */
+    nk_draw_list_clear(&task->list);
+    task->list.vertices = &task->vertices;
+    task->list.elements = &task->elements;
+    nk_draw_list_add_clip(&task->list, task->clip);
+
+    cmd = task->begin;
+    for (i = 0; i < task->count && cmd; ++i) {
+        nk_convert_command(&task->list, cmd);
+        if (i + 1 == task->count) break;
+        cmd = (const struct nk_command*)nk_buffer_at(&ctx->memory, cmd->next);
+    }
+    return nk_convert_result(&task->list);
 }
 
-/*
- * ==============================================================
- *
- *                          TRUETYPE
- *
- * ===============================================================
- */
-/* stb_truetype.h - v1.07 - public domain */
-#define NK_TT_MAX_OVERSAMPLE   8
-#define NK_TT__OVER_MASK  (NK_TT_MAX_OVERSAMPLE-1)
+struct nk_convert_span {
+    const struct nk_draw_command *commands;
+    /* vertex draw commands stored back to front like in a draw list */
+    unsigned int command_count;
+    const void *elements;
+    unsigned int element_count;
+    const void *vertices;
+    unsigned int vertex_count;
+};
 
-struct nk_tt_bakedchar {
-    unsigned short x0,y0,x1,y1;
-    /* coordinates of bbox in bitmap */
-    float xoff,yoff,xadvance;
-};
-
-struct nk_tt_aligned_quad{
-    float x0,y0,s0,t0; /* top-left */
-    float x1,y1,s1,t1; /* bottom-right */
-};
-
-struct nk_tt_packedchar {
-    unsigned short x0,y0,x1,y1;
-    /* coordinates of bbox in bitmap */
-    float xoff,yoff,xadvance;
-    float xoff2,yoff2;
-};
-
-struct nk_tt_pack_range {
-    float font_size;
-    int first_unicode_codepoint_in_range;
-    /* if non-zero, then the chars are continuous, and this is the first codepoint */
-    int *array_of_unicode_codepoints;
-    /* if non-zero, then this is an array of unicode codepoints */
-    int num_chars;
-    struct nk_tt_packedchar *chardata_for_range; /* output */
-    unsigned char h_oversample, v_oversample;
-    /* don't set these, they're used internally */
-};
-
-struct nk_tt_pack_context {
-    void *pack_info;
-    int   width;
-    int   height;
-    int   stride_in_bytes;
-    int   padding;
-    unsigned int   h_oversample, v_oversample;
-    unsigned char *pixels;
-    void  *nodes;
-};
+NK_INTERN void
+nk_convert_task_span(const struct nk_convert_task *task, struct nk_convert_span *span)
+{
+    /* output of a task without the vertices and elements of earlier tasks */
+    const struct nk_draw_list *list = &task->list;
+    nk_size index_size = (list->config.index_type == NK_DRAW_INDEX_UINT) ?
+        sizeof(nk_uint): sizeof(nk_draw_index);
+    span->commands = nk__draw_list_end(list, &task->cmds);
+    span->command_count = list->cmd_count;
+    span->element_count = list->element_count;
+    span->elements = (const nk_byte*)nk_buffer_memory_const(&task->elements) +
+        task->elements.allocated - index_size * list->element_count;
+    span->vertex_count = list->vertex_count;
+    span->vertices = (const nk_byte*)nk_buffer_memory_const(&task->vertices) +
+        task->vertices.allocated - list->config.vertex_size * list->vertex_count;
+}
 
-struct nk_tt_fontinfo {
-    const unsigned char* data; /* pointer to .ttf file */
-    int fontstart;/* offset of start of font */
-    int numGlyphs;/* number of glyphs, needed for range checking */
-    int loca,head,glyf,hhea,hmtx,kern; /* table locations as offset from start of .ttf */
-    int index_map; /* a cmap mapping for our chosen character encoding */
-    int indexToLocFormat; /* format needed to map from glyph index to glyph */
-};
+NK_INTERN int
+nk_convert_join(struct nk_draw_list *list, const struct nk_convert_span *src,
+    struct nk_draw_command **out)
+{
+    /* append vertex draw commands with indices moved behind the vertices
+     * already in `list`. 16 bit indices keep using a base vertex for as
+     * long as all vertices up to the end of the span stay addressable.
+     * Base vertices of the span are not ordered since clipped shapes can
+     * drop back to an earlier one */
+    const void *src_ids = src->elements;
+    nk_size size, offset = 0;
+    unsigned int vertex_count, i;
+    void *vtx, *ids;
+
+    if (!src->vertex_count) return nk_true;
+    vertex_count = list->vertex_count;
+    vtx = nk_draw_list_alloc_vertices(list, src->vertex_count);
+    if (!vtx) return nk_false;
+    list->vertex_count = vertex_count;
+    NK_MEMCPY(vtx, src->vertices, list->config.vertex_size * src->vertex_count);
+
+    size = (list->config.index_type == NK_DRAW_INDEX_UINT) ? sizeof(nk_uint): sizeof(nk_draw_index);
+    for (i = src->command_count; i > 0; --i) {
+        const struct nk_draw_command *cmd = &src->commands[i-1];
+        nk_size base = list->vertex_count + cmd->vertex_offset;
+        nk_size k;
+        if (!cmd->elem_count) continue;
+        if (*out && (base < (*out)->vertex_offset ||
+            (list->config.index_type == NK_DRAW_INDEX_USHORT &&
+            list->vertex_count + src->vertex_count - (*out)->vertex_offset > (nk_size)NK_USHORT_MAX + 1)))
+            *out = 0;
+        if (!*out || (*out)->texture.id != cmd->texture.id ||
+            (*out)->clip_rect.x != cmd->clip_rect.x || (*out)->clip_rect.y != cmd->clip_rect.y ||
+            (*out)->clip_rect.w != cmd->clip_rect.w || (*out)->clip_rect.h != cmd->clip_rect.h
+        #ifdef NK_INCLUDE_COMMAND_USERDATA
+            || (*out)->userdata.id != cmd->userdata.id
+        #endif
+        ) {
+            nk_size vertex_offset = (*out) ? (*out)->vertex_offset: 0;
+            if (list->config.index_type == NK_DRAW_INDEX_USHORT &&
+                list->vertex_count + src->vertex_count - vertex_offset > (nk_size)NK_USHORT_MAX + 1)
+                vertex_offset = base;
+        #ifdef NK_INCLUDE_COMMAND_USERDATA
+            list->userdata = cmd->userdata;
+        #endif
+            list->cmd_vertex_offset = (unsigned int)vertex_offset;
+            *out = nk_draw_list_push_command(list, cmd->clip_rect, cmd->texture);
+            if (!*out) return nk_false;
+        }
+        ids = nk_draw_list_alloc_elements(list, cmd->elem_count);
+        if (!ids) return nk_false;
+        base -= (*out)->vertex_offset;
+        if (!base) {
+            NK_MEMCPY(ids, (const nk_byte*)src_ids + offset * size, cmd->elem_count * size);
+        } else if (list->config.index_type == NK_DRAW_INDEX_UINT) {
+            const nk_uint *from = (const nk_uint*)src_ids + offset;
+            for (k = 0; k < cmd->elem_count; ++k)
+                ((nk_uint*)ids)[k] = from[k] + (nk_uint)base;
+        } else {
+            const nk_draw_index *from = (const nk_draw_index*)src_ids + offset;
+            for (k = 0; k < cmd->elem_count; ++k)
+                ((nk_draw_index*)ids)[k] = (nk_draw_index)(from[k] + base);
+        }
+        offset += cmd->elem_count;
+    }
+    list->vertex_count += src->vertex_count;
+    return nk_true;
+}
 
-enum {
-  NK_TT_vmove=1,
-  NK_TT_vline,
-  NK_TT_vcurve
-};
+NK_API nk_flags
+nk_convert_end(struct nk_context *ctx, struct nk_buffer *cmds,
+    struct nk_buffer *vertices, struct nk_buffer *elements,
+    const struct nk_convert_task *tasks, int count)
+{
+    nk_flags res = NK_CONVERT_SUCCESS;
+    struct nk_draw_command *out = 0;
+    const struct nk_convert_config *config;
+    nk_size grows;
+    int i;
 
-struct nk_tt_vertex {
-    short x,y,cx,cy;
-    unsigned char type,padding;
-};
+    NK_ASSERT(ctx);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(tasks);
+    NK_ASSERT(count > 0);
+    if (!ctx || !cmds || !vertices || !elements || !tasks || count <= 0)
+        return NK_CONVERT_INVALID_PARAM;
 
-struct nk_tt__bitmap{
-   int w,h,stride;
-   unsigned char *pixels;
-};
+    config = &tasks[0].list.config;
+    grows = cmds->grows + vertices->grows + elements->grows;
+    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+        config->line_AA, config->shape_AA);
+    for (i = 0; i < count; ++i)
+        res |= nk_convert_result(&tasks[i].list);
+    for (i = 0; i < count; ++i) {
+        struct nk_convert_span span;
+        nk_convert_task_span(&tasks[i], &span);
+        if (!nk_convert_join(&ctx->draw_list, &span, &out)) break;
+    }
+    res |= nk_convert_result(&ctx->draw_list);
+    nk_convert_stats(ctx, grows);
+    return res;
+}
 
-struct nk_tt__hheap_chunk {
-    struct nk_tt__hheap_chunk *next;
-};
-struct nk_tt__hheap {
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_convert_cache_init_default(struct nk_convert_cache *cache)
+{
     struct nk_allocator alloc;
-    struct nk_tt__hheap_chunk *head;
-    void   *first_free;
-    int    num_remaining_in_head_chunk;
-};
-
-struct nk_tt__edge {
-    float x0,y0, x1,y1;
-    int invert;
-};
-
-struct nk_tt__active_edge {
-    struct nk_tt__active_edge *next;
-    float fx,fdx,fdy;
-    float direction;
-    float sy;
-    float ey;
-};
-struct nk_tt__point {float x,y;};
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_convert_cache_init(cache, &alloc);
+}
+#endif
 
-#define NK_TT_MACSTYLE_DONTCARE     0
-#define NK_TT_MACSTYLE_BOLD         1
-#define NK_TT_MACSTYLE_ITALIC       2
-#define NK_TT_MACSTYLE_UNDERSCORE   4
-#define NK_TT_MACSTYLE_NONE         8
-/* <= not same as 0, this makes us check the bitfield is 0 */
+NK_API void
+nk_convert_cache_init(struct nk_convert_cache *cache, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(cache);
+    NK_ASSERT(alloc);
+    if (!cache || !alloc) return;
+    nk_zero(cache, sizeof(*cache));
+    nk_convert_task_init(&cache->task, alloc);
+    cache->alloc = *alloc;
+}
 
-enum { /* platformID */
-   NK_TT_PLATFORM_ID_UNICODE   =0,
-   NK_TT_PLATFORM_ID_MAC       =1,
-   NK_TT_PLATFORM_ID_ISO       =2,
-   NK_TT_PLATFORM_ID_MICROSOFT =3
-};
+NK_API void
+nk_convert_cache_clear(struct nk_convert_cache *cache)
+{
+    int i;
+    NK_ASSERT(cache);
+    if (!cache) return;
+    for (i = 0; i < NK_CONVERT_CACHE_WINDOWS; ++i)
+        cache->windows[i].valid = nk_false;
+}
 
-enum { /* encodingID for NK_TT_PLATFORM_ID_UNICODE */
-   NK_TT_UNICODE_EID_UNICODE_1_0    =0,
-   NK_TT_UNICODE_EID_UNICODE_1_1    =1,
-   NK_TT_UNICODE_EID_ISO_10646      =2,
-   NK_TT_UNICODE_EID_UNICODE_2_0_BMP=3,
-   NK_TT_UNICODE_EID_UNICODE_2_0_FULL=4
-};
+NK_API void
+nk_convert_cache_free(struct nk_convert_cache *cache)
+{
+    int i;
+    NK_ASSERT(cache);
+    if (!cache) return;
+    for (i = 0; i < NK_CONVERT_CACHE_WINDOWS; ++i) {
+        struct nk_convert_window *win = &cache->windows[i];
+        if (win->memory) cache->alloc.free(cache->alloc.userdata, win->memory);
+        win->memory = 0;
+        win->capacity = 0;
+        win->valid = nk_false;
+    }
+    nk_convert_task_free(&cache->task);
+}
 
-enum { /* encodingID for NK_TT_PLATFORM_ID_MICROSOFT */
-   NK_TT_MS_EID_SYMBOL        =0,
-   NK_TT_MS_EID_UNICODE_BMP   =1,
-   NK_TT_MS_EID_SHIFTJIS      =2,
-   NK_TT_MS_EID_UNICODE_FULL  =10
-};
+NK_INTERN int
+nk_convert_config_equal(const struct nk_convert_config *a, const struct nk_convert_config *b)
+{
+    return a->global_alpha == b->global_alpha && a->line_AA == b->line_AA &&
+        a->shape_AA == b->shape_AA && a->circle_segment_count == b->circle_segment_count &&
+        a->arc_segment_count == b->arc_segment_count &&
+        a->curve_segment_count == b->curve_segment_count &&
+        a->null.texture.ptr == b->null.texture.ptr &&
+        a->null.uv.x == b->null.uv.x && a->null.uv.y == b->null.uv.y &&
+        a->vertex_layout == b->vertex_layout && a->vertex_size == b->vertex_size &&
+        a->vertex_alignment == b->vertex_alignment && a->index_type == b->index_type &&
+        a->segment_tolerance == b->segment_tolerance && a->clipping == b->clipping &&
+        a->shape_mode == b->shape_mode;
+}
+
+NK_INTERN struct nk_convert_window*
+nk_convert_cache_window(struct nk_convert_cache *cache, nk_hash id)
+{
+    /* returns the window with `id` or one which was not used in the last
+     * two frames. Windows still in use are not replaced since with more
+     * windows than the cache holds they would keep replacing each other */
+    struct nk_convert_window *win = &cache->windows[0];
+    int i;
+    for (i = 0; i < NK_CONVERT_CACHE_WINDOWS; ++i) {
+        struct nk_convert_window *iter = &cache->windows[i];
+        if (iter->valid && iter->id == id) return iter;
+        if (win->valid && (!iter->valid || iter->seq < win->seq)) win = iter;
+    }
+    if (win->valid && win->seq + 1 >= cache->seq)
+        return 0;
+    win->valid = nk_false;
+    return win;
+}
 
-enum { /* encodingID for NK_TT_PLATFORM_ID_MAC; same as Script Manager codes */
-   NK_TT_MAC_EID_ROMAN        =0,   NK_TT_MAC_EID_ARABIC       =4,
-   NK_TT_MAC_EID_JAPANESE     =1,   NK_TT_MAC_EID_HEBREW       =5,
-   NK_TT_MAC_EID_CHINESE_TRAD =2,   NK_TT_MAC_EID_GREEK        =6,
-   NK_TT_MAC_EID_KOREAN       =3,   NK_TT_MAC_EID_RUSSIAN      =7
-};
+NK_INTERN void
+nk_convert_window_span(const struct nk_convert_cache *cache,
+    const struct nk_convert_window *win, struct nk_convert_span *span)
+{
+    const nk_byte *memory = (const nk_byte*)win->memory;
+    nk_size index_size = (cache->config.index_type == NK_DRAW_INDEX_UINT) ?
+        sizeof(nk_uint): sizeof(nk_draw_index);
+    span->commands = (const struct nk_draw_command*)win->memory;
+    span->command_count = win->command_count;
+    memory += sizeof(struct nk_draw_command) * win->command_count;
+    span->elements = memory;
+    span->element_count = win->element_count;
+    memory += index_size * win->element_count;
+    span->vertices = memory;
+    span->vertex_count = win->vertex_count;
+}
 
-enum { /* languageID for NK_TT_PLATFORM_ID_MICROSOFT; same as LCID... */
-       /* problematic because there are e.g. 16 english LCIDs and 16 arabic LCIDs */
-   NK_TT_MS_LANG_ENGLISH     =0x0409,   NK_TT_MS_LANG_ITALIAN     =0x0410,
-   NK_TT_MS_LANG_CHINESE     =0x0804,   NK_TT_MS_LANG_JAPANESE    =0x0411,
-   NK_TT_MS_LANG_DUTCH       =0x0413,   NK_TT_MS_LANG_KOREAN      =0x0412,
-   NK_TT_MS_LANG_FRENCH      =0x040c,   NK_TT_MS_LANG_RUSSIAN     =0x0419,
-   NK_TT_MS_LANG_GERMAN      =0x0407,   NK_TT_MS_LANG_SPANISH     =0x0409,
-   NK_TT_MS_LANG_HEBREW      =0x040d,   NK_TT_MS_LANG_SWEDISH     =0x041D
-};
+NK_INTERN void
+nk_convert_window_store(struct nk_convert_cache *cache, struct nk_convert_window *win,
+    struct nk_convert_span *span)
+{
+    /* copies the output of a converted window into one allocation holding
+     * its draw commands, elements and vertices and points `span` at it */
+    const struct nk_convert_config *config = &cache->config;
+    nk_size index_size = (config->index_type == NK_DRAW_INDEX_UINT) ?
+        sizeof(nk_uint): sizeof(nk_draw_index);
+    nk_size commands = sizeof(struct nk_draw_command) * span->command_count;
+    nk_size elements = index_size * span->element_count;
+    nk_size vertices = config->vertex_size * span->vertex_count;
+    nk_byte *memory;
 
-enum { /* languageID for NK_TT_PLATFORM_ID_MAC */
-   NK_TT_MAC_LANG_ENGLISH      =0 ,   NK_TT_MAC_LANG_JAPANESE     =11,
-   NK_TT_MAC_LANG_ARABIC       =12,   NK_TT_MAC_LANG_KOREAN       =23,
-   NK_TT_MAC_LANG_DUTCH        =4 ,   NK_TT_MAC_LANG_RUSSIAN      =32,
-   NK_TT_MAC_LANG_FRENCH       =1 ,   NK_TT_MAC_LANG_SPANISH      =6 ,
-   NK_TT_MAC_LANG_GERMAN       =2 ,   NK_TT_MAC_LANG_SWEDISH      =5 ,
-   NK_TT_MAC_LANG_HEBREW       =10,   NK_TT_MAC_LANG_CHINESE_SIMPLIFIED =33,
-   NK_TT_MAC_LANG_ITALIAN      =3 ,   NK_TT_MAC_LANG_CHINESE_TRAD =19
-};
+    if (commands + elements + vertices > win->capacity) {
+        if (win->memory) cache->alloc.free(cache->alloc.userdata, win->memory);
+        win->capacity = commands + elements + vertices;
+        win->memory = cache->alloc.alloc(cache->alloc.userdata, 0, win->capacity);
+        if (!win->memory) {
+            win->capacity = 0;
+            return;
+        }
+    }
+    memory = (nk_byte*)win->memory;
+    NK_MEMCPY(memory, span->commands, commands);
+    NK_MEMCPY(memory + commands, span->elements, elements);
+    NK_MEMCPY(memory + commands + elements, span->vertices, vertices);
+    win->command_count = span->command_count;
+    win->element_count = span->element_count;
+    win->vertex_count = span->vertex_count;
+    win->valid = nk_true;
+    nk_convert_window_span(cache, win, span);
+}
 
-#define nk_ttBYTE(p)     (* (const nk_byte *) (p))
-#define nk_ttCHAR(p)     (* (const char *) (p))
+NK_API nk_flags
+nk_convert_cached(struct nk_context *ctx, struct nk_convert_cache *cache,
+    struct nk_buffer *cmds, struct nk_buffer *vertices, struct nk_buffer *elements,
+    const struct nk_convert_config *config)
+{
+    nk_flags res = NK_CONVERT_SUCCESS;
+    struct nk_draw_command *out = 0;
+    struct nk_command_range_iterator it;
+    struct nk_command_range range;
+    struct nk_rect clip = nk_null_rect;
+    unsigned int reused = 0;
+    nk_size grows;
 
-#if defined(NK_BIGENDIAN) && !defined(NK_ALLOW_UNALIGNED_TRUETYPE)
-   #define nk_ttUSHORT(p)   (* (nk_ushort *) (p))
-   #define nk_ttSHORT(p)    (* (nk_short *) (p))
-   #define nk_ttULONG(p)    (* (nk_uint *) (p))
-   #define nk_ttLONG(p)     (* (nk_int *) (p))
-#else
-    static nk_ushort nk_ttUSHORT(const nk_byte *p) { return (nk_ushort)(p[0]*256 + p[1]); }
-    static nk_short nk_ttSHORT(const nk_byte *p)   { return (nk_short)(p[0]*256 + p[1]); }
-    static nk_uint nk_ttULONG(const nk_byte *p)  { return (nk_uint)((p[0]<<24) + (p[1]<<16) + (p[2]<<8) + p[3]); }
-#endif
+    NK_ASSERT(ctx);
+    NK_ASSERT(cache);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !cache || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+        return NK_CONVERT_INVALID_PARAM;
 
-#define nk_tt_tag4(p,c0,c1,c2,c3)\
-    ((p)[0] == (c0) && (p)[1] == (c1) && (p)[2] == (c2) && (p)[3] == (c3))
-#define nk_tt_tag(p,str) nk_tt_tag4(p,str[0],str[1],str[2],str[3])
+    if (!nk_convert_config_equal(&cache->config, config)) {
+        nk_convert_cache_clear(cache);
+        cache->config = *config;
+    }
+    cache->seq++;
+    grows = cmds->grows + vertices->grows + elements->grows;
+    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+        config->line_AA, config->shape_AA);
 
-NK_INTERN int nk_tt_GetGlyphShape(const struct nk_tt_fontinfo *info, struct nk_allocator *alloc,
-                                int glyph_index, struct nk_tt_vertex **pvertices);
+    /* link all command buffers in the same order `nk_convert` draws them */
+    it.win = ctx->begin;
+    it.state = (nk__begin(ctx)) ? 0: 3;
+    while (nk_command_range_next(ctx, &it, &range)) {
+        struct nk_convert_window *win;
+        struct nk_convert_span span;
+        struct nk_rect last = clip;
+        nk_size offset = range.begin;
+        nk_size count = 0;
+        nk_hash hash = 0;
+        int custom = nk_false;
+
+        while (offset >= range.begin && offset < range.end) {
+            const struct nk_command *cmd;
+            cmd = (const struct nk_command*)nk_buffer_at(&ctx->memory, offset);
+            hash = nk_command_hash(hash, cmd);
+            if (cmd->type == NK_COMMAND_SCISSOR) {
+                const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+                last = nk_rect(s->x, s->y, s->w, s->h);
+            } else if (cmd->type == NK_COMMAND_CUSTOM) custom = nk_true;
+            count++;
+            if (offset == range.last || cmd->next <= offset) break;
+            offset = cmd->next;
+        }
 
-NK_INTERN nk_uint
-nk_tt__find_table(const nk_byte *data, nk_uint fontstart, const char *tag)
-{
-    /* @OPTIMIZE: binary search */
-    nk_int num_tables = nk_ttUSHORT(data+fontstart+4);
-    nk_uint tabledir = fontstart + 12;
-    nk_int i;
-    for (i = 0; i < num_tables; ++i) {
-        nk_uint loc = tabledir + (nk_uint)(16*i);
-        if (nk_tt_tag(data+loc+0, tag))
-            return nk_ttULONG(data+loc+8);
+        /* custom callbacks draw outside of the command data and are
+         * therefore never reused even if their commands stay the same */
+        win = nk_convert_cache_window(cache, range.id);
+        if (win && win->valid && !custom && win->hash == hash && win->count == count &&
+            win->size == range.last - range.begin &&
+            win->clip.x == clip.x && win->clip.y == clip.y &&
+            win->clip.w == clip.w && win->clip.h == clip.h) {
+            nk_convert_window_span(cache, win, &span);
+            reused += span.vertex_count;
+        } else {
+            struct nk_convert_task *task = &cache->task;
+            nk_flags result;
+            nk_draw_list_setup(&task->list, config, &task->cmds, &task->vertices,
+                &task->elements, config->line_AA, config->shape_AA);
+            task->begin = (const struct nk_command*)nk_buffer_at(&ctx->memory, range.begin);
+            task->count = count;
+            task->clip = clip;
+            result = nk_convert_task(ctx, task);
+            nk_convert_task_span(task, &span);
+            res |= result;
+            if (win) {
+                win->valid = nk_false;
+                win->id = range.id;
+                win->hash = hash;
+                win->count = count;
+                win->size = range.last - range.begin;
+                win->clip = clip;
+                if (!result && !custom)
+                    nk_convert_window_store(cache, win, &span);
+            }
+        }
+        if (win) win->seq = cache->seq;
+        if (!nk_convert_join(&ctx->draw_list, &span, &out)) break;
+        clip = last;
     }
-    return 0;
+    res |= nk_convert_result(&ctx->draw_list);
+    nk_convert_stats(ctx, grows);
+    ctx->stats.vertices_reused = reused;
+    return res;
 }
 
-NK_INTERN int
-nk_tt_InitFont(struct nk_tt_fontinfo *info, const unsigned char *data2, int fontstart)
+NK_INTERN void
+nk_convert_instance(struct nk_draw_list *list, const struct nk_command *cmd)
 {
-    nk_uint cmap, t;
-    nk_int i,numTables;
-    const nk_byte *data = (const nk_byte *) data2;
-
-    info->data = data;
-    info->fontstart = fontstart;
-
-    cmap = nk_tt__find_table(data, (nk_uint)fontstart, "cmap");       /* required */
-    info->loca = (int)nk_tt__find_table(data, (nk_uint)fontstart, "loca"); /* required */
-    info->head = (int)nk_tt__find_table(data, (nk_uint)fontstart, "head"); /* required */
-    info->glyf = (int)nk_tt__find_table(data, (nk_uint)fontstart, "glyf"); /* required */
-    info->hhea = (int)nk_tt__find_table(data, (nk_uint)fontstart, "hhea"); /* required */
-    info->hmtx = (int)nk_tt__find_table(data, (nk_uint)fontstart, "hmtx"); /* required */
-    info->kern = (int)nk_tt__find_table(data, (nk_uint)fontstart, "kern"); /* not required */
-    if (!cmap || !info->loca || !info->head || !info->glyf || !info->hhea || !info->hmtx)
-        return 0;
-
-    t = nk_tt__find_table(data, (nk_uint)fontstart, "maxp");
-    if (t) info->numGlyphs = nk_ttUSHORT(data+t+4);
-    else info->numGlyphs = 0xffff;
-
-    /* find a cmap encoding table we understand *now* to avoid searching */
-    /* later. (todo: could make this installable) */
-    /* the same regardless of glyph. */
-    numTables = nk_ttUSHORT(data + cmap + 2);
-    info->index_map = 0;
-    for (i=0; i < numTables; ++i)
-    {
-        nk_uint encoding_record = cmap + 4 + 8 * (nk_uint)i;
-        /* find an encoding we understand: */
-        switch(nk_ttUSHORT(data+encoding_record)) {
-        case NK_TT_PLATFORM_ID_MICROSOFT:
-            switch (nk_ttUSHORT(data+encoding_record+2)) {
-            case NK_TT_MS_EID_UNICODE_BMP:
-            case NK_TT_MS_EID_UNICODE_FULL:
-                /* MS/Unicode */
-                info->index_map = (int)(cmap + nk_ttULONG(data+encoding_record+4));
-                break;
-            default: break;
-            } break;
-        case NK_TT_PLATFORM_ID_UNICODE:
-            /* Mac/iOS has these */
-            /* all the encodingIDs are unicode, so we don't bother to check it */
-            info->index_map = (int)(cmap + nk_ttULONG(data+encoding_record+4));
-            break;
-        default: break;
+    /* shapes, glyphs and images become instance records while everything
+     * else is converted into triangles like in `nk_convert` */
+    enum nk_draw_instance_type type;
+    struct nk_color color;
+    float rect[4], params[4] = {0,0,0,0};
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    list->userdata = cmd->userdata;
+#endif
+    switch (cmd->type) {
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line*)cmd;
+        type = NK_DRAW_INSTANCE_LINE;
+        rect[0] = (float)l->begin.x; rect[1] = (float)l->begin.y;
+        rect[2] = (float)l->end.x; rect[3] = (float)l->end.y;
+        params[1] = (float)l->line_thickness;
+        color = l->color;
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        type = NK_DRAW_INSTANCE_RECT;
+        rect[0] = (float)r->x; rect[1] = (float)r->y;
+        rect[2] = (float)r->w; rect[3] = (float)r->h;
+        params[0] = (float)r->rounding;
+        params[1] = (float)r->line_thickness;
+        color = r->color;
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        type = NK_DRAW_INSTANCE_RECT;
+        rect[0] = (float)r->x; rect[1] = (float)r->y;
+        rect[2] = (float)r->w; rect[3] = (float)r->h;
+        params[0] = (float)r->rounding;
+        color = r->color;
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        type = NK_DRAW_INSTANCE_CIRCLE;
+        rect[0] = (float)c->x; rect[1] = (float)c->y;
+        rect[2] = (float)c->w; rect[3] = (float)c->h;
+        params[1] = (float)c->line_thickness;
+        color = c->color;
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled*)cmd;
+        type = NK_DRAW_INSTANCE_CIRCLE;
+        rect[0] = (float)c->x; rect[1] = (float)c->y;
+        rect[2] = (float)c->w; rect[3] = (float)c->h;
+        color = c->color;
+    } break;
+    case NK_COMMAND_TEXT:
+    case NK_COMMAND_IMAGE:
+        /* `nk_draw_list_add_text` and `nk_draw_list_add_image` write instances */
+    case NK_COMMAND_NOP:
+    case NK_COMMAND_SCISSOR:
+        nk_convert_shape(list, cmd);
+        return;
+    default:
+        /* triangles can not be added to a vertex draw command of instances */
+        if (list->cmd_count && nk_draw_list_command_last(list)->instance_count) {
+            nk_handle texture = nk_draw_list_command_last(list)->texture;
+            nk_draw_list_push_command(list, list->clip_rect, texture);
         }
+        nk_convert_command(list, cmd);
+        return;
     }
-    if (info->index_map == 0)
-        return 0;
-    info->indexToLocFormat = nk_ttUSHORT(data+info->head + 50);
-    return 1;
+    if (!color.a) return;
+    color.a = (nk_byte)((float)color.a * list->config.global_alpha);
+    nk_draw_list_push_instance(list, type, rect, params, color, list->config.null.texture);
 }
 
-NK_INTERN int
-nk_tt_FindGlyphIndex(const struct nk_tt_fontinfo *info, int unicode_codepoint)
+NK_API nk_flags
+nk_convert_instanced(struct nk_context *ctx, struct nk_buffer *cmds,
+    struct nk_buffer *vertices, struct nk_buffer *elements,
+    struct nk_buffer *instances, const struct nk_convert_config *config)
 {
-    const nk_byte *data = info->data;
-    nk_uint index_map = (nk_uint)info->index_map;
+    nk_flags res = NK_CONVERT_SUCCESS;
+    const struct nk_command *cmd;
+    nk_size grows, instance_grows;
+    NK_ASSERT(ctx);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(instances);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !cmds || !vertices || !elements || !instances ||
+        !config || !config->vertex_layout)
+        return NK_CONVERT_INVALID_PARAM;
 
-    nk_ushort format = nk_ttUSHORT(data + index_map + 0);
-    if (format == 0) { /* apple byte encoding */
-        nk_int bytes = nk_ttUSHORT(data + index_map + 2);
-        if (unicode_codepoint < bytes-6)
-            return nk_ttBYTE(data + index_map + 6 + unicode_codepoint);
-        return 0;
-    } else if (format == 6) {
-        nk_uint first = nk_ttUSHORT(data + index_map + 6);
-        nk_uint count = nk_ttUSHORT(data + index_map + 8);
-        if ((nk_uint) unicode_codepoint >= first && (nk_uint) unicode_codepoint < first+count)
-            return nk_ttUSHORT(data + index_map + 10 + (unicode_codepoint - (int)first)*2);
-        return 0;
-    } else if (format == 2) {
-        NK_ASSERT(0); /* @TODO: high-byte mapping for japanese/chinese/korean */
-        return 0;
-    } else if (format == 4) { /* standard mapping for windows fonts: binary search collection of ranges */
-        nk_ushort segcount = nk_ttUSHORT(data+index_map+6) >> 1;
-        nk_ushort searchRange = nk_ttUSHORT(data+index_map+8) >> 1;
-        nk_ushort entrySelector = nk_ttUSHORT(data+index_map+10);
-        nk_ushort rangeShift = nk_ttUSHORT(data+index_map+12) >> 1;
+    grows = cmds->grows + vertices->grows + elements->grows;
+    instance_grows = instances->grows;
+    nk_draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+        config->line_AA, config->shape_AA);
+    ctx->draw_list.instances = instances;
+    nk_foreach(cmd, ctx)
+        nk_convert_instance(&ctx->draw_list, cmd);
+    res |= nk_convert_result(&ctx->draw_list);
 
-        /* do a binary search of the segments */
-        nk_uint endCount = index_map + 14;
-        nk_uint search = endCount;
+    nk_convert_stats(ctx, grows);
+    ctx->stats.convert_grows += instances->grows - instance_grows;
+    return res;
+}
+NK_API const struct nk_draw_command*
+nk__draw_begin(const struct nk_context *ctx,
+    const struct nk_buffer *buffer)
+{return nk__draw_list_begin(&ctx->draw_list, buffer);}
 
-        if (unicode_codepoint > 0xffff)
-            return 0;
+NK_API const struct nk_draw_command*
+nk__draw_end(const struct nk_context *ctx, const struct nk_buffer *buffer)
+{return nk__draw_list_end(&ctx->draw_list, buffer);}
 
-        /* they lie from endCount .. endCount + segCount */
-        /* but searchRange is the nearest power of two, so... */
-        if (unicode_codepoint >= nk_ttUSHORT(data + search + rangeShift*2))
-            search += (nk_uint)(rangeShift*2);
+NK_API const struct nk_draw_command*
+nk__draw_next(const struct nk_draw_command *cmd,
+    const struct nk_buffer *buffer, const struct nk_context *ctx)
+{return nk__draw_list_next(cmd, buffer, &ctx->draw_list);}
 
-        /* now decrement to bias correctly to find smallest */
-        search -= 2;
-        while (entrySelector) {
-            nk_ushort end;
-            searchRange >>= 1;
-            end = nk_ttUSHORT(data + search + searchRange*2);
-            if (unicode_codepoint > end)
-                search += (nk_uint)(searchRange*2);
-            --entrySelector;
-        }
-        search += 2;
+#endif
 
-      {
-         nk_ushort offset, start;
-         nk_ushort item = (nk_ushort) ((search - endCount) >> 1);
+/*
+ * ==============================================================
+ *
+ *                          FONT HANDLING
+ *
+ * ===============================================================
+ */
+#ifdef NK_INCLUDE_FONT_BAKING
+/* -------------------------------------------------------------
+ *
+ *                          RECT PACK
+ *
+ * --------------------------------------------------------------*/
+/* stb_rect_pack.h - v0.05 - public domain - rectangle packing */
+/* Sean Barrett 2014 */
+#define NK_RP__MAXVAL  0xffff
+typedef unsigned short nk_rp_coord;
 
-         NK_ASSERT(unicode_codepoint <= nk_ttUSHORT(data + endCount + 2*item));
-         start = nk_ttUSHORT(data + index_map + 14 + segcount*2 + 2 + 2*item);
-         if (unicode_codepoint < start)
-            return 0;
+struct nk_rp_rect {
+    /* reserved for your use: */
+    int id;
+    /* input: */
+    nk_rp_coord w, h;
+    /* output: */
+    nk_rp_coord x, y;
+    int was_packed;
+    /* non-zero if valid packing */
+}; /* 16 bytes, nominally */
 
-         offset = nk_ttUSHORT(data + index_map + 14 + segcount*6 + 2 + 2*item);
-         if (offset == 0)
-            return (nk_ushort) (unicode_codepoint + nk_ttSHORT(data + index_map + 14 + segcount*4 + 2 + 2*item));
+struct nk_rp_node {
+    nk_rp_coord  x,y;
+    struct nk_rp_node  *next;
+};
 
-         return nk_ttUSHORT(data + offset + (unicode_codepoint-start)*2 + index_map + 14 + segcount*6 + 2 + 2*item);
-      }
-   } else if (format == 12 || format == 13) {
-        nk_uint ngroups = nk_ttULONG(data+index_map+12);
-        nk_int low,high;
-        low = 0; high = (nk_int)ngroups;
-        /* Binary search the right group. */
-        while (low < high) {
-            nk_int mid = low + ((high-low) >> 1); /* rounds down, so low <= mid < high */
-            nk_uint start_char = nk_ttULONG(data+index_map+16+mid*12);
-            nk_uint end_char = nk_ttULONG(data+index_map+16+mid*12+4);
-            if ((nk_uint) unicode_codepoint < start_char)
-                high = mid;
-            else if ((nk_uint) unicode_codepoint > end_char)
-                low = mid+1;
-            else {
-                nk_uint start_glyph = nk_ttULONG(data+index_map+16+mid*12+8);
-                if (format == 12)
-                    return (int)start_glyph + (int)unicode_codepoint - (int)start_char;
-                else /* format == 13 */
-                    return (int)start_glyph;
-            }
-        }
-        return 0; /* not found */
-    }
-    /* @TODO */
-    NK_ASSERT(0);
-    return 0;
-}
+struct nk_rp_context {
+    int width;
+    int height;
+    int align;
+    int init_mode;
+    int heuristic;
+    int num_nodes;
+    struct nk_rp_node *active_head;
+    struct nk_rp_node *free_head;
+    struct nk_rp_node extra[2];
+    /* we allocate two extra nodes so optimal user-node-count is 'width' not 'width+2' */
+};
+
+struct nk_rp__findresult {
+    int x,y;
+    struct nk_rp_node **prev_link;
+};
+
+enum NK_RP_HEURISTIC {
+    NK_RP_HEURISTIC_Skyline_default=0,
+    NK_RP_HEURISTIC_Skyline_BL_sortHeight = NK_RP_HEURISTIC_Skyline_default,
+    NK_RP_HEURISTIC_Skyline_BF_sortHeight
+};
+enum NK_RP_INIT_STATE{NK_RP__INIT_skyline = 1};
 
 NK_INTERN void
-nk_tt_setvertex(struct nk_tt_vertex *v, nk_byte type, nk_int x, nk_int y, nk_int cx, nk_int cy)
+nk_rp_setup_allow_out_of_mem(struct nk_rp_context *context, int allow_out_of_mem)
 {
-    v->type = type;
-    v->x = (nk_short) x;
-    v->y = (nk_short) y;
-    v->cx = (nk_short) cx;
-    v->cy = (nk_short) cy;
+    if (allow_out_of_mem)
+        /* if it's ok to run out of memory, then don't bother aligning them; */
+        /* this gives better packing, but may fail due to OOM (even though */
+        /* the rectangles easily fit). @TODO a smarter approach would be to only */
+        /* quantize once we've hit OOM, then we could get rid of this parameter. */
+        context->align = 1;
+    else {
+        /* if it's not ok to run out of memory, then quantize the widths */
+        /* so that num_nodes is always enough nodes. */
+        /* */
+        /* I.e. num_nodes * align >= width */
+        /*                  align >= width / num_nodes */
+        /*                  align = ceil(width/num_nodes) */
+        context->align = (context->width + context->num_nodes-1) / context->num_nodes;
+    }
 }
 
-NK_INTERN int
-nk_tt__GetGlyfOffset(const struct nk_tt_fontinfo *info, int glyph_index)
+NK_INTERN void
+nk_rp_init_target(struct nk_rp_context *context, int width, int height,
+    struct nk_rp_node *nodes, int num_nodes)
 {
-    int g1,g2;
-    if (glyph_index >= info->numGlyphs) return -1; /* glyph index out of range */
-    if (info->indexToLocFormat >= 2)    return -1; /* unknown index->glyph map format */
+    int i;
+#ifndef STBRP_LARGE_RECTS
+    NK_ASSERT(width <= 0xffff && height <= 0xffff);
+#endif
 
-    if (info->indexToLocFormat == 0) {
-        g1 = info->glyf + nk_ttUSHORT(info->data + info->loca + glyph_index * 2) * 2;
-        g2 = info->glyf + nk_ttUSHORT(info->data + info->loca + glyph_index * 2 + 2) * 2;
-    } else {
-        g1 = info->glyf + (int)nk_ttULONG (info->data + info->loca + glyph_index * 4);
-        g2 = info->glyf + (int)nk_ttULONG (info->data + info->loca + glyph_index * 4 + 4);
-    }
-    return g1==g2 ? -1 : g1; /* if length is 0, return -1 */
+    for (i=0; i < num_nodes-1; ++i)
+        nodes[i].next = &nodes[i+1];
+    nodes[i].next = 0;
+    context->init_mode = NK_RP__INIT_skyline;
+    context->heuristic = NK_RP_HEURISTIC_Skyline_default;
+    context->free_head = &nodes[0];
+    context->active_head = &context->extra[0];
+    context->width = width;
+    context->height = height;
+    context->num_nodes = num_nodes;
+    nk_rp_setup_allow_out_of_mem(context, 0);
+
+    /* node 0 is the full width, node 1 is the sentinel (lets us not store width explicitly) */
+    context->extra[0].x = 0;
+    context->extra[0].y = 0;
+    context->extra[0].next = &context->extra[1];
+    context->extra[1].x = (nk_rp_coord) width;
+    context->extra[1].y = 65535;
+    context->extra[1].next = 0;
 }
 
+/* find minimum y position if it starts at x1 */
 NK_INTERN int
-nk_tt_GetGlyphBox(const struct nk_tt_fontinfo *info, int glyph_index,
-    int *x0, int *y0, int *x1, int *y1)
+nk_rp__skyline_find_min_y(struct nk_rp_context *c, struct nk_rp_node *first,
+    int x0, int width, int *pwaste)
 {
-    int g = nk_tt__GetGlyfOffset(info, glyph_index);
-    if (g < 0) return 0;
+    struct nk_rp_node *node = first;
+    int x1 = x0 + width;
+    int min_y, visited_width, waste_area;
+    NK_ASSERT(first->x <= x0);
+    NK_UNUSED(c);
 
-    if (x0) *x0 = nk_ttSHORT(info->data + g + 2);
-    if (y0) *y0 = nk_ttSHORT(info->data + g + 4);
-    if (x1) *x1 = nk_ttSHORT(info->data + g + 6);
-    if (y1) *y1 = nk_ttSHORT(info->data + g + 8);
-    return 1;
-}
+    NK_ASSERT(node->next->x > x0);
+    /* we ended up handling this in the caller for efficiency */
+    NK_ASSERT(node->x <= x0);
 
-NK_INTERN int
-stbtt__close_shape(struct nk_tt_vertex *vertices, int num_vertices, int was_off,
-    int start_off, nk_int sx, nk_int sy, nk_int scx, nk_int scy, nk_int cx, nk_int cy)
-{
-   if (start_off) {
-      if (was_off)
-         nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve, (cx+scx)>>1, (cy+scy)>>1, cx,cy);
-      nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve, sx,sy,scx,scy);
-   } else {
-      if (was_off)
-         nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve,sx,sy,cx,cy);
-      else
-         nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vline,sx,sy,0,0);
-   }
-   return num_vertices;
+    min_y = 0;
+    waste_area = 0;
+    visited_width = 0;
+    while (node->x < x1)
+    {
+        if (node->y > min_y) {
+            /* raise min_y higher. */
+            /* we've accounted for all waste up to min_y, */
+            /* but we'll now add more waste for everything we've visited */
+            waste_area += visited_width * (node->y - min_y);
+            min_y = node->y;
+            /* the first time through, visited_width might be reduced */
+            if (node->x < x0)
+            visited_width += node->next->x - x0;
+            else
+            visited_width += node->next->x - node->x;
+        } else {
+            /* add waste area */
+            int under_width = node->next->x - node->x;
+            if (under_width + visited_width > width)
+            under_width = width - visited_width;
+            waste_area += under_width * (min_y - node->y);
+            visited_width += under_width;
+        }
+        node = node->next;
+    }
+    *pwaste = waste_area;
+    return min_y;
 }
 
-NK_INTERN int
-nk_tt_GetGlyphShape(const struct nk_tt_fontinfo *info, struct nk_allocator *alloc,
-    int glyph_index, struct nk_tt_vertex **pvertices)
+NK_INTERN struct nk_rp__findresult
+nk_rp__skyline_find_best_pos(struct nk_rp_context *c, int width, int height)
 {
-    nk_short numberOfContours;
-    const nk_byte *endPtsOfContours;
-    const nk_byte *data = info->data;
-    struct nk_tt_vertex *vertices=0;
-    int num_vertices=0;
-    int g = nk_tt__GetGlyfOffset(info, glyph_index);
-    *pvertices = 0;
-
-    if (g < 0) return 0;
-    numberOfContours = nk_ttSHORT(data + g);
-    if (numberOfContours > 0) {
-        nk_byte flags=0,flagcount;
-        nk_int ins, i,j=0,m,n, next_move, was_off=0, off, start_off=0;
-        nk_int x,y,cx,cy,sx,sy, scx,scy;
-        const nk_byte *points;
-        endPtsOfContours = (data + g + 10);
-        ins = nk_ttUSHORT(data + g + 10 + numberOfContours * 2);
-        points = data + g + 10 + numberOfContours * 2 + 2 + ins;
-
-        n = 1+nk_ttUSHORT(endPtsOfContours + numberOfContours*2-2);
-        m = n + 2*numberOfContours;  /* a loose bound on how many vertices we might need */
-        vertices = (struct nk_tt_vertex *)alloc->alloc(alloc->userdata, 0, (nk_size)m * sizeof(vertices[0]));
-        if (vertices == 0)
-            return 0;
-
-        next_move = 0;
-        flagcount=0;
-
-        /* in first pass, we load uninterpreted data into the allocated array */
-        /* above, shifted to the end of the array so we won't overwrite it when */
-        /* we create our final data starting from the front */
-        off = m - n; /* starting offset for uninterpreted data, regardless of how m ends up being calculated */
+    int best_waste = (1<<30), best_x, best_y = (1 << 30);
+    struct nk_rp__findresult fr;
+    struct nk_rp_node **prev, *node, *tail, **best = 0;
 
-        /* first load flags */
-        for (i=0; i < n; ++i) {
-            if (flagcount == 0) {
-                flags = *points++;
-                if (flags & 8)
-                    flagcount = *points++;
-            } else --flagcount;
-            vertices[off+i].type = flags;
-        }
+    /* align to multiple of c->align */
+    width = (width + c->align - 1);
+    width -= width % c->align;
+    NK_ASSERT(width % c->align == 0);
 
-        /* now load x coordinates */
-        x=0;
-        for (i=0; i < n; ++i) {
-            flags = vertices[off+i].type;
-            if (flags & 2) {
-                nk_short dx = *points++;
-                x += (flags & 16) ? dx : -dx; /* ??? */
-            } else {
-                if (!(flags & 16)) {
-                    x = x + (nk_short) (points[0]*256 + points[1]);
-                    points += 2;
+    node = c->active_head;
+    prev = &c->active_head;
+    while (node->x + width <= c->width) {
+        int y,waste;
+        y = nk_rp__skyline_find_min_y(c, node, node->x, width, &waste);
+        /* actually just want to test BL */
+        if (c->heuristic == NK_RP_HEURISTIC_Skyline_BL_sortHeight) {
+            /* bottom left */
+            if (y < best_y) {
+            best_y = y;
+            best = prev;
+            }
+        } else {
+            /* best-fit */
+            if (y + height <= c->height) {
+                /* can only use it if it first vertically */
+                if (y < best_y || (y == best_y && waste < best_waste)) {
+                    best_y = y;
+                    best_waste = waste;
+                    best = prev;
                 }
             }
-            vertices[off+i].x = (nk_short) x;
         }
+        prev = &node->next;
+        node = node->next;
+    }
+    best_x = (best == 0) ? 0 : (*best)->x;
 
-        /* now load y coordinates */
-        y=0;
-        for (i=0; i < n; ++i) {
-            flags = vertices[off+i].type;
-            if (flags & 4) {
-                nk_short dy = *points++;
-                y += (flags & 32) ? dy : -dy; /* ??? */
-            } else {
-                if (!(flags & 32)) {
-                    y = y + (nk_short) (points[0]*256 + points[1]);
-                    points += 2;
+    /* if doing best-fit (BF), we also have to try aligning right edge to each node position */
+    /* */
+    /* e.g, if fitting */
+    /* */
+    /*     ____________________ */
+    /*    |____________________| */
+    /* */
+    /*            into */
+    /* */
+    /*   |                         | */
+    /*   |             ____________| */
+    /*   |____________| */
+    /* */
+    /* then right-aligned reduces waste, but bottom-left BL is always chooses left-aligned */
+    /* */
+    /* This makes BF take about 2x the time */
+    if (c->heuristic == NK_RP_HEURISTIC_Skyline_BF_sortHeight)
+    {
+        tail = c->active_head;
+        node = c->active_head;
+        prev = &c->active_head;
+        /* find first node that's admissible */
+        while (tail->x < width)
+            tail = tail->next;
+        while (tail)
+        {
+            int xpos = tail->x - width;
+            int y,waste;
+            NK_ASSERT(xpos >= 0);
+            /* find the left position that matches this */
+            while (node->next->x <= xpos) {
+                prev = &node->next;
+                node = node->next;
+            }
+            NK_ASSERT(node->next->x > xpos && node->x <= xpos);
+            y = nk_rp__skyline_find_min_y(c, node, xpos, width, &waste);
+            if (y + height < c->height) {
+                if (y <= best_y) {
+                    if (y < best_y || waste < best_waste || (waste==best_waste && xpos < best_x)) {
+                        best_x = xpos;
+                        NK_ASSERT(y <= best_y);
+                        best_y = y;
+                        best_waste = waste;
+                        best = prev;
+                    }
                 }
             }
-            vertices[off+i].y = (nk_short) y;
+            tail = tail->next;
         }
+    }
+    fr.prev_link = best;
+    fr.x = best_x;
+    fr.y = best_y;
+    return fr;
+}
 
-        /* now convert them to our format */
-        num_vertices=0;
-        sx = sy = cx = cy = scx = scy = 0;
-        for (i=0; i < n; ++i)
-        {
-            flags = vertices[off+i].type;
-            x     = (nk_short) vertices[off+i].x;
-            y     = (nk_short) vertices[off+i].y;
+NK_INTERN struct nk_rp__findresult
+nk_rp__skyline_pack_rectangle(struct nk_rp_context *context, int width, int height)
+{
+    /* find best position according to heuristic */
+    struct nk_rp__findresult res = nk_rp__skyline_find_best_pos(context, width, height);
+    struct nk_rp_node *node, *cur;
 
-            if (next_move == i) {
-                if (i != 0)
-                    num_vertices = stbtt__close_shape(vertices, num_vertices, was_off, start_off, sx,sy,scx,scy,cx,cy);
-
-                /* now start the new one                */
-                start_off = !(flags & 1);
-                if (start_off) {
-                    /* if we start off with an off-curve point, then when we need to find a point on the curve */
-                    /* where we can start, and we need to save some state for when we wraparound. */
-                    scx = x;
-                    scy = y;
-                    if (!(vertices[off+i+1].type & 1)) {
-                        /* next point is also a curve point, so interpolate an on-point curve */
-                        sx = (x + (nk_int) vertices[off+i+1].x) >> 1;
-                        sy = (y + (nk_int) vertices[off+i+1].y) >> 1;
-                    } else {
-                        /* otherwise just use the next point as our start point */
-                        sx = (nk_int) vertices[off+i+1].x;
-                        sy = (nk_int) vertices[off+i+1].y;
-                        ++i; /* we're using point i+1 as the starting point, so skip it */
-                    }
-                } else {
-                    sx = x;
-                    sy = y;
-                }
-                nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vmove,sx,sy,0,0);
-                was_off = 0;
-                next_move = 1 + nk_ttUSHORT(endPtsOfContours+j*2);
-                ++j;
-            } else {
-                if (!(flags & 1))
-                { /* if it's a curve */
-                    if (was_off) /* two off-curve control points in a row means interpolate an on-curve midpoint */
-                        nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve, (cx+x)>>1, (cy+y)>>1, cx, cy);
-                    cx = x;
-                    cy = y;
-                    was_off = 1;
-                } else {
-                    if (was_off)
-                        nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve, x,y, cx, cy);
-                    else nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vline, x,y,0,0);
-                    was_off = 0;
-                }
-            }
-        }
-        num_vertices = stbtt__close_shape(vertices, num_vertices, was_off, start_off, sx,sy,scx,scy,cx,cy);
-    } else if (numberOfContours == -1) {
-        /* Compound shapes. */
-        int more = 1;
-        const nk_byte *comp = data + g + 10;
-        num_vertices = 0;
-        vertices = 0;
-
-        while (more)
-        {
-            nk_ushort flags, gidx;
-            int comp_num_verts = 0, i;
-            struct nk_tt_vertex *comp_verts = 0, *tmp = 0;
-            float mtx[6] = {1,0,0,1,0,0}, m, n;
-
-            flags = (nk_ushort)nk_ttSHORT(comp); comp+=2;
-            gidx = (nk_ushort)nk_ttSHORT(comp); comp+=2;
+    /* bail if: */
+    /*    1. it failed */
+    /*    2. the best node doesn't fit (we don't always check this) */
+    /*    3. we're out of memory */
+    if (res.prev_link == 0 || res.y + height > context->height || context->free_head == 0) {
+        res.prev_link = 0;
+        return res;
+    }
 
-            if (flags & 2) { /* XY values */
-                if (flags & 1) { /* shorts */
-                    mtx[4] = nk_ttSHORT(comp); comp+=2;
-                    mtx[5] = nk_ttSHORT(comp); comp+=2;
-                } else {
-                    mtx[4] = nk_ttCHAR(comp); comp+=1;
-                    mtx[5] = nk_ttCHAR(comp); comp+=1;
-                }
-            } else {
-                /* @TODO handle matching point */
-                NK_ASSERT(0);
-            }
-            if (flags & (1<<3)) { /* WE_HAVE_A_SCALE */
-                mtx[0] = mtx[3] = nk_ttSHORT(comp)/16384.0f; comp+=2;
-                mtx[1] = mtx[2] = 0;
-            } else if (flags & (1<<6)) { /* WE_HAVE_AN_X_AND_YSCALE */
-                mtx[0] = nk_ttSHORT(comp)/16384.0f; comp+=2;
-                mtx[1] = mtx[2] = 0;
-                mtx[3] = nk_ttSHORT(comp)/16384.0f; comp+=2;
-            } else if (flags & (1<<7)) { /* WE_HAVE_A_TWO_BY_TWO */
-                mtx[0] = nk_ttSHORT(comp)/16384.0f; comp+=2;
-                mtx[1] = nk_ttSHORT(comp)/16384.0f; comp+=2;
-                mtx[2] = nk_ttSHORT(comp)/16384.0f; comp+=2;
-                mtx[3] = nk_ttSHORT(comp)/16384.0f; comp+=2;
-            }
+    /* on success, create new node */
+    node = context->free_head;
+    node->x = (nk_rp_coord) res.x;
+    node->y = (nk_rp_coord) (res.y + height);
 
-             /* Find transformation scales. */
-            m = (float) NK_SQRT(mtx[0]*mtx[0] + mtx[1]*mtx[1]);
-            n = (float) NK_SQRT(mtx[2]*mtx[2] + mtx[3]*mtx[3]);
+    context->free_head = node->next;
 
-             /* Get indexed glyph. */
-            comp_num_verts = nk_tt_GetGlyphShape(info, alloc, gidx, &comp_verts);
-            if (comp_num_verts > 0)
-            {
-                /* Transform vertices. */
-                for (i = 0; i < comp_num_verts; ++i) {
-                    struct nk_tt_vertex* v = &comp_verts[i];
-                    short x,y;
-                    x=v->x; y=v->y;
-                    v->x = (short)(m * (mtx[0]*x + mtx[2]*y + mtx[4]));
-                    v->y = (short)(n * (mtx[1]*x + mtx[3]*y + mtx[5]));
-                    x=v->cx; y=v->cy;
-                    v->cx = (short)(m * (mtx[0]*x + mtx[2]*y + mtx[4]));
-                    v->cy = (short)(n * (mtx[1]*x + mtx[3]*y + mtx[5]));
-                }
-                /* Append vertices. */
-                tmp = (struct nk_tt_vertex*)alloc->alloc(alloc->userdata, 0,
-                    (nk_size)(num_vertices+comp_num_verts)*sizeof(struct nk_tt_vertex));
-                if (!tmp) {
-                    if (vertices) alloc->free(alloc->userdata, vertices);
-                    if (comp_verts) alloc->free(alloc->userdata, comp_verts);
-                    return 0;
-                }
-                if (num_vertices > 0) NK_MEMCPY(tmp, vertices, (nk_size)num_vertices*sizeof(struct nk_tt_vertex));
-                NK_MEMCPY(tmp+num_vertices, comp_verts, (nk_size)comp_num_verts*sizeof(struct nk_tt_vertex));
-                if (vertices) alloc->free(alloc->userdata,vertices);
-                vertices = tmp;
-                alloc->free(alloc->userdata,comp_verts);
-                num_vertices += comp_num_verts;
-            }
-            /* More components ? */
-            more = flags & (1<<5);
-        }
-    } else if (numberOfContours < 0) {
-        /* @TODO other compound variations? */
-        NK_ASSERT(0);
+    /* insert the new node into the right starting point, and */
+    /* let 'cur' point to the remaining nodes needing to be */
+    /* stitched back in */
+    cur = *res.prev_link;
+    if (cur->x < res.x) {
+        /* preserve the existing one, so start testing with the next one */
+        struct nk_rp_node *next = cur->next;
+        cur->next = node;
+        cur = next;
     } else {
-        /* numberOfCounters == 0, do nothing */
+        *res.prev_link = node;
     }
-    *pvertices = vertices;
-    return num_vertices;
-}
 
-NK_INTERN void
-nk_tt_GetGlyphHMetrics(const struct nk_tt_fontinfo *info, int glyph_index,
-    int *advanceWidth, int *leftSideBearing)
-{
-    nk_ushort numOfLongHorMetrics = nk_ttUSHORT(info->data+info->hhea + 34);
-    if (glyph_index < numOfLongHorMetrics) {
-        if (advanceWidth)
-            *advanceWidth    = nk_ttSHORT(info->data + info->hmtx + 4*glyph_index);
-        if (leftSideBearing)
-            *leftSideBearing = nk_ttSHORT(info->data + info->hmtx + 4*glyph_index + 2);
-    } else {
-        if (advanceWidth)
-            *advanceWidth    = nk_ttSHORT(info->data + info->hmtx + 4*(numOfLongHorMetrics-1));
-        if (leftSideBearing)
-            *leftSideBearing = nk_ttSHORT(info->data + info->hmtx + 4*numOfLongHorMetrics + 2*(glyph_index - numOfLongHorMetrics));
+    /* from here, traverse cur and free the nodes, until we get to one */
+    /* that shouldn't be freed */
+    while (cur->next && cur->next->x <= res.x + width) {
+        struct nk_rp_node *next = cur->next;
+        /* move the current node to the free list */
+        cur->next = context->free_head;
+        context->free_head = cur;
+        cur = next;
     }
-}
+    /* stitch the list back in */
+    node->next = cur;
 
-NK_INTERN void
-nk_tt_GetFontVMetrics(const struct nk_tt_fontinfo *info,
-    int *ascent, int *descent, int *lineGap)
-{
-   if (ascent ) *ascent  = nk_ttSHORT(info->data+info->hhea + 4);
-   if (descent) *descent = nk_ttSHORT(info->data+info->hhea + 6);
-   if (lineGap) *lineGap = nk_ttSHORT(info->data+info->hhea + 8);
+    if (cur->x < res.x + width)
+        cur->x = (nk_rp_coord) (res.x + width);
+    return res;
 }
 
-NK_INTERN float
-nk_tt_ScaleForPixelHeight(const struct nk_tt_fontinfo *info, float height)
+NK_INTERN int
+nk_rect_height_compare(const void *a, const void *b)
 {
-   int fheight = nk_ttSHORT(info->data + info->hhea + 4) - nk_ttSHORT(info->data + info->hhea + 6);
-   return (float) height / (float)fheight;
+    const struct nk_rp_rect *p = (const struct nk_rp_rect *) a;
+    const struct nk_rp_rect *q = (const struct nk_rp_rect *) b;
+    if (p->h > q->h)
+        return -1;
+    if (p->h < q->h)
+        return  1;
+    return (p->w > q->w) ? -1 : (p->w < q->w);
 }
 
-NK_INTERN float
-nk_tt_ScaleForMappingEmToPixels(const struct nk_tt_fontinfo *info, float pixels)
+NK_INTERN int
+nk_rect_original_order(const void *a, const void *b)
 {
-   int unitsPerEm = nk_ttUSHORT(info->data + info->head + 18);
-   return pixels / (float)unitsPerEm;
+    const struct nk_rp_rect *p = (const struct nk_rp_rect *) a;
+    const struct nk_rp_rect *q = (const struct nk_rp_rect *) b;
+    return (p->was_packed < q->was_packed) ? -1 : (p->was_packed > q->was_packed);
 }
 
-/*-------------------------------------------------------------
- *            antialiasing software rasterizer
- * --------------------------------------------------------------*/
 NK_INTERN void
-nk_tt_GetGlyphBitmapBoxSubpixel(const struct nk_tt_fontinfo *font,
-    int glyph, float scale_x, float scale_y,float shift_x, float shift_y,
-    int *ix0, int *iy0, int *ix1, int *iy1)
+nk_rp_qsort(struct nk_rp_rect *array, unsigned int len, int(*cmp)(const void*,const void*))
 {
-    int x0,y0,x1,y1;
-    if (!nk_tt_GetGlyphBox(font, glyph, &x0,&y0,&x1,&y1)) {
-        /* e.g. space character */
-        if (ix0) *ix0 = 0;
-        if (iy0) *iy0 = 0;
-        if (ix1) *ix1 = 0;
-        if (iy1) *iy1 = 0;
-    } else {
-        /* move to integral bboxes (treating pixels as little squares, what pixels get touched)? */
-        if (ix0) *ix0 = nk_ifloorf((float)x0 * scale_x + shift_x);
-        if (iy0) *iy0 = nk_ifloorf((float)-y1 * scale_y + shift_y);
-        if (ix1) *ix1 = nk_iceilf ((float)x1 * scale_x + shift_x);
-        if (iy1) *iy1 = nk_iceilf ((float)-y0 * scale_y + shift_y);
+    /* iterative quick sort */
+    #define NK_MAX_SORT_STACK 64
+    unsigned right, left = 0, stack[NK_MAX_SORT_STACK], pos = 0;
+    unsigned seed = len/2 * 69069+1;
+    for (;;) {
+        for (; left+1 < len; len++) {
+            struct nk_rp_rect pivot, tmp;
+            if (pos == NK_MAX_SORT_STACK) len = stack[pos = 0];
+            pivot = array[left+seed%(len-left)];
+            seed = seed * 69069 + 1;
+            stack[pos++] = len;
+            for (right = left-1;;) {
+                while (cmp(&array[++right], &pivot) < 0);
+                while (cmp(&pivot, &array[--len]) < 0);
+                if (right >= len) break;
+                tmp = array[right];
+                array[right] = array[len];
+                array[len] = tmp;
+            }
+        }
+        if (pos == 0) break;
+        left = len;
+        len = stack[--pos];
     }
+    #undef NK_MAX_SORT_STACK
 }
 
 NK_INTERN void
-nk_tt_GetGlyphBitmapBox(const struct nk_tt_fontinfo *font, int glyph,
+nk_rp_pack_rects(struct nk_rp_context *context, struct nk_rp_rect *rects, int num_rects)
+{
+    int i;
+    /* we use the 'was_packed' field internally to allow sorting/unsorting */
+    for (i=0; i < num_rects; ++i) {
+        rects[i].was_packed = i;
+    }
+
+    /* sort according to heuristic */
+    nk_rp_qsort(rects, (unsigned)num_rects, nk_rect_height_compare);
+
+    for (i=0; i < num_rects; ++i) {
+        struct nk_rp__findresult fr = nk_rp__skyline_pack_rectangle(context, rects[i].w, rects[i].h);
+        if (fr.prev_link) {
+            rects[i].x = (nk_rp_coord) fr.x;
+            rects[i].y = (nk_rp_coord) fr.y;
+        } else {
+            rects[i].x = rects[i].y = NK_RP__MAXVAL;
+        }
+    }
+
+    /* unsort */
+    nk_rp_qsort(rects, (unsigned)num_rects, nk_rect_original_order);
+
+    /* set was_packed flags */
+    for (i=0; i < num_rects; ++i)
+        rects[i].was_packed = !(rects[i].x == NK_RP__MAXVAL && rects[i].y == NK_RP__MAXVAL);
+}
+
+/*
+ * ==============================================================
+ *
+ *                          TRUETYPE
+ *
+ * ===============================================================
+ */
+/* stb_truetype.h - v1.07 - public domain */
+#define NK_TT_MAX_OVERSAMPLE   8
+#define NK_TT__OVER_MASK  (NK_TT_MAX_OVERSAMPLE-1)
+
+struct nk_tt_bakedchar {
+    unsigned short x0,y0,x1,y1;
+    /* coordinates of bbox in bitmap */
+    float xoff,yoff,xadvance;
+};
+
+struct nk_tt_aligned_quad{
+    float x0,y0,s0,t0; /* top-left */
+    float x1,y1,s1,t1; /* bottom-right */
+};
+
+struct nk_tt_packedchar {
+    unsigned short x0,y0,x1,y1;
+    /* coordinates of bbox in bitmap */
+    float xoff,yoff,xadvance;
+    float xoff2,yoff2;
+};
+
+struct nk_tt_pack_range {
+    float font_size;
+    int first_unicode_codepoint_in_range;
+    /* if non-zero, then the chars are continuous, and this is the first codepoint */
+    int *array_of_unicode_codepoints;
+    /* if non-zero, then this is an array of unicode codepoints */
+    int num_chars;
+    struct nk_tt_packedchar *chardata_for_range; /* output */
+    unsigned char h_oversample, v_oversample;
+    /* don't set these, they're used internally */
+};
+
+struct nk_tt_pack_context {
+    void *pack_info;
+    int   width;
+    int   height;
+    int   stride_in_bytes;
+    int   padding;
+    unsigned int   h_oversample, v_oversample;
+    unsigned char *pixels;
+    void  *nodes;
+};
+
+struct nk_tt_fontinfo {
+    const unsigned char* data; /* pointer to .ttf file */
+    int fontstart;/* offset of start of font */
+    int numGlyphs;/* number of glyphs, needed for range checking */
+    int loca,head,glyf,hhea,hmtx,kern; /* table locations as offset from start of .ttf */
+    int index_map; /* a cmap mapping for our chosen character encoding */
+    int indexToLocFormat; /* format needed to map from glyph index to glyph */
+};
+
+enum {
+  NK_TT_vmove=1,
+  NK_TT_vline,
+  NK_TT_vcurve
+};
+
+struct nk_tt_vertex {
+    short x,y,cx,cy;
+    unsigned char type,padding;
+};
+
+struct nk_tt__bitmap{
+   int w,h,stride;
+   unsigned char *pixels;
+};
+
+struct nk_tt__hheap_chunk {
+    struct nk_tt__hheap_chunk *next;
+};
+struct nk_tt__hheap {
+    struct nk_allocator alloc;
+    struct nk_tt__hheap_chunk *head;
+    void   *first_free;
+    int    num_remaining_in_head_chunk;
+};
+
+struct nk_tt__edge {
+    float x0,y0, x1,y1;
+    int invert;
+};
+
+struct nk_tt__active_edge {
+    struct nk_tt__active_edge *next;
+    float fx,fdx,fdy;
+    float direction;
+    float sy;
+    float ey;
+};
+struct nk_tt__point {float x,y;};
+
+#define NK_TT_MACSTYLE_DONTCARE     0
+#define NK_TT_MACSTYLE_BOLD         1
+#define NK_TT_MACSTYLE_ITALIC       2
+#define NK_TT_MACSTYLE_UNDERSCORE   4
+#define NK_TT_MACSTYLE_NONE         8
+/* <= not same as 0, this makes us check the bitfield is 0 */
+
+enum { /* platformID */
+   NK_TT_PLATFORM_ID_UNICODE   =0,
+   NK_TT_PLATFORM_ID_MAC       =1,
+   NK_TT_PLATFORM_ID_ISO       =2,
+   NK_TT_PLATFORM_ID_MICROSOFT =3
+};
+
+enum { /* encodingID for NK_TT_PLATFORM_ID_UNICODE */
+   NK_TT_UNICODE_EID_UNICODE_1_0    =0,
+   NK_TT_UNICODE_EID_UNICODE_1_1    =1,
+   NK_TT_UNICODE_EID_ISO_10646      =2,
+   NK_TT_UNICODE_EID_UNICODE_2_0_BMP=3,
+   NK_TT_UNICODE_EID_UNICODE_2_0_FULL=4
+};
+
+enum { /* encodingID for NK_TT_PLATFORM_ID_MICROSOFT */
+   NK_TT_MS_EID_SYMBOL        =0,
+   NK_TT_MS_EID_UNICODE_BMP   =1,
+   NK_TT_MS_EID_SHIFTJIS      =2,
+   NK_TT_MS_EID_UNICODE_FULL  =10
+};
+
+enum { /* encodingID for NK_TT_PLATFORM_ID_MAC; same as Script Manager codes */
+   NK_TT_MAC_EID_ROMAN        =0,   NK_TT_MAC_EID_ARABIC       =4,
+   NK_TT_MAC_EID_JAPANESE     =1,   NK_TT_MAC_EID_HEBREW       =5,
+   NK_TT_MAC_EID_CHINESE_TRAD =2,   NK_TT_MAC_EID_GREEK        =6,
+   NK_TT_MAC_EID_KOREAN       =3,   NK_TT_MAC_EID_RUSSIAN      =7
+};
+
+enum { /* languageID for NK_TT_PLATFORM_ID_MICROSOFT; same as LCID... */
+       /* problematic because there are e.g. 16 english LCIDs and 16 arabic LCIDs */
+   NK_TT_MS_LANG_ENGLISH     =0x0409,   NK_TT_MS_LANG_ITALIAN     =0x0410,
+   NK_TT_MS_LANG_CHINESE     =0x0804,   NK_TT_MS_LANG_JAPANESE    =0x0411,
+   NK_TT_MS_LANG_DUTCH       =0x0413,   NK_TT_MS_LANG_KOREAN      =0x0412,
+   NK_TT_MS_LANG_FRENCH      =0x040c,   NK_TT_MS_LANG_RUSSIAN     =0x0419,
+   NK_TT_MS_LANG_GERMAN      =0x0407,   NK_TT_MS_LANG_SPANISH     =0x0409,
+   NK_TT_MS_LANG_HEBREW      =0x040d,   NK_TT_MS_LANG_SWEDISH     =0x041D
+};
+
+enum { /* languageID for NK_TT_PLATFORM_ID_MAC */
+   NK_TT_MAC_LANG_ENGLISH      =0 ,   NK_TT_MAC_LANG_JAPANESE     =11,
+   NK_TT_MAC_LANG_ARABIC       =12,   NK_TT_MAC_LANG_KOREAN       =23,
+   NK_TT_MAC_LANG_DUTCH        =4 ,   NK_TT_MAC_LANG_RUSSIAN      =32,
+   NK_TT_MAC_LANG_FRENCH       =1 ,   NK_TT_MAC_LANG_SPANISH      =6 ,
+   NK_TT_MAC_LANG_GERMAN       =2 ,   NK_TT_MAC_LANG_SWEDISH      =5 ,
+   NK_TT_MAC_LANG_HEBREW       =10,   NK_TT_MAC_LANG_CHINESE_SIMPLIFIED =33,
+   NK_TT_MAC_LANG_ITALIAN      =3 ,   NK_TT_MAC_LANG_CHINESE_TRAD =19
+};
+
+#define nk_ttBYTE(p)     (* (const nk_byte *) (p))
+#define nk_ttCHAR(p)     (* (const char *) (p))
+
+#if defined(NK_BIGENDIAN) && !defined(NK_ALLOW_UNALIGNED_TRUETYPE)
+   #define nk_ttUSHORT(p)   (* (nk_ushort *) (p))
+   #define nk_ttSHORT(p)    (* (nk_short *) (p))
+   #define nk_ttULONG(p)    (* (nk_uint *) (p))
+   #define nk_ttLONG(p)     (* (nk_int *) (p))
+#else
+    static nk_ushort nk_ttUSHORT(const nk_byte *p) { return (nk_ushort)(p[0]*256 + p[1]); }
+    static nk_short nk_ttSHORT(const nk_byte *p)   { return (nk_short)(p[0]*256 + p[1]); }
+    static nk_uint nk_ttULONG(const nk_byte *p)  { return (nk_uint)((p[0]<<24) + (p[1]<<16) + (p[2]<<8) + p[3]); }
+#endif
+
+#define nk_tt_tag4(p,c0,c1,c2,c3)\
+    ((p)[0] == (c0) && (p)[1] == (c1) && (p)[2] == (c2) && (p)[3] == (c3))
+#define nk_tt_tag(p,str) nk_tt_tag4(p,str[0],str[1],str[2],str[3])
+
+NK_INTERN int nk_tt_GetGlyphShape(const struct nk_tt_fontinfo *info, struct nk_allocator *alloc,
+                                int glyph_index, struct nk_tt_vertex **pvertices);
+
+NK_INTERN nk_uint
+nk_tt__find_table(const nk_byte *data, nk_uint fontstart, const char *tag)
+{
+    /* @OPTIMIZE: binary search */
+    nk_int num_tables = nk_ttUSHORT(data+fontstart+4);
+    nk_uint tabledir = fontstart + 12;
+    nk_int i;
+    for (i = 0; i < num_tables; ++i) {
+        nk_uint loc = tabledir + (nk_uint)(16*i);
+        if (nk_tt_tag(data+loc+0, tag))
+            return nk_ttULONG(data+loc+8);
+    }
+    return 0;
+}
+
+NK_INTERN int
+nk_tt_InitFont(struct nk_tt_fontinfo *info, const unsigned char *data2, int fontstart)
+{
+    nk_uint cmap, t;
+    nk_int i,numTables;
+    const nk_byte *data = (const nk_byte *) data2;
+
+    info->data = data;
+    info->fontstart = fontstart;
+
+    cmap = nk_tt__find_table(data, (nk_uint)fontstart, "cmap");       /* required */
+    info->loca = (int)nk_tt__find_table(data, (nk_uint)fontstart, "loca"); /* required */
+    info->head = (int)nk_tt__find_table(data, (nk_uint)fontstart, "head"); /* required */
+    info->glyf = (int)nk_tt__find_table(data, (nk_uint)fontstart, "glyf"); /* required */
+    info->hhea = (int)nk_tt__find_table(data, (nk_uint)fontstart, "hhea"); /* required */
+    info->hmtx = (int)nk_tt__find_table(data, (nk_uint)fontstart, "hmtx"); /* required */
+    info->kern = (int)nk_tt__find_table(data, (nk_uint)fontstart, "kern"); /* not required */
+    if (!cmap || !info->loca || !info->head || !info->glyf || !info->hhea || !info->hmtx)
+        return 0;
+
+    t = nk_tt__find_table(data, (nk_uint)fontstart, "maxp");
+    if (t) info->numGlyphs = nk_ttUSHORT(data+t+4);
+    else info->numGlyphs = 0xffff;
+
+    /* find a cmap encoding table we understand *now* to avoid searching */
+    /* later. (todo: could make this installable) */
+    /* the same regardless of glyph. */
+    numTables = nk_ttUSHORT(data + cmap + 2);
+    info->index_map = 0;
+    for (i=0; i < numTables; ++i)
+    {
+        nk_uint encoding_record = cmap + 4 + 8 * (nk_uint)i;
+        /* find an encoding we understand: */
+        switch(nk_ttUSHORT(data+encoding_record)) {
+        case NK_TT_PLATFORM_ID_MICROSOFT:
+            switch (nk_ttUSHORT(data+encoding_record+2)) {
+            case NK_TT_MS_EID_UNICODE_BMP:
+            case NK_TT_MS_EID_UNICODE_FULL:
+                /* MS/Unicode */
+                info->index_map = (int)(cmap + nk_ttULONG(data+encoding_record+4));
+                break;
+            default: break;
+            } break;
+        case NK_TT_PLATFORM_ID_UNICODE:
+            /* Mac/iOS has these */
+            /* all the encodingIDs are unicode, so we don't bother to check it */
+            info->index_map = (int)(cmap + nk_ttULONG(data+encoding_record+4));
+            break;
+        default: break;
+        }
+    }
+    if (info->index_map == 0)
+        return 0;
+    info->indexToLocFormat = nk_ttUSHORT(data+info->head + 50);
+    return 1;
+}
+
+NK_INTERN int
+nk_tt_FindGlyphIndex(const struct nk_tt_fontinfo *info, int unicode_codepoint)
+{
+    const nk_byte *data = info->data;
+    nk_uint index_map = (nk_uint)info->index_map;
+
+    nk_ushort format = nk_ttUSHORT(data + index_map + 0);
+    if (format == 0) { /* apple byte encoding */
+        nk_int bytes = nk_ttUSHORT(data + index_map + 2);
+        if (unicode_codepoint < bytes-6)
+            return nk_ttBYTE(data + index_map + 6 + unicode_codepoint);
+        return 0;
+    } else if (format == 6) {
+        nk_uint first = nk_ttUSHORT(data + index_map + 6);
+        nk_uint count = nk_ttUSHORT(data + index_map + 8);
+        if ((nk_uint) unicode_codepoint >= first && (nk_uint) unicode_codepoint < first+count)
+            return nk_ttUSHORT(data + index_map + 10 + (unicode_codepoint - (int)first)*2);
+        return 0;
+    } else if (format == 2) {
+        NK_ASSERT(0); /* @TODO: high-byte mapping for japanese/chinese/korean */
+        return 0;
+    } else if (format == 4) { /* standard mapping for windows fonts: binary search collection of ranges */
+        nk_ushort segcount = nk_ttUSHORT(data+index_map+6) >> 1;
+        nk_ushort searchRange = nk_ttUSHORT(data+index_map+8) >> 1;
+        nk_ushort entrySelector = nk_ttUSHORT(data+index_map+10);
+        nk_ushort rangeShift = nk_ttUSHORT(data+index_map+12) >> 1;
+
+        /* do a binary search of the segments */
+        nk_uint endCount = index_map + 14;
+        nk_uint search = endCount;
+
+        if (unicode_codepoint > 0xffff)
+            return 0;
+
+        /* they lie from endCount .. endCount + segCount */
+        /* but searchRange is the nearest power of two, so... */
+        if (unicode_codepoint >= nk_ttUSHORT(data + search + rangeShift*2))
+            search += (nk_uint)(rangeShift*2);
+
+        /* now decrement to bias correctly to find smallest */
+        search -= 2;
+        while (entrySelector) {
+            nk_ushort end;
+            searchRange >>= 1;
+            end = nk_ttUSHORT(data + search + searchRange*2);
+            if (unicode_codepoint > end)
+                search += (nk_uint)(searchRange*2);
+            --entrySelector;
+        }
+        search += 2;
+
+      {
+         nk_ushort offset, start;
+         nk_ushort item = (nk_ushort) ((search - endCount) >> 1);
+
+         NK_ASSERT(unicode_codepoint <= nk_ttUSHORT(data + endCount + 2*item));
+         start = nk_ttUSHORT(data + index_map + 14 + segcount*2 + 2 + 2*item);
+         if (unicode_codepoint < start)
+            return 0;
+
+         offset = nk_ttUSHORT(data + index_map + 14 + segcount*6 + 2 + 2*item);
+         if (offset == 0)
+            return (nk_ushort) (unicode_codepoint + nk_ttSHORT(data + index_map + 14 + segcount*4 + 2 + 2*item));
+
+         return nk_ttUSHORT(data + offset + (unicode_codepoint-start)*2 + index_map + 14 + segcount*6 + 2 + 2*item);
+      }
+   } else if (format == 12 || format == 13) {
+        nk_uint ngroups = nk_ttULONG(data+index_map+12);
+        nk_int low,high;
+        low = 0; high = (nk_int)ngroups;
+        /* Binary search the right group. */
+        while (low < high) {
+            nk_int mid = low + ((high-low) >> 1); /* rounds down, so low <= mid < high */
+            nk_uint start_char = nk_ttULONG(data+index_map+16+mid*12);
+            nk_uint end_char = nk_ttULONG(data+index_map+16+mid*12+4);
+            if ((nk_uint) unicode_codepoint < start_char)
+                high = mid;
+            else if ((nk_uint) unicode_codepoint > end_char)
+                low = mid+1;
+            else {
+                nk_uint start_glyph = nk_ttULONG(data+index_map+16+mid*12+8);
+                if (format == 12)
+                    return (int)start_glyph + (int)unicode_codepoint - (int)start_char;
+                else /* format == 13 */
+                    return (int)start_glyph;
+            }
+        }
+        return 0; /* not found */
+    }
+    /* @TODO */
+    NK_ASSERT(0);
+    return 0;
+}
+
+NK_INTERN void
+nk_tt_setvertex(struct nk_tt_vertex *v, nk_byte type, nk_int x, nk_int y, nk_int cx, nk_int cy)
+{
+    v->type = type;
+    v->x = (nk_short) x;
+    v->y = (nk_short) y;
+    v->cx = (nk_short) cx;
+    v->cy = (nk_short) cy;
+}
+
+NK_INTERN int
+nk_tt__GetGlyfOffset(const struct nk_tt_fontinfo *info, int glyph_index)
+{
+    int g1,g2;
+    if (glyph_index >= info->numGlyphs) return -1; /* glyph index out of range */
+    if (info->indexToLocFormat >= 2)    return -1; /* unknown index->glyph map format */
+
+    if (info->indexToLocFormat == 0) {
+        g1 = info->glyf + nk_ttUSHORT(info->data + info->loca + glyph_index * 2) * 2;
+        g2 = info->glyf + nk_ttUSHORT(info->data + info->loca + glyph_index * 2 + 2) * 2;
+    } else {
+        g1 = info->glyf + (int)nk_ttULONG (info->data + info->loca + glyph_index * 4);
+        g2 = info->glyf + (int)nk_ttULONG (info->data + info->loca + glyph_index * 4 + 4);
+    }
+    return g1==g2 ? -1 : g1; /* if length is 0, return -1 */
+}
+
+NK_INTERN int
+nk_tt_GetGlyphBox(const struct nk_tt_fontinfo *info, int glyph_index,
+    int *x0, int *y0, int *x1, int *y1)
+{
+    int g = nk_tt__GetGlyfOffset(info, glyph_index);
+    if (g < 0) return 0;
+
+    if (x0) *x0 = nk_ttSHORT(info->data + g + 2);
+    if (y0) *y0 = nk_ttSHORT(info->data + g + 4);
+    if (x1) *x1 = nk_ttSHORT(info->data + g + 6);
+    if (y1) *y1 = nk_ttSHORT(info->data + g + 8);
+    return 1;
+}
+
+NK_INTERN int
+stbtt__close_shape(struct nk_tt_vertex *vertices, int num_vertices, int was_off,
+    int start_off, nk_int sx, nk_int sy, nk_int scx, nk_int scy, nk_int cx, nk_int cy)
+{
+   if (start_off) {
+      if (was_off)
+         nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve, (cx+scx)>>1, (cy+scy)>>1, cx,cy);
+      nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve, sx,sy,scx,scy);
+   } else {
+      if (was_off)
+         nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve,sx,sy,cx,cy);
+      else
+         nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vline,sx,sy,0,0);
+   }
+   return num_vertices;
+}
+
+NK_INTERN int
+nk_tt_GetGlyphShape(const struct nk_tt_fontinfo *info, struct nk_allocator *alloc,
+    int glyph_index, struct nk_tt_vertex **pvertices)
+{
+    nk_short numberOfContours;
+    const nk_byte *endPtsOfContours;
+    const nk_byte *data = info->data;
+    struct nk_tt_vertex *vertices=0;
+    int num_vertices=0;
+    int g = nk_tt__GetGlyfOffset(info, glyph_index);
+    *pvertices = 0;
+
+    if (g < 0) return 0;
+    numberOfContours = nk_ttSHORT(data + g);
+    if (numberOfContours > 0) {
+        nk_byte flags=0,flagcount;
+        nk_int ins, i,j=0,m,n, next_move, was_off=0, off, start_off=0;
+        nk_int x,y,cx,cy,sx,sy, scx,scy;
+        const nk_byte *points;
+        endPtsOfContours = (data + g + 10);
+        ins = nk_ttUSHORT(data + g + 10 + numberOfContours * 2);
+        points = data + g + 10 + numberOfContours * 2 + 2 + ins;
+
+        n = 1+nk_ttUSHORT(endPtsOfContours + numberOfContours*2-2);
+        m = n + 2*numberOfContours;  /* a loose bound on how many vertices we might need */
+        vertices = (struct nk_tt_vertex *)alloc->alloc(alloc->userdata, 0, (nk_size)m * sizeof(vertices[0]));
+        if (vertices == 0)
+            return 0;
+
+        next_move = 0;
+        flagcount=0;
+
+        /* in first pass, we load uninterpreted data into the allocated array */
+        /* above, shifted to the end of the array so we won't overwrite it when */
+        /* we create our final data starting from the front */
+        off = m - n; /* starting offset for uninterpreted data, regardless of how m ends up being calculated */
+
+        /* first load flags */
+        for (i=0; i < n; ++i) {
+            if (flagcount == 0) {
+                flags = *points++;
+                if (flags & 8)
+                    flagcount = *points++;
+            } else --flagcount;
+            vertices[off+i].type = flags;
+        }
+
+        /* now load x coordinates */
+        x=0;
+        for (i=0; i < n; ++i) {
+            flags = vertices[off+i].type;
+            if (flags & 2) {
+                nk_short dx = *points++;
+                x += (flags & 16) ? dx : -dx; /* ??? */
+            } else {
+                if (!(flags & 16)) {
+                    x = x + (nk_short) (points[0]*256 + points[1]);
+                    points += 2;
+                }
+            }
+            vertices[off+i].x = (nk_short) x;
+        }
+
+        /* now load y coordinates */
+        y=0;
+        for (i=0; i < n; ++i) {
+            flags = vertices[off+i].type;
+            if (flags & 4) {
+                nk_short dy = *points++;
+                y += (flags & 32) ? dy : -dy; /* ??? */
+            } else {
+                if (!(flags & 32)) {
+                    y = y + (nk_short) (points[0]*256 + points[1]);
+                    points += 2;
+                }
+            }
+            vertices[off+i].y = (nk_short) y;
+        }
+
+        /* now convert them to our format */
+        num_vertices=0;
+        sx = sy = cx = cy = scx = scy = 0;
+        for (i=0; i < n; ++i)
+        {
+            flags = vertices[off+i].type;
+            x     = (nk_short) vertices[off+i].x;
+            y     = (nk_short) vertices[off+i].y;
+
+            if (next_move == i) {
+                if (i != 0)
+                    num_vertices = stbtt__close_shape(vertices, num_vertices, was_off, start_off, sx,sy,scx,scy,cx,cy);
+
+                /* now start the new one                */
+                start_off = !(flags & 1);
+                if (start_off) {
+                    /* if we start off with an off-curve point, then when we need to find a point on the curve */
+                    /* where we can start, and we need to save some state for when we wraparound. */
+                    scx = x;
+                    scy = y;
+                    if (!(vertices[off+i+1].type & 1)) {
+                        /* next point is also a curve point, so interpolate an on-point curve */
+                        sx = (x + (nk_int) vertices[off+i+1].x) >> 1;
+                        sy = (y + (nk_int) vertices[off+i+1].y) >> 1;
+                    } else {
+                        /* otherwise just use the next point as our start point */
+                        sx = (nk_int) vertices[off+i+1].x;
+                        sy = (nk_int) vertices[off+i+1].y;
+                        ++i; /* we're using point i+1 as the starting point, so skip it */
+                    }
+                } else {
+                    sx = x;
+                    sy = y;
+                }
+                nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vmove,sx,sy,0,0);
+                was_off = 0;
+                next_move = 1 + nk_ttUSHORT(endPtsOfContours+j*2);
+                ++j;
+            } else {
+                if (!(flags & 1))
+                { /* if it's a curve */
+                    if (was_off) /* two off-curve control points in a row means interpolate an on-curve midpoint */
+                        nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve, (cx+x)>>1, (cy+y)>>1, cx, cy);
+                    cx = x;
+                    cy = y;
+                    was_off = 1;
+                } else {
+                    if (was_off)
+                        nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vcurve, x,y, cx, cy);
+                    else nk_tt_setvertex(&vertices[num_vertices++], NK_TT_vline, x,y,0,0);
+                    was_off = 0;
+                }
+            }
+        }
+        num_vertices = stbtt__close_shape(vertices, num_vertices, was_off, start_off, sx,sy,scx,scy,cx,cy);
+    } else if (numberOfContours == -1) {
+        /* Compound shapes. */
+        int more = 1;
+        const nk_byte *comp = data + g + 10;
+        num_vertices = 0;
+        vertices = 0;
+
+        while (more)
+        {
+            nk_ushort flags, gidx;
+            int comp_num_verts = 0, i;
+            struct nk_tt_vertex *comp_verts = 0, *tmp = 0;
+            float mtx[6] = {1,0,0,1,0,0}, m, n;
+
+            flags = (nk_ushort)nk_ttSHORT(comp); comp+=2;
+            gidx = (nk_ushort)nk_ttSHORT(comp); comp+=2;
+
+            if (flags & 2) { /* XY values */
+                if (flags & 1) { /* shorts */
+                    mtx[4] = nk_ttSHORT(comp); comp+=2;
+                    mtx[5] = nk_ttSHORT(comp); comp+=2;
+                } else {
+                    mtx[4] = nk_ttCHAR(comp); comp+=1;
+                    mtx[5] = nk_ttCHAR(comp); comp+=1;
+                }
+            } else {
+                /* @TODO handle matching point */
+                NK_ASSERT(0);
+            }
+            if (flags & (1<<3)) { /* WE_HAVE_A_SCALE */
+                mtx[0] = mtx[3] = nk_ttSHORT(comp)/16384.0f; comp+=2;
+                mtx[1] = mtx[2] = 0;
+            } else if (flags & (1<<6)) { /* WE_HAVE_AN_X_AND_YSCALE */
+                mtx[0] = nk_ttSHORT(comp)/16384.0f; comp+=2;
+                mtx[1] = mtx[2] = 0;
+                mtx[3] = nk_ttSHORT(comp)/16384.0f; comp+=2;
+            } else if (flags & (1<<7)) { /* WE_HAVE_A_TWO_BY_TWO */
+                mtx[0] = nk_ttSHORT(comp)/16384.0f; comp+=2;
+                mtx[1] = nk_ttSHORT(comp)/16384.0f; comp+=2;
+                mtx[2] = nk_ttSHORT(comp)/16384.0f; comp+=2;
+                mtx[3] = nk_ttSHORT(comp)/16384.0f; comp+=2;
+            }
+
+             /* Find transformation scales. */
+            m = (float) NK_SQRT(mtx[0]*mtx[0] + mtx[1]*mtx[1]);
+            n = (float) NK_SQRT(mtx[2]*mtx[2] + mtx[3]*mtx[3]);
+
+             /* Get indexed glyph. */
+            comp_num_verts = nk_tt_GetGlyphShape(info, alloc, gidx, &comp_verts);
+            if (comp_num_verts > 0)
+            {
+                /* Transform vertices. */
+                for (i = 0; i < comp_num_verts; ++i) {
+                    struct nk_tt_vertex* v = &comp_verts[i];
+                    short x,y;
+                    x=v->x; y=v->y;
+                    v->x = (short)(m * (mtx[0]*x + mtx[2]*y + mtx[4]));
+                    v->y = (short)(n * (mtx[1]*x + mtx[3]*y + mtx[5]));
+                    x=v->cx; y=v->cy;
+                    v->cx = (short)(m * (mtx[0]*x + mtx[2]*y + mtx[4]));
+                    v->cy = (short)(n * (mtx[1]*x + mtx[3]*y + mtx[5]));
+                }
+                /* Append vertices. */
+                tmp = (struct nk_tt_vertex*)alloc->alloc(alloc->userdata, 0,
+                    (nk_size)(num_vertices+comp_num_verts)*sizeof(struct nk_tt_vertex));
+                if (!tmp) {
+                    if (vertices) alloc->free(alloc->userdata, vertices);
+                    if (comp_verts) alloc->free(alloc->userdata, comp_verts);
+                    return 0;
+                }
+                if (num_vertices > 0) NK_MEMCPY(tmp, vertices, (nk_size)num_vertices*sizeof(struct nk_tt_vertex));
+                NK_MEMCPY(tmp+num_vertices, comp_verts, (nk_size)comp_num_verts*sizeof(struct nk_tt_vertex));
+                if (vertices) alloc->free(alloc->userdata,vertices);
+                vertices = tmp;
+                alloc->free(alloc->userdata,comp_verts);
+                num_vertices += comp_num_verts;
+            }
+            /* More components ? */
+            more = flags & (1<<5);
+        }
+    } else if (numberOfContours < 0) {
+        /* @TODO other compound variations? */
+        NK_ASSERT(0);
+    } else {
+        /* numberOfCounters == 0, do nothing */
+    }
+    *pvertices = vertices;
+    return num_vertices;
+}
+
+NK_INTERN void
+nk_tt_GetGlyphHMetrics(const struct nk_tt_fontinfo *info, int glyph_index,
+    int *advanceWidth, int *leftSideBearing)
+{
+    nk_ushort numOfLongHorMetrics = nk_ttUSHORT(info->data+info->hhea + 34);
+    if (glyph_index < numOfLongHorMetrics) {
+        if (advanceWidth)
+            *advanceWidth    = nk_ttSHORT(info->data + info->hmtx + 4*glyph_index);
+        if (leftSideBearing)
+            *leftSideBearing = nk_ttSHORT(info->data + info->hmtx + 4*glyph_index + 2);
+    } else {
+        if (advanceWidth)
+            *advanceWidth    = nk_ttSHORT(info->data + info->hmtx + 4*(numOfLongHorMetrics-1));
+        if (leftSideBearing)
+            *leftSideBearing = nk_ttSHORT(info->data + info->hmtx + 4*numOfLongHorMetrics + 2*(glyph_index - numOfLongHorMetrics));
+    }
+}
+
+NK_INTERN void
+nk_tt_GetFontVMetrics(const struct nk_tt_fontinfo *info,
+    int *ascent, int *descent, int *lineGap)
+{
+   if (ascent ) *ascent  = nk_ttSHORT(info->data+info->hhea + 4);
+   if (descent) *descent = nk_ttSHORT(info->data+info->hhea + 6);
+   if (lineGap) *lineGap = nk_ttSHORT(info->data+info->hhea + 8);
+}
+
+NK_INTERN float
+nk_tt_ScaleForPixelHeight(const struct nk_tt_fontinfo *info, float height)
+{
+   int fheight = nk_ttSHORT(info->data + info->hhea + 4) - nk_ttSHORT(info->data + info->hhea + 6);
+   return (float) height / (float)fheight;
+}
+
+NK_INTERN float
+nk_tt_ScaleForMappingEmToPixels(const struct nk_tt_fontinfo *info, float pixels)
+{
+   int unitsPerEm = nk_ttUSHORT(info->data + info->head + 18);
+   return pixels / (float)unitsPerEm;
+}
+
+/*-------------------------------------------------------------
+ *            antialiasing software rasterizer
+ * --------------------------------------------------------------*/
+NK_INTERN void
+nk_tt_GetGlyphBitmapBoxSubpixel(const struct nk_tt_fontinfo *font,
+    int glyph, float scale_x, float scale_y,float shift_x, float shift_y,
+    int *ix0, int *iy0, int *ix1, int *iy1)
+{
+    int x0,y0,x1,y1;
+    if (!nk_tt_GetGlyphBox(font, glyph, &x0,&y0,&x1,&y1)) {
+        /* e.g. space character */
+        if (ix0) *ix0 = 0;
+        if (iy0) *iy0 = 0;
+        if (ix1) *ix1 = 0;
+        if (iy1) *iy1 = 0;
+    } else {
+        /* move to integral bboxes (treating pixels as little squares, what pixels get touched)? */
+        if (ix0) *ix0 = nk_ifloorf((float)x0 * scale_x + shift_x);
+        if (iy0) *iy0 = nk_ifloorf((float)-y1 * scale_y + shift_y);
+        if (ix1) *ix1 = nk_iceilf ((float)x1 * scale_x + shift_x);
+        if (iy1) *iy1 = nk_iceilf ((float)-y0 * scale_y + shift_y);
+    }
+}
+
+NK_INTERN void
+nk_tt_GetGlyphBitmapBox(const struct nk_tt_fontinfo *font, int glyph,
     float scale_x, float scale_y, int *ix0, int *iy0, int *ix1, int *iy1)
 {
    nk_tt_GetGlyphBitmapBoxSubpixel(font, glyph, scale_x, scale_y,0.0f,0.0f, ix0, iy0, ix1, iy1);
@@ -12113,33 +15427,130 @@ nk_font_query_font_glyph(nk_handle handle, float height,
 }
 #endif
 
-NK_API const struct nk_font_glyph*
-nk_font_find_glyph(struct nk_font *font, nk_rune unicode)
+NK_INTERN const struct nk_font_glyph*
+nk_font_search_glyph(const struct nk_font *font, nk_rune unicode)
 {
+    /* linear search through the ranges of all merged font configs */
     int i = 0;
     int count;
     int total_glyphs = 0;
+    const struct nk_font_config *iter = font->config;
+    do {count = nk_range_count(iter->range);
+        for (i = 0; i < count; ++i) {
+            nk_rune f = iter->range[(i*2)+0];
+            nk_rune t = iter->range[(i*2)+1];
+            int diff = (int)((t - f) + 1);
+            if (unicode >= f && unicode <= t)
+                return &font->glyphs[((nk_rune)total_glyphs + (unicode - f))];
+            total_glyphs += diff;
+        }
+    } while ((iter = iter->n) != font->config);
+    return 0;
+}
+
+NK_API const struct nk_font_glyph*
+nk_font_find_glyph(struct nk_font *font, nk_rune unicode)
+{
     const struct nk_font_glyph *glyph = 0;
-    const struct nk_font_config *iter = 0;
-
     NK_ASSERT(font);
     NK_ASSERT(font->glyphs);
     NK_ASSERT(font->info.ranges);
     if (!font || !font->glyphs) return 0;
 
-    glyph = font->fallback;
+    if (unicode < NK_LEN(font->latin))
+        return font->latin[unicode];
+    if (font->ranges) {
+        /* binary search through the ranges built at bake time */
+        int lo = 0, hi = font->range_count - 1;
+        while (lo <= hi) {
+            const int mid = (lo + hi) / 2;
+            const struct nk_font_glyph_range *r = &font->ranges[mid];
+            if (unicode < r->first) hi = mid - 1;
+            else if (unicode > r->last) lo = mid + 1;
+            else return &font->glyphs[r->glyph + (unicode - r->first)];
+        }
+        return font->fallback;
+    }
+    glyph = nk_font_search_glyph(font, unicode);
+    return (glyph) ? glyph: font->fallback;
+}
+
+NK_INTERN void
+nk_font_build_ranges(struct nk_font *font, struct nk_allocator *permanent,
+    struct nk_allocator *temporary)
+{
+    /* Splits the codepoint ranges of all merged font configs above the
+     * `latin` table at every range boundary into sorted non overlapping
+     * ranges for `nk_font_find_glyph`. Each piece keeps the glyphs of the
+     * first config range containing it, same as the linear search. */
+    const struct nk_font_config *iter;
+    nk_rune *bounds;
+    int count = 0, bound_count = 0, i, j;
+    const nk_rune first_rune = (nk_rune)NK_LEN(font->latin);
+
+    if (font->ranges)
+        permanent->free(permanent->userdata, font->ranges);
+    font->ranges = 0;
+    font->range_count = 0;
+
     iter = font->config;
-    do {count = nk_range_count(iter->range);
-        for (i = 0; i < count; ++i) {
-            nk_rune f = iter->range[(i*2)+0];
+    do {count += nk_range_count(iter->range);
+    } while ((iter = iter->n) != font->config);
+    if (!count) return;
+
+    bounds = (nk_rune*)temporary->alloc(temporary->userdata, 0, sizeof(nk_rune) * 2 * (nk_size)count);
+    font->ranges = (struct nk_font_glyph_range*)permanent->alloc(permanent->userdata, 0,
+        sizeof(struct nk_font_glyph_range) * 2 * (nk_size)count);
+    if (!bounds || !font->ranges) goto failed;
+
+    /* collect every range start and end as sorted unique boundaries */
+    iter = font->config;
+    do {const int n = nk_range_count(iter->range);
+        for (i = 0; i < n; ++i) {
+            nk_rune f = NK_MAX(iter->range[(i*2)+0], first_rune);
             nk_rune t = iter->range[(i*2)+1];
-            int diff = (int)((t - f) + 1);
-            if (unicode >= f && unicode <= t)
-                return &font->glyphs[((nk_rune)total_glyphs + (unicode - f))];
-            total_glyphs += diff;
+            if (f > t) continue;
+            bounds[bound_count++] = f;
+            bounds[bound_count++] = t + 1;
         }
     } while ((iter = iter->n) != font->config);
-    return glyph;
+    for (i = 1; i < bound_count; ++i) {
+        nk_rune b = bounds[i];
+        for (j = i; j > 0 && bounds[j-1] > b; --j)
+            bounds[j] = bounds[j-1];
+        bounds[j] = b;
+    }
+
+    /* look up each interval between two boundaries once */
+    for (i = 0; i + 1 < bound_count; ++i) {
+        const nk_rune lo = bounds[i];
+        const nk_rune hi = bounds[i+1] - 1;
+        const struct nk_font_glyph *glyph;
+        struct nk_font_glyph_range *prev;
+        nk_rune index;
+        if (lo > hi) continue;
+        glyph = nk_font_search_glyph(font, lo);
+        if (!glyph) continue;
+
+        index = (nk_rune)(glyph - font->glyphs);
+        prev = (font->range_count) ? &font->ranges[font->range_count-1]: 0;
+        if (prev && prev->last + 1 == lo && prev->glyph + (lo - prev->first) == index) {
+            prev->last = hi;
+        } else {
+            prev = &font->ranges[font->range_count++];
+            prev->first = lo;
+            prev->last = hi;
+            prev->glyph = index;
+        }
+    }
+    temporary->free(temporary->userdata, bounds);
+    return;
+
+failed:
+    if (bounds) temporary->free(temporary->userdata, bounds);
+    if (font->ranges) permanent->free(permanent->userdata, font->ranges);
+    font->ranges = 0;
+    font->range_count = 0;
 }
 
 NK_INTERN void
@@ -12161,7 +15572,12 @@ nk_font_init(struct nk_font *font, float pixel_height,
     font->glyphs = &glyphs[baked_font->glyph_offset];
     font->texture = atlas;
     font->fallback_codepoint = fallback_codepoint;
-    font->fallback = nk_font_find_glyph(font, fallback_codepoint);
+    font->fallback = nk_font_search_glyph(font, fallback_codepoint);
+    {nk_rune i;
+    for (i = 0; i < (nk_rune)NK_LEN(font->latin); ++i) {
+        font->latin[i] = nk_font_search_glyph(font, i);
+        if (!font->latin[i]) font->latin[i] = font->fallback;
+    }}
 
     font->handle.height = font->info.height * font->scale;
     font->handle.width = nk_font_text_width;
@@ -12857,6 +16273,7 @@ nk_font_atlas_bake(struct nk_font_atlas *atlas, int *width, int *height,
         struct nk_font_config *config = font->config;
         nk_font_init(font, config->size, config->fallback_glyph, atlas->glyphs,
             config->font, nk_handle_ptr(0));
+        nk_font_build_ranges(font, &atlas->permanent, &atlas->temporary);
     }
 
     /* initialize each cursor */
@@ -12989,6 +16406,8 @@ nk_font_atlas_clear(struct nk_font_atlas *atlas)
         struct nk_font *iter, *next;
         for (iter = atlas->fonts; iter; iter = next) {
             next = iter->next;
+            if (iter->ranges)
+                atlas->permanent.free(atlas->permanent.userdata, iter->ranges);
             atlas->permanent.free(atlas->permanent.userdata, iter);
         }
         atlas->fonts = 0;
@@ -16663,8 +20082,10 @@ nk_do_property(nk_flags *ws,
     text_edit->string.buffer.memory.ptr = dst;
     text_edit->string.buffer.size = NK_MAX_NUMBER_BUFFER;
     text_edit->mode = NK_TEXT_EDIT_MODE_INSERT;
+    nk_draw_text_copy(out, nk_true);
     nk_do_edit(ws, out, edit, NK_EDIT_FIELD|NK_EDIT_AUTO_SELECT,
         filters[filter], text_edit, &style->edit, (*state == NK_PROPERTY_EDIT) ? in: 0, font);
+    nk_draw_text_copy(out, nk_false);
 
     *length = text_edit->string.len;
     *cursor = text_edit->cursor;
@@ -17653,10 +21074,22 @@ nk_pool_init_fixed(struct nk_pool *pool, void *memory, nk_size size)
     if (size < sizeof(struct nk_page)) return;
     pool->capacity = (unsigned)(size - sizeof(struct nk_page)) / sizeof(struct nk_page_element);
     pool->pages = (struct nk_page*)memory;
+    pool->pages->size = 0;
+    pool->pages->live = 0;
+    pool->pages->next = 0;
     pool->type = NK_BUFFER_FIXED;
+    pool->page_count = 1;
     pool->size = size;
 }
 
+NK_INTERN nk_size
+nk_pool_page_size(const struct nk_pool *pool)
+{
+    if (pool->type == NK_BUFFER_FIXED)
+        return pool->size;
+    return sizeof(struct nk_page) + pool->capacity * sizeof(struct nk_page_element);
+}
+
 NK_INTERN struct nk_page_element*
 nk_pool_alloc(struct nk_pool *pool)
 {
@@ -17671,12 +21104,15 @@ nk_pool_alloc(struct nk_pool *pool)
             NK_ASSERT(pool->pages->size < pool->capacity);
             return 0;
         } else {
-            nk_size size = sizeof(struct nk_page);
-            size += NK_POOL_DEFAULT_CAPACITY * sizeof(union nk_page_data);
+            nk_size size = nk_pool_page_size(pool);
             page = (struct nk_page*)pool->alloc.alloc(pool->alloc.userdata,0, size);
+            NK_ASSERT(page);
+            if (!page) return 0;
             page->next = pool->pages;
             pool->pages = page;
             page->size = 0;
+            page->live = 0;
+            pool->page_count++;
         }
     }
     return &pool->pages->win[pool->pages->size++];
@@ -17692,6 +21128,8 @@ NK_INTERN void nk_remove_window(struct nk_context*, struct nk_window*);
 NK_INTERN void nk_free_window(struct nk_context *ctx, struct nk_window *win);
 NK_INTERN void nk_free_table(struct nk_context *ctx, struct nk_table *tbl);
 NK_INTERN void nk_remove_table(struct nk_window *win, struct nk_table *tbl);
+NK_INTERN int nk_table_has_children(const struct nk_table *tbl);
+NK_INTERN void nk_window_cache_free(struct nk_context *ctx, struct nk_window *win);
 NK_INTERN void* nk_create_panel(struct nk_context *ctx);
 NK_INTERN void nk_free_panel(struct nk_context*, struct nk_panel *pan);
 
@@ -17785,8 +21223,15 @@ nk_free(struct nk_context *ctx)
     NK_ASSERT(ctx);
     if (!ctx) return;
     nk_buffer_free(&ctx->memory);
-    if (ctx->use_pool)
+    if (ctx->use_pool) {
+        struct nk_window *iter;
+        for (iter = ctx->begin; iter; iter = iter->next) {
+            if (iter->popup.win)
+                nk_window_cache_free(ctx, iter->popup.win);
+            nk_window_cache_free(ctx, iter);
+        }
         nk_pool_free(&ctx->pool);
+    }
 
     nk_zero(&ctx->input, sizeof(ctx->input));
     nk_zero(&ctx->style, sizeof(ctx->style));
@@ -17799,7 +21244,252 @@ nk_free(struct nk_context *ctx)
     ctx->active = 0;
     ctx->current = 0;
     ctx->freelist = 0;
+    ctx->freelist_count = 0;
+    ctx->element_count = 0;
+    ctx->element_peak = 0;
     ctx->count = 0;
+    nk_zero(ctx->window_index, sizeof(ctx->window_index));
+    ctx->window_index_count = 0;
+    ctx->window_index_missed = 0;
+    nk_zero(&ctx->stats, sizeof(ctx->stats));
+}
+
+NK_API nk_size
+nk_trim(struct nk_context *ctx)
+{
+    struct nk_page_element *elem, *next;
+    struct nk_page_element *keep = 0;
+    struct nk_page **iter;
+    nk_size released = 0;
+
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->use_pool || ctx->pool.type == NK_BUFFER_FIXED)
+        return 0;
+
+    /* unlink elements of completely unused pages from freelist */
+    elem = ctx->freelist;
+    while (elem) {
+        next = elem->next;
+        if (elem->page && !elem->page->live) {
+            ctx->freelist_count--;
+        } else {
+            elem->next = keep;
+            keep = elem;
+        }
+        elem = next;
+    }
+    ctx->freelist = keep;
+
+    /* return unused pages to the allocator */
+    iter = &ctx->pool.pages;
+    while (*iter) {
+        struct nk_page *page = *iter;
+        if (page->live) {
+            iter = &page->next;
+            continue;
+        }
+        *iter = page->next;
+        ctx->pool.alloc.free(ctx->pool.alloc.userdata, page);
+        ctx->pool.page_count--;
+        released += nk_pool_page_size(&ctx->pool);
+    }
+    return released;
+}
+
+NK_API void
+nk_page_info(struct nk_page_status *s, struct nk_context *ctx)
+{
+    NK_ASSERT(s);
+    NK_ASSERT(ctx);
+    if (!s || !ctx) return;
+    s->element_size = sizeof(struct nk_page_element);
+    s->elements = ctx->element_count;
+    s->elements_free = ctx->freelist_count;
+    s->elements_peak = ctx->element_peak;
+    if (ctx->use_pool) {
+        s->pages = ctx->pool.page_count;
+        s->allocated = s->pages * nk_pool_page_size(&ctx->pool);
+    } else {
+        /* page elements are allocated from the back of the command buffer */
+        s->pages = 0;
+        s->allocated = (nk_size)(s->elements + s->elements_free) * s->element_size;
+    }
+}
+
+NK_INTERN nk_size
+nk_command_fixed_size(enum nk_command_type type)
+{
+    /* size of a command without its trailing points or text */
+    switch (type) {
+    default:
+    case NK_COMMAND_NOP: return sizeof(struct nk_command);
+    case NK_COMMAND_SCISSOR: return sizeof(struct nk_command_scissor);
+    case NK_COMMAND_LINE: return sizeof(struct nk_command_line);
+    case NK_COMMAND_CURVE: return sizeof(struct nk_command_curve);
+    case NK_COMMAND_RECT: return sizeof(struct nk_command_rect);
+    case NK_COMMAND_RECT_FILLED: return sizeof(struct nk_command_rect_filled);
+    case NK_COMMAND_RECT_MULTI_COLOR: return sizeof(struct nk_command_rect_multi_color);
+    case NK_COMMAND_CIRCLE: return sizeof(struct nk_command_circle);
+    case NK_COMMAND_CIRCLE_FILLED: return sizeof(struct nk_command_circle_filled);
+    case NK_COMMAND_ARC: return sizeof(struct nk_command_arc);
+    case NK_COMMAND_ARC_FILLED: return sizeof(struct nk_command_arc_filled);
+    case NK_COMMAND_TRIANGLE: return sizeof(struct nk_command_triangle);
+    case NK_COMMAND_TRIANGLE_FILLED: return sizeof(struct nk_command_triangle_filled);
+    case NK_COMMAND_POLYGON: return sizeof(struct nk_command_polygon);
+    case NK_COMMAND_POLYGON_FILLED: return sizeof(struct nk_command_polygon_filled);
+    case NK_COMMAND_POLYLINE: return sizeof(struct nk_command_polyline);
+    case NK_COMMAND_TEXT: return sizeof(struct nk_command_text);
+    case NK_COMMAND_IMAGE: return sizeof(struct nk_command_image);
+    case NK_COMMAND_CUSTOM: return sizeof(struct nk_command_custom);
+    }
+}
+
+NK_INTERN nk_size
+nk_command_size(const struct nk_command *cmd)
+{
+    switch (cmd->type) {
+    default: return nk_command_fixed_size(cmd->type);
+    case NK_COMMAND_POLYGON: return sizeof(struct nk_command_polygon) +
+        sizeof(short) * 2 * ((const struct nk_command_polygon*)cmd)->point_count;
+    case NK_COMMAND_POLYGON_FILLED: return sizeof(struct nk_command_polygon_filled) +
+        sizeof(short) * 2 * ((const struct nk_command_polygon_filled*)cmd)->point_count;
+    case NK_COMMAND_POLYLINE: return sizeof(struct nk_command_polyline) +
+        sizeof(short) * 2 * ((const struct nk_command_polyline*)cmd)->point_count;
+#ifdef NK_ZERO_COPY_TEXT
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        if (t->string && t->string != (const char*)(t + 1))
+            return sizeof(struct nk_command_text);
+        return sizeof(struct nk_command_text) + (nk_size)t->length + 1;
+    }
+#else
+    case NK_COMMAND_TEXT: return sizeof(struct nk_command_text) +
+        (nk_size)((const struct nk_command_text*)cmd)->length + 1;
+#endif
+    }
+}
+
+NK_INTERN nk_size
+nk_command_copy_size(const struct nk_command *cmd)
+{
+    /* size of a command copied by `nk_command_copy` */
+#ifdef NK_ZERO_COPY_TEXT
+    if (cmd->type == NK_COMMAND_TEXT)
+        return sizeof(struct nk_command_text) +
+            (nk_size)((const struct nk_command_text*)cmd)->length + 1;
+#endif
+    return nk_command_size(cmd);
+}
+
+NK_INTERN void
+nk_command_copy(struct nk_command *dst, const struct nk_command *src)
+{
+    /* copies a command including referenced text so it can outlive the
+     * current frame or the context it was drawn in */
+#ifdef NK_ZERO_COPY_TEXT
+    if (src->type == NK_COMMAND_TEXT) {
+        const struct nk_command_text *t = (const struct nk_command_text*)src;
+        struct nk_command_text *copy = (struct nk_command_text*)dst;
+        char *string = (char*)(copy + 1);
+        NK_MEMCPY(copy, t, sizeof(*t));
+        NK_MEMCPY(string, nk_command_text_string(t), (nk_size)t->length);
+        string[t->length] = '\0';
+        copy->string = 0;
+        return;
+    }
+#endif
+    NK_MEMCPY(dst, src, nk_command_size(src));
+}
+
+NK_INTERN void
+nk_command_stats_add(struct nk_command_stats *s, const struct nk_buffer *buffer,
+    nk_size begin, nk_size last, nk_size end)
+{
+    nk_size offset = begin;
+    while (offset >= begin && offset < end) {
+        const struct nk_command *cmd = (const struct nk_command*)nk_buffer_at(buffer, offset);
+        nk_size size = nk_command_size(cmd);
+        s->bytes += size;
+        s->count++;
+        if ((unsigned)cmd->type < NK_COMMAND_TYPE_COUNT) {
+            s->type_bytes[cmd->type] += size;
+            s->type_count[cmd->type]++;
+        }
+        if (offset == last || cmd->next <= offset) break;
+        offset = cmd->next;
+    }
+}
+
+NK_INTERN int
+nk_window_command_stats(struct nk_command_stats *s,
+    const struct nk_context *ctx, const struct nk_window *win)
+{
+    const struct nk_buffer *buffer = &ctx->memory;
+    if (win->seq != ctx->seq || (win->flags & NK_WINDOW_HIDDEN) ||
+        win->buffer.last == win->buffer.begin)
+        return nk_false;
+    nk_command_stats_add(s, buffer, win->buffer.begin, win->buffer.last, win->buffer.end);
+    if (win->popup.buf.active) {
+        const struct nk_popup_buffer *buf = &win->popup.buf;
+        nk_command_stats_add(s, buffer, buf->begin, buf->last, buf->end);
+    }
+    return nk_true;
+}
+
+NK_API void
+nk_context_info(struct nk_context_stats *s, struct nk_context *ctx)
+{
+    struct nk_context_stats *peak;
+    struct nk_window *iter;
+    NK_ASSERT(s);
+    NK_ASSERT(ctx);
+    if (!s || !ctx) return;
+
+    *s = ctx->stats;
+    nk_zero(&s->commands, sizeof(s->commands));
+    s->windows = 0;
+    s->windows_occluded = 0;
+    s->tables = 0;
+    for (iter = ctx->begin; iter; iter = iter->next) {
+        s->tables += iter->table_count;
+        if (nk_window_command_stats(&s->commands, ctx, iter))
+            s->windows++;
+        if (iter->flags & NK_WINDOW_OCCLUDED)
+            s->windows_occluded++;
+    }
+    if (ctx->overlay.end != ctx->overlay.begin) {
+        nk_command_stats_add(&s->commands, &ctx->memory,
+            ctx->overlay.begin, ctx->overlay.last, ctx->overlay.end);
+    }
+    nk_page_info(&s->pages, ctx);
+    nk_buffer_info(&s->memory, &ctx->memory);
+
+    /* update peak values */
+    peak = &ctx->stats;
+    peak->command_bytes_peak = NK_MAX(peak->command_bytes_peak, s->commands.bytes);
+    peak->command_count_peak = NK_MAX(peak->command_count_peak, s->commands.count);
+    peak->tables_peak = NK_MAX(peak->tables_peak, s->tables);
+    peak->memory_peak = NK_MAX(peak->memory_peak, s->memory.allocated);
+    peak->memory_needed_peak = NK_MAX(peak->memory_needed_peak, s->memory.needed);
+    s->command_bytes_peak = peak->command_bytes_peak;
+    s->command_count_peak = peak->command_count_peak;
+    s->tables_peak = peak->tables_peak;
+    s->memory_peak = peak->memory_peak;
+    s->memory_needed_peak = peak->memory_needed_peak;
+}
+
+NK_API void
+nk_window_command_info(struct nk_command_stats *s, struct nk_context *ctx,
+    const char *name)
+{
+    struct nk_window *win;
+    NK_ASSERT(s);
+    NK_ASSERT(ctx);
+    if (!s || !ctx) return;
+
+    nk_zero(s, sizeof(*s));
+    win = nk_window_find(ctx, name);
+    if (win) nk_window_command_stats(s, ctx, win);
 }
 
 NK_API void
@@ -17810,6 +21500,8 @@ nk_clear(struct nk_context *ctx)
     NK_ASSERT(ctx);
 
     if (!ctx) return;
+    ctx->stats.memory_peak = NK_MAX(ctx->stats.memory_peak, ctx->memory.allocated);
+    ctx->stats.memory_needed_peak = NK_MAX(ctx->stats.memory_needed_peak, ctx->memory.needed);
     if (ctx->use_pool)
         nk_buffer_clear(&ctx->memory);
     else nk_buffer_reset(&ctx->memory, NK_BUFFER_FRONT);
@@ -17830,6 +21522,7 @@ nk_clear(struct nk_context *ctx)
         if ((iter->flags & NK_WINDOW_MINIMIZED) &&
             !(iter->flags & NK_WINDOW_CLOSED) &&
             iter->seq == ctx->seq) {
+            iter->popup.buf.active = nk_false;
             iter = iter->next;
             continue;
         }
@@ -17847,20 +21540,27 @@ nk_clear(struct nk_context *ctx)
             nk_free_window(ctx, iter->popup.win);
             iter->popup.win = 0;
         }
-        /* remove unused window state tables */
-        {struct nk_table *n, *it = iter->tables;
-        while (it) {
-            n = it->next;
-            if (it->seq != ctx->seq) {
-                nk_remove_table(iter, it);
-                nk_zero(it, sizeof(union nk_page_data));
-                nk_free_table(ctx, it);
-                if (it == iter->tables)
-                    iter->tables = n;
-            } it = n;
+        /* remove unused window state tables. Used tables are at the front
+         * so only unused tables are visited starting at the back, which
+         * always removes children before their parent table */
+        {struct nk_table *n, *it = iter->table_last;
+        while (it && it->seq != ctx->seq) {
+            n = it->prev;
+            NK_ASSERT(!nk_table_has_children(it));
+            nk_remove_table(iter, it);
+            nk_zero(it, sizeof(union nk_page_data));
+            nk_free_table(ctx, it);
+            it = n;
         }}
+        /* popup draw commands are only valid for one frame */
+        iter->popup.buf.active = nk_false;
         /* window itself is not used anymore so free */
         if (iter->seq != ctx->seq || iter->flags & NK_WINDOW_CLOSED) {
+            struct nk_rect *freed = &ctx->damage_freed;
+            if (iter->damage_area.w > 0 && iter->damage_area.h > 0) {
+                *freed = (freed->w > 0 && freed->h > 0) ?
+                    nk_rect_union(*freed, iter->damage_area): iter->damage_area;
+            }
             next = iter->next;
             nk_remove_window(ctx, iter);
             nk_free_window(ctx, iter);
@@ -17881,7 +21581,9 @@ nk_start_buffer(struct nk_context *ctx, struct nk_command_buffer *buffer)
     NK_ASSERT(ctx);
     NK_ASSERT(buffer);
     if (!ctx || !buffer) return;
-    buffer->begin = ctx->memory.allocated;
+    /* commands are aligned so make sure the first one starts at `begin` */
+    buffer->begin = ctx->memory.allocated + NK_ALIGNOF(struct nk_command) - 1;
+    buffer->begin -= buffer->begin % NK_ALIGNOF(struct nk_command);
     buffer->end = buffer->begin;
     buffer->last = buffer->begin;
     buffer->clip = nk_null_rect;
@@ -17931,7 +21633,8 @@ nk_finish_buffer(struct nk_context *ctx, struct nk_command_buffer *buffer)
     NK_ASSERT(ctx);
     NK_ASSERT(buffer);
     if (!ctx || !buffer) return;
-    buffer->end = ctx->memory.allocated;
+    buffer->end = ctx->memory.allocated + NK_ALIGNOF(struct nk_command) - 1;
+    buffer->end -= buffer->end % NK_ALIGNOF(struct nk_command);
 }
 
 NK_INTERN void
@@ -17939,7 +21642,6 @@ nk_finish(struct nk_context *ctx, struct nk_window *win)
 {
     struct nk_popup_buffer *buf;
     struct nk_command *parent_last;
-    void *memory;
 
     NK_ASSERT(ctx);
     NK_ASSERT(win);
@@ -17948,17 +21650,309 @@ nk_finish(struct nk_context *ctx, struct nk_window *win)
     if (!win->popup.buf.active) return;
 
     buf = &win->popup.buf;
-    memory = ctx->memory.memory.ptr;
-    parent_last = nk_ptr_add(struct nk_command, memory, buf->parent);
+    parent_last = (struct nk_command*)nk_buffer_at(&ctx->memory, buf->parent);
     parent_last->next = buf->end;
 }
 
+/* number of previous commands checked for being covered by an opaque rectangle */
+#define NK_OPTIMIZE_LOOKBACK 16
+/* extra space around command bounds to cover anti-aliased edges and rounding */
+#define NK_OPTIMIZE_PADDING 1.0f
+
+struct nk_optimize_candidate {
+    struct nk_command *cmd;
+    struct nk_rect clip;
+};
+
+NK_INTERN int
+nk_command_bounds(struct nk_rect *bounds, const struct nk_command *cmd)
+{
+    /* screen area which can be touched by a draw command. Returns
+     * false(0) for commands without simple bounds */
+    float x0, y0, x1, y1, pad = NK_OPTIMIZE_PADDING;
+    switch (cmd->type) {
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line*)cmd;
+        x0 = (float)NK_MIN(l->begin.x, l->end.x);
+        y0 = (float)NK_MIN(l->begin.y, l->end.y);
+        x1 = (float)NK_MAX(l->begin.x, l->end.x);
+        y1 = (float)NK_MAX(l->begin.y, l->end.y);
+        pad += (float)l->line_thickness;
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        x0 = (float)r->x; y0 = (float)r->y;
+        x1 = x0 + (float)r->w; y1 = y0 + (float)r->h;
+        pad += (float)r->line_thickness;
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        x0 = (float)r->x; y0 = (float)r->y;
+        x1 = x0 + (float)r->w; y1 = y0 + (float)r->h;
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
+        x0 = (float)r->x; y0 = (float)r->y;
+        x1 = x0 + (float)r->w; y1 = y0 + (float)r->h;
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        x0 = (float)c->x; y0 = (float)c->y;
+        x1 = x0 + (float)c->w; y1 = y0 + (float)c->h;
+        pad += (float)c->line_thickness;
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled*)cmd;
+        x0 = (float)c->x; y0 = (float)c->y;
+        x1 = x0 + (float)c->w; y1 = y0 + (float)c->h;
+    } break;
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
+        x0 = (float)NK_MIN(t->a.x, NK_MIN(t->b.x, t->c.x));
+        y0 = (float)NK_MIN(t->a.y, NK_MIN(t->b.y, t->c.y));
+        x1 = (float)NK_MAX(t->a.x, NK_MAX(t->b.x, t->c.x));
+        y1 = (float)NK_MAX(t->a.y, NK_MAX(t->b.y, t->c.y));
+        pad += (float)t->line_thickness;
+    } break;
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled*)cmd;
+        x0 = (float)NK_MIN(t->a.x, NK_MIN(t->b.x, t->c.x));
+        y0 = (float)NK_MIN(t->a.y, NK_MIN(t->b.y, t->c.y));
+        x1 = (float)NK_MAX(t->a.x, NK_MAX(t->b.x, t->c.x));
+        y1 = (float)NK_MAX(t->a.y, NK_MAX(t->b.y, t->c.y));
+    } break;
+    case NK_COMMAND_TEXT: {
+        /* glyphs can reach outside of the text bounds */
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        x0 = (float)t->x; y0 = (float)t->y;
+        x1 = x0 + (float)t->w; y1 = y0 + (float)t->h;
+        pad += t->height;
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+        x0 = (float)i->x; y0 = (float)i->y;
+        x1 = x0 + (float)i->w; y1 = y0 + (float)i->h;
+    } break;
+    default: return nk_false;
+    }
+    *bounds = nk_rect(x0 - pad, y0 - pad, (x1 - x0) + 2.0f * pad, (y1 - y0) + 2.0f * pad);
+    return nk_true;
+}
+
+NK_INTERN int
+nk_command_is_empty(const struct nk_command *cmd)
+{
+    /* commands without area or fully transparent color */
+    switch (cmd->type) {
+    case NK_COMMAND_LINE:
+        return ((const struct nk_command_line*)cmd)->color.a == 0;
+    case NK_COMMAND_CURVE:
+        return ((const struct nk_command_curve*)cmd)->color.a == 0;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect*)cmd;
+        return r->w == 0 || r->h == 0 || r->color.a == 0;
+    }
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        return r->w == 0 || r->h == 0 || r->color.a == 0;
+    }
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color*)cmd;
+        return r->w == 0 || r->h == 0 || (r->left.a == 0 && r->top.a == 0 &&
+            r->bottom.a == 0 && r->right.a == 0);
+    }
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle*)cmd;
+        return c->w == 0 || c->h == 0 || c->color.a == 0;
+    }
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled*)cmd;
+        return c->w == 0 || c->h == 0 || c->color.a == 0;
+    }
+    case NK_COMMAND_ARC:
+        return ((const struct nk_command_arc*)cmd)->color.a == 0;
+    case NK_COMMAND_ARC_FILLED:
+        return ((const struct nk_command_arc_filled*)cmd)->color.a == 0;
+    case NK_COMMAND_TRIANGLE:
+        return ((const struct nk_command_triangle*)cmd)->color.a == 0;
+    case NK_COMMAND_TRIANGLE_FILLED:
+        return ((const struct nk_command_triangle_filled*)cmd)->color.a == 0;
+    case NK_COMMAND_POLYGON:
+        return ((const struct nk_command_polygon*)cmd)->color.a == 0;
+    case NK_COMMAND_POLYGON_FILLED:
+        return ((const struct nk_command_polygon_filled*)cmd)->color.a == 0;
+    case NK_COMMAND_POLYLINE:
+        return ((const struct nk_command_polyline*)cmd)->color.a == 0;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        return t->length == 0 || (t->foreground.a == 0 && t->background.a == 0);
+    }
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+        return i->w == 0 || i->h == 0;
+    }
+    default: return nk_false;
+    }
+}
+
+NK_INTERN int
+nk_command_merge(struct nk_command *prev, const struct nk_command *cmd)
+{
+    /* merges two directly following filled rectangles with the same color
+     * sharing a complete edge into the first rectangle */
+    struct nk_command_rect_filled *a;
+    const struct nk_command_rect_filled *b;
+    if (prev->type != NK_COMMAND_RECT_FILLED || cmd->type != NK_COMMAND_RECT_FILLED)
+        return nk_false;
+    a = (struct nk_command_rect_filled*)prev;
+    b = (const struct nk_command_rect_filled*)cmd;
+    if (a->rounding || b->rounding || nk_color_u32(a->color) != nk_color_u32(b->color))
+        return nk_false;
+    if (a->y == b->y && a->h == b->h && (unsigned)a->w + b->w <= 0xFFFF &&
+        (a->x + a->w == b->x || b->x + b->w == a->x)) {
+        a->x = NK_MIN(a->x, b->x);
+        a->w = (unsigned short)(a->w + b->w);
+        return nk_true;
+    }
+    if (a->x == b->x && a->w == b->w && (unsigned)a->h + b->h <= 0xFFFF &&
+        (a->y + a->h == b->y || b->y + b->h == a->y)) {
+        a->y = NK_MIN(a->y, b->y);
+        a->h = (unsigned short)(a->h + b->h);
+        return nk_true;
+    }
+    return nk_false;
+}
+
+NK_INTERN struct nk_rect
+nk_optimize_intersect(struct nk_rect a, struct nk_rect b)
+{
+    float x0 = NK_MAX(a.x, b.x);
+    float y0 = NK_MAX(a.y, b.y);
+    float x1 = NK_MIN(a.x + a.w, b.x + b.w);
+    float y1 = NK_MIN(a.y + a.h, b.y + b.h);
+    return nk_rect(x0, y0, NK_MAX(x1 - x0, 0), NK_MAX(y1 - y0, 0));
+}
+
+NK_INTERN void
+nk_command_list_unlink(struct nk_buffer *buffer, nk_size begin, nk_size last, nk_size end)
+{
+    /* unlinks NOP commands from a command list while keeping the first
+     * and last command in place for code walking the list of one window */
+    struct nk_command *prev;
+    nk_size offset = begin;
+    if (begin == last) return;
+    prev = (struct nk_command*)nk_buffer_at(buffer, begin);
+    while (prev->next != last && prev->next > offset && prev->next < end) {
+        struct nk_command *cmd = (struct nk_command*)nk_buffer_at(buffer, prev->next);
+        if (cmd->type == NK_COMMAND_NOP) {
+            prev->next = cmd->next;
+        } else {
+            offset = prev->next;
+            prev = cmd;
+        }
+    }
+}
+
+#ifdef NK_OCCLUSION_CULLING
+NK_INTERN int
+nk_command_list_extent(struct nk_rect *extent, const struct nk_buffer *buffer,
+    nk_size begin, nk_size last, nk_size end)
+{
+    /* screen area touched by a command list drawn without scissor rectangle.
+     * Returns false(0) if nothing is drawn */
+    struct nk_rect clip = nk_null_rect;
+    int drawn = nk_false;
+    nk_size offset = begin;
+    while (offset >= begin && offset < end) {
+        const struct nk_command *cmd;
+        struct nk_rect area;
+        cmd = (const struct nk_command*)nk_buffer_at(buffer, offset);
+        if (cmd->type == NK_COMMAND_SCISSOR) {
+            const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+            clip = nk_rect(s->x, s->y, s->w, s->h);
+        } else if (cmd->type != NK_COMMAND_NOP) {
+            if (nk_command_bounds(&area, cmd))
+                area = nk_optimize_intersect(area, clip);
+            else area = clip;
+            if (area.w > 0 && area.h > 0) {
+                *extent = (drawn) ? nk_rect_union(*extent, area): area;
+                drawn = nk_true;
+            }
+        }
+        if (offset == last || cmd->next <= offset) break;
+        offset = cmd->next;
+    }
+    return drawn;
+}
+
+NK_INTERN void
+nk_build_occlusion(struct nk_context *ctx)
+{
+    /* Skips windows whose commands are completely below the opaque area of a
+     * window drawn above. Each window resets the scissor rectangle in
+     * `nk_panel_end`, so skipping a window does not change the scissor
+     * rectangle of the following ones. Popups are drawn after all windows
+     * and are never skipped. */
+    struct nk_window *it, *above;
+    for (it = ctx->begin; it; it = it->next) {
+        struct nk_rect extent;
+        int measured = nk_false;
+        if (it->buffer.last == it->buffer.begin || (it->flags & NK_WINDOW_HIDDEN) ||
+            it->seq != ctx->seq)
+            continue;
+        for (above = it->next; above; above = above->next) {
+            struct nk_rect cover;
+            if (above->buffer.last == above->buffer.begin || (above->flags & NK_WINDOW_HIDDEN) ||
+                above->seq != ctx->seq || above->opaque.w <= 0 || above->opaque.h <= 0)
+                continue;
+            cover = nk_pad_rect(above->opaque, nk_vec2(NK_OPTIMIZE_PADDING, NK_OPTIMIZE_PADDING));
+            if (!NK_CONTAINS(it->bounds.x, it->bounds.y, it->bounds.w, it->bounds.h,
+                cover.x, cover.y, cover.w, cover.h))
+                continue;
+            if (!measured) {
+                /* commands can be drawn outside of the window bounds */
+                if (!nk_command_list_extent(&extent, &ctx->memory, it->buffer.begin,
+                    it->buffer.last, it->buffer.end)) break;
+                measured = nk_true;
+            }
+            if (NK_CONTAINS(extent.x, extent.y, extent.w, extent.h,
+                cover.x, cover.y, cover.w, cover.h)) {
+                it->flags |= NK_WINDOW_OCCLUDED;
+                break;
+            }
+        }
+    }
+}
+
+#endif
+
+#ifdef NK_ZERO_COPY_TEXT
+NK_INTERN void
+nk_build_text(struct nk_context *ctx)
+{
+    /* point copied text to its final place behind each text command */
+    struct nk_window *iter = ctx->begin;
+    nk_size offset;
+    while (iter && ((iter->buffer.begin == iter->buffer.end) ||
+        (iter->flags & (NK_WINDOW_HIDDEN|NK_WINDOW_OCCLUDED)) || iter->seq != ctx->seq))
+        iter = iter->next;
+    if (!iter) return;
+    offset = iter->buffer.begin;
+    while (offset < ctx->memory.allocated) {
+        struct nk_command *cmd = (struct nk_command*)nk_buffer_at(&ctx->memory, offset);
+        if (cmd->type == NK_COMMAND_TEXT) {
+            struct nk_command_text *t = (struct nk_command_text*)cmd;
+            t->string = nk_command_text_string(t);
+        }
+        offset = cmd->next;
+    }
+}
+#endif
 NK_INTERN void
 nk_build(struct nk_context *ctx)
 {
     struct nk_window *it = 0;
     struct nk_command *cmd = 0;
-    nk_byte *buffer = 0;
 
     /* draw cursor overlay */
     if (!ctx->style.cursor_active)
@@ -17977,19 +21971,23 @@ nk_build(struct nk_context *ctx)
         nk_draw_image(&ctx->overlay, mouse_bounds, &cursor->img, nk_white);
         nk_finish_buffer(ctx, &ctx->overlay);
     }
+    for (it = ctx->begin; it; it = it->next)
+        it->flags &= ~(nk_flags)NK_WINDOW_OCCLUDED;
+#ifdef NK_OCCLUSION_CULLING
+    nk_build_occlusion(ctx);
+#endif
     /* build one big draw command list out of all window buffers */
     it = ctx->begin;
-    buffer = (nk_byte*)ctx->memory.memory.ptr;
     while (it != 0) {
         struct nk_window *next = it->next;
         if (it->buffer.last == it->buffer.begin || (it->flags & NK_WINDOW_HIDDEN)||
-            it->seq != ctx->seq)
+            (it->flags & NK_WINDOW_OCCLUDED) || it->seq != ctx->seq)
             goto cont;
 
-        cmd = nk_ptr_add(struct nk_command, buffer, it->buffer.last);
+        cmd = (struct nk_command*)nk_buffer_at(&ctx->memory, it->buffer.last);
         while (next && ((next->buffer.last == next->buffer.begin) ||
-            (next->flags & NK_WINDOW_HIDDEN)))
-            next = next->next; /* skip empty command buffers */
+            (next->flags & (NK_WINDOW_HIDDEN|NK_WINDOW_OCCLUDED)) || next->seq != ctx->seq))
+            next = next->next; /* skip empty, occluded and stale command buffers */
 
         if (next) cmd->next = next->buffer.begin;
         cont: it = next;
@@ -18004,51 +22002,274 @@ nk_build(struct nk_context *ctx)
 
         buf = &it->popup.buf;
         cmd->next = buf->begin;
-        cmd = nk_ptr_add(struct nk_command, buffer, buf->last);
-        buf->active = nk_false;
+        cmd = (struct nk_command*)nk_buffer_at(&ctx->memory, buf->last);
         skip: it = next;
     }
-    if (cmd) {
-        /* append overlay commands */
-        if (ctx->overlay.end != ctx->overlay.begin)
-            cmd->next = ctx->overlay.begin;
-        else cmd->next = ctx->memory.allocated;
+    if (cmd) {
+        /* append overlay commands */
+        if (ctx->overlay.end != ctx->overlay.begin)
+            cmd->next = ctx->overlay.begin;
+        else cmd->next = ctx->memory.allocated;
+    }
+#ifdef NK_ZERO_COPY_TEXT
+    nk_build_text(ctx);
+#endif
+}
+
+NK_API const struct nk_command*
+nk__begin(struct nk_context *ctx)
+{
+    struct nk_window *iter;
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
+    if (!ctx->count) return 0;
+
+    if (!ctx->build) {
+        nk_build(ctx);
+        ctx->build = nk_true;
+    }
+    iter = ctx->begin;
+    while (iter && ((iter->buffer.begin == iter->buffer.end) ||
+        (iter->flags & (NK_WINDOW_HIDDEN|NK_WINDOW_OCCLUDED)) || iter->seq != ctx->seq))
+        iter = iter->next;
+    if (!iter) return 0;
+    return (const struct nk_command*)nk_buffer_at(&ctx->memory, iter->buffer.begin);
+}
+
+NK_API const struct nk_command*
+nk__next(struct nk_context *ctx, const struct nk_command *cmd)
+{
+    const struct nk_command *next;
+    NK_ASSERT(ctx);
+    if (!ctx || !cmd || !ctx->count) return 0;
+    if (cmd->next >= ctx->memory.allocated) return 0;
+    next = (const struct nk_command*)nk_buffer_at(&ctx->memory, cmd->next);
+    return next;
+}
+
+NK_API void
+nk_optimize(struct nk_context *ctx, struct nk_optimize_stats *stats)
+{
+    struct nk_optimize_candidate candidates[NK_OPTIMIZE_LOOKBACK];
+    struct nk_optimize_stats s;
+    struct nk_command *cmd;
+    struct nk_command *prev = 0;
+    struct nk_command *scissor = 0;
+    struct nk_rect clip = nk_null_rect;
+    struct nk_rect scissor_clip = nk_null_rect;
+    struct nk_window *iter;
+    int clipped = nk_false, scissor_clipped = nk_false;
+    int i, count = 0, index = 0;
+
+    NK_ASSERT(ctx);
+    nk_zero_struct(s);
+    if (stats) *stats = s;
+    if (!ctx) return;
+
+    for (cmd = (struct nk_command*)nk__begin(ctx); cmd != 0;
+        cmd = (struct nk_command*)nk__next(ctx, cmd)) {
+        struct nk_rect bounds;
+        int has_bounds;
+
+        if (cmd->type == NK_COMMAND_NOP) continue;
+        if (cmd->type == NK_COMMAND_SCISSOR) {
+            const struct nk_command_scissor *sc = (const struct nk_command_scissor*)cmd;
+            struct nk_rect r = nk_rect(sc->x, sc->y, sc->w, sc->h);
+            if (scissor) {
+                /* previous scissor rectangle was never used */
+                scissor->type = NK_COMMAND_NOP;
+                clip = scissor_clip;
+                clipped = scissor_clipped;
+                s.scissors++;
+            }
+            if (clipped && nk_rect_equal(r, clip)) {
+                cmd->type = NK_COMMAND_NOP;
+                scissor = 0;
+                s.scissors++;
+            } else {
+                scissor = cmd;
+                scissor_clip = clip;
+                scissor_clipped = clipped;
+                clip = r;
+                clipped = nk_true;
+                prev = 0;
+            }
+            continue;
+        }
+
+        has_bounds = nk_command_bounds(&bounds, cmd);
+        if (nk_command_is_empty(cmd) || (has_bounds && clipped &&
+            !NK_INTERSECT(bounds.x, bounds.y, bounds.w, bounds.h,
+                clip.x, clip.y, clip.w, clip.h))) {
+            cmd->type = NK_COMMAND_NOP;
+            s.invisible++;
+            continue;
+        }
+        scissor = 0;
+        if (prev && nk_command_merge(prev, cmd)) {
+            cmd->type = NK_COMMAND_NOP;
+            s.merged++;
+            continue;
+        }
+        if (cmd->type == NK_COMMAND_RECT_FILLED) {
+            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+            if (!r->rounding && r->color.a == 255) {
+                /* remove previous commands completely below this rectangle */
+                struct nk_rect cover = nk_rect(r->x, r->y, r->w, r->h);
+                cover = nk_pad_rect(cover, nk_vec2(NK_OPTIMIZE_PADDING, NK_OPTIMIZE_PADDING));
+                if (clipped) cover = nk_optimize_intersect(cover,
+                    nk_pad_rect(clip, nk_vec2(NK_OPTIMIZE_PADDING, NK_OPTIMIZE_PADDING)));
+                for (i = 0; i < count && cover.w > 0 && cover.h > 0; ++i) {
+                    struct nk_optimize_candidate *c = &candidates[i];
+                    struct nk_rect area;
+                    if (c->cmd->type == NK_COMMAND_NOP || !nk_command_bounds(&area, c->cmd))
+                        continue;
+                    area = nk_optimize_intersect(area, c->clip);
+                    if (area.x >= cover.x && area.y >= cover.y &&
+                        area.x + area.w <= cover.x + cover.w &&
+                        area.y + area.h <= cover.y + cover.h) {
+                        c->cmd->type = NK_COMMAND_NOP;
+                        s.covered++;
+                    }
+                }
+            }
+        }
+        if (has_bounds) {
+            candidates[index].cmd = cmd;
+            candidates[index].clip = clip;
+            index = (index + 1) % NK_OPTIMIZE_LOOKBACK;
+            count = NK_MIN(count + 1, NK_OPTIMIZE_LOOKBACK);
+        }
+        prev = cmd;
+    }
+    if (scissor) {
+        /* trailing scissor rectangle */
+        scissor->type = NK_COMMAND_NOP;
+        s.scissors++;
+    }
+
+    /* unlink removed commands from each command list */
+    for (iter = ctx->begin; iter; iter = iter->next) {
+        if (iter->buffer.last == iter->buffer.begin || (iter->flags & NK_WINDOW_HIDDEN) ||
+            iter->seq != ctx->seq)
+            continue;
+        nk_command_list_unlink(&ctx->memory, iter->buffer.begin,
+            iter->buffer.last, iter->buffer.end);
+        if (iter->popup.buf.active) {
+            const struct nk_popup_buffer *buf = &iter->popup.buf;
+            nk_command_list_unlink(&ctx->memory, buf->begin, buf->last, buf->end);
+        }
+    }
+    if (ctx->overlay.end != ctx->overlay.begin)
+        nk_command_list_unlink(&ctx->memory, ctx->overlay.begin,
+            ctx->overlay.last, ctx->overlay.end);
+
+    {const struct nk_command *c;
+    nk_foreach(c, ctx) {
+        if (c->type != NK_COMMAND_NOP)
+            s.commands++;
+    }}
+    if (stats) *stats = s;
+}
+
+/* extra space around window bounds to cover anti-aliased edges */
+#define NK_DAMAGE_PADDING 2.0f
+
+NK_INTERN void
+nk_damage_add(struct nk_rect *rects, int *count, int max, struct nk_rect r)
+{
+    int i;
+    if (r.w <= 0 || r.h <= 0) return;
+    /* merge with all overlapping rectangles */
+    for (i = 0; i < *count; ++i) {
+        const struct nk_rect *o = &rects[i];
+        if (!NK_INTERSECT(r.x, r.y, r.w, r.h, o->x, o->y, o->w, o->h))
+            continue;
+        r = nk_rect_union(r, *o);
+        rects[i] = rects[--(*count)];
+        i = -1;
     }
+    if (*count < max)
+        rects[(*count)++] = r;
+    else rects[max-1] = nk_rect_union(rects[max-1], r);
 }
 
-NK_API const struct nk_command*
-nk__begin(struct nk_context *ctx)
+NK_API int
+nk_damage(struct nk_context *ctx, struct nk_rect *rects, int max)
 {
     struct nk_window *iter;
-    nk_byte *buffer;
-    NK_ASSERT(ctx);
-    if (!ctx) return 0;
-    if (!ctx->count) return 0;
+    const struct nk_buffer *buffer;
+    nk_hash seed = 0;
+    int count = 0;
 
-    buffer = (nk_byte*)ctx->memory.memory.ptr;
+    NK_ASSERT(ctx);
+    NK_ASSERT(rects);
+    NK_ASSERT(max > 0);
+    if (!ctx || !rects || max <= 0) return 0;
     if (!ctx->build) {
         nk_build(ctx);
         ctx->build = nk_true;
     }
-    iter = ctx->begin;
-    while (iter && ((iter->buffer.begin == iter->buffer.end) ||
-        (iter->flags & NK_WINDOW_HIDDEN) || iter->seq != ctx->seq))
-        iter = iter->next;
-    if (!iter) return 0;
-    return nk_ptr_add_const(struct nk_command, buffer, iter->buffer.begin);
-}
+    buffer = &ctx->memory;
 
-NK_API const struct nk_command*
-nk__next(struct nk_context *ctx, const struct nk_command *cmd)
-{
-    nk_byte *buffer;
-    const struct nk_command *next;
-    NK_ASSERT(ctx);
-    if (!ctx || !cmd || !ctx->count) return 0;
-    if (cmd->next >= ctx->memory.allocated) return 0;
-    buffer = (nk_byte*)ctx->memory.memory.ptr;
-    next = nk_ptr_add_const(struct nk_command, buffer, cmd->next);
-    return next;
+    /* windows freed since last call */
+    nk_damage_add(rects, &count, max, ctx->damage_freed);
+    ctx->damage_freed = nk_rect(0,0,0,0);
+
+    /* compare draw commands and area of each window. Hashes are chained in
+     * drawing order so changes in window order damage the reordered window */
+    for (iter = ctx->begin; iter; iter = iter->next) {
+        nk_hash hash = 0;
+        struct nk_rect area = nk_rect(0,0,0,0);
+        if (iter->buffer.last != iter->buffer.begin && !(iter->flags & NK_WINDOW_HIDDEN) &&
+            iter->seq == ctx->seq) {
+            const struct nk_popup_buffer *buf = &iter->popup.buf;
+            hash = nk_command_list_hash(seed, buffer, iter->buffer.begin,
+                iter->buffer.last, iter->buffer.end);
+            area = nk_pad_rect(iter->bounds, nk_vec2(-NK_DAMAGE_PADDING, -NK_DAMAGE_PADDING));
+            if (buf->active && iter->popup.win) {
+                struct nk_rect popup = iter->popup.win->bounds;
+                hash = nk_command_list_hash(hash, buffer, buf->begin, buf->last, buf->end);
+                popup = nk_pad_rect(popup, nk_vec2(-NK_DAMAGE_PADDING, -NK_DAMAGE_PADDING));
+                area = nk_rect_union(area, popup);
+            }
+            seed = iter->name;
+        }
+        if (hash != iter->damage_hash || !nk_rect_equal(area, iter->damage_area)) {
+            nk_damage_add(rects, &count, max, iter->damage_area);
+            nk_damage_add(rects, &count, max, area);
+        }
+        iter->damage_hash = hash;
+        iter->damage_area = area;
+    }
+
+    /* cursor overlay */
+    {nk_hash hash = 0;
+    struct nk_rect area = nk_rect(0,0,0,0);
+    if (ctx->overlay.end != ctx->overlay.begin) {
+        nk_size offset = ctx->overlay.begin;
+        hash = nk_command_list_hash(0, buffer, ctx->overlay.begin,
+            ctx->overlay.last, ctx->overlay.end);
+        while (offset < ctx->overlay.end) {
+            const struct nk_command *cmd;
+            cmd = (const struct nk_command*)nk_buffer_at(buffer, offset);
+            if (cmd->type == NK_COMMAND_IMAGE) {
+                const struct nk_command_image *i = (const struct nk_command_image*)cmd;
+                struct nk_rect r = nk_rect(i->x, i->y, i->w, i->h);
+                area = (area.w > 0) ? nk_rect_union(area, r): r;
+            }
+            if (offset == ctx->overlay.last || cmd->next <= offset) break;
+            offset = cmd->next;
+        }
+    }
+    if (hash != ctx->overlay_damage_hash ||
+        !nk_rect_equal(area, ctx->overlay_damage_area)) {
+        nk_damage_add(rects, &count, max, ctx->overlay_damage_area);
+        nk_damage_add(rects, &count, max, area);
+    }
+    ctx->overlay_damage_hash = hash;
+    ctx->overlay_damage_area = area;}
+    return count;
 }
 
 /* ----------------------------------------------------------------
@@ -18111,29 +22332,261 @@ nk_panel_get_border_color(const struct nk_style *style, enum nk_panel_type type)
     case NK_PANEL_MENU: return style->window.menu_border_color;
     case NK_PANEL_TOOLTIP: return style->window.menu_border_color;
     }
-}
+}
+
+NK_INTERN int
+nk_panel_is_sub(enum nk_panel_type type)
+{
+    return (type & NK_PANEL_SET_SUB)?1:0;
+}
+
+NK_INTERN int
+nk_panel_is_nonblock(enum nk_panel_type type)
+{
+    return (type & NK_PANEL_SET_NONBLOCK)?1:0;
+}
+
+NK_INTERN int
+nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type panel_type)
+{
+    struct nk_input *in;
+    struct nk_window *win;
+    struct nk_panel *layout;
+    struct nk_command_buffer *out;
+    const struct nk_style *style;
+    const struct nk_user_font *font;
+
+    struct nk_vec2 scrollbar_size;
+    struct nk_vec2 panel_padding;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(ctx->current->layout);
+    if (!ctx || !ctx->current || !ctx->current->layout) return 0;
+    nk_zero(ctx->current->layout, sizeof(*ctx->current->layout));
+    if ((ctx->current->flags & NK_WINDOW_HIDDEN) || (ctx->current->flags & NK_WINDOW_CLOSED)) {
+        nk_zero(ctx->current->layout, sizeof(struct nk_panel));
+        ctx->current->layout->type = panel_type;
+        return 0;
+    }
+    /* pull state into local stack */
+    style = &ctx->style;
+    font = style->font;
+    win = ctx->current;
+    layout = win->layout;
+    out = &win->buffer;
+    in = (win->flags & NK_WINDOW_NO_INPUT) ? 0: &ctx->input;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    win->buffer.userdata = ctx->userdata;
+#endif
+    /* pull style configuration into local stack */
+    scrollbar_size = style->window.scrollbar_size;
+    panel_padding = nk_panel_get_padding(style, panel_type);
+
+    /* window movement */
+    if ((win->flags & NK_WINDOW_MOVABLE) && !(win->flags & NK_WINDOW_ROM)) {
+        int left_mouse_down;
+        int left_mouse_click_in_cursor;
+
+        /* calculate draggable window space */
+        struct nk_rect header;
+        header.x = win->bounds.x;
+        header.y = win->bounds.y;
+        header.w = win->bounds.w;
+        if (nk_panel_has_header(win->flags, title)) {
+            header.h = font->height + 2.0f * style->window.header.padding.y;
+            header.h += 2.0f * style->window.header.label_padding.y;
+        } else header.h = panel_padding.y;
+
+        /* window movement by dragging */
+        left_mouse_down = in->mouse.buttons[NK_BUTTON_LEFT].down;
+        left_mouse_click_in_cursor = nk_input_has_mouse_click_down_in_rect(in,
+            NK_BUTTON_LEFT, header, nk_true);
+        if (left_mouse_down && left_mouse_click_in_cursor) {
+            win->bounds.x = win->bounds.x + in->mouse.delta.x;
+            win->bounds.y = win->bounds.y + in->mouse.delta.y;
+            in->mouse.buttons[NK_BUTTON_LEFT].clicked_pos.x += in->mouse.delta.x;
+            in->mouse.buttons[NK_BUTTON_LEFT].clicked_pos.y += in->mouse.delta.y;
+            ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_MOVE];
+        }
+    }
+
+    /* setup panel */
+    layout->type = panel_type;
+    layout->flags = win->flags;
+    layout->bounds = win->bounds;
+    if (panel_type == NK_PANEL_WINDOW)
+        win->opaque = nk_rect(0,0,0,0);
+    layout->bounds.x += panel_padding.x;
+    layout->bounds.w -= 2*panel_padding.x;
+    if (win->flags & NK_WINDOW_BORDER) {
+        layout->border = nk_panel_get_border(style, win->flags, panel_type);
+        layout->bounds = nk_shrink_rect(layout->bounds, layout->border);
+    } else layout->border = 0;
+    layout->at_y = layout->bounds.y;
+    layout->at_x = layout->bounds.x;
+    layout->max_x = 0;
+    layout->header_height = 0;
+    layout->footer_height = 0;
+    nk_layout_reset_min_row_height(ctx);
+    layout->row.index = 0;
+    layout->row.columns = 0;
+    layout->row.ratio = 0;
+    layout->row.item_width = 0;
+    layout->row.tree_depth = 0;
+    layout->row.height = panel_padding.y;
+    layout->has_scrolling = nk_true;
+    if (!(win->flags & NK_WINDOW_NO_SCROLLBAR))
+        layout->bounds.w -= scrollbar_size.x;
+    if (!nk_panel_is_nonblock(panel_type)) {
+        layout->footer_height = 0;
+        if (!(win->flags & NK_WINDOW_NO_SCROLLBAR) || win->flags & NK_WINDOW_SCALABLE)
+            layout->footer_height = scrollbar_size.y;
+        layout->bounds.h -= layout->footer_height;
+    }
+
+    /* panel header */
+    if (nk_panel_has_header(win->flags, title))
+    {
+        struct nk_text text;
+        struct nk_rect header;
+        const struct nk_style_item *background = 0;
+
+        /* calculate header bounds */
+        header.x = win->bounds.x;
+        header.y = win->bounds.y;
+        header.w = win->bounds.w;
+        header.h = font->height + 2.0f * style->window.header.padding.y;
+        header.h += (2.0f * style->window.header.label_padding.y);
+
+        /* shrink panel by header */
+        layout->header_height = header.h;
+        layout->bounds.y += header.h;
+        layout->bounds.h -= header.h;
+        layout->at_y += header.h;
+
+        /* select correct header background and text color */
+        if (ctx->active == win) {
+            background = &style->window.header.active;
+            text.text = style->window.header.label_active;
+        } else if (nk_input_is_mouse_hovering_rect(&ctx->input, header)) {
+            background = &style->window.header.hover;
+            text.text = style->window.header.label_hover;
+        } else {
+            background = &style->window.header.normal;
+            text.text = style->window.header.label_normal;
+        }
+
+        /* draw header background */
+        header.h += 1.0f;
+        if (background->type == NK_STYLE_ITEM_IMAGE) {
+            text.background = nk_rgba(0,0,0,0);
+            nk_draw_image(&win->buffer, header, &background->data.image, nk_white);
+        } else {
+            text.background = background->data.color;
+            nk_fill_rect(out, header, 0, background->data.color);
+            if (panel_type == NK_PANEL_WINDOW && background->data.color.a == 255)
+                win->opaque = header;
+        }
+
+        /* window close button */
+        {struct nk_rect button;
+        button.y = header.y + style->window.header.padding.y;
+        button.h = header.h - 2 * style->window.header.padding.y;
+        button.w = button.h;
+        if (win->flags & NK_WINDOW_CLOSABLE) {
+            nk_flags ws = 0;
+            if (style->window.header.align == NK_HEADER_RIGHT) {
+                button.x = (header.w + header.x) - (button.w + style->window.header.padding.x);
+                header.w -= button.w + style->window.header.spacing.x + style->window.header.padding.x;
+            } else {
+                button.x = header.x + style->window.header.padding.x;
+                header.x += button.w + style->window.header.spacing.x + style->window.header.padding.x;
+            }
+
+            if (nk_do_button_symbol(&ws, &win->buffer, button,
+                style->window.header.close_symbol, NK_BUTTON_DEFAULT,
+                &style->window.header.close_button, in, style->font) && !(win->flags & NK_WINDOW_ROM))
+            {
+                layout->flags |= NK_WINDOW_HIDDEN;
+                layout->flags &= (nk_flags)~NK_WINDOW_MINIMIZED;
+            }
+        }
+
+        /* window minimize button */
+        if (win->flags & NK_WINDOW_MINIMIZABLE) {
+            nk_flags ws = 0;
+            if (style->window.header.align == NK_HEADER_RIGHT) {
+                button.x = (header.w + header.x) - button.w;
+                if (!(win->flags & NK_WINDOW_CLOSABLE)) {
+                    button.x -= style->window.header.padding.x;
+                    header.w -= style->window.header.padding.x;
+                }
+                header.w -= button.w + style->window.header.spacing.x;
+            } else {
+                button.x = header.x;
+                header.x += button.w + style->window.header.spacing.x + style->window.header.padding.x;
+            }
+            if (nk_do_button_symbol(&ws, &win->buffer, button, (layout->flags & NK_WINDOW_MINIMIZED)?
+                style->window.header.maximize_symbol: style->window.header.minimize_symbol,
+                NK_BUTTON_DEFAULT, &style->window.header.minimize_button, in, style->font) && !(win->flags & NK_WINDOW_ROM))
+                layout->flags = (layout->flags & NK_WINDOW_MINIMIZED) ?
+                    layout->flags & (nk_flags)~NK_WINDOW_MINIMIZED:
+                    layout->flags | NK_WINDOW_MINIMIZED;
+        }}
+
+        {/* window header title */
+        int text_len = nk_strlen(title);
+        struct nk_rect label = {0,0,0,0};
+        float t = font->width(font->userdata, font->height, title, text_len);
+        text.padding = nk_vec2(0,0);
+
+        label.x = header.x + style->window.header.padding.x;
+        label.x += style->window.header.label_padding.x;
+        label.y = header.y + style->window.header.label_padding.y;
+        label.h = font->height + 2 * style->window.header.label_padding.y;
+        label.w = t + 2 * style->window.header.spacing.x;
+        label.w = NK_CLAMP(0, label.w, header.x + header.w - label.x);
+        /* titles are often formatted names so they are always copied */
+        nk_draw_text_copy(out, nk_true);
+        nk_widget_text(out, label,(const char*)title, text_len, &text, NK_TEXT_LEFT, font);
+        nk_draw_text_copy(out, nk_false);}
+    }
 
-NK_INTERN int
-nk_panel_is_sub(enum nk_panel_type type)
-{
-    return (type & NK_PANEL_SET_SUB)?1:0;
-}
+    /* draw window background */
+    if (!(layout->flags & NK_WINDOW_MINIMIZED) && !(layout->flags & NK_WINDOW_DYNAMIC)) {
+        struct nk_rect body;
+        body.x = win->bounds.x;
+        body.w = win->bounds.w;
+        body.y = (win->bounds.y + layout->header_height);
+        body.h = (win->bounds.h - layout->header_height);
+        if (style->window.fixed_background.type == NK_STYLE_ITEM_IMAGE)
+            nk_draw_image(out, body, &style->window.fixed_background.data.image, nk_white);
+        else {
+            nk_fill_rect(out, body, 0, style->window.fixed_background.data.color);
+            if (panel_type == NK_PANEL_WINDOW && style->window.fixed_background.data.color.a == 255)
+                win->opaque = (win->opaque.w > 0) ? nk_rect_union(win->opaque, body): body;
+        }
+    }
 
-NK_INTERN int
-nk_panel_is_nonblock(enum nk_panel_type type)
-{
-    return (type & NK_PANEL_SET_NONBLOCK)?1:0;
+    /* set clipping rectangle */
+    {struct nk_rect clip;
+    layout->clip = layout->bounds;
+    nk_unify(&clip, &win->buffer.clip, layout->clip.x, layout->clip.y,
+        layout->clip.x + layout->clip.w, layout->clip.y + layout->clip.h);
+    nk_push_scissor(out, clip);
+    layout->clip = clip;}
+    return !(layout->flags & NK_WINDOW_HIDDEN) && !(layout->flags & NK_WINDOW_MINIMIZED);
 }
 
-NK_INTERN int
-nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type panel_type)
+NK_INTERN void
+nk_panel_end(struct nk_context *ctx)
 {
     struct nk_input *in;
-    struct nk_window *win;
+    struct nk_window *window;
     struct nk_panel *layout;
-    struct nk_command_buffer *out;
     const struct nk_style *style;
-    const struct nk_user_font *font;
+    struct nk_command_buffer *out;
 
     struct nk_vec2 scrollbar_size;
     struct nk_vec2 panel_padding;
@@ -18141,1375 +22594,2447 @@ nk_panel_begin(struct nk_context *ctx, const char *title, enum nk_panel_type pan
     NK_ASSERT(ctx);
     NK_ASSERT(ctx->current);
     NK_ASSERT(ctx->current->layout);
-    if (!ctx || !ctx->current || !ctx->current->layout) return 0;
-    nk_zero(ctx->current->layout, sizeof(*ctx->current->layout));
-    if ((ctx->current->flags & NK_WINDOW_HIDDEN) || (ctx->current->flags & NK_WINDOW_CLOSED)) {
-        nk_zero(ctx->current->layout, sizeof(struct nk_panel));
-        ctx->current->layout->type = panel_type;
-        return 0;
-    }
-    /* pull state into local stack */
+    if (!ctx || !ctx->current || !ctx->current->layout)
+        return;
+
+    window = ctx->current;
+    layout = window->layout;
     style = &ctx->style;
-    font = style->font;
-    win = ctx->current;
-    layout = win->layout;
-    out = &win->buffer;
-    in = (win->flags & NK_WINDOW_NO_INPUT) ? 0: &ctx->input;
-#ifdef NK_INCLUDE_COMMAND_USERDATA
-    win->buffer.userdata = ctx->userdata;
-#endif
-    /* pull style configuration into local stack */
+    out = &window->buffer;
+    in = (layout->flags & NK_WINDOW_ROM || layout->flags & NK_WINDOW_NO_INPUT) ? 0 :&ctx->input;
+    if (!nk_panel_is_sub(layout->type))
+        nk_push_scissor(out, nk_null_rect);
+
+    /* cache configuration data */
     scrollbar_size = style->window.scrollbar_size;
-    panel_padding = nk_panel_get_padding(style, panel_type);
+    panel_padding = nk_panel_get_padding(style, layout->type);
 
-    /* window movement */
-    if ((win->flags & NK_WINDOW_MOVABLE) && !(win->flags & NK_WINDOW_ROM)) {
-        int left_mouse_down;
-        int left_mouse_click_in_cursor;
+    /* update the current cursor Y-position to point over the last added widget */
+    layout->at_y += layout->row.height;
 
-        /* calculate draggable window space */
-        struct nk_rect header;
-        header.x = win->bounds.x;
-        header.y = win->bounds.y;
-        header.w = win->bounds.w;
-        if (nk_panel_has_header(win->flags, title)) {
-            header.h = font->height + 2.0f * style->window.header.padding.y;
-            header.h += 2.0f * style->window.header.label_padding.y;
-        } else header.h = panel_padding.y;
+    /* dynamic panels */
+    if (layout->flags & NK_WINDOW_DYNAMIC && !(layout->flags & NK_WINDOW_MINIMIZED))
+    {
+        /* update panel height to fit dynamic growth */
+        struct nk_rect empty_space;
+        if (layout->at_y < (layout->bounds.y + layout->bounds.h))
+            layout->bounds.h = layout->at_y - layout->bounds.y;
 
-        /* window movement by dragging */
-        left_mouse_down = in->mouse.buttons[NK_BUTTON_LEFT].down;
-        left_mouse_click_in_cursor = nk_input_has_mouse_click_down_in_rect(in,
-            NK_BUTTON_LEFT, header, nk_true);
-        if (left_mouse_down && left_mouse_click_in_cursor) {
-            win->bounds.x = win->bounds.x + in->mouse.delta.x;
-            win->bounds.y = win->bounds.y + in->mouse.delta.y;
-            in->mouse.buttons[NK_BUTTON_LEFT].clicked_pos.x += in->mouse.delta.x;
-            in->mouse.buttons[NK_BUTTON_LEFT].clicked_pos.y += in->mouse.delta.y;
-            ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_MOVE];
+        /* fill top empty space */
+        empty_space.x = window->bounds.x;
+        empty_space.y = layout->bounds.y;
+        empty_space.h = panel_padding.y;
+        empty_space.w = window->bounds.w;
+        nk_fill_rect(out, empty_space, 0, style->window.background);
+
+        /* fill left empty space */
+        empty_space.x = window->bounds.x;
+        empty_space.y = layout->bounds.y;
+        empty_space.w = panel_padding.x + layout->border;
+        empty_space.h = layout->bounds.h;
+        nk_fill_rect(out, empty_space, 0, style->window.background);
+
+        /* fill right empty space */
+        empty_space.x = layout->bounds.x + layout->bounds.w - layout->border;
+        empty_space.y = layout->bounds.y;
+        empty_space.w = panel_padding.x + layout->border;
+        empty_space.h = layout->bounds.h;
+        if (*layout->offset_y == 0 && !(layout->flags & NK_WINDOW_NO_SCROLLBAR))
+            empty_space.w += scrollbar_size.x;
+        nk_fill_rect(out, empty_space, 0, style->window.background);
+
+        /* fill bottom empty space */
+        if (*layout->offset_x != 0 && !(layout->flags & NK_WINDOW_NO_SCROLLBAR)) {
+            empty_space.x = window->bounds.x;
+            empty_space.y = layout->bounds.y + layout->bounds.h;
+            empty_space.w = window->bounds.w;
+            empty_space.h = scrollbar_size.y;
+            nk_fill_rect(out, empty_space, 0, style->window.background);
         }
     }
 
-    /* setup panel */
-    layout->type = panel_type;
-    layout->flags = win->flags;
-    layout->bounds = win->bounds;
-    layout->bounds.x += panel_padding.x;
-    layout->bounds.w -= 2*panel_padding.x;
-    if (win->flags & NK_WINDOW_BORDER) {
-        layout->border = nk_panel_get_border(style, win->flags, panel_type);
-        layout->bounds = nk_shrink_rect(layout->bounds, layout->border);
-    } else layout->border = 0;
-    layout->at_y = layout->bounds.y;
-    layout->at_x = layout->bounds.x;
-    layout->max_x = 0;
-    layout->header_height = 0;
-    layout->footer_height = 0;
-    nk_layout_reset_min_row_height(ctx);
-    layout->row.index = 0;
-    layout->row.columns = 0;
-    layout->row.ratio = 0;
-    layout->row.item_width = 0;
-    layout->row.tree_depth = 0;
-    layout->row.height = panel_padding.y;
-    layout->has_scrolling = nk_true;
-    if (!(win->flags & NK_WINDOW_NO_SCROLLBAR))
-        layout->bounds.w -= scrollbar_size.x;
-    if (!nk_panel_is_nonblock(panel_type)) {
-        layout->footer_height = 0;
-        if (!(win->flags & NK_WINDOW_NO_SCROLLBAR) || win->flags & NK_WINDOW_SCALABLE)
-            layout->footer_height = scrollbar_size.y;
-        layout->bounds.h -= layout->footer_height;
+    /* scrollbars */
+    if (!(layout->flags & NK_WINDOW_NO_SCROLLBAR) &&
+        !(layout->flags & NK_WINDOW_MINIMIZED) &&
+        window->scrollbar_hiding_timer < NK_SCROLLBAR_HIDING_TIMEOUT)
+    {
+        struct nk_rect scroll;
+        int scroll_has_scrolling;
+        float scroll_target;
+        float scroll_offset;
+        float scroll_step;
+        float scroll_inc;
+
+        /* mouse wheel scrolling */
+        if (nk_panel_is_sub(layout->type))
+        {
+            /* sub-window mouse wheel scrolling */
+            struct nk_window *root_window = window;
+            struct nk_panel *root_panel = window->layout;
+            while (root_panel->parent)
+                root_panel = root_panel->parent;
+            while (root_window->parent)
+                root_window = root_window->parent;
+
+            /* only allow scrolling if parent window is active */
+            scroll_has_scrolling = 0;
+            if ((root_window == ctx->active) && layout->has_scrolling) {
+                /* and panel is being hovered and inside clip rect*/
+                if (nk_input_is_mouse_hovering_rect(in, layout->bounds) &&
+                    NK_INTERSECT(layout->bounds.x, layout->bounds.y, layout->bounds.w, layout->bounds.h,
+                        root_panel->clip.x, root_panel->clip.y, root_panel->clip.w, root_panel->clip.h))
+                {
+                    /* deactivate all parent scrolling */
+                    root_panel = window->layout;
+                    while (root_panel->parent) {
+                        root_panel->has_scrolling = nk_false;
+                        root_panel = root_panel->parent;
+                    }
+                    root_panel->has_scrolling = nk_false;
+                    scroll_has_scrolling = nk_true;
+                }
+            }
+        } else if (!nk_panel_is_sub(layout->type)) {
+            /* window mouse wheel scrolling */
+            scroll_has_scrolling = (window == ctx->active) && layout->has_scrolling;
+            if (in && (in->mouse.scroll_delta.y > 0 || in->mouse.scroll_delta.x > 0) && scroll_has_scrolling)
+                window->scrolled = nk_true;
+            else window->scrolled = nk_false;
+        } else scroll_has_scrolling = nk_false;
+
+        {
+            /* vertical scrollbar */
+            nk_flags state = 0;
+            scroll.x = layout->bounds.x + layout->bounds.w + panel_padding.x;
+            scroll.y = layout->bounds.y;
+            scroll.w = scrollbar_size.x;
+            scroll.h = layout->bounds.h;
+
+            scroll_offset = (float)*layout->offset_y;
+            scroll_step = scroll.h * 0.10f;
+            scroll_inc = scroll.h * 0.01f;
+            scroll_target = (float)(int)(layout->at_y - scroll.y);
+            scroll_offset = nk_do_scrollbarv(&state, out, scroll, scroll_has_scrolling,
+                scroll_offset, scroll_target, scroll_step, scroll_inc,
+                &ctx->style.scrollv, in, style->font);
+            *layout->offset_y = (nk_uint)scroll_offset;
+            if (in && scroll_has_scrolling)
+                in->mouse.scroll_delta.y = 0;
+        }
+        {
+            /* horizontal scrollbar */
+            nk_flags state = 0;
+            scroll.x = layout->bounds.x;
+            scroll.y = layout->bounds.y + layout->bounds.h;
+            scroll.w = layout->bounds.w;
+            scroll.h = scrollbar_size.y;
+
+            scroll_offset = (float)*layout->offset_x;
+            scroll_target = (float)(int)(layout->max_x - scroll.x);
+            scroll_step = layout->max_x * 0.05f;
+            scroll_inc = layout->max_x * 0.005f;
+            scroll_offset = nk_do_scrollbarh(&state, out, scroll, scroll_has_scrolling,
+                scroll_offset, scroll_target, scroll_step, scroll_inc,
+                &ctx->style.scrollh, in, style->font);
+            *layout->offset_x = (nk_uint)scroll_offset;
+        }
     }
 
-    /* panel header */
-    if (nk_panel_has_header(win->flags, title))
+    /* hide scroll if no user input */
+    if (window->flags & NK_WINDOW_SCROLL_AUTO_HIDE) {
+        int has_input = ctx->input.mouse.delta.x != 0 || ctx->input.mouse.delta.y != 0 || ctx->input.mouse.scroll_delta.y != 0;
+        int is_window_hovered = nk_window_is_hovered(ctx);
+        int any_item_active = (ctx->last_widget_state & NK_WIDGET_STATE_MODIFIED);
+        if ((!has_input && is_window_hovered) || (!is_window_hovered && !any_item_active))
+            window->scrollbar_hiding_timer += ctx->delta_time_seconds;
+        else window->scrollbar_hiding_timer = 0;
+    } else window->scrollbar_hiding_timer = 0;
+
+    /* window border */
+    if (layout->flags & NK_WINDOW_BORDER)
     {
-        struct nk_text text;
-        struct nk_rect header;
-        const struct nk_style_item *background = 0;
+        struct nk_color border_color = nk_panel_get_border_color(style, layout->type);
+        const float padding_y = (layout->flags & NK_WINDOW_MINIMIZED) ?
+            style->window.border + window->bounds.y + layout->header_height:
+            (layout->flags & NK_WINDOW_DYNAMIC)?
+            layout->bounds.y + layout->bounds.h + layout->footer_height:
+            window->bounds.y + window->bounds.h;
 
-        /* calculate header bounds */
-        header.x = win->bounds.x;
-        header.y = win->bounds.y;
-        header.w = win->bounds.w;
-        header.h = font->height + 2.0f * style->window.header.padding.y;
-        header.h += (2.0f * style->window.header.label_padding.y);
+        /* draw border top */
+        nk_stroke_line(out,window->bounds.x,window->bounds.y,
+            window->bounds.x + window->bounds.w, window->bounds.y,
+            layout->border, border_color);
 
-        /* shrink panel by header */
-        layout->header_height = header.h;
-        layout->bounds.y += header.h;
-        layout->bounds.h -= header.h;
-        layout->at_y += header.h;
+        /* draw bottom border */
+        nk_stroke_line(out, window->bounds.x, padding_y,
+            window->bounds.x + window->bounds.w, padding_y, layout->border, border_color);
 
-        /* select correct header background and text color */
-        if (ctx->active == win) {
-            background = &style->window.header.active;
-            text.text = style->window.header.label_active;
-        } else if (nk_input_is_mouse_hovering_rect(&ctx->input, header)) {
-            background = &style->window.header.hover;
-            text.text = style->window.header.label_hover;
-        } else {
-            background = &style->window.header.normal;
-            text.text = style->window.header.label_normal;
-        }
+        /* draw left border */
+        nk_stroke_line(out, window->bounds.x + layout->border*0.5f,
+            window->bounds.y, window->bounds.x + layout->border*0.5f,
+            padding_y, layout->border, border_color);
 
-        /* draw header background */
-        header.h += 1.0f;
-        if (background->type == NK_STYLE_ITEM_IMAGE) {
-            text.background = nk_rgba(0,0,0,0);
-            nk_draw_image(&win->buffer, header, &background->data.image, nk_white);
-        } else {
-            text.background = background->data.color;
-            nk_fill_rect(out, header, 0, background->data.color);
-        }
+        /* draw right border */
+        nk_stroke_line(out, window->bounds.x + window->bounds.w - layout->border*0.5f,
+            window->bounds.y, window->bounds.x + window->bounds.w - layout->border*0.5f,
+            padding_y, layout->border, border_color);
+    }
 
-        /* window close button */
-        {struct nk_rect button;
-        button.y = header.y + style->window.header.padding.y;
-        button.h = header.h - 2 * style->window.header.padding.y;
-        button.w = button.h;
-        if (win->flags & NK_WINDOW_CLOSABLE) {
-            nk_flags ws = 0;
-            if (style->window.header.align == NK_HEADER_RIGHT) {
-                button.x = (header.w + header.x) - (button.w + style->window.header.padding.x);
-                header.w -= button.w + style->window.header.spacing.x + style->window.header.padding.x;
+    /* scaler */
+    if ((layout->flags & NK_WINDOW_SCALABLE) && in && !(layout->flags & NK_WINDOW_MINIMIZED))
+    {
+        /* calculate scaler bounds */
+        struct nk_rect scaler;
+        scaler.w = scrollbar_size.x;
+        scaler.h = scrollbar_size.y;
+        scaler.y = layout->bounds.y + layout->bounds.h;
+        if (layout->flags & NK_WINDOW_SCALE_LEFT)
+            scaler.x = layout->bounds.x - panel_padding.x * 0.5f;
+        else scaler.x = layout->bounds.x + layout->bounds.w + panel_padding.x;
+        if (layout->flags & NK_WINDOW_NO_SCROLLBAR)
+            scaler.x -= scaler.w;
+
+        /* draw scaler */
+        {const struct nk_style_item *item = &style->window.scaler;
+        if (item->type == NK_STYLE_ITEM_IMAGE)
+            nk_draw_image(out, scaler, &item->data.image, nk_white);
+        else {
+            if (layout->flags & NK_WINDOW_SCALE_LEFT) {
+                nk_fill_triangle(out, scaler.x, scaler.y, scaler.x,
+                    scaler.y + scaler.h, scaler.x + scaler.w,
+                    scaler.y + scaler.h, item->data.color);
             } else {
-                button.x = header.x + style->window.header.padding.x;
-                header.x += button.w + style->window.header.spacing.x + style->window.header.padding.x;
+                nk_fill_triangle(out, scaler.x + scaler.w, scaler.y, scaler.x + scaler.w,
+                    scaler.y + scaler.h, scaler.x, scaler.y + scaler.h, item->data.color);
             }
+        }}
 
-            if (nk_do_button_symbol(&ws, &win->buffer, button,
-                style->window.header.close_symbol, NK_BUTTON_DEFAULT,
-                &style->window.header.close_button, in, style->font) && !(win->flags & NK_WINDOW_ROM))
-            {
-                layout->flags |= NK_WINDOW_HIDDEN;
-                layout->flags &= (nk_flags)~NK_WINDOW_MINIMIZED;
-            }
-        }
+        /* do window scaling */
+        if (!(window->flags & NK_WINDOW_ROM)) {
+            struct nk_vec2 window_size = style->window.min_size;
+            int left_mouse_down = in->mouse.buttons[NK_BUTTON_LEFT].down;
+            int left_mouse_click_in_scaler = nk_input_has_mouse_click_down_in_rect(in,
+                    NK_BUTTON_LEFT, scaler, nk_true);
 
-        /* window minimize button */
-        if (win->flags & NK_WINDOW_MINIMIZABLE) {
-            nk_flags ws = 0;
-            if (style->window.header.align == NK_HEADER_RIGHT) {
-                button.x = (header.w + header.x) - button.w;
-                if (!(win->flags & NK_WINDOW_CLOSABLE)) {
-                    button.x -= style->window.header.padding.x;
-                    header.w -= style->window.header.padding.x;
+            if (left_mouse_down && left_mouse_click_in_scaler) {
+                float delta_x = in->mouse.delta.x;
+                if (layout->flags & NK_WINDOW_SCALE_LEFT) {
+                    delta_x = -delta_x;
+                    window->bounds.x += in->mouse.delta.x;
                 }
-                header.w -= button.w + style->window.header.spacing.x;
-            } else {
-                button.x = header.x;
-                header.x += button.w + style->window.header.spacing.x + style->window.header.padding.x;
+                /* dragging in x-direction  */
+                if (window->bounds.w + delta_x >= window_size.x) {
+                    if ((delta_x < 0) || (delta_x > 0 && in->mouse.pos.x >= scaler.x)) {
+                        window->bounds.w = window->bounds.w + delta_x;
+                        scaler.x += in->mouse.delta.x;
+                    }
+                }
+                /* dragging in y-direction (only possible if static window) */
+                if (!(layout->flags & NK_WINDOW_DYNAMIC)) {
+                    if (window_size.y < window->bounds.h + in->mouse.delta.y) {
+                        if ((in->mouse.delta.y < 0) || (in->mouse.delta.y > 0 && in->mouse.pos.y >= scaler.y)) {
+                            window->bounds.h = window->bounds.h + in->mouse.delta.y;
+                            scaler.y += in->mouse.delta.y;
+                        }
+                    }
+                }
+                ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_RESIZE_TOP_RIGHT_DOWN_LEFT];
+                in->mouse.buttons[NK_BUTTON_LEFT].clicked_pos.x = scaler.x + scaler.w/2.0f;
+                in->mouse.buttons[NK_BUTTON_LEFT].clicked_pos.y = scaler.y + scaler.h/2.0f;
             }
-            if (nk_do_button_symbol(&ws, &win->buffer, button, (layout->flags & NK_WINDOW_MINIMIZED)?
-                style->window.header.maximize_symbol: style->window.header.minimize_symbol,
-                NK_BUTTON_DEFAULT, &style->window.header.minimize_button, in, style->font) && !(win->flags & NK_WINDOW_ROM))
-                layout->flags = (layout->flags & NK_WINDOW_MINIMIZED) ?
-                    layout->flags & (nk_flags)~NK_WINDOW_MINIMIZED:
-                    layout->flags | NK_WINDOW_MINIMIZED;
-        }}
-
-        {/* window header title */
-        int text_len = nk_strlen(title);
-        struct nk_rect label = {0,0,0,0};
-        float t = font->width(font->userdata, font->height, title, text_len);
-        text.padding = nk_vec2(0,0);
+        }
+    }
+    if (!nk_panel_is_sub(layout->type)) {
+        /* window is hidden so clear command buffer  */
+        if (layout->flags & NK_WINDOW_HIDDEN)
+            nk_command_buffer_reset(&window->buffer);
+        /* window is visible and not tab */
+        else nk_finish(ctx, window);
+    }
 
-        label.x = header.x + style->window.header.padding.x;
-        label.x += style->window.header.label_padding.x;
-        label.y = header.y + style->window.header.label_padding.y;
-        label.h = font->height + 2 * style->window.header.label_padding.y;
-        label.w = t + 2 * style->window.header.spacing.x;
-        label.w = NK_CLAMP(0, label.w, header.x + header.w - label.x);
-        nk_widget_text(out, label,(const char*)title, text_len, &text, NK_TEXT_LEFT, font);}
+    /* NK_WINDOW_REMOVE_ROM flag was set so remove NK_WINDOW_ROM */
+    if (layout->flags & NK_WINDOW_REMOVE_ROM) {
+        layout->flags &= ~(nk_flags)NK_WINDOW_ROM;
+        layout->flags &= ~(nk_flags)NK_WINDOW_REMOVE_ROM;
     }
+    window->flags = layout->flags;
 
-    /* draw window background */
-    if (!(layout->flags & NK_WINDOW_MINIMIZED) && !(layout->flags & NK_WINDOW_DYNAMIC)) {
-        struct nk_rect body;
-        body.x = win->bounds.x;
-        body.w = win->bounds.w;
-        body.y = (win->bounds.y + layout->header_height);
-        body.h = (win->bounds.h - layout->header_height);
-        if (style->window.fixed_background.type == NK_STYLE_ITEM_IMAGE)
-            nk_draw_image(out, body, &style->window.fixed_background.data.image, nk_white);
-        else nk_fill_rect(out, body, 0, style->window.fixed_background.data.color);
+    /* property garbage collector */
+    if (window->property.active && window->property.old != window->property.seq &&
+        window->property.active == window->property.prev) {
+        nk_zero(&window->property, sizeof(window->property));
+    } else {
+        window->property.old = window->property.seq;
+        window->property.prev = window->property.active;
+        window->property.seq = 0;
+    }
+    /* edit garbage collector */
+    if (window->edit.active && window->edit.old != window->edit.seq &&
+       window->edit.active == window->edit.prev) {
+        nk_zero(&window->edit, sizeof(window->edit));
+    } else {
+        window->edit.old = window->edit.seq;
+        window->edit.prev = window->edit.active;
+        window->edit.seq = 0;
+    }
+    /* contextual garbage collector */
+    if (window->popup.active_con && window->popup.con_old != window->popup.con_count) {
+        window->popup.con_count = 0;
+        window->popup.con_old = 0;
+        window->popup.active_con = 0;
+    } else {
+        window->popup.con_old = window->popup.con_count;
+        window->popup.con_count = 0;
     }
+    window->popup.combo_count = 0;
+    /* helper to make sure you have a 'nk_tree_push' for every 'nk_tree_pop' */
+    NK_ASSERT(!layout->row.tree_depth);
+}
 
-    /* set clipping rectangle */
-    {struct nk_rect clip;
-    layout->clip = layout->bounds;
-    nk_unify(&clip, &win->buffer.clip, layout->clip.x, layout->clip.y,
-        layout->clip.x + layout->clip.w, layout->clip.y + layout->clip.h);
-    nk_push_scissor(out, clip);
-    layout->clip = clip;}
-    return !(layout->flags & NK_WINDOW_HIDDEN) && !(layout->flags & NK_WINDOW_MINIMIZED);
+/* ----------------------------------------------------------------
+ *
+ *                          PAGE ELEMENT
+ *
+ * ---------------------------------------------------------------*/
+NK_INTERN struct nk_page_element*
+nk_create_page_element(struct nk_context *ctx)
+{
+    struct nk_page_element *elem;
+    struct nk_page *page = 0;
+    if (ctx->freelist) {
+        /* unlink page element from free list */
+        elem = ctx->freelist;
+        ctx->freelist = elem->next;
+        ctx->freelist_count--;
+        page = elem->page;
+    } else if (ctx->use_pool) {
+        /* allocate page element from memory pool */
+        elem = nk_pool_alloc(&ctx->pool);
+        NK_ASSERT(elem);
+        if (!elem) return 0;
+        page = ctx->pool.pages;
+    } else {
+        /* allocate new page element from back of fixed size memory buffer */
+        NK_STORAGE const nk_size size = sizeof(struct nk_page_element);
+        NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_page_element);
+        elem = (struct nk_page_element*)nk_buffer_alloc(&ctx->memory, NK_BUFFER_BACK, size, align);
+        NK_ASSERT(elem);
+        if (!elem) return 0;
+    }
+    nk_zero_struct(*elem);
+    elem->next = 0;
+    elem->prev = 0;
+    elem->page = page;
+    if (page) page->live++;
+    ctx->element_count++;
+    ctx->element_peak = NK_MAX(ctx->element_peak, ctx->element_count);
+    return elem;
 }
 
 NK_INTERN void
-nk_panel_end(struct nk_context *ctx)
+nk_link_page_element_into_freelist(struct nk_context *ctx,
+    struct nk_page_element *elem)
 {
-    struct nk_input *in;
-    struct nk_window *window;
-    struct nk_panel *layout;
-    const struct nk_style *style;
-    struct nk_command_buffer *out;
-
-    struct nk_vec2 scrollbar_size;
-    struct nk_vec2 panel_padding;
+    /* link table into freelist */
+    if (!ctx->freelist) {
+        ctx->freelist = elem;
+    } else {
+        elem->next = ctx->freelist;
+        ctx->freelist = elem;
+    }
+    ctx->freelist_count++;
+}
 
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    NK_ASSERT(ctx->current->layout);
-    if (!ctx || !ctx->current || !ctx->current->layout)
+NK_INTERN void
+nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem)
+{
+    NK_ASSERT(ctx->element_count);
+    ctx->element_count--;
+    /* we have a pool so just add to free list */
+    if (ctx->use_pool) {
+        if (elem->page) {
+            NK_ASSERT(elem->page->live);
+            elem->page->live--;
+        }
+        nk_link_page_element_into_freelist(ctx, elem);
         return;
+    }
+    /* if possible remove last element from back of fixed memory buffer */
+    {void *elem_end = (void*)(elem + 1);
+    void *buffer_end = (nk_byte*)ctx->memory.memory.ptr + ctx->memory.size;
+    if (elem_end == buffer_end)
+        ctx->memory.size -= sizeof(struct nk_page_element);
+    else nk_link_page_element_into_freelist(ctx, elem);}
+}
 
-    window = ctx->current;
-    layout = window->layout;
-    style = &ctx->style;
-    out = &window->buffer;
-    in = (layout->flags & NK_WINDOW_ROM || layout->flags & NK_WINDOW_NO_INPUT) ? 0 :&ctx->input;
-    if (!nk_panel_is_sub(layout->type))
-        nk_push_scissor(out, nk_null_rect);
+/* ----------------------------------------------------------------
+ *
+ *                          PANEL
+ *
+ * ---------------------------------------------------------------*/
+NK_INTERN void*
+nk_create_panel(struct nk_context *ctx)
+{
+    struct nk_page_element *elem;
+    elem = nk_create_page_element(ctx);
+    if (!elem) return 0;
+    nk_zero_struct(elem->data);
+    return &elem->data.pan;
+}
 
-    /* cache configuration data */
-    scrollbar_size = style->window.scrollbar_size;
-    panel_padding = nk_panel_get_padding(style, layout->type);
+NK_INTERN void
+nk_free_panel(struct nk_context *ctx, struct nk_panel *pan)
+{
+    union nk_page_data *pd = NK_CONTAINER_OF(pan, union nk_page_data, pan);
+    struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
+    nk_free_page_element(ctx, pe);
+}
 
-    /* update the current cursor Y-position to point over the last added widget */
-    layout->at_y += layout->row.height;
+/* ----------------------------------------------------------------
+ *
+ *                          TABLES
+ *
+ * ---------------------------------------------------------------*/
+NK_INTERN struct nk_table*
+nk_create_table(struct nk_context *ctx)
+{
+    struct nk_page_element *elem;
+    elem = nk_create_page_element(ctx);
+    if (!elem) return 0;
+    nk_zero_struct(elem->data);
+    return &elem->data.tbl;
+}
 
-    /* dynamic panels */
-    if (layout->flags & NK_WINDOW_DYNAMIC && !(layout->flags & NK_WINDOW_MINIMIZED))
-    {
-        /* update panel height to fit dynamic growth */
-        struct nk_rect empty_space;
-        if (layout->at_y < (layout->bounds.y + layout->bounds.h))
-            layout->bounds.h = layout->at_y - layout->bounds.y;
+NK_INTERN void
+nk_free_table(struct nk_context *ctx, struct nk_table *tbl)
+{
+    union nk_page_data *pd = NK_CONTAINER_OF(tbl, union nk_page_data, tbl);
+    struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
+    nk_free_page_element(ctx, pe);
+}
 
-        /* fill top empty space */
-        empty_space.x = window->bounds.x;
-        empty_space.y = layout->bounds.y;
-        empty_space.h = panel_padding.y;
-        empty_space.w = window->bounds.w;
-        nk_fill_rect(out, empty_space, 0, style->window.background);
+NK_INTERN void
+nk_push_table(struct nk_window *win, struct nk_table *tbl)
+{
+    if (!win->tables) {
+        win->tables = tbl;
+        win->table_last = tbl;
+        tbl->next = 0;
+        tbl->prev = 0;
+        tbl->size = 0;
+        win->table_count = 1;
+        return;
+    }
+    win->tables->prev = tbl;
+    tbl->next = win->tables;
+    tbl->prev = 0;
+    tbl->size = 0;
+    win->tables = tbl;
+    win->table_count++;
+}
 
-        /* fill left empty space */
-        empty_space.x = window->bounds.x;
-        empty_space.y = layout->bounds.y;
-        empty_space.w = panel_padding.x + layout->border;
-        empty_space.h = layout->bounds.h;
-        nk_fill_rect(out, empty_space, 0, style->window.background);
+NK_INTERN void
+nk_touch_table(struct nk_window *win, struct nk_table *tbl)
+{
+    /* mark table and all its parents as used and move them to the front */
+    for (; tbl; tbl = tbl->parent) {
+        tbl->seq = win->seq;
+        if (win->tables == tbl) continue;
+        if (win->table_last == tbl)
+            win->table_last = tbl->prev;
+        tbl->prev->next = tbl->next;
+        if (tbl->next)
+            tbl->next->prev = tbl->prev;
+        tbl->prev = 0;
+        tbl->next = win->tables;
+        win->tables->prev = tbl;
+        win->tables = tbl;
+    }
+}
 
-        /* fill right empty space */
-        empty_space.x = layout->bounds.x + layout->bounds.w - layout->border;
-        empty_space.y = layout->bounds.y;
-        empty_space.w = panel_padding.x + layout->border;
-        empty_space.h = layout->bounds.h;
-        if (*layout->offset_y == 0 && !(layout->flags & NK_WINDOW_NO_SCROLLBAR))
-            empty_space.w += scrollbar_size.x;
-        nk_fill_rect(out, empty_space, 0, style->window.background);
+NK_INTERN int
+nk_table_has_children(const struct nk_table *tbl)
+{
+    int i;
+    for (i = 0; i < NK_VALUE_PAGE_FANOUT; ++i)
+        if (tbl->children[i]) return nk_true;
+    return nk_false;
+}
 
-        /* fill bottom empty space */
-        if (*layout->offset_x != 0 && !(layout->flags & NK_WINDOW_NO_SCROLLBAR)) {
-            empty_space.x = window->bounds.x;
-            empty_space.y = layout->bounds.y + layout->bounds.h;
-            empty_space.w = window->bounds.w;
-            empty_space.h = scrollbar_size.y;
-            nk_fill_rect(out, empty_space, 0, style->window.background);
+NK_INTERN void
+nk_remove_table(struct nk_window *win, struct nk_table *tbl)
+{
+    /* unlink table from hash trie. Only leaf tables can be removed
+     * without losing values stored in the tables below */
+    NK_ASSERT(!nk_table_has_children(tbl));
+    if (win->table_root == tbl)
+        win->table_root = 0;
+    if (tbl->parent) {
+        int i;
+        for (i = 0; i < NK_VALUE_PAGE_FANOUT; ++i) {
+            if (tbl->parent->children[i] != tbl) continue;
+            tbl->parent->children[i] = 0;
+            break;
         }
+        tbl->parent = 0;
     }
+    if (win->tables == tbl)
+        win->tables = tbl->next;
+    if (win->table_last == tbl)
+        win->table_last = tbl->prev;
+    if (tbl->next)
+        tbl->next->prev = tbl->prev;
+    if (tbl->prev)
+        tbl->prev->next = tbl->next;
+    tbl->next = 0;
+    tbl->prev = 0;
+    NK_ASSERT(win->table_count);
+    win->table_count--;
+}
 
-    /* scrollbars */
-    if (!(layout->flags & NK_WINDOW_NO_SCROLLBAR) &&
-        !(layout->flags & NK_WINDOW_MINIMIZED) &&
-        window->scrollbar_hiding_timer < NK_SCROLLBAR_HIDING_TIMEOUT)
-    {
-        struct nk_rect scroll;
-        int scroll_has_scrolling;
-        float scroll_target;
-        float scroll_offset;
-        float scroll_step;
-        float scroll_inc;
+NK_INTERN unsigned int
+nk_table_child(nk_hash name, unsigned int depth)
+{
+    /* every level of the trie consumes four bits of the key hash */
+    return (name >> ((depth * 4) & 31)) & (NK_VALUE_PAGE_FANOUT-1);
+}
 
-        /* mouse wheel scrolling */
-        if (nk_panel_is_sub(layout->type))
-        {
-            /* sub-window mouse wheel scrolling */
-            struct nk_window *root_window = window;
-            struct nk_panel *root_panel = window->layout;
-            while (root_panel->parent)
-                root_panel = root_panel->parent;
-            while (root_window->parent)
-                root_window = root_window->parent;
+NK_INTERN nk_uint*
+nk_add_value(struct nk_context *ctx, struct nk_window *win,
+            nk_hash name, nk_uint value)
+{
+    struct nk_table **slot;
+    struct nk_table *parent = 0;
+    struct nk_table *tbl;
+    unsigned int depth = 0;
 
-            /* only allow scrolling if parent window is active */
-            scroll_has_scrolling = 0;
-            if ((root_window == ctx->active) && layout->has_scrolling) {
-                /* and panel is being hovered and inside clip rect*/
-                if (nk_input_is_mouse_hovering_rect(in, layout->bounds) &&
-                    NK_INTERSECT(layout->bounds.x, layout->bounds.y, layout->bounds.w, layout->bounds.h,
-                        root_panel->clip.x, root_panel->clip.y, root_panel->clip.w, root_panel->clip.h))
-                {
-                    /* deactivate all parent scrolling */
-                    root_panel = window->layout;
-                    while (root_panel->parent) {
-                        root_panel->has_scrolling = nk_false;
-                        root_panel = root_panel->parent;
-                    }
-                    root_panel->has_scrolling = nk_false;
-                    scroll_has_scrolling = nk_true;
-                }
+    NK_ASSERT(ctx);
+    NK_ASSERT(win);
+    if (!win || !ctx) return 0;
+
+    /* store value in the first non-full table along the key path */
+    slot = &win->table_root;
+    while (*slot && (*slot)->size >= NK_VALUE_PAGE_CAPACITY) {
+        parent = *slot;
+        slot = &parent->children[nk_table_child(name, depth++)];
+    }
+    if (!*slot) {
+        tbl = nk_create_table(ctx);
+        NK_ASSERT(tbl);
+        if (!tbl) return 0;
+        nk_push_table(win, tbl);
+        tbl->parent = parent;
+        *slot = tbl;
+        nk_touch_table(win, tbl);
+    }
+    tbl = *slot;
+    if (tbl->seq != win->seq)
+        nk_touch_table(win, tbl);
+    tbl->keys[tbl->size] = name;
+    tbl->values[tbl->size] = value;
+    return &tbl->values[tbl->size++];
+}
+
+NK_INTERN nk_uint*
+nk_find_value(struct nk_window *win, nk_hash name)
+{
+    struct nk_table *iter = win->table_root;
+    unsigned int depth = 0;
+    while (iter) {
+        unsigned int i = 0;
+        unsigned int size = iter->size;
+        for (i = 0; i < size; ++i) {
+            if (iter->keys[i] == name) {
+                if (iter->seq != win->seq)
+                    nk_touch_table(win, iter);
+                return &iter->values[i];
             }
-        } else if (!nk_panel_is_sub(layout->type)) {
-            /* window mouse wheel scrolling */
-            scroll_has_scrolling = (window == ctx->active) && layout->has_scrolling;
-            if (in && (in->mouse.scroll_delta.y > 0 || in->mouse.scroll_delta.x > 0) && scroll_has_scrolling)
-                window->scrolled = nk_true;
-            else window->scrolled = nk_false;
-        } else scroll_has_scrolling = nk_false;
+        }
+        /* only full tables can have values stored below them */
+        if (size < NK_VALUE_PAGE_CAPACITY) break;
+        iter = iter->children[nk_table_child(name, depth++)];
+    }
+    return 0;
+}
+
+/* ----------------------------------------------------------------
+ *
+ *                          WINDOW
+ *
+ * ---------------------------------------------------------------*/
+NK_INTERN void*
+nk_create_window(struct nk_context *ctx)
+{
+    struct nk_page_element *elem;
+    elem = nk_create_page_element(ctx);
+    if (!elem) return 0;
+    elem->data.win.seq = ctx->seq;
+    return &elem->data.win;
+}
 
-        {
-            /* vertical scrollbar */
-            nk_flags state = 0;
-            scroll.x = layout->bounds.x + layout->bounds.w + panel_padding.x;
-            scroll.y = layout->bounds.y;
-            scroll.w = scrollbar_size.x;
-            scroll.h = layout->bounds.h;
+NK_INTERN int
+nk_window_index_slot(const struct nk_context *ctx, const struct nk_window *win)
+{
+    /* returns the index slot holding `win` or -1 if it is not indexed */
+    const unsigned int mask = NK_WINDOW_INDEX_SIZE-1;
+    unsigned int i = win->name & mask;
+    unsigned int n;
+    for (n = 0; n < NK_WINDOW_INDEX_SIZE; ++n) {
+        const struct nk_window *slot = ctx->window_index[i];
+        if (!slot) break;
+        if (slot == win) return (int)i;
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
 
-            scroll_offset = (float)*layout->offset_y;
-            scroll_step = scroll.h * 0.10f;
-            scroll_inc = scroll.h * 0.01f;
-            scroll_target = (float)(int)(layout->at_y - scroll.y);
-            scroll_offset = nk_do_scrollbarv(&state, out, scroll, scroll_has_scrolling,
-                scroll_offset, scroll_target, scroll_step, scroll_inc,
-                &ctx->style.scrollv, in, style->font);
-            *layout->offset_y = (nk_uint)scroll_offset;
-            if (in && scroll_has_scrolling)
-                in->mouse.scroll_delta.y = 0;
+NK_INTERN int
+nk_window_index_add(struct nk_context *ctx, struct nk_window *win)
+{
+    const unsigned int mask = NK_WINDOW_INDEX_SIZE-1;
+    unsigned int i;
+    /* keep the load factor below 3/4 so probe sequences stay short */
+    if (ctx->window_index_count >= (NK_WINDOW_INDEX_SIZE/4)*3)
+        return nk_false;
+    i = win->name & mask;
+    while (ctx->window_index[i])
+        i = (i + 1) & mask;
+    ctx->window_index[i] = win;
+    ctx->window_index_count++;
+    return nk_true;
+}
+
+NK_INTERN int
+nk_window_index_remove(struct nk_context *ctx, struct nk_window *win)
+{
+    const unsigned int mask = NK_WINDOW_INDEX_SIZE-1;
+    unsigned int hole, i;
+    int slot = nk_window_index_slot(ctx, win);
+    if (slot < 0) return nk_false;
+
+    /* backward shift deletion: move following entries of the probe
+     * sequence into the hole so no tombstones are required */
+    hole = (unsigned int)slot;
+    i = hole;
+    for (;;) {
+        unsigned int home;
+        i = (i + 1) & mask;
+        if (!ctx->window_index[i]) break;
+        home = ctx->window_index[i]->name & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            ctx->window_index[hole] = ctx->window_index[i];
+            hole = i;
         }
-        {
-            /* horizontal scrollbar */
-            nk_flags state = 0;
-            scroll.x = layout->bounds.x;
-            scroll.y = layout->bounds.y + layout->bounds.h;
-            scroll.w = layout->bounds.w;
-            scroll.h = scrollbar_size.y;
+    }
+    ctx->window_index[hole] = 0;
+    ctx->window_index_count--;
+    return nk_true;
+}
 
-            scroll_offset = (float)*layout->offset_x;
-            scroll_target = (float)(int)(layout->max_x - scroll.x);
-            scroll_step = layout->max_x * 0.05f;
-            scroll_inc = layout->max_x * 0.005f;
-            scroll_offset = nk_do_scrollbarh(&state, out, scroll, scroll_has_scrolling,
-                scroll_offset, scroll_target, scroll_step, scroll_inc,
-                &ctx->style.scrollh, in, style->font);
-            *layout->offset_x = (nk_uint)scroll_offset;
+NK_INTERN void
+nk_window_cache_store(struct nk_context *ctx, struct nk_window *win)
+{
+    NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_command);
+    struct nk_window_cache *cache = &win->cache;
+    const struct nk_command_buffer *buf = &win->buffer;
+    const struct nk_command *cmd;
+    nk_size offset, size;
+
+    cache->valid = nk_false;
+    if (!ctx->use_pool || buf->last == buf->begin || win->popup.buf.active)
+        return;
+
+    /* calculate the size of all commands without chunk links */
+    size = 0;
+    offset = buf->begin;
+    while (1) {
+        cmd = (const struct nk_command*)nk_buffer_at(&ctx->memory, offset);
+        if (cmd->type != NK_COMMAND_NOP)
+            size += (nk_command_copy_size(cmd) + align - 1) & ~(align - 1);
+        if (offset == buf->last) break;
+        NK_ASSERT(cmd->next > offset);
+        offset = cmd->next;
+    }
+    if (!size) return;
+    if (size > cache->capacity) {
+        struct nk_allocator *alloc = &ctx->pool.alloc;
+        if (cache->memory)
+            alloc->free(alloc->userdata, cache->memory);
+        cache->capacity = 0;
+        cache->memory = alloc->alloc(alloc->userdata, 0, size);
+        if (!cache->memory) return;
+        cache->capacity = size;
+    }
+
+    /* copy commands one after another with offsets relative to the first */
+    cache->size = 0;
+    offset = buf->begin;
+    while (1) {
+        cmd = (const struct nk_command*)nk_buffer_at(&ctx->memory, offset);
+        if (cmd->type != NK_COMMAND_NOP) {
+            struct nk_command *dst = nk_ptr_add(struct nk_command, cache->memory, cache->size);
+            nk_size cmd_size = nk_command_copy_size(cmd);
+            nk_command_copy(dst, cmd);
+            cache->last = cache->size;
+            cache->size += (cmd_size + align - 1) & ~(align - 1);
+            dst->next = cache->size;
         }
+        if (offset == buf->last) break;
+        offset = cmd->next;
     }
+    cache->bounds = win->bounds;
+    cache->flags = win->flags;
+    cache->font = ctx->style.font;
+    cache->active = (ctx->active == win);
+    cache->valid = nk_true;
+}
 
-    /* hide scroll if no user input */
-    if (window->flags & NK_WINDOW_SCROLL_AUTO_HIDE) {
-        int has_input = ctx->input.mouse.delta.x != 0 || ctx->input.mouse.delta.y != 0 || ctx->input.mouse.scroll_delta.y != 0;
-        int is_window_hovered = nk_window_is_hovered(ctx);
-        int any_item_active = (ctx->last_widget_state & NK_WIDGET_STATE_MODIFIED);
-        if ((!has_input && is_window_hovered) || (!is_window_hovered && !any_item_active))
-            window->scrollbar_hiding_timer += ctx->delta_time_seconds;
-        else window->scrollbar_hiding_timer = 0;
-    } else window->scrollbar_hiding_timer = 0;
+NK_INTERN void
+nk_window_cache_free(struct nk_context *ctx, struct nk_window *win)
+{
+    struct nk_window_cache *cache = &win->cache;
+    if (cache->memory)
+        ctx->pool.alloc.free(ctx->pool.alloc.userdata, cache->memory);
+    nk_zero(cache, sizeof(*cache));
+}
 
-    /* window border */
-    if (layout->flags & NK_WINDOW_BORDER)
-    {
-        struct nk_color border_color = nk_panel_get_border_color(style, layout->type);
-        const float padding_y = (layout->flags & NK_WINDOW_MINIMIZED) ?
-            style->window.border + window->bounds.y + layout->header_height:
-            (layout->flags & NK_WINDOW_DYNAMIC)?
-            layout->bounds.y + layout->bounds.h + layout->footer_height:
-            window->bounds.y + window->bounds.h;
+NK_INTERN int
+nk_window_cache_is_dirty(const struct nk_context *ctx, const struct nk_window *win)
+{
+    const struct nk_window_cache *cache = &win->cache;
+    const struct nk_input *in = &ctx->input;
+    const struct nk_rect b = win->bounds;
+    int i;
 
-        /* draw border top */
-        nk_stroke_line(out,window->bounds.x,window->bounds.y,
-            window->bounds.x + window->bounds.w, window->bounds.y,
-            layout->border, border_color);
+    if (!cache->valid || !(win->flags & NK_WINDOW_RETAINED))
+        return nk_true;
+    /* occlusion only changes drawing and not the content of a window */
+    if (((win->flags ^ cache->flags) & ~(nk_flags)NK_WINDOW_OCCLUDED) ||
+        !nk_rect_equal(b, cache->bounds) ||
+        (ctx->active == win) != cache->active || ctx->style.font != cache->font)
+        return nk_true;
+    /* persistent widget state which changes over time */
+    if (win->popup.win || win->edit.active || win->property.active ||
+        (win->flags & NK_WINDOW_SCROLL_AUTO_HIDE))
+        return nk_true;
 
-        /* draw bottom border */
-        nk_stroke_line(out, window->bounds.x, padding_y,
-            window->bounds.x + window->bounds.w, padding_y, layout->border, border_color);
+    /* mouse over the window or interacting with a widget inside */
+    if (NK_INBOX(in->mouse.pos.x, in->mouse.pos.y, b.x, b.y, b.w, b.h) ||
+        NK_INBOX(in->mouse.prev.x, in->mouse.prev.y, b.x, b.y, b.w, b.h))
+        return nk_true;
+    for (i = 0; i < NK_BUTTON_MAX; ++i) {
+        const struct nk_mouse_button *btn = &in->mouse.buttons[i];
+        if ((btn->down || btn->clicked) &&
+            NK_INBOX(btn->clicked_pos.x, btn->clicked_pos.y, b.x, b.y, b.w, b.h))
+            return nk_true;
+    }
+    /* keyboard input into the focused window */
+    if (ctx->active == win) {
+        if (in->keyboard.text_len)
+            return nk_true;
+        for (i = 0; i < NK_KEY_MAX; ++i)
+            if (in->keyboard.keys[i].down || in->keyboard.keys[i].clicked)
+                return nk_true;
+    }
+    return nk_false;
+}
 
-        /* draw left border */
-        nk_stroke_line(out, window->bounds.x + layout->border*0.5f,
-            window->bounds.y, window->bounds.x + layout->border*0.5f,
-            padding_y, layout->border, border_color);
+NK_INTERN void
+nk_free_window(struct nk_context *ctx, struct nk_window *win)
+{
+    /* unlink windows from list */
+    struct nk_table *it = win->tables;
+    NK_ASSERT(nk_window_index_slot(ctx, win) < 0 && "window still inside window list");
+    if (win->popup.win) {
+        nk_free_window(ctx, win->popup.win);
+        win->popup.win = 0;
+    }
+    win->next = 0;
+    win->prev = 0;
+    nk_window_cache_free(ctx, win);
 
-        /* draw right border */
-        nk_stroke_line(out, window->bounds.x + window->bounds.w - layout->border*0.5f,
-            window->bounds.y, window->bounds.x + window->bounds.w - layout->border*0.5f,
-            padding_y, layout->border, border_color);
+    while (it) {
+        /*free window state tables */
+        struct nk_table *n = it->next;
+        nk_zero(it->children, sizeof(it->children));
+        nk_remove_table(win, it);
+        nk_free_table(ctx, it);
+        if (it == win->tables)
+            win->tables = n;
+        it = n;
     }
+    win->table_root = 0;
+    win->table_last = 0;
 
-    /* scaler */
-    if ((layout->flags & NK_WINDOW_SCALABLE) && in && !(layout->flags & NK_WINDOW_MINIMIZED))
-    {
-        /* calculate scaler bounds */
-        struct nk_rect scaler;
-        scaler.w = scrollbar_size.x;
-        scaler.h = scrollbar_size.y;
-        scaler.y = layout->bounds.y + layout->bounds.h;
-        if (layout->flags & NK_WINDOW_SCALE_LEFT)
-            scaler.x = layout->bounds.x - panel_padding.x * 0.5f;
-        else scaler.x = layout->bounds.x + layout->bounds.w + panel_padding.x;
-        if (layout->flags & NK_WINDOW_NO_SCROLLBAR)
-            scaler.x -= scaler.w;
+    /* link windows into freelist */
+    {union nk_page_data *pd = NK_CONTAINER_OF(win, union nk_page_data, win);
+    struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
+    nk_free_page_element(ctx, pe);}
+}
 
-        /* draw scaler */
-        {const struct nk_style_item *item = &style->window.scaler;
-        if (item->type == NK_STYLE_ITEM_IMAGE)
-            nk_draw_image(out, scaler, &item->data.image, nk_white);
-        else {
-            if (layout->flags & NK_WINDOW_SCALE_LEFT) {
-                nk_fill_triangle(out, scaler.x, scaler.y, scaler.x,
-                    scaler.y + scaler.h, scaler.x + scaler.w,
-                    scaler.y + scaler.h, item->data.color);
-            } else {
-                nk_fill_triangle(out, scaler.x + scaler.w, scaler.y, scaler.x + scaler.w,
-                    scaler.y + scaler.h, scaler.x, scaler.y + scaler.h, item->data.color);
-            }
-        }}
+NK_INTERN struct nk_window*
+nk_find_window(struct nk_context *ctx, nk_hash hash, const char *name)
+{
+    const unsigned int mask = NK_WINDOW_INDEX_SIZE-1;
+    struct nk_window *iter;
+    unsigned int i, n;
 
-        /* do window scaling */
-        if (!(window->flags & NK_WINDOW_ROM)) {
-            struct nk_vec2 window_size = style->window.min_size;
-            int left_mouse_down = in->mouse.buttons[NK_BUTTON_LEFT].down;
-            int left_mouse_click_in_scaler = nk_input_has_mouse_click_down_in_rect(in,
-                    NK_BUTTON_LEFT, scaler, nk_true);
+    /* probe hash index */
+    i = hash & mask;
+    for (n = 0; n < NK_WINDOW_INDEX_SIZE; ++n) {
+        iter = ctx->window_index[i];
+        if (!iter) break;
+        if (iter->name == hash) {
+            int max_len = nk_strlen(iter->name_string);
+            if (!nk_stricmpn(iter->name_string, name, max_len))
+                return iter;
+        }
+        i = (i + 1) & mask;
+    }
+    if (!ctx->window_index_missed)
+        return 0;
 
-            if (left_mouse_down && left_mouse_click_in_scaler) {
-                float delta_x = in->mouse.delta.x;
-                if (layout->flags & NK_WINDOW_SCALE_LEFT) {
-                    delta_x = -delta_x;
-                    window->bounds.x += in->mouse.delta.x;
-                }
-                /* dragging in x-direction  */
-                if (window->bounds.w + delta_x >= window_size.x) {
-                    if ((delta_x < 0) || (delta_x > 0 && in->mouse.pos.x >= scaler.x)) {
-                        window->bounds.w = window->bounds.w + delta_x;
-                        scaler.x += in->mouse.delta.x;
-                    }
-                }
-                /* dragging in y-direction (only possible if static window) */
-                if (!(layout->flags & NK_WINDOW_DYNAMIC)) {
-                    if (window_size.y < window->bounds.h + in->mouse.delta.y) {
-                        if ((in->mouse.delta.y < 0) || (in->mouse.delta.y > 0 && in->mouse.pos.y >= scaler.y)) {
-                            window->bounds.h = window->bounds.h + in->mouse.delta.y;
-                            scaler.y += in->mouse.delta.y;
-                        }
-                    }
-                }
-                ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_RESIZE_TOP_RIGHT_DOWN_LEFT];
-                in->mouse.buttons[NK_BUTTON_LEFT].clicked_pos.x = scaler.x + scaler.w/2.0f;
-                in->mouse.buttons[NK_BUTTON_LEFT].clicked_pos.y = scaler.y + scaler.h/2.0f;
+    /* index overflowed so fall back to scanning the window list */
+    iter = ctx->begin;
+    while (iter) {
+        NK_ASSERT(iter != iter->next);
+        if (iter->name == hash) {
+            int max_len = nk_strlen(iter->name_string);
+            if (!nk_stricmpn(iter->name_string, name, max_len)) {
+                /* try to move window into index if space got freed up */
+                if (nk_window_index_add(ctx, iter))
+                    ctx->window_index_missed--;
+                return iter;
             }
         }
+        iter = iter->next;
+    }
+    return 0;
+}
+
+enum nk_window_insert_location {
+    NK_INSERT_BACK, /* inserts window into the back of list (front of screen) */
+    NK_INSERT_FRONT /* inserts window into the front of list (back of screen) */
+};
+NK_INTERN void
+nk_insert_window(struct nk_context *ctx, struct nk_window *win,
+    enum nk_window_insert_location loc)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(win);
+    if (!win || !ctx) return;
+
+    /* window is already inside the list */
+    NK_ASSERT(nk_window_index_slot(ctx, win) < 0);
+    if (nk_window_index_slot(ctx, win) >= 0) return;
+    if (!nk_window_index_add(ctx, win))
+        ctx->window_index_missed++;
+
+    if (!ctx->begin) {
+        win->next = 0;
+        win->prev = 0;
+        ctx->begin = win;
+        ctx->end = win;
+        ctx->count = 1;
+        return;
+    }
+    if (loc == NK_INSERT_BACK) {
+        struct nk_window *end;
+        end = ctx->end;
+        end->flags |= NK_WINDOW_ROM;
+        end->next = win;
+        win->prev = ctx->end;
+        win->next = 0;
+        ctx->end = win;
+        ctx->active = ctx->end;
+        ctx->end->flags &= ~(nk_flags)NK_WINDOW_ROM;
+    } else {
+        /*ctx->end->flags |= NK_WINDOW_ROM;*/
+        ctx->begin->prev = win;
+        win->next = ctx->begin;
+        win->prev = 0;
+        ctx->begin = win;
+        ctx->begin->flags &= ~(nk_flags)NK_WINDOW_ROM;
+    }
+    ctx->count++;
+}
+
+NK_INTERN void
+nk_remove_window(struct nk_context *ctx, struct nk_window *win)
+{
+    if (!nk_window_index_remove(ctx, win)) {
+        NK_ASSERT(ctx->window_index_missed);
+        ctx->window_index_missed--;
+    }
+    if (win == ctx->begin || win == ctx->end) {
+        if (win == ctx->begin) {
+            ctx->begin = win->next;
+            if (win->next)
+                win->next->prev = 0;
+        }
+        if (win == ctx->end) {
+            ctx->end = win->prev;
+            if (win->prev)
+                win->prev->next = 0;
+        }
+    } else {
+        if (win->next)
+            win->next->prev = win->prev;
+        if (win->prev)
+            win->prev->next = win->next;
     }
-    if (!nk_panel_is_sub(layout->type)) {
-        /* window is hidden so clear command buffer  */
-        if (layout->flags & NK_WINDOW_HIDDEN)
-            nk_command_buffer_reset(&window->buffer);
-        /* window is visible and not tab */
-        else nk_finish(ctx, window);
+    if (win == ctx->active || !ctx->active) {
+        ctx->active = ctx->end;
+        if (ctx->end)
+            ctx->end->flags &= ~(nk_flags)NK_WINDOW_ROM;
     }
+    win->next = 0;
+    win->prev = 0;
+    ctx->count--;
+}
 
-    /* NK_WINDOW_REMOVE_ROM flag was set so remove NK_WINDOW_ROM */
-    if (layout->flags & NK_WINDOW_REMOVE_ROM) {
-        layout->flags &= ~(nk_flags)NK_WINDOW_ROM;
-        layout->flags &= ~(nk_flags)NK_WINDOW_REMOVE_ROM;
-    }
-    window->flags = layout->flags;
+NK_INTERN void
+nk_window_update_focus(struct nk_context *ctx, struct nk_window *win)
+{
+    const struct nk_style *style = &ctx->style;
+    int inpanel, ishovered;
+    struct nk_window *iter = win;
+    float h = ctx->style.font->height + 2.0f * style->window.header.padding.y +
+        (2.0f * style->window.header.label_padding.y);
+    struct nk_rect win_bounds = (!(win->flags & NK_WINDOW_MINIMIZED))?
+        win->bounds: nk_rect(win->bounds.x, win->bounds.y, win->bounds.w, h);
+    if ((win->flags & NK_WINDOW_HIDDEN) || (win->flags & NK_WINDOW_NO_INPUT))
+        return;
 
-    /* property garbage collector */
-    if (window->property.active && window->property.old != window->property.seq &&
-        window->property.active == window->property.prev) {
-        nk_zero(&window->property, sizeof(window->property));
-    } else {
-        window->property.old = window->property.seq;
-        window->property.prev = window->property.active;
-        window->property.seq = 0;
+    /* activate window if hovered and no other window is overlapping this window */
+    inpanel = nk_input_has_mouse_click_down_in_rect(&ctx->input, NK_BUTTON_LEFT, win_bounds, nk_true);
+    inpanel = inpanel && ctx->input.mouse.buttons[NK_BUTTON_LEFT].clicked;
+    ishovered = nk_input_is_mouse_hovering_rect(&ctx->input, win_bounds);
+    if ((win != ctx->active) && ishovered && !ctx->input.mouse.buttons[NK_BUTTON_LEFT].down) {
+        iter = win->next;
+        while (iter) {
+            struct nk_rect iter_bounds = (!(iter->flags & NK_WINDOW_MINIMIZED))?
+                iter->bounds: nk_rect(iter->bounds.x, iter->bounds.y, iter->bounds.w, h);
+            if (NK_INTERSECT(win_bounds.x, win_bounds.y, win_bounds.w, win_bounds.h,
+                iter_bounds.x, iter_bounds.y, iter_bounds.w, iter_bounds.h) &&
+                (!(iter->flags & NK_WINDOW_HIDDEN)))
+                break;
+
+            if (iter->popup.win && iter->popup.active && !(iter->flags & NK_WINDOW_HIDDEN) &&
+                NK_INTERSECT(win->bounds.x, win_bounds.y, win_bounds.w, win_bounds.h,
+                iter->popup.win->bounds.x, iter->popup.win->bounds.y,
+                iter->popup.win->bounds.w, iter->popup.win->bounds.h))
+                break;
+            iter = iter->next;
+        }
     }
-    /* edit garbage collector */
-    if (window->edit.active && window->edit.old != window->edit.seq &&
-       window->edit.active == window->edit.prev) {
-        nk_zero(&window->edit, sizeof(window->edit));
-    } else {
-        window->edit.old = window->edit.seq;
-        window->edit.prev = window->edit.active;
-        window->edit.seq = 0;
+
+    /* activate window if clicked */
+    if (iter && inpanel && (win != ctx->end)) {
+        iter = win->next;
+        while (iter) {
+            /* try to find a panel with higher priority in the same position */
+            struct nk_rect iter_bounds = (!(iter->flags & NK_WINDOW_MINIMIZED))?
+            iter->bounds: nk_rect(iter->bounds.x, iter->bounds.y, iter->bounds.w, h);
+            if (NK_INBOX(ctx->input.mouse.pos.x, ctx->input.mouse.pos.y,
+                iter_bounds.x, iter_bounds.y, iter_bounds.w, iter_bounds.h) &&
+                !(iter->flags & NK_WINDOW_HIDDEN))
+                break;
+            if (iter->popup.win && iter->popup.active && !(iter->flags & NK_WINDOW_HIDDEN) &&
+                NK_INTERSECT(win_bounds.x, win_bounds.y, win_bounds.w, win_bounds.h,
+                iter->popup.win->bounds.x, iter->popup.win->bounds.y,
+                iter->popup.win->bounds.w, iter->popup.win->bounds.h))
+                break;
+            iter = iter->next;
+        }
     }
-    /* contextual garbage collector */
-    if (window->popup.active_con && window->popup.con_old != window->popup.con_count) {
-        window->popup.con_count = 0;
-        window->popup.con_old = 0;
-        window->popup.active_con = 0;
+    if (iter && !(win->flags & NK_WINDOW_ROM) && (win->flags & NK_WINDOW_BACKGROUND)) {
+        win->flags |= (nk_flags)NK_WINDOW_ROM;
+        iter->flags &= ~(nk_flags)NK_WINDOW_ROM;
+        ctx->active = iter;
+        if (!(iter->flags & NK_WINDOW_BACKGROUND)) {
+            /* current window is active in that position so transfer to top
+             * at the highest priority in stack */
+            nk_remove_window(ctx, iter);
+            nk_insert_window(ctx, iter, NK_INSERT_BACK);
+        }
     } else {
-        window->popup.con_old = window->popup.con_count;
-        window->popup.con_count = 0;
+        if (!iter && ctx->end != win) {
+            if (!(win->flags & NK_WINDOW_BACKGROUND)) {
+                /* current window is active in that position so transfer to top
+                 * at the highest priority in stack */
+                nk_remove_window(ctx, win);
+                nk_insert_window(ctx, win, NK_INSERT_BACK);
+            }
+            win->flags &= ~(nk_flags)NK_WINDOW_ROM;
+            ctx->active = win;
+        }
+        if (ctx->end != win && !(win->flags & NK_WINDOW_BACKGROUND))
+            win->flags |= NK_WINDOW_ROM;
     }
-    window->popup.combo_count = 0;
-    /* helper to make sure you have a 'nk_tree_push' for every 'nk_tree_pop' */
-    NK_ASSERT(!layout->row.tree_depth);
 }
 
-/* ----------------------------------------------------------------
- *
- *                          PAGE ELEMENT
- *
- * ---------------------------------------------------------------*/
-NK_INTERN struct nk_page_element*
-nk_create_page_element(struct nk_context *ctx)
+NK_API int
+nk_begin(struct nk_context *ctx, const char *title,
+    struct nk_rect bounds, nk_flags flags)
 {
-    struct nk_page_element *elem;
-    if (ctx->freelist) {
-        /* unlink page element from free list */
-        elem = ctx->freelist;
-        ctx->freelist = elem->next;
-    } else if (ctx->use_pool) {
-        /* allocate page element from memory pool */
-        elem = nk_pool_alloc(&ctx->pool);
-        NK_ASSERT(elem);
-        if (!elem) return 0;
+    return nk_begin_titled(ctx, title, title, bounds, flags);
+}
+
+NK_API int
+nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
+    struct nk_rect bounds, nk_flags flags)
+{
+    struct nk_window *win;
+    nk_hash title_hash;
+    int title_len;
+    int ret = 0;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(name);
+    NK_ASSERT(title);
+    NK_ASSERT(ctx->style.font && ctx->style.font->width && "if this triggers you forgot to add a font");
+    NK_ASSERT(!ctx->current && "if this triggers you missed a `nk_end` call");
+    if (!ctx || ctx->current || !title || !name)
+        return 0;
+
+    /* find or create window */
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (!win) {
+        /* create new window */
+        nk_size name_length = (nk_size)nk_strlen(name);
+        win = (struct nk_window*)nk_create_window(ctx);
+        NK_ASSERT(win);
+        if (!win) return 0;
+
+        /* name is the window index key and has to be set before insertion */
+        win->name = title_hash;
+        name_length = NK_MIN(name_length, NK_WINDOW_MAX_NAME-1);
+        NK_MEMCPY(win->name_string, name, name_length);
+        win->name_string[name_length] = 0;
+        if (flags & NK_WINDOW_BACKGROUND)
+            nk_insert_window(ctx, win, NK_INSERT_FRONT);
+        else nk_insert_window(ctx, win, NK_INSERT_BACK);
+        nk_command_buffer_init(&win->buffer, &ctx->memory, NK_CLIPPING_ON);
+
+        win->flags = flags;
+        win->bounds = bounds;
+        win->popup.win = 0;
+        if (!ctx->active)
+            ctx->active = win;
     } else {
-        /* allocate new page element from back of fixed size memory buffer */
-        NK_STORAGE const nk_size size = sizeof(struct nk_page_element);
-        NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_page_element);
-        elem = (struct nk_page_element*)nk_buffer_alloc(&ctx->memory, NK_BUFFER_BACK, size, align);
-        NK_ASSERT(elem);
-        if (!elem) return 0;
+        /* update window */
+        win->flags &= ~(nk_flags)(NK_WINDOW_PRIVATE-1);
+        win->flags |= flags;
+        if (!(win->flags & (NK_WINDOW_MOVABLE | NK_WINDOW_SCALABLE)))
+            win->bounds = bounds;
+        /* If this assert triggers you either:
+         *
+         * I.) Have more than one window with the same name or
+         * II.) You forgot to actually draw the window.
+         *      More specific you did not call `nk_clear` (nk_clear will be
+         *      automatically called for you if you are using one of the
+         *      provided demo backends). */
+        NK_ASSERT(win->seq != ctx->seq);
+        win->seq = ctx->seq;
+        if (!ctx->active && !(win->flags & NK_WINDOW_HIDDEN)) {
+            ctx->active = win;
+            ctx->end = win;
+        }
     }
-    nk_zero_struct(*elem);
-    elem->next = 0;
-    elem->prev = 0;
-    return elem;
+    if (win->flags & NK_WINDOW_HIDDEN) {
+        ctx->current = win;
+        win->layout = 0;
+        return 0;
+    } else nk_start(ctx, win);
+
+    /* window overlapping */
+    nk_window_update_focus(ctx, win);
+    win->layout = (struct nk_panel*)nk_create_panel(ctx);
+    ctx->current = win;
+    ret = nk_panel_begin(ctx, title, NK_PANEL_WINDOW);
+    win->layout->offset_x = &win->scrollbar.x;
+    win->layout->offset_y = &win->scrollbar.y;
+    return ret;
 }
 
-NK_INTERN void
-nk_link_page_element_into_freelist(struct nk_context *ctx,
-    struct nk_page_element *elem)
+NK_API void
+nk_end(struct nk_context *ctx)
 {
-    /* link table into freelist */
-    if (!ctx->freelist) {
-        ctx->freelist = elem;
-    } else {
-        elem->next = ctx->freelist;
-        ctx->freelist = elem;
+    struct nk_panel *layout;
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current && "if this triggers you forgot to call `nk_begin`");
+    if (!ctx || !ctx->current)
+        return;
+
+    layout = ctx->current->layout;
+    if (!layout || (layout->type == NK_PANEL_WINDOW && (ctx->current->flags & NK_WINDOW_HIDDEN))) {
+        ctx->current->cache.valid = nk_false;
+        ctx->current = 0;
+        return;
     }
+    nk_panel_end(ctx);
+    if (layout->type == NK_PANEL_WINDOW && (ctx->current->flags & NK_WINDOW_RETAINED))
+        nk_window_cache_store(ctx, ctx->current);
+    else ctx->current->cache.valid = nk_false;
+    nk_free_panel(ctx, ctx->current->layout);
+    ctx->current = 0;
+}
+
+NK_API struct nk_rect
+nk_window_get_bounds(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current) return nk_rect(0,0,0,0);
+    return ctx->current->bounds;
+}
+
+NK_API struct nk_vec2
+nk_window_get_position(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current) return nk_vec2(0,0);
+    return nk_vec2(ctx->current->bounds.x, ctx->current->bounds.y);
+}
+
+NK_API struct nk_vec2
+nk_window_get_size(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current) return nk_vec2(0,0);
+    return nk_vec2(ctx->current->bounds.w, ctx->current->bounds.h);
+}
+
+NK_API float
+nk_window_get_width(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current) return 0;
+    return ctx->current->bounds.w;
+}
+
+NK_API float
+nk_window_get_height(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current) return 0;
+    return ctx->current->bounds.h;
 }
 
-NK_INTERN void
-nk_free_page_element(struct nk_context *ctx, struct nk_page_element *elem)
+NK_API struct nk_rect
+nk_window_get_content_region(struct nk_context *ctx)
 {
-    /* we have a pool so just add to free list */
-    if (ctx->use_pool) {
-        nk_link_page_element_into_freelist(ctx, elem);
-        return;
-    }
-    /* if possible remove last element from back of fixed memory buffer */
-    {void *elem_end = (void*)(elem + 1);
-    void *buffer_end = (nk_byte*)ctx->memory.memory.ptr + ctx->memory.size;
-    if (elem_end == buffer_end)
-        ctx->memory.size -= sizeof(struct nk_page_element);
-    else nk_link_page_element_into_freelist(ctx, elem);}
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current) return nk_rect(0,0,0,0);
+    return ctx->current->layout->clip;
 }
 
-/* ----------------------------------------------------------------
- *
- *                          PANEL
- *
- * ---------------------------------------------------------------*/
-NK_INTERN void*
-nk_create_panel(struct nk_context *ctx)
+NK_API struct nk_vec2
+nk_window_get_content_region_min(struct nk_context *ctx)
 {
-    struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
-    if (!elem) return 0;
-    nk_zero_struct(*elem);
-    return &elem->data.pan;
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(ctx->current->layout);
+    if (!ctx || !ctx->current) return nk_vec2(0,0);
+    return nk_vec2(ctx->current->layout->clip.x, ctx->current->layout->clip.y);
 }
 
-NK_INTERN void
-nk_free_panel(struct nk_context *ctx, struct nk_panel *pan)
+NK_API struct nk_vec2
+nk_window_get_content_region_max(struct nk_context *ctx)
 {
-    union nk_page_data *pd = NK_CONTAINER_OF(pan, union nk_page_data, pan);
-    struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(ctx->current->layout);
+    if (!ctx || !ctx->current) return nk_vec2(0,0);
+    return nk_vec2(ctx->current->layout->clip.x + ctx->current->layout->clip.w,
+        ctx->current->layout->clip.y + ctx->current->layout->clip.h);
 }
 
-/* ----------------------------------------------------------------
- *
- *                          TABLES
- *
- * ---------------------------------------------------------------*/
-NK_INTERN struct nk_table*
-nk_create_table(struct nk_context *ctx)
+NK_API struct nk_vec2
+nk_window_get_content_region_size(struct nk_context *ctx)
 {
-    struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
-    if (!elem) return 0;
-    nk_zero_struct(*elem);
-    return &elem->data.tbl;
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(ctx->current->layout);
+    if (!ctx || !ctx->current) return nk_vec2(0,0);
+    return nk_vec2(ctx->current->layout->clip.w, ctx->current->layout->clip.h);
 }
 
-NK_INTERN void
-nk_free_table(struct nk_context *ctx, struct nk_table *tbl)
+NK_API struct nk_command_buffer*
+nk_window_get_canvas(struct nk_context *ctx)
 {
-    union nk_page_data *pd = NK_CONTAINER_OF(tbl, union nk_page_data, tbl);
-    struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(ctx->current->layout);
+    if (!ctx || !ctx->current) return 0;
+    return &ctx->current->buffer;
 }
 
-NK_INTERN void
-nk_push_table(struct nk_window *win, struct nk_table *tbl)
+NK_API struct nk_panel*
+nk_window_get_panel(struct nk_context *ctx)
 {
-    if (!win->tables) {
-        win->tables = tbl;
-        tbl->next = 0;
-        tbl->prev = 0;
-        tbl->size = 0;
-        win->table_count = 1;
-        return;
-    }
-    win->tables->prev = tbl;
-    tbl->next = win->tables;
-    tbl->prev = 0;
-    tbl->size = 0;
-    win->tables = tbl;
-    win->table_count++;
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current) return 0;
+    return ctx->current->layout;
 }
 
-NK_INTERN void
-nk_remove_table(struct nk_window *win, struct nk_table *tbl)
+NK_API int
+nk_window_has_focus(const struct nk_context *ctx)
 {
-    if (win->tables == tbl)
-        win->tables = tbl->next;
-    if (tbl->next)
-        tbl->next->prev = tbl->prev;
-    if (tbl->prev)
-        tbl->prev->next = tbl->next;
-    tbl->next = 0;
-    tbl->prev = 0;
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(ctx->current->layout);
+    if (!ctx || !ctx->current) return 0;
+    return ctx->current == ctx->active;
 }
 
-NK_INTERN nk_uint*
-nk_add_value(struct nk_context *ctx, struct nk_window *win,
-            nk_hash name, nk_uint value)
+NK_API int
+nk_window_is_hovered(struct nk_context *ctx)
 {
     NK_ASSERT(ctx);
-    NK_ASSERT(win);
-    if (!win || !ctx) return 0;
-    if (!win->tables || win->tables->size >= NK_VALUE_PAGE_CAPACITY) {
-        struct nk_table *tbl = nk_create_table(ctx);
-        NK_ASSERT(tbl);
-        if (!tbl) return 0;
-        nk_push_table(win, tbl);
-    }
-    win->tables->seq = win->seq;
-    win->tables->keys[win->tables->size] = name;
-    win->tables->values[win->tables->size] = value;
-    return &win->tables->values[win->tables->size++];
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current) return 0;
+    if(ctx->current->flags & NK_WINDOW_HIDDEN)
+        return 0;
+    return nk_input_is_mouse_hovering_rect(&ctx->input, ctx->current->bounds);
 }
 
-NK_INTERN nk_uint*
-nk_find_value(struct nk_window *win, nk_hash name)
+NK_API int
+nk_window_is_any_hovered(struct nk_context *ctx)
 {
-    struct nk_table *iter = win->tables;
+    struct nk_window *iter;
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
+    iter = ctx->begin;
     while (iter) {
-        unsigned int i = 0;
-        unsigned int size = iter->size;
-        for (i = 0; i < size; ++i) {
-            if (iter->keys[i] == name) {
-                iter->seq = win->seq;
-                return &iter->values[i];
+        /* check if window is being hovered */
+        if(!(iter->flags & NK_WINDOW_HIDDEN)) {
+            /* check if window popup is being hovered */
+            if (iter->popup.active && iter->popup.win && nk_input_is_mouse_hovering_rect(&ctx->input, iter->popup.win->bounds))
+                return 1;
+
+            if (iter->flags & NK_WINDOW_MINIMIZED) {
+                struct nk_rect header = iter->bounds;
+                header.h = ctx->style.font->height + 2 * ctx->style.window.header.padding.y;
+                if (nk_input_is_mouse_hovering_rect(&ctx->input, header))
+                    return 1;
+            } else if (nk_input_is_mouse_hovering_rect(&ctx->input, iter->bounds)) {
+                return 1;
             }
-        } size = NK_VALUE_PAGE_CAPACITY;
+        }
         iter = iter->next;
     }
     return 0;
 }
 
-/* ----------------------------------------------------------------
- *
- *                          WINDOW
- *
- * ---------------------------------------------------------------*/
-NK_INTERN void*
-nk_create_window(struct nk_context *ctx)
+NK_API int
+nk_item_is_any_active(struct nk_context *ctx)
 {
-    struct nk_page_element *elem;
-    elem = nk_create_page_element(ctx);
-    if (!elem) return 0;
-    elem->data.win.seq = ctx->seq;
-    return &elem->data.win;
+    int any_hovered = nk_window_is_any_hovered(ctx);
+    int any_active = (ctx->last_widget_state & NK_WIDGET_STATE_MODIFIED);
+    return any_hovered || any_active;
 }
 
-NK_INTERN void
-nk_free_window(struct nk_context *ctx, struct nk_window *win)
+NK_API int
+nk_window_is_collapsed(struct nk_context *ctx, const char *name)
 {
-    /* unlink windows from list */
-    struct nk_table *it = win->tables;
-    if (win->popup.win) {
-        nk_free_window(ctx, win->popup.win);
-        win->popup.win = 0;
-    }
-    win->next = 0;
-    win->prev = 0;
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
 
-    while (it) {
-        /*free window state tables */
-        struct nk_table *n = it->next;
-        nk_remove_table(win, it);
-        nk_free_table(ctx, it);
-        if (it == win->tables)
-            win->tables = n;
-        it = n;
-    }
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (!win) return 0;
+    return win->flags & NK_WINDOW_MINIMIZED;
+}
+
+NK_API int
+nk_window_is_closed(struct nk_context *ctx, const char *name)
+{
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
+    NK_ASSERT(ctx);
+    if (!ctx) return 1;
+
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (!win) return 1;
+    return (win->flags & NK_WINDOW_CLOSED);
+}
+
+NK_API int
+nk_window_is_hidden(struct nk_context *ctx, const char *name)
+{
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
+    NK_ASSERT(ctx);
+    if (!ctx) return 1;
+
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (!win) return 1;
+    return (win->flags & NK_WINDOW_HIDDEN);
+}
+
+NK_API int
+nk_window_is_active(struct nk_context *ctx, const char *name)
+{
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
 
-    /* link windows into freelist */
-    {union nk_page_data *pd = NK_CONTAINER_OF(win, union nk_page_data, win);
-    struct nk_page_element *pe = NK_CONTAINER_OF(pd, struct nk_page_element, data);
-    nk_free_page_element(ctx, pe);}
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (!win) return 0;
+    return win == ctx->active;
 }
 
-NK_INTERN struct nk_window*
-nk_find_window(struct nk_context *ctx, nk_hash hash, const char *name)
+NK_API struct nk_window*
+nk_window_find(struct nk_context *ctx, const char *name)
 {
-    struct nk_window *iter;
-    iter = ctx->begin;
-    while (iter) {
-        NK_ASSERT(iter != iter->next);
-        if (iter->name == hash) {
-            int max_len = nk_strlen(iter->name_string);
-            if (!nk_stricmpn(iter->name_string, name, max_len))
-                return iter;
-        }
-        iter = iter->next;
-    }
-    return 0;
+    int title_len;
+    nk_hash title_hash;
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    return nk_find_window(ctx, title_hash, name);
 }
 
-enum nk_window_insert_location {
-    NK_INSERT_BACK, /* inserts window into the back of list (front of screen) */
-    NK_INSERT_FRONT /* inserts window into the front of list (back of screen) */
-};
-NK_INTERN void
-nk_insert_window(struct nk_context *ctx, struct nk_window *win,
-    enum nk_window_insert_location loc)
+NK_API void
+nk_window_close(struct nk_context *ctx, const char *name)
 {
-    const struct nk_window *iter;
+    struct nk_window *win;
     NK_ASSERT(ctx);
-    NK_ASSERT(win);
-    if (!win || !ctx) return;
-
-    iter = ctx->begin;
-    while (iter) {
-        NK_ASSERT(iter != iter->next);
-        NK_ASSERT(iter != win);
-        if (iter == win) return;
-        iter = iter->next;
-    }
+    if (!ctx) return;
+    win = nk_window_find(ctx, name);
+    if (!win) return;
+    NK_ASSERT(ctx->current != win && "You cannot close a currently active window");
+    if (ctx->current == win) return;
+    win->flags |= NK_WINDOW_HIDDEN;
+    win->flags |= NK_WINDOW_CLOSED;
+}
 
-    if (!ctx->begin) {
-        win->next = 0;
-        win->prev = 0;
-        ctx->begin = win;
-        ctx->end = win;
-        ctx->count = 1;
-        return;
-    }
-    if (loc == NK_INSERT_BACK) {
-        struct nk_window *end;
-        end = ctx->end;
-        end->flags |= NK_WINDOW_ROM;
-        end->next = win;
-        win->prev = ctx->end;
-        win->next = 0;
-        ctx->end = win;
-        ctx->active = ctx->end;
-        ctx->end->flags &= ~(nk_flags)NK_WINDOW_ROM;
-    } else {
-        /*ctx->end->flags |= NK_WINDOW_ROM;*/
-        ctx->begin->prev = win;
-        win->next = ctx->begin;
-        win->prev = 0;
-        ctx->begin = win;
-        ctx->begin->flags &= ~(nk_flags)NK_WINDOW_ROM;
-    }
-    ctx->count++;
+NK_API void
+nk_window_set_bounds(struct nk_context *ctx,
+    const char *name, struct nk_rect bounds)
+{
+    struct nk_window *win;
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+    win = nk_window_find(ctx, name);
+    if (!win) return;
+    NK_ASSERT(ctx->current != win && "You cannot update a currently in procecss window");
+    win->bounds = bounds;
 }
 
-NK_INTERN void
-nk_remove_window(struct nk_context *ctx, struct nk_window *win)
+NK_API void
+nk_window_set_position(struct nk_context *ctx,
+    const char *name, struct nk_vec2 pos)
 {
-    if (win == ctx->begin || win == ctx->end) {
-        if (win == ctx->begin) {
-            ctx->begin = win->next;
-            if (win->next)
-                win->next->prev = 0;
-        }
-        if (win == ctx->end) {
-            ctx->end = win->prev;
-            if (win->prev)
-                win->prev->next = 0;
-        }
-    } else {
-        if (win->next)
-            win->next->prev = win->prev;
-        if (win->prev)
-            win->prev->next = win->next;
-    }
-    if (win == ctx->active || !ctx->active) {
-        ctx->active = ctx->end;
-        if (ctx->end)
-            ctx->end->flags &= ~(nk_flags)NK_WINDOW_ROM;
-    }
-    win->next = 0;
-    win->prev = 0;
-    ctx->count--;
+    struct nk_window *win = nk_window_find(ctx, name);
+    if (!win) return;
+    win->bounds.x = pos.x;
+    win->bounds.y = pos.y;
 }
 
-NK_API int
-nk_begin(struct nk_context *ctx, const char *title,
-    struct nk_rect bounds, nk_flags flags)
+NK_API void
+nk_window_set_size(struct nk_context *ctx,
+    const char *name, struct nk_vec2 size)
 {
-    return nk_begin_titled(ctx, title, title, bounds, flags);
+    struct nk_window *win = nk_window_find(ctx, name);
+    if (!win) return;
+    win->bounds.w = size.x;
+    win->bounds.h = size.y;
 }
 
-NK_API int
-nk_begin_titled(struct nk_context *ctx, const char *name, const char *title,
-    struct nk_rect bounds, nk_flags flags)
+NK_API void
+nk_window_collapse(struct nk_context *ctx, const char *name,
+                    enum nk_collapse_states c)
 {
-    struct nk_window *win;
-    struct nk_style *style;
-    nk_hash title_hash;
     int title_len;
-    int ret = 0;
-
+    nk_hash title_hash;
+    struct nk_window *win;
     NK_ASSERT(ctx);
-    NK_ASSERT(name);
-    NK_ASSERT(title);
-    NK_ASSERT(ctx->style.font && ctx->style.font->width && "if this triggers you forgot to add a font");
-    NK_ASSERT(!ctx->current && "if this triggers you missed a `nk_end` call");
-    if (!ctx || ctx->current || !title || !name)
-        return 0;
+    if (!ctx) return;
 
-    /* find or create window */
-    style = &ctx->style;
     title_len = (int)nk_strlen(name);
     title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
     win = nk_find_window(ctx, title_hash, name);
-    if (!win) {
-        /* create new window */
-        nk_size name_length = (nk_size)nk_strlen(name);
-        win = (struct nk_window*)nk_create_window(ctx);
-        NK_ASSERT(win);
-        if (!win) return 0;
-
-        if (flags & NK_WINDOW_BACKGROUND)
-            nk_insert_window(ctx, win, NK_INSERT_FRONT);
-        else nk_insert_window(ctx, win, NK_INSERT_BACK);
-        nk_command_buffer_init(&win->buffer, &ctx->memory, NK_CLIPPING_ON);
-
-        win->flags = flags;
-        win->bounds = bounds;
-        win->name = title_hash;
-        name_length = NK_MIN(name_length, NK_WINDOW_MAX_NAME-1);
-        NK_MEMCPY(win->name_string, name, name_length);
-        win->name_string[name_length] = 0;
-        win->popup.win = 0;
-        if (!ctx->active)
-            ctx->active = win;
-    } else {
-        /* update window */
-        win->flags &= ~(nk_flags)(NK_WINDOW_PRIVATE-1);
-        win->flags |= flags;
-        if (!(win->flags & (NK_WINDOW_MOVABLE | NK_WINDOW_SCALABLE)))
-            win->bounds = bounds;
-        /* If this assert triggers you either:
-         *
-         * I.) Have more than one window with the same name or
-         * II.) You forgot to actually draw the window.
-         *      More specific you did not call `nk_clear` (nk_clear will be
-         *      automatically called for you if you are using one of the
-         *      provided demo backends). */
-        NK_ASSERT(win->seq != ctx->seq);
-        win->seq = ctx->seq;
-        if (!ctx->active && !(win->flags & NK_WINDOW_HIDDEN)) {
-            ctx->active = win;
-            ctx->end = win;
-        }
-    }
-    if (win->flags & NK_WINDOW_HIDDEN) {
-        ctx->current = win;
-        win->layout = 0;
-        return 0;
-    } else nk_start(ctx, win);
-
-    /* window overlapping */
-    if (!(win->flags & NK_WINDOW_HIDDEN) && !(win->flags & NK_WINDOW_NO_INPUT))
-    {
-        int inpanel, ishovered;
-        struct nk_window *iter = win;
-        float h = ctx->style.font->height + 2.0f * style->window.header.padding.y +
-            (2.0f * style->window.header.label_padding.y);
-        struct nk_rect win_bounds = (!(win->flags & NK_WINDOW_MINIMIZED))?
-            win->bounds: nk_rect(win->bounds.x, win->bounds.y, win->bounds.w, h);
-
-        /* activate window if hovered and no other window is overlapping this window */
-        inpanel = nk_input_has_mouse_click_down_in_rect(&ctx->input, NK_BUTTON_LEFT, win_bounds, nk_true);
-        inpanel = inpanel && ctx->input.mouse.buttons[NK_BUTTON_LEFT].clicked;
-        ishovered = nk_input_is_mouse_hovering_rect(&ctx->input, win_bounds);
-        if ((win != ctx->active) && ishovered && !ctx->input.mouse.buttons[NK_BUTTON_LEFT].down) {
-            iter = win->next;
-            while (iter) {
-                struct nk_rect iter_bounds = (!(iter->flags & NK_WINDOW_MINIMIZED))?
-                    iter->bounds: nk_rect(iter->bounds.x, iter->bounds.y, iter->bounds.w, h);
-                if (NK_INTERSECT(win_bounds.x, win_bounds.y, win_bounds.w, win_bounds.h,
-                    iter_bounds.x, iter_bounds.y, iter_bounds.w, iter_bounds.h) &&
-                    (!(iter->flags & NK_WINDOW_HIDDEN)))
-                    break;
+    if (!win) return;
+    if (c == NK_MINIMIZED)
+        win->flags |= NK_WINDOW_MINIMIZED;
+    else win->flags &= ~(nk_flags)NK_WINDOW_MINIMIZED;
+}
 
-                if (iter->popup.win && iter->popup.active && !(iter->flags & NK_WINDOW_HIDDEN) &&
-                    NK_INTERSECT(win->bounds.x, win_bounds.y, win_bounds.w, win_bounds.h,
-                    iter->popup.win->bounds.x, iter->popup.win->bounds.y,
-                    iter->popup.win->bounds.w, iter->popup.win->bounds.h))
-                    break;
-                iter = iter->next;
-            }
-        }
+NK_API void
+nk_window_collapse_if(struct nk_context *ctx, const char *name,
+    enum nk_collapse_states c, int cond)
+{
+    NK_ASSERT(ctx);
+    if (!ctx || !cond) return;
+    nk_window_collapse(ctx, name, c);
+}
 
-        /* activate window if clicked */
-        if (iter && inpanel && (win != ctx->end)) {
-            iter = win->next;
-            while (iter) {
-                /* try to find a panel with higher priority in the same position */
-                struct nk_rect iter_bounds = (!(iter->flags & NK_WINDOW_MINIMIZED))?
-                iter->bounds: nk_rect(iter->bounds.x, iter->bounds.y, iter->bounds.w, h);
-                if (NK_INBOX(ctx->input.mouse.pos.x, ctx->input.mouse.pos.y,
-                    iter_bounds.x, iter_bounds.y, iter_bounds.w, iter_bounds.h) &&
-                    !(iter->flags & NK_WINDOW_HIDDEN))
-                    break;
-                if (iter->popup.win && iter->popup.active && !(iter->flags & NK_WINDOW_HIDDEN) &&
-                    NK_INTERSECT(win_bounds.x, win_bounds.y, win_bounds.w, win_bounds.h,
-                    iter->popup.win->bounds.x, iter->popup.win->bounds.y,
-                    iter->popup.win->bounds.w, iter->popup.win->bounds.h))
-                    break;
-                iter = iter->next;
-            }
-        }
-        if (iter && !(win->flags & NK_WINDOW_ROM) && (win->flags & NK_WINDOW_BACKGROUND)) {
-            win->flags |= (nk_flags)NK_WINDOW_ROM;
-            iter->flags &= ~(nk_flags)NK_WINDOW_ROM;
-            ctx->active = iter;
-            if (!(iter->flags & NK_WINDOW_BACKGROUND)) {
-                /* current window is active in that position so transfer to top
-                 * at the highest priority in stack */
-                nk_remove_window(ctx, iter);
-                nk_insert_window(ctx, iter, NK_INSERT_BACK);
-            }
-        } else {
-            if (!iter && ctx->end != win) {
-                if (!(win->flags & NK_WINDOW_BACKGROUND)) {
-                    /* current window is active in that position so transfer to top
-                     * at the highest priority in stack */
-                    nk_remove_window(ctx, win);
-                    nk_insert_window(ctx, win, NK_INSERT_BACK);
-                }
-                win->flags &= ~(nk_flags)NK_WINDOW_ROM;
-                ctx->active = win;
-            }
-            if (ctx->end != win && !(win->flags & NK_WINDOW_BACKGROUND))
-                win->flags |= NK_WINDOW_ROM;
-        }
-    }
-    win->layout = (struct nk_panel*)nk_create_panel(ctx);
-    ctx->current = win;
-    ret = nk_panel_begin(ctx, title, NK_PANEL_WINDOW);
-    win->layout->offset_x = &win->scrollbar.x;
-    win->layout->offset_y = &win->scrollbar.y;
-    return ret;
+NK_API void
+nk_window_show(struct nk_context *ctx, const char *name, enum nk_show_states s)
+{
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (!win) return;
+    if (s == NK_HIDDEN) {
+        win->flags |= NK_WINDOW_HIDDEN;
+    } else win->flags &= ~(nk_flags)NK_WINDOW_HIDDEN;
 }
 
 NK_API void
-nk_end(struct nk_context *ctx)
+nk_window_show_if(struct nk_context *ctx, const char *name,
+    enum nk_show_states s, int cond)
 {
-    struct nk_panel *layout;
     NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current && "if this triggers you forgot to call `nk_begin`");
-    if (!ctx || !ctx->current)
-        return;
+    if (!ctx || !cond) return;
+    nk_window_show(ctx, name, s);
+}
 
-    layout = ctx->current->layout;
-    if (!layout || (layout->type == NK_PANEL_WINDOW && (ctx->current->flags & NK_WINDOW_HIDDEN))) {
-        ctx->current = 0;
-        return;
+NK_API void
+nk_window_set_focus(struct nk_context *ctx, const char *name)
+{
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (win && ctx->end != win) {
+        nk_remove_window(ctx, win);
+        nk_insert_window(ctx, win, NK_INSERT_BACK);
     }
-    nk_panel_end(ctx);
-    nk_free_panel(ctx, ctx->current->layout);
-    ctx->current = 0;
+    ctx->active = win;
 }
 
-NK_API struct nk_rect
-nk_window_get_bounds(const struct nk_context *ctx)
+NK_API int
+nk_window_is_dirty(struct nk_context *ctx, const char *name)
 {
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
     NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    if (!ctx || !ctx->current) return nk_rect(0,0,0,0);
-    return ctx->current->bounds;
+    if (!ctx) return 1;
+
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (!win) return 1;
+    return nk_window_cache_is_dirty(ctx, win);
 }
 
-NK_API struct nk_vec2
-nk_window_get_position(const struct nk_context *ctx)
+NK_API void
+nk_window_invalidate(struct nk_context *ctx, const char *name)
 {
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
     NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    if (!ctx || !ctx->current) return nk_vec2(0,0);
-    return nk_vec2(ctx->current->bounds.x, ctx->current->bounds.y);
+    if (!ctx) return;
+
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (win) win->cache.valid = nk_false;
 }
 
-NK_API struct nk_vec2
-nk_window_get_size(const struct nk_context *ctx)
+NK_API int
+nk_window_reuse(struct nk_context *ctx, const char *name)
 {
+    NK_STORAGE const nk_size align = NK_ALIGNOF(struct nk_command);
+    int title_len;
+    nk_hash title_hash;
+    struct nk_window *win;
+    struct nk_window_cache *cache;
+    struct nk_table *it;
+    nk_byte *memory;
+    nk_size begin, offset;
+
     NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    if (!ctx || !ctx->current) return nk_vec2(0,0);
-    return nk_vec2(ctx->current->bounds.w, ctx->current->bounds.h);
+    NK_ASSERT(!ctx->current && "if this triggers you missed a `nk_end` call");
+    if (!ctx || ctx->current) return 0;
+
+    title_len = (int)nk_strlen(name);
+    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
+    win = nk_find_window(ctx, title_hash, name);
+    if (!win || nk_window_cache_is_dirty(ctx, win))
+        return 0;
+    /* see `nk_begin_titled` for why this triggers */
+    NK_ASSERT(win->seq != ctx->seq);
+
+    /* splice last frame commands into the current command buffer */
+    cache = &win->cache;
+    memory = (nk_byte*)nk_buffer_alloc(&ctx->memory, NK_BUFFER_FRONT, cache->size, align);
+    if (!memory) return 0;
+    NK_MEMCPY(memory, cache->memory, cache->size);
+    begin = ctx->memory.allocated - cache->size;
+    offset = 0;
+    while (1) {
+        struct nk_command *cmd = nk_ptr_add(struct nk_command, memory, offset);
+        nk_size next = cmd->next;
+        cmd->next += begin;
+        if (offset == cache->last) break;
+        offset = next;
+    }
+    win->buffer.begin = begin;
+    win->buffer.last = begin + cache->last;
+    win->buffer.end = begin + cache->size;
+
+    /* keep window and its state tables alive */
+    win->seq = ctx->seq;
+    for (it = win->tables; it; it = it->next)
+        it->seq = ctx->seq;
+    return 1;
 }
 
-NK_API float
-nk_window_get_width(const struct nk_context *ctx)
+/*----------------------------------------------------------------
+ *
+ *                          WORKER
+ *
+ * --------------------------------------------------------------*/
+NK_INTERN void
+nk_command_buffer_copy(struct nk_command_buffer *dst, const struct nk_buffer *src,
+    nk_size begin, nk_size last)
+{
+    /* copies all commands from `begin` up to and including `last` */
+    nk_size offset = begin;
+    while (1) {
+        const struct nk_command *cmd = (const struct nk_command*)nk_buffer_at(src, offset);
+        if (cmd->type != NK_COMMAND_NOP) {
+            nk_size size = nk_command_size(cmd);
+            struct nk_command *copy = (struct nk_command*)
+                nk_command_buffer_push(dst, cmd->type, size);
+            nk_size next;
+            if (!copy) return;
+            next = copy->next;
+            NK_MEMCPY(copy, cmd, size);
+            copy->next = next;
+#ifdef NK_ZERO_COPY_TEXT
+            if (cmd->type == NK_COMMAND_TEXT) {
+                /* referenced text stays valid, copied text moved along */
+                struct nk_command_text *t = (struct nk_command_text*)copy;
+                if (t->string == (const char*)((const struct nk_command_text*)cmd + 1))
+                    t->string = 0;
+            }
+#endif
+        }
+        if (offset == last) break;
+        NK_ASSERT(cmd->next > offset);
+        offset = cmd->next;
+    }
+}
+
+NK_INTERN const struct nk_window*
+nk_popup_at(const struct nk_context *ctx, struct nk_vec2 pos)
 {
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    if (!ctx || !ctx->current) return 0;
-    return ctx->current->bounds.w;
+    const struct nk_window *iter;
+    for (iter = ctx->end; iter; iter = iter->prev) {
+        const struct nk_window *popup = iter->popup.win;
+        if (popup && iter->popup.active && !(iter->flags & NK_WINDOW_HIDDEN) &&
+            NK_INBOX(pos.x, pos.y, popup->bounds.x, popup->bounds.y,
+                popup->bounds.w, popup->bounds.h))
+            return iter;
+    }
+    return 0;
 }
 
-NK_API float
-nk_window_get_height(const struct nk_context *ctx)
+NK_INTERN const struct nk_window*
+nk_window_at(const struct nk_context *ctx, struct nk_vec2 pos)
 {
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    if (!ctx || !ctx->current) return 0;
-    return ctx->current->bounds.h;
+    const struct nk_style *style = &ctx->style;
+    const struct nk_window *iter;
+    float h = style->font->height + 2.0f * style->window.header.padding.y +
+        (2.0f * style->window.header.label_padding.y);
+
+    /* popups are drawn on top of all windows */
+    iter = nk_popup_at(ctx, pos);
+    if (iter) return iter;
+    for (iter = ctx->end; iter; iter = iter->prev) {
+        struct nk_rect bounds = iter->bounds;
+        if (iter->flags & NK_WINDOW_HIDDEN) continue;
+        if (iter->flags & NK_WINDOW_MINIMIZED) bounds.h = h;
+        if (NK_INBOX(pos.x, pos.y, bounds.x, bounds.y, bounds.w, bounds.h))
+            return iter;
+    }
+    return 0;
 }
 
-NK_API struct nk_rect
-nk_window_get_content_region(struct nk_context *ctx)
+NK_INTERN struct nk_window*
+nk_merge_window(struct nk_context *ctx, nk_hash name, const char *name_string,
+    nk_flags flags)
 {
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    if (!ctx || !ctx->current) return nk_rect(0,0,0,0);
-    return ctx->current->layout->clip;
+    /* finds or creates a window for draw commands not built by `ctx` */
+    struct nk_window *win = nk_find_window(ctx, name, name_string);
+    if (!win) {
+        nk_size name_length = (nk_size)nk_strlen(name_string);
+        win = (struct nk_window*)nk_create_window(ctx);
+        NK_ASSERT(win);
+        if (!win) return 0;
+
+        /* name is the window index key and has to be set before insertion */
+        win->name = name;
+        name_length = NK_MIN(name_length, NK_WINDOW_MAX_NAME-1);
+        NK_MEMCPY(win->name_string, name_string, name_length);
+        win->name_string[name_length] = 0;
+        if (flags & NK_WINDOW_BACKGROUND)
+            nk_insert_window(ctx, win, NK_INSERT_FRONT);
+        else nk_insert_window(ctx, win, NK_INSERT_BACK);
+        nk_command_buffer_init(&win->buffer, &ctx->memory, NK_CLIPPING_ON);
+        win->popup.win = 0;
+    } else {
+        /* If this assert triggers the window was built more than once
+         * by either the context itself or multiple workers. */
+        NK_ASSERT(win->seq != ctx->seq);
+    }
+    win->flags = flags | NK_WINDOW_MERGED;
+    win->seq = ctx->seq;
+    nk_start_buffer(ctx, &win->buffer);
+    return win;
 }
 
-NK_API struct nk_vec2
-nk_window_get_content_region_min(struct nk_context *ctx)
+NK_INTERN int
+nk_worker_owns(struct nk_context *worker, const struct nk_window *win)
 {
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    NK_ASSERT(ctx->current->layout);
-    if (!ctx || !ctx->current) return nk_vec2(0,0);
-    return nk_vec2(ctx->current->layout->clip.x, ctx->current->layout->clip.y);
+    return (win->flags & NK_WINDOW_MERGED) &&
+        nk_find_window(worker, win->name, win->name_string) != 0;
 }
 
-NK_API struct nk_vec2
-nk_window_get_content_region_max(struct nk_context *ctx)
+NK_API void
+nk_worker_begin(struct nk_context *worker, const struct nk_context *ctx)
 {
+    const struct nk_window *win;
+    const struct nk_mouse *mouse;
+    struct nk_vec2 pos;
+    int i;
+
     NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    NK_ASSERT(ctx->current->layout);
-    if (!ctx || !ctx->current) return nk_vec2(0,0);
-    return nk_vec2(ctx->current->layout->clip.x + ctx->current->layout->clip.w,
-        ctx->current->layout->clip.y + ctx->current->layout->clip.h);
+    NK_ASSERT(worker);
+    NK_ASSERT(worker != ctx);
+    NK_ASSERT(!worker->current && "if this triggers you missed a `nk_end` call");
+    if (!ctx || !worker || worker == ctx || worker->current) return;
+
+    worker->style = ctx->style;
+    worker->clip = ctx->clip;
+    worker->delta_time_seconds = ctx->delta_time_seconds;
+    worker->input = ctx->input;
+
+    /* mouse belongs to the window it was pressed in or otherwise the window below it */
+    mouse = &ctx->input.mouse;
+    pos = mouse->pos;
+    for (i = 0; i < NK_BUTTON_MAX; ++i) {
+        if (!mouse->buttons[i].down) continue;
+        pos = mouse->buttons[i].clicked_pos;
+        break;
+    }
+    win = nk_window_at(ctx, pos);
+    if (win && !nk_worker_owns(worker, win) && !nk_popup_at(worker, pos)) {
+        /* move mouse far outside of all windows. Worker popups are not
+         * known by the context so they are checked separately */
+        struct nk_mouse *m = &worker->input.mouse;
+        nk_zero(m->buttons, sizeof(m->buttons));
+        m->pos = nk_vec2(-16384.0f, -16384.0f);
+        m->prev = m->pos;
+        m->delta = nk_vec2(0,0);
+        m->scroll_delta = nk_vec2(0,0);
+        for (i = 0; i < NK_BUTTON_MAX; ++i)
+            m->buttons[i].clicked_pos = m->pos;
+    }
+    /* keyboard input only goes to the active window */
+    if (!ctx->active || !nk_worker_owns(worker, ctx->active))
+        nk_zero(&worker->input.keyboard, sizeof(worker->input.keyboard));
+
+    /* worker windows are only active if they are active in the context */
+    for (win = ctx->begin; win; win = win->next) {
+        struct nk_window *own;
+        if (!(win->flags & NK_WINDOW_MERGED)) continue;
+        own = nk_find_window(worker, win->name, win->name_string);
+        if (!own) continue;
+        if (win->flags & NK_WINDOW_ROM)
+            own->flags |= NK_WINDOW_ROM;
+        else own->flags &= ~(nk_flags)NK_WINDOW_ROM;
+    }
 }
 
-NK_API struct nk_vec2
-nk_window_get_content_region_size(struct nk_context *ctx)
+NK_API void
+nk_worker_merge(struct nk_context *ctx, struct nk_context *worker)
 {
+    struct nk_window *iter;
     NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    NK_ASSERT(ctx->current->layout);
-    if (!ctx || !ctx->current) return nk_vec2(0,0);
-    return nk_vec2(ctx->current->layout->clip.w, ctx->current->layout->clip.h);
+    NK_ASSERT(worker);
+    NK_ASSERT(worker != ctx);
+    NK_ASSERT(!worker->current && "if this triggers you missed a `nk_end` call");
+    if (!ctx || !worker || worker == ctx || worker->current) return;
+
+    for (iter = worker->begin; iter; iter = iter->next) {
+        struct nk_window *win;
+        if (iter->seq != worker->seq)
+            continue;
+
+        win = nk_merge_window(ctx, iter->name, iter->name_string, iter->flags);
+        if (!win) return;
+        win->bounds = iter->bounds;
+        win->opaque = iter->opaque;
+
+        /* copy window commands and popup commands as separate lists */
+        if (!(iter->flags & NK_WINDOW_HIDDEN) && iter->buffer.last != iter->buffer.begin) {
+            nk_command_buffer_copy(&win->buffer, &worker->memory,
+                iter->buffer.begin, iter->buffer.last);
+            nk_finish_buffer(ctx, &win->buffer);
+            if (iter->popup.buf.active) {
+                const struct nk_popup_buffer *buf = &iter->popup.buf;
+                nk_size last = win->buffer.last;
+                nk_start_popup(ctx, win);
+                nk_command_buffer_copy(&win->buffer, &worker->memory, buf->begin, buf->last);
+                nk_finish_popup(ctx, win);
+                win->buffer.last = last;
+                win->buffer.end = win->popup.buf.begin;
+            }
+        }
+        /* carry popups used this frame over for focus handling and `nk_damage` */
+        if (iter->popup.win && iter->popup.active && iter->popup.win->seq == worker->seq &&
+            !(iter->flags & NK_WINDOW_HIDDEN)) {
+            struct nk_window *popup = win->popup.win;
+            if (!popup) {
+                popup = (struct nk_window*)nk_create_window(ctx);
+                if (!popup) return;
+                win->popup.win = popup;
+            }
+            popup->parent = win;
+            popup->bounds = iter->popup.win->bounds;
+            popup->flags = iter->popup.win->flags;
+            popup->seq = ctx->seq;
+            win->popup.name = iter->popup.name;
+            win->popup.type = iter->popup.type;
+            win->popup.active = 1;
+        } else win->popup.active = 0;
+        nk_window_update_focus(ctx, win);
+    }
+    if (worker->style.cursor_active != worker->style.cursors[NK_CURSOR_ARROW])
+        ctx->style.cursor_active = worker->style.cursor_active;
 }
 
-NK_API struct nk_command_buffer*
-nk_window_get_canvas(struct nk_context *ctx)
+/*----------------------------------------------------------------
+ *
+ *                          RECORDING
+ *
+ * --------------------------------------------------------------*/
+#define NK_RECORD_VERSION 2
+#ifdef NK_ZERO_COPY_TEXT
+#define NK_RECORD_TEXT_REFERENCE 1
+#else
+#define NK_RECORD_TEXT_REFERENCE 0
+#endif
+#define NK_RECORD_ALIGN(x) (((x) + NK_ALIGNOF(struct nk_command) - 1) &\
+    ~(nk_size)(NK_ALIGNOF(struct nk_command) - 1))
+
+struct nk_record_header {
+    char magic[4];
+    nk_uint version;
+    nk_uint pointer_size;
+    nk_uint command_size;
+    nk_uint text_reference;
+    /* text commands hold a string pointer instead of the string (`NK_ZERO_COPY_TEXT`) */
+};
+struct nk_record_frame {
+    nk_uint size;
+    /* size of the frame including this header */
+    nk_uint commands;
+    nk_uint fonts;
+    nk_uint reserved;
+    struct nk_rect bounds;
+    /* followed by `fonts` font records and `commands` draw commands */
+};
+struct nk_record_font {
+    nk_handle userdata;
+    float height;
+};
+
+NK_INTERN nk_size
+nk_record_commands_offset(const struct nk_record_frame *frame)
 {
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    NK_ASSERT(ctx->current->layout);
-    if (!ctx || !ctx->current) return 0;
-    return &ctx->current->buffer;
+    return NK_RECORD_ALIGN(sizeof(struct nk_record_frame)) +
+        NK_RECORD_ALIGN(frame->fonts * sizeof(struct nk_record_font));
 }
 
-NK_API struct nk_panel*
-nk_window_get_panel(struct nk_context *ctx)
+NK_INTERN struct nk_rect
+nk_record_bounds(const struct nk_context *ctx)
 {
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    if (!ctx || !ctx->current) return 0;
-    return ctx->current->layout;
+    /* screen area of all drawn windows and popups */
+    struct nk_rect bounds = nk_rect(0,0,0,0);
+    const struct nk_window *iter;
+    for (iter = ctx->begin; iter; iter = iter->next) {
+        struct nk_rect r = iter->bounds;
+        if (iter->seq != ctx->seq || (iter->flags & NK_WINDOW_HIDDEN))
+            continue;
+        bounds = (bounds.w > 0 && bounds.h > 0) ? nk_rect_union(bounds, r): r;
+        if (iter->popup.buf.active && iter->popup.win)
+            bounds = nk_rect_union(bounds, iter->popup.win->bounds);
+    }
+    return bounds;
 }
 
-NK_API int
-nk_window_has_focus(const struct nk_context *ctx)
+NK_INTERN void
+nk_record_header_init(struct nk_record_header *header, const char *magic)
 {
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    NK_ASSERT(ctx->current->layout);
-    if (!ctx || !ctx->current) return 0;
-    return ctx->current == ctx->active;
+    nk_zero(header, NK_RECORD_ALIGN(sizeof(*header)));
+    NK_MEMCPY(header->magic, magic, 4);
+    header->version = NK_RECORD_VERSION;
+    header->pointer_size = (nk_uint)sizeof(void*);
+    header->command_size = (nk_uint)sizeof(struct nk_command);
+    header->text_reference = NK_RECORD_TEXT_REFERENCE;
 }
 
-NK_API int
-nk_window_is_hovered(struct nk_context *ctx)
+NK_INTERN int
+nk_record_header_valid(const struct nk_record_header *header, const char *magic)
 {
-    NK_ASSERT(ctx);
-    NK_ASSERT(ctx->current);
-    if (!ctx || !ctx->current) return 0;
-    if(ctx->current->flags & NK_WINDOW_HIDDEN)
+    return header->magic[0] == magic[0] && header->magic[1] == magic[1] &&
+        header->magic[2] == magic[2] && header->magic[3] == magic[3] &&
+        header->version == NK_RECORD_VERSION &&
+        header->pointer_size == sizeof(void*) &&
+        header->command_size == sizeof(struct nk_command) &&
+        header->text_reference == NK_RECORD_TEXT_REFERENCE;
+}
+
+NK_INTERN const struct nk_command*
+nk_record_command(const void *memory, nk_size size, nk_size offset)
+{
+    /* make sure damaged recordings never read outside of their memory */
+    const struct nk_command *cmd;
+    if (offset % NK_ALIGNOF(struct nk_command) || offset > size ||
+        size - offset < sizeof(struct nk_command)) return 0;
+    cmd = (const struct nk_command*)((const nk_byte*)memory + offset);
+    /* fixed part of the command has to be inside before reading its fields */
+    if ((unsigned)cmd->type >= NK_COMMAND_TYPE_COUNT ||
+        nk_command_fixed_size(cmd->type) > size - offset ||
+        (cmd->type == NK_COMMAND_TEXT && ((const struct nk_command_text*)cmd)->length < 0) ||
+        nk_command_copy_size(cmd) > size - offset)
         return 0;
-    return nk_input_is_mouse_hovering_rect(&ctx->input, ctx->current->bounds);
+    return cmd;
 }
 
 NK_API int
-nk_window_is_any_hovered(struct nk_context *ctx)
+nk_record(struct nk_context *ctx, struct nk_buffer *out)
 {
-    struct nk_window *iter;
+    const struct nk_user_font *fonts[NK_RECORD_MAX_FONTS];
+    const struct nk_command *cmd;
+    struct nk_record_frame *frame;
+    struct nk_record_font *font;
+    nk_byte *memory;
+    nk_uint font_count = 0;
+    nk_uint count = 0;
+    nk_size offset, size = 0;
+
     NK_ASSERT(ctx);
-    if (!ctx) return 0;
-    iter = ctx->begin;
-    while (iter) {
-        /* check if window is being hovered */
-        if(!(iter->flags & NK_WINDOW_HIDDEN)) {
-            /* check if window popup is being hovered */
-            if (iter->popup.active && iter->popup.win && nk_input_is_mouse_hovering_rect(&ctx->input, iter->popup.win->bounds))
-                return 1;
+    NK_ASSERT(out);
+    NK_ASSERT(!ctx->current && "if this triggers you missed a `nk_end` call");
+    NK_ASSERT(out->type != NK_BUFFER_CHUNKED);
+    if (!ctx || !out || ctx->current || out->type == NK_BUFFER_CHUNKED)
+        return 0;
 
-            if (iter->flags & NK_WINDOW_MINIMIZED) {
-                struct nk_rect header = iter->bounds;
-                header.h = ctx->style.font->height + 2 * ctx->style.window.header.padding.y;
-                if (nk_input_is_mouse_hovering_rect(&ctx->input, header))
-                    return 1;
-            } else if (nk_input_is_mouse_hovering_rect(&ctx->input, iter->bounds)) {
-                return 1;
+    /* start recording with header */
+    if (!out->allocated) {
+        struct nk_record_header *header;
+        header = (struct nk_record_header*)nk_buffer_alloc(out, NK_BUFFER_FRONT,
+            NK_RECORD_ALIGN(sizeof(*header)), 1);
+        if (!header) return 0;
+        NK_ASSERT(header == (void*)NK_ALIGN_PTR(header, NK_ALIGNOF(struct nk_command)));
+        nk_record_header_init(header, "NKRC");
+    }
+    /* calculate frame size and collect all used fonts */
+    nk_foreach(cmd, ctx) {
+        if (cmd->type == NK_COMMAND_NOP || cmd->type == NK_COMMAND_CUSTOM)
+            continue;
+        if (cmd->type == NK_COMMAND_TEXT) {
+            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+            nk_uint i = 0;
+            while (i < font_count && fonts[i] != t->font) ++i;
+            if (i == font_count) {
+                if (font_count >= NK_RECORD_MAX_FONTS) return 0;
+                fonts[font_count++] = t->font;
             }
         }
-        iter = iter->next;
+        size += NK_RECORD_ALIGN(nk_command_copy_size(cmd));
+        count++;
     }
-    return 0;
+    memory = (nk_byte*)nk_buffer_alloc(out, NK_BUFFER_FRONT,
+        NK_RECORD_ALIGN(sizeof(struct nk_record_frame)) +
+        NK_RECORD_ALIGN(font_count * sizeof(struct nk_record_font)) + size, 1);
+    if (!memory) return 0;
+
+    frame = (struct nk_record_frame*)memory;
+    nk_zero(frame, sizeof(*frame));
+    frame->commands = count;
+    frame->fonts = font_count;
+    frame->bounds = nk_record_bounds(ctx);
+    font = (struct nk_record_font*)(memory + NK_RECORD_ALIGN(sizeof(*frame)));
+    for (count = 0; count < font_count; ++count) {
+        nk_zero(&font[count], sizeof(font[count]));
+        font[count].userdata = fonts[count]->userdata;
+        font[count].height = fonts[count]->height;
+    }
+    /* copy commands with links relative to the frame */
+    offset = nk_record_commands_offset(frame);
+    nk_foreach(cmd, ctx) {
+        struct nk_command *copy;
+        nk_size cmd_size;
+        if (cmd->type == NK_COMMAND_NOP || cmd->type == NK_COMMAND_CUSTOM)
+            continue;
+        cmd_size = nk_command_copy_size(cmd);
+        copy = (struct nk_command*)(memory + offset);
+        nk_command_copy(copy, cmd);
+        offset += NK_RECORD_ALIGN(cmd_size);
+        copy->next = offset;
+        if (cmd->type == NK_COMMAND_TEXT) {
+            struct nk_command_text *t = (struct nk_command_text*)copy;
+            nk_ptr i = 0;
+            while (fonts[i] != t->font) ++i;
+            t->font = (const struct nk_user_font*)i;
+        }
+    }
+    frame->size = (nk_uint)offset;
+    return 1;
 }
 
-NK_API int
-nk_item_is_any_active(struct nk_context *ctx)
+NK_INTERN const struct nk_record_frame*
+nk_replay_frame(const struct nk_replay *replay)
 {
-    int any_hovered = nk_window_is_any_hovered(ctx);
-    int any_active = (ctx->last_widget_state & NK_WIDGET_STATE_MODIFIED);
-    return any_hovered || any_active;
+    const struct nk_record_frame *frame;
+    if (!replay->memory || replay->offset >= replay->size ||
+        replay->size - replay->offset < sizeof(struct nk_record_frame))
+        return 0;
+    frame = (const struct nk_record_frame*)
+        ((const nk_byte*)replay->memory + replay->offset);
+    if (frame->size > replay->size - replay->offset ||
+        frame->size < nk_record_commands_offset(frame))
+        return 0;
+    return frame;
 }
 
 NK_API int
-nk_window_is_collapsed(struct nk_context *ctx, const char *name)
+nk_replay_init(struct nk_replay *replay, const void *memory, nk_size size)
 {
-    int title_len;
-    nk_hash title_hash;
-    struct nk_window *win;
-    NK_ASSERT(ctx);
-    if (!ctx) return 0;
+    const struct nk_record_header *header = (const struct nk_record_header*)memory;
+    NK_ASSERT(replay);
+    NK_ASSERT(memory);
+    if (!replay) return 0;
+    nk_zero(replay, sizeof(*replay));
+    if (!memory || size < NK_RECORD_ALIGN(sizeof(*header)))
+        return 0;
 
-    title_len = (int)nk_strlen(name);
-    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
-    win = nk_find_window(ctx, title_hash, name);
-    if (!win) return 0;
-    return win->flags & NK_WINDOW_MINIMIZED;
+    NK_ASSERT(memory == NK_ALIGN_PTR_BACK(memory, NK_ALIGNOF(struct nk_command)));
+    if (!nk_record_header_valid(header, "NKRC"))
+        return 0;
+    replay->memory = memory;
+    replay->size = size;
+    replay->offset = NK_RECORD_ALIGN(sizeof(*header));
+    return nk_replay_frame(replay) != 0;
 }
 
 NK_API int
-nk_window_is_closed(struct nk_context *ctx, const char *name)
+nk_replay_next(struct nk_replay *replay)
 {
-    int title_len;
-    nk_hash title_hash;
-    struct nk_window *win;
-    NK_ASSERT(ctx);
-    if (!ctx) return 1;
+    const struct nk_record_frame *frame;
+    NK_ASSERT(replay);
+    if (!replay) return 0;
+    frame = nk_replay_frame(replay);
+    if (!frame) return 0;
+    replay->offset += frame->size;
+    replay->frame++;
+    return nk_replay_frame(replay) != 0;
+}
 
-    title_len = (int)nk_strlen(name);
-    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
-    win = nk_find_window(ctx, title_hash, name);
-    if (!win) return 1;
-    return (win->flags & NK_WINDOW_CLOSED);
+NK_INTERN const struct nk_command*
+nk_replay_command(const struct nk_record_frame *frame, nk_size offset)
+{
+    return nk_record_command(frame, frame->size, offset);
 }
 
-NK_API int
-nk_window_is_hidden(struct nk_context *ctx, const char *name)
+NK_API const struct nk_command*
+nk__replay_begin(const struct nk_replay *replay)
 {
-    int title_len;
-    nk_hash title_hash;
-    struct nk_window *win;
-    NK_ASSERT(ctx);
-    if (!ctx) return 1;
+    const struct nk_record_frame *frame;
+    NK_ASSERT(replay);
+    if (!replay) return 0;
+    frame = nk_replay_frame(replay);
+    if (!frame || !frame->commands) return 0;
+    return nk_replay_command(frame, nk_record_commands_offset(frame));
+}
 
-    title_len = (int)nk_strlen(name);
-    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
-    win = nk_find_window(ctx, title_hash, name);
-    if (!win) return 1;
-    return (win->flags & NK_WINDOW_HIDDEN);
+NK_API const struct nk_command*
+nk__replay_next(const struct nk_replay *replay, const struct nk_command *cmd)
+{
+    const struct nk_record_frame *frame;
+    NK_ASSERT(replay);
+    if (!replay || !cmd) return 0;
+    frame = (const struct nk_record_frame*)
+        ((const nk_byte*)replay->memory + replay->offset);
+    /* links only point forward and end at the end of the frame */
+    if (cmd->next <= (nk_size)((const nk_byte*)cmd - (const nk_byte*)frame))
+        return 0;
+    return nk_replay_command(frame, cmd->next);
 }
 
 NK_API int
-nk_window_is_active(struct nk_context *ctx, const char *name)
+nk_replay_load(struct nk_context *ctx, const struct nk_replay *replay,
+    const struct nk_replay_config *config)
 {
-    int title_len;
-    nk_hash title_hash;
+    const struct nk_user_font *fonts[NK_RECORD_MAX_FONTS];
+    const struct nk_record_frame *frame;
+    const struct nk_record_font *font;
+    const struct nk_command *cmd;
     struct nk_window *win;
-    NK_ASSERT(ctx);
-    if (!ctx) return 0;
+    nk_uint i;
 
-    title_len = (int)nk_strlen(name);
-    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
-    win = nk_find_window(ctx, title_hash, name);
+    NK_ASSERT(ctx);
+    NK_ASSERT(replay);
+    NK_ASSERT(!ctx->current && "if this triggers you missed a `nk_end` call");
+    if (!ctx || !replay || ctx->current) return 0;
+    frame = nk_replay_frame(replay);
+    if (!frame || frame->fonts > NK_RECORD_MAX_FONTS) return 0;
+
+    /* resolve recorded fonts */
+    font = (const struct nk_record_font*)((const nk_byte*)frame +
+        NK_RECORD_ALIGN(sizeof(*frame)));
+    for (i = 0; i < frame->fonts; ++i) {
+        fonts[i] = (config && config->font) ?
+            config->font(config->userdata, font[i].userdata, font[i].height): 0;
+        if (!fonts[i]) fonts[i] = ctx->style.font;
+    }
+    win = nk_merge_window(ctx, nk_murmur_hash("nk_replay", 9, NK_WINDOW_TITLE),
+        "nk_replay", NK_WINDOW_BACKGROUND|NK_WINDOW_NO_INPUT);
     if (!win) return 0;
-    return win == ctx->active;
+    win->bounds = frame->bounds;
+
+    nk_replay_foreach(cmd, replay) {
+        nk_size size = nk_command_copy_size(cmd);
+        struct nk_command *copy;
+        nk_size next;
+        if (cmd->type == NK_COMMAND_NOP || cmd->type == NK_COMMAND_CUSTOM)
+            continue;
+        copy = (struct nk_command*)nk_command_buffer_push(&win->buffer, cmd->type, size);
+        if (!copy) break;
+        next = copy->next;
+        NK_MEMCPY(copy, cmd, size);
+        copy->next = next;
+        if (cmd->type == NK_COMMAND_TEXT) {
+            struct nk_command_text *t = (struct nk_command_text*)copy;
+            nk_ptr index = (nk_ptr)t->font;
+            t->font = (index < frame->fonts) ? fonts[index]: ctx->style.font;
+        } else if (cmd->type == NK_COMMAND_IMAGE && config && config->image) {
+            struct nk_command_image *img = (struct nk_command_image*)copy;
+            img->img.handle = config->image(config->userdata, img->img.handle);
+        }
+    }
+    nk_finish_buffer(ctx, &win->buffer);
+    return 1;
 }
 
-NK_API struct nk_window*
-nk_window_find(struct nk_context *ctx, const char *name)
+/*----------------------------------------------------------------
+ *
+ *                          DELTA
+ *
+ * --------------------------------------------------------------*/
+struct nk_delta_header {
+    struct nk_record_header record;
+    nk_uint size;
+    /* size of the message including this header */
+    nk_uint sequence;
+    /* counts up from zero after each key frame */
+    nk_uint windows;
+    nk_uint fonts;
+    struct nk_rect bounds;
+    /* followed by `fonts` font records and `windows` window blocks */
+};
+struct nk_delta_block {
+    nk_hash id;
+    nk_uint reference;
+    /* index plus one of the unchanged window in the previous frame or zero */
+    nk_uint size;
+    /* size of all commands following this block unless referenced */
+    nk_uint commands;
+};
+
+NK_INTERN int
+nk_delta_font(struct nk_delta_encoder *encoder, const struct nk_user_font *font)
 {
-    int title_len;
-    nk_hash title_hash;
-    title_len = (int)nk_strlen(name);
-    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
-    return nk_find_window(ctx, title_hash, name);
+    /* fonts keep their index until the next key frame */
+    nk_uint i = 0;
+    while (i < encoder->font_count && encoder->fonts[i] != font) ++i;
+    if (i == encoder->font_count) {
+        if (encoder->font_count >= NK_RECORD_MAX_FONTS) return -1;
+        encoder->fonts[encoder->font_count++] = font;
+    }
+    return (int)i;
 }
 
-NK_API void
-nk_window_close(struct nk_context *ctx, const char *name)
+NK_INTERN int
+nk_delta_measure(struct nk_delta_encoder *encoder, const struct nk_buffer *buffer,
+    const struct nk_command_range *range, struct nk_delta_window *window)
 {
-    struct nk_window *win;
-    NK_ASSERT(ctx);
-    if (!ctx) return;
-    win = nk_window_find(ctx, name);
-    if (!win) return;
-    NK_ASSERT(ctx->current != win && "You cannot close a currently active window");
-    if (ctx->current == win) return;
-    win->flags |= NK_WINDOW_HIDDEN;
-    win->flags |= NK_WINDOW_CLOSED;
+    nk_size offset = range->begin;
+    nk_size size = 0;
+    nk_zero_struct(*window);
+    window->id = range->id;
+    while (offset >= range->begin && offset < range->end) {
+        const struct nk_command *cmd;
+        cmd = (const struct nk_command*)nk_buffer_at(buffer, offset);
+        if (cmd->type != NK_COMMAND_NOP && cmd->type != NK_COMMAND_CUSTOM) {
+            if (cmd->type == NK_COMMAND_TEXT &&
+                nk_delta_font(encoder, ((const struct nk_command_text*)cmd)->font) < 0)
+                return nk_false;
+            window->hash = nk_command_hash(window->hash, cmd);
+            size += NK_RECORD_ALIGN(nk_command_copy_size(cmd));
+            window->commands++;
+        }
+        if (offset == range->last || cmd->next <= offset) break;
+        offset = cmd->next;
+    }
+    window->size = (nk_uint)size;
+    return nk_true;
 }
 
-NK_API void
-nk_window_set_bounds(struct nk_context *ctx,
-    const char *name, struct nk_rect bounds)
-{
-    struct nk_window *win;
-    NK_ASSERT(ctx);
-    if (!ctx) return;
-    win = nk_window_find(ctx, name);
-    if (!win) return;
-    NK_ASSERT(ctx->current != win && "You cannot update a currently in procecss window");
-    win->bounds = bounds;
+NK_INTERN nk_uint
+nk_delta_reference(const struct nk_delta_encoder *encoder,
+    const struct nk_delta_window *window, nk_uint index)
+{
+    /* windows mostly keep their place so look there first */
+    nk_uint i;
+    for (i = 0; i < encoder->window_count; ++i) {
+        const struct nk_delta_window *prev;
+        prev = &encoder->windows[(index + i) % encoder->window_count];
+        if (prev->id != window->id) continue;
+        if (prev->hash == window->hash && prev->size == window->size &&
+            prev->commands == window->commands)
+            return (index + i) % encoder->window_count + 1;
+        return 0;
+    }
+    return 0;
 }
 
-NK_API void
-nk_window_set_position(struct nk_context *ctx,
-    const char *name, struct nk_vec2 pos)
-{
-    struct nk_window *win = nk_window_find(ctx, name);
-    if (!win) return;
-    win->bounds.x = pos.x;
-    win->bounds.y = pos.y;
+NK_INTERN int
+nk_delta_measure_frame(struct nk_delta_encoder *encoder, const struct nk_context *ctx,
+    struct nk_delta_window *windows, nk_uint *references, nk_uint *count, nk_size *size)
+{
+    struct nk_command_range_iterator it;
+    struct nk_command_range range;
+    *count = 0;
+    *size = NK_RECORD_ALIGN(sizeof(struct nk_delta_header));
+    it.win = ctx->begin;
+    it.state = 0;
+    while (nk_command_range_next(ctx, &it, &range)) {
+        struct nk_delta_window window;
+        nk_uint reference = 0;
+        if (!nk_delta_measure(encoder, &ctx->memory, &range, &window))
+            return nk_false;
+        if (*count < NK_DELTA_MAX_WINDOWS) {
+            reference = nk_delta_reference(encoder, &window, *count);
+            windows[*count] = window;
+            references[*count] = reference;
+        }
+        *size += NK_RECORD_ALIGN(sizeof(struct nk_delta_block));
+        if (!reference) *size += window.size;
+        (*count)++;
+    }
+    *size += NK_RECORD_ALIGN(encoder->font_count * sizeof(struct nk_record_font));
+    return nk_true;
 }
 
 NK_API void
-nk_window_set_size(struct nk_context *ctx,
-    const char *name, struct nk_vec2 size)
+nk_delta_encoder_init(struct nk_delta_encoder *encoder)
 {
-    struct nk_window *win = nk_window_find(ctx, name);
-    if (!win) return;
-    win->bounds.w = size.x;
-    win->bounds.h = size.y;
+    NK_ASSERT(encoder);
+    if (!encoder) return;
+    nk_zero(encoder, sizeof(*encoder));
 }
 
-NK_API void
-nk_window_collapse(struct nk_context *ctx, const char *name,
-                    enum nk_collapse_states c)
-{
-    int title_len;
-    nk_hash title_hash;
-    struct nk_window *win;
+NK_API int
+nk_delta_encode(struct nk_delta_encoder *encoder, struct nk_context *ctx,
+    struct nk_buffer *out)
+{
+    struct nk_delta_window windows[NK_DELTA_MAX_WINDOWS];
+    nk_uint references[NK_DELTA_MAX_WINDOWS];
+    struct nk_delta_header *header;
+    struct nk_record_font *font;
+    struct nk_command_range_iterator it;
+    struct nk_command_range range;
+    nk_byte *memory;
+    nk_size offset, size;
+    nk_uint count, i;
+
+    NK_ASSERT(encoder);
     NK_ASSERT(ctx);
-    if (!ctx) return;
+    NK_ASSERT(out);
+    NK_ASSERT(!ctx->current && "if this triggers you missed a `nk_end` call");
+    NK_ASSERT(out->type != NK_BUFFER_CHUNKED);
+    if (!encoder || !ctx || !out || ctx->current || out->type == NK_BUFFER_CHUNKED)
+        return 0;
+    if (!ctx->build) {
+        nk_build(ctx);
+        ctx->build = nk_true;
+    }
 
-    title_len = (int)nk_strlen(name);
-    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
-    win = nk_find_window(ctx, title_hash, name);
-    if (!win) return;
-    if (c == NK_MINIMIZED)
-        win->flags |= NK_WINDOW_MINIMIZED;
-    else win->flags &= ~(nk_flags)NK_WINDOW_MINIMIZED;
+    /* measure message and find windows unchanged since the previous frame.
+     * Running out of font slots starts over with a key frame */
+    if (!nk_delta_measure_frame(encoder, ctx, windows, references, &count, &size)) {
+        nk_delta_encoder_init(encoder);
+        if (!nk_delta_measure_frame(encoder, ctx, windows, references, &count, &size))
+            return 0;
+    }
+    memory = (nk_byte*)nk_buffer_alloc(out, NK_BUFFER_FRONT, size, 1);
+    if (!memory) return 0;
+    NK_ASSERT(memory == NK_ALIGN_PTR(memory, NK_ALIGNOF(struct nk_command)));
+
+    header = (struct nk_delta_header*)memory;
+    nk_zero(header, NK_RECORD_ALIGN(sizeof(*header)));
+    nk_record_header_init(&header->record, "NKDT");
+    header->size = (nk_uint)size;
+    header->sequence = encoder->sequence;
+    header->windows = count;
+    header->fonts = encoder->font_count;
+    header->bounds = nk_record_bounds(ctx);
+    offset = NK_RECORD_ALIGN(sizeof(*header));
+    font = (struct nk_record_font*)(memory + offset);
+    for (i = 0; i < encoder->font_count; ++i) {
+        nk_zero(&font[i], sizeof(font[i]));
+        font[i].userdata = encoder->fonts[i]->userdata;
+        font[i].height = encoder->fonts[i]->height;
+    }
+    offset += NK_RECORD_ALIGN(encoder->font_count * sizeof(struct nk_record_font));
+
+    /* write each window as reference or with all its commands */
+    it.win = ctx->begin;
+    it.state = 0;
+    i = 0;
+    while (nk_command_range_next(ctx, &it, &range)) {
+        struct nk_delta_block *block = (struct nk_delta_block*)(memory + offset);
+        nk_size cmd_offset = range.begin;
+        nk_zero(block, NK_RECORD_ALIGN(sizeof(*block)));
+        block->id = range.id;
+        offset += NK_RECORD_ALIGN(sizeof(*block));
+        if (i < NK_DELTA_MAX_WINDOWS && references[i]) {
+            block->reference = references[i];
+            block->size = windows[i].size;
+            block->commands = windows[i].commands;
+            i++; continue;
+        }
+        while (cmd_offset >= range.begin && cmd_offset < range.end) {
+            const struct nk_command *cmd;
+            cmd = (const struct nk_command*)nk_buffer_at(&ctx->memory, cmd_offset);
+            if (cmd->type != NK_COMMAND_NOP && cmd->type != NK_COMMAND_CUSTOM) {
+                struct nk_command *copy = (struct nk_command*)(memory + offset);
+                nk_size cmd_size = NK_RECORD_ALIGN(nk_command_copy_size(cmd));
+                nk_command_copy(copy, cmd);
+                copy->next = 0;
+                if (cmd->type == NK_COMMAND_TEXT) {
+                    struct nk_command_text *t = (struct nk_command_text*)copy;
+                    t->font = (const struct nk_user_font*)(nk_ptr)nk_delta_font(encoder, t->font);
+                }
+                block->size += (nk_uint)cmd_size;
+                block->commands++;
+                offset += cmd_size;
+            }
+            if (cmd_offset == range.last || cmd->next <= cmd_offset) break;
+            cmd_offset = cmd->next;
+        }
+        i++;
+    }
+    NK_ASSERT(offset == size);
+
+    /* remember windows for the next frame */
+    encoder->window_count = NK_MIN(count, NK_DELTA_MAX_WINDOWS);
+    for (i = 0; i < encoder->window_count; ++i)
+        encoder->windows[i] = windows[i];
+    encoder->sequence++;
+    return 1;
 }
 
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void
-nk_window_collapse_if(struct nk_context *ctx, const char *name,
-    enum nk_collapse_states c, int cond)
+nk_delta_decoder_init_default(struct nk_delta_decoder *decoder)
 {
-    NK_ASSERT(ctx);
-    if (!ctx || !cond) return;
-    nk_window_collapse(ctx, name, c);
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_delta_decoder_init(decoder, &alloc);
 }
+#endif
 
 NK_API void
-nk_window_show(struct nk_context *ctx, const char *name, enum nk_show_states s)
+nk_delta_decoder_init(struct nk_delta_decoder *decoder, const struct nk_allocator *alloc)
 {
-    int title_len;
-    nk_hash title_hash;
-    struct nk_window *win;
-    NK_ASSERT(ctx);
-    if (!ctx) return;
-
-    title_len = (int)nk_strlen(name);
-    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
-    win = nk_find_window(ctx, title_hash, name);
-    if (!win) return;
-    if (s == NK_HIDDEN) {
-        win->flags |= NK_WINDOW_HIDDEN;
-    } else win->flags &= ~(nk_flags)NK_WINDOW_HIDDEN;
+    NK_ASSERT(decoder);
+    NK_ASSERT(alloc);
+    if (!decoder || !alloc) return;
+    nk_zero(decoder, sizeof(*decoder));
+    nk_buffer_init(&decoder->frames[0], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&decoder->frames[1], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
 }
 
 NK_API void
-nk_window_show_if(struct nk_context *ctx, const char *name,
-    enum nk_show_states s, int cond)
+nk_delta_decoder_free(struct nk_delta_decoder *decoder)
 {
-    NK_ASSERT(ctx);
-    if (!ctx || !cond) return;
-    nk_window_show(ctx, name, s);
+    NK_ASSERT(decoder);
+    if (!decoder) return;
+    nk_buffer_free(&decoder->frames[0]);
+    nk_buffer_free(&decoder->frames[1]);
+    decoder->valid = nk_false;
 }
 
-NK_API void
-nk_window_set_focus(struct nk_context *ctx, const char *name)
+NK_INTERN int
+nk_delta_decode_frame(struct nk_delta_decoder *decoder, const nk_byte *memory)
+{
+    const struct nk_delta_header *header = (const struct nk_delta_header*)memory;
+    int prev = decoder->current;
+    int next = !decoder->current;
+    struct nk_buffer *out = &decoder->frames[next];
+    const nk_size frame_offset = NK_RECORD_ALIGN(sizeof(struct nk_record_header));
+    struct nk_record_frame *frame;
+    nk_size offset, commands = 0;
+    nk_uint i;
+
+    /* recording header, frame and font table */
+    nk_buffer_clear(out);
+    offset = NK_RECORD_ALIGN(sizeof(*header));
+    if (!nk_buffer_alloc(out, NK_BUFFER_FRONT, frame_offset +
+        NK_RECORD_ALIGN(sizeof(struct nk_record_frame)) +
+        NK_RECORD_ALIGN(header->fonts * sizeof(struct nk_record_font)), 1))
+        return nk_false;
+    NK_MEMCPY((nk_byte*)nk_buffer_memory(out) + frame_offset + NK_RECORD_ALIGN(sizeof(*frame)),
+        memory + offset, header->fonts * sizeof(struct nk_record_font));
+    offset += NK_RECORD_ALIGN(header->fonts * sizeof(struct nk_record_font));
+
+    /* append commands of each window out of the message or the previous frame */
+    decoder->window_count[next] = 0;
+    for (i = 0; i < header->windows; ++i) {
+        const struct nk_delta_block *block;
+        const nk_byte *src;
+        nk_byte *dst;
+        nk_size begin, at, n;
+
+        if (header->size - offset < NK_RECORD_ALIGN(sizeof(*block)))
+            return nk_false;
+        block = (const struct nk_delta_block*)(memory + offset);
+        offset += NK_RECORD_ALIGN(sizeof(*block));
+        if (block->reference) {
+            const struct nk_delta_window *window;
+            if (!header->sequence || block->reference > decoder->window_count[prev])
+                return nk_false;
+            window = &decoder->windows[prev][block->reference-1];
+            if (window->id != block->id || window->size != block->size ||
+                window->commands != block->commands)
+                return nk_false;
+            src = (const nk_byte*)nk_buffer_memory_const(&decoder->frames[prev]) + window->offset;
+        } else {
+            /* only accept complete draw commands from the message */
+            nk_uint j;
+            if (block->size > header->size - offset) return nk_false;
+            for (j = 0, at = 0; j < block->commands; ++j) {
+                const struct nk_command *cmd;
+                cmd = nk_record_command(memory + offset, block->size, at);
+                if (!cmd) return nk_false;
+                at += NK_RECORD_ALIGN(nk_command_copy_size(cmd));
+            }
+            if (at != block->size) return nk_false;
+            src = memory + offset;
+            offset += block->size;
+        }
+        begin = out->allocated;
+        dst = (nk_byte*)nk_buffer_alloc(out, NK_BUFFER_FRONT, block->size, 1);
+        if (!dst && block->size) return nk_false;
+        if (block->size) NK_MEMCPY(dst, src, block->size);
+
+        /* link commands relative to the frame */
+        for (at = 0, n = 0; n < block->commands; ++n) {
+            struct nk_command *cmd = (struct nk_command*)(dst + at);
+            at += NK_RECORD_ALIGN(nk_command_copy_size(cmd));
+            cmd->next = begin + at - frame_offset;
+        }
+        if (decoder->window_count[next] < NK_DELTA_MAX_WINDOWS) {
+            struct nk_delta_window *window;
+            window = &decoder->windows[next][decoder->window_count[next]++];
+            window->id = block->id;
+            window->hash = 0;
+            window->offset = begin;
+            window->size = block->size;
+            window->commands = block->commands;
+        }
+        commands += block->commands;
+    }
+    if (offset != header->size) return nk_false;
+
+    nk_record_header_init((struct nk_record_header*)nk_buffer_memory(out), "NKRC");
+    frame = (struct nk_record_frame*)((nk_byte*)nk_buffer_memory(out) + frame_offset);
+    nk_zero(frame, sizeof(*frame));
+    frame->size = (nk_uint)(out->allocated - frame_offset);
+    frame->commands = (nk_uint)commands;
+    frame->fonts = header->fonts;
+    frame->bounds = header->bounds;
+    return nk_true;
+}
+
+NK_API int
+nk_delta_decode(struct nk_delta_decoder *decoder, struct nk_replay *replay,
+    const void *memory, nk_size size)
 {
-    int title_len;
-    nk_hash title_hash;
-    struct nk_window *win;
-    NK_ASSERT(ctx);
-    if (!ctx) return;
+    const struct nk_delta_header *header = (const struct nk_delta_header*)memory;
+    NK_ASSERT(decoder);
+    NK_ASSERT(replay);
+    NK_ASSERT(memory);
+    if (!decoder || !replay || !memory) return 0;
+    nk_zero(replay, sizeof(*replay));
+    NK_ASSERT(memory == NK_ALIGN_PTR_BACK(memory, NK_ALIGNOF(struct nk_command)));
+    if (size < NK_RECORD_ALIGN(sizeof(*header)) ||
+        !nk_record_header_valid(&header->record, "NKDT") ||
+        header->size > size || header->fonts > NK_RECORD_MAX_FONTS ||
+        header->size < NK_RECORD_ALIGN(sizeof(*header)) +
+            NK_RECORD_ALIGN(header->fonts * sizeof(struct nk_record_font)))
+        return 0;
 
-    title_len = (int)nk_strlen(name);
-    title_hash = nk_murmur_hash(name, (int)title_len, NK_WINDOW_TITLE);
-    win = nk_find_window(ctx, title_hash, name);
-    if (win && ctx->end != win) {
-        nk_remove_window(ctx, win);
-        nk_insert_window(ctx, win, NK_INSERT_BACK);
+    /* frames other than key frames need their previous frame */
+    if (header->sequence && (!decoder->valid || header->sequence != decoder->sequence + 1))
+        return 0;
+    if (!nk_delta_decode_frame(decoder, (const nk_byte*)memory)) {
+        decoder->valid = nk_false;
+        return 0;
     }
-    ctx->active = win;
+    decoder->current = !decoder->current;
+    decoder->sequence = header->sequence;
+    decoder->valid = nk_true;
+    return nk_replay_init(replay, nk_buffer_memory(&decoder->frames[decoder->current]),
+        decoder->frames[decoder->current].allocated);
 }
 
 /*----------------------------------------------------------------
@@ -20869,6 +26394,13 @@ nk_text_wrap_colored(struct nk_context *ctx, const char *str,
 }
 
 #ifdef NK_INCLUDE_STANDARD_VARARGS
+NK_INTERN void
+nk_label_copy(struct nk_context *ctx, int enable)
+{
+    /* formatted text lives on the stack and has to be copied */
+    if (ctx && ctx->current)
+        nk_draw_text_copy(&ctx->current->buffer, enable);
+}
 NK_API void
 nk_labelf_colored(struct nk_context *ctx, nk_flags flags,
     struct nk_color color, const char *fmt, ...)
@@ -20877,7 +26409,9 @@ nk_labelf_colored(struct nk_context *ctx, nk_flags flags,
     va_list args;
     va_start(args, fmt);
     nk_strfmt(buf, NK_LEN(buf), fmt, args);
+    nk_label_copy(ctx, nk_true);
     nk_label_colored(ctx, buf, flags, color);
+    nk_label_copy(ctx, nk_false);
     va_end(args);
 }
 
@@ -20889,7 +26423,9 @@ nk_labelf_colored_wrap(struct nk_context *ctx, struct nk_color color,
     va_list args;
     va_start(args, fmt);
     nk_strfmt(buf, NK_LEN(buf), fmt, args);
+    nk_label_copy(ctx, nk_true);
     nk_label_colored_wrap(ctx, buf, color);
+    nk_label_copy(ctx, nk_false);
     va_end(args);
 }
 
@@ -20900,7 +26436,9 @@ nk_labelf(struct nk_context *ctx, nk_flags flags, const char *fmt, ...)
     va_list args;
     va_start(args, fmt);
     nk_strfmt(buf, NK_LEN(buf), fmt, args);
+    nk_label_copy(ctx, nk_true);
     nk_label(ctx, buf, flags);
+    nk_label_copy(ctx, nk_false);
     va_end(args);
 }
 
@@ -20911,7 +26449,9 @@ nk_labelf_wrap(struct nk_context *ctx, const char *fmt,...)
     va_list args;
     va_start(args, fmt);
     nk_strfmt(buf, NK_LEN(buf), fmt, args);
+    nk_label_copy(ctx, nk_true);
     nk_label_wrap(ctx, buf);
+    nk_label_copy(ctx, nk_false);
     va_end(args);
 }
 
@@ -21777,8 +27317,11 @@ nk_edit_buffer(struct nk_context *ctx, nk_flags flags,
     filter = (!filter) ? nk_filter_default: filter;
     prev_state = (unsigned char)edit->active;
     in = (flags & NK_EDIT_READ_ONLY) ? 0: in;
+    /* edited text changes with input and is therefore always copied */
+    nk_draw_text_copy(&win->buffer, nk_true);
     ret_flags = nk_do_edit(&ctx->last_widget_state, &win->buffer, bounds, flags,
                     filter, edit, &style->edit, in, style->font);
+    nk_draw_text_copy(&win->buffer, nk_false);
 
     if (ctx->last_widget_state & NK_WIDGET_STATE_HOVER)
         ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_TEXT];
@@ -22177,6 +27720,37 @@ nk_chart_add_slot(struct nk_context *ctx, const enum nk_chart_type type,
     int count, float min_value, float max_value)
 {nk_chart_add_slot_colored(ctx, type, ctx->style.chart.color, ctx->style.chart.selected_color, count, min_value, max_value);}
 
+NK_INTERN void
+nk_chart_push_line_point(struct nk_command_buffer *out, struct nk_chart_slot *slot,
+    struct nk_vec2 point)
+{
+    /* extends the trace of `slot` from its last point to `point`. The trace
+     * is one polyline reserved for all remaining values of the slot, which
+     * is continued by another one if more values are pushed */
+    struct nk_command_polyline *line = 0;
+    if (slot->line_capacity)
+        line = (struct nk_command_polyline*)nk_buffer_at(out->base, slot->line);
+    if (!line || line->point_count >= slot->line_capacity) {
+        int capacity = slot->count - slot->index + 1;
+        if (capacity < 2) capacity = slot->count + 1;
+        capacity = NK_CLAMP(2, capacity, NK_USHORT_MAX);
+        line = (struct nk_command_polyline*)nk_command_buffer_push(out, NK_COMMAND_POLYLINE,
+            sizeof(*line) + sizeof(short) * 2 * (nk_size)capacity);
+        slot->line_capacity = 0;
+        if (!line) return;
+        slot->line = out->last;
+        slot->line_capacity = capacity;
+        line->color = slot->color;
+        line->line_thickness = 1;
+        line->points[0].x = (short)slot->last.x;
+        line->points[0].y = (short)slot->last.y;
+        line->point_count = 1;
+    }
+    line->points[line->point_count].x = (short)point.x;
+    line->points[line->point_count].y = (short)point.y;
+    line->point_count++;
+}
+
 NK_INTERN nk_flags
 nk_chart_push_line(struct nk_context *ctx, struct nk_window *win,
     struct nk_chart *g, float value, int slot)
@@ -22224,7 +27798,7 @@ nk_chart_push_line(struct nk_context *ctx, struct nk_window *win,
     color = g->slots[slot].color;
     cur.x = g->x + (float)(step * (float)g->slots[slot].index);
     cur.y = (g->y + g->h) - (ratio * (float)g->h);
-    nk_stroke_line(out, g->slots[slot].last.x, g->slots[slot].last.y, cur.x, cur.y, 1.0f, color);
+    nk_chart_push_line_point(out, &g->slots[slot], cur);
 
     bounds.x = cur.x - 3;
     bounds.y = cur.y - 3;
@@ -22547,7 +28121,15 @@ nk_group_begin(struct nk_context *ctx, const char *title, nk_flags flags)
         NK_ASSERT(y_offset);
         if (!x_offset || !y_offset) return 0;
         *x_offset = *y_offset = 0;
-    } else y_offset = nk_find_value(win, title_hash+1);
+    } else {
+        y_offset = nk_find_value(win, title_hash+1);
+        if (!y_offset) {
+            /* both offsets can end up in different tables */
+            y_offset = nk_add_value(ctx, win, title_hash+1, 0);
+            NK_ASSERT(y_offset);
+            if (!y_offset) return 0;
+        }
+    }
     return nk_group_scrolled_offset_begin(ctx, x_offset, y_offset, title, flags);
 }
 
@@ -22592,7 +28174,15 @@ nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
         NK_ASSERT(y_offset);
         if (!x_offset || !y_offset) return 0;
         *x_offset = *y_offset = 0;
-    } else y_offset = nk_find_value(win, title_hash+1);
+    } else {
+        y_offset = nk_find_value(win, title_hash+1);
+        if (!y_offset) {
+            /* both offsets can end up in different tables */
+            y_offset = nk_add_value(ctx, win, title_hash+1, 0);
+            NK_ASSERT(y_offset);
+            if (!y_offset) return 0;
+        }
+    }
     view->scroll_value = *y_offset;
     view->scroll_pointer = y_offset;
 
@@ -22956,7 +28546,9 @@ nk_tooltipf(struct nk_context *ctx, const char *fmt, ...)
     va_start(args, fmt);
     nk_strfmt(buf, NK_LEN(buf), fmt, args);
     va_end(args);
+    nk_label_copy(ctx, nk_true);
     nk_tooltip(ctx, buf);
+    nk_label_copy(ctx, nk_false);
 }
 #endif
 
@@ -24183,6 +29775,52 @@ nk_menu_end(struct nk_context *ctx)
 ///    - [yy]: Minor version with non-breaking API and library changes
 ///    - [zz]: Bug fix version with no direct changes to API
 ///
+/// - 2026/10/18 (3.22.0) - Look up font glyphs in a table for Latin-1 and a binary search over
+///                        codepoint ranges built at bake time
+/// - 2026/10/18 (3.21.1) - Tessellate open polylines in one pass and in chunks to draw long plots
+///                        with 16 bit indices, skip miter joins of 1px polylines, draw the
+///                        trace of line charts as one polyline
+/// - 2026/10/18 (3.21.0) - Added `nk_convert_instanced` to write shapes, glyphs and images as instance
+///                        records for instanced rendering
+/// - 2026/10/18 (3.20.0) - Added `shape_mode` to `nk_convert_config` and `NK_VERTEX_SHAPE` to emit
+///                        rectangles, circles and lines as one quad for a signed distance shader
+/// - 2026/10/18 (3.19.0) - Added `clipping` to `nk_convert_config` to clip geometry on the CPU and
+///                        merge vertex draw commands of different clipping rectangles
+/// - 2026/10/18 (3.18.0) - Added `nk_convert_cached` to reuse the vertices of windows with unchanged
+///                        draw commands from the last frame
+/// - 2026/10/18 (3.17.0) - Added `segment_tolerance` to `nk_convert_config` to derive the number of
+///                        segments of circles, arcs and curves from their size
+/// - 2026/10/18 (3.16.1) - Cache outlines and normals of rectangles and circles in the draw list
+///                        instead of tessellating each of them point by point
+/// - 2026/10/18 (3.16.0) - Added `nk_convert_begin`, `nk_convert_task` and `nk_convert_end` to
+///                        convert draw commands into vertices on several threads
+/// - 2026/10/18 (3.15.0) - Added `index_type` to `nk_convert_config` for 32 bit vertex indices and
+///                        split 16 bit vertex draw commands with a base `vertex_offset`
+/// - 2026/10/18 (3.14.1) - Write vertices of float aligned float position, float uv and 8 bit
+///                        color layouts directly instead of going through the generic vertex writer
+/// - 2026/10/18 (3.14.0) - Added `nk_delta_encode` and `nk_delta_decode` to stream frames as
+///                        changes against the previous frame to thin clients
+/// - 2026/10/18 (3.13.0) - Added `NK_ZERO_COPY_TEXT` to reference caller owned text from text
+///                        draw commands instead of copying it into the command buffer
+/// - 2026/10/18 (3.12.0) - Added `NK_OCCLUSION_CULLING` to skip drawing windows completely
+///                        hidden behind opaque windows
+/// - 2026/10/18 (3.11.0) - Added `nk_optimize` to remove draw commands without visible effect
+///                        and merge adjacent filled rectangles before drawing
+/// - 2026/10/18 (3.10.0) - Added `nk_record` and `nk_replay_xxx` to record draw commands into a
+///                        binary recording and replay them without running the application
+/// - 2026/10/18 (3.09.0) - Changed `nk_clear` to only visit unused window state tables
+/// - 2026/10/18 (3.08.0) - Added `nk_worker_begin` and `nk_worker_merge` to build windows on
+///                        multiple threads with worker contexts
+/// - 2026/10/18 (3.07.0) - Added chunked `nk_buffer` for draw commands that grows without
+///                        copying already allocated memory by `nk_buffer_init_chunked`
+/// - 2026/10/18 (3.06.0) - Added `nk_context_info` and `nk_window_command_info` statistics and
+///                        number of reallocations to `nk_buffer` and `nk_memory_status`
+/// - 2026/10/18 (3.05.0) - Added `NK_WINDOW_RETAINED` flag and `nk_window_reuse` to reuse the
+///                        draw commands of unchanged windows instead of rebuilding them
+/// - 2026/10/18 (3.04.0) - Added `nk_damage` to query changed screen areas between frames
+/// - 2026/10/18 (3.03.0) - Added `nk_trim` and `nk_page_info` to release and monitor window/panel/table memory
+/// - 2026/10/18 (3.02.0) - Changed window state tables into a hash trie for faster lookup
+/// - 2026/10/18 (3.01.0) - Added hash index for window lookup by name
 /// - 2017/01/07 (3.00.1) - Started to change documentation style
 /// - 2017/01/05 (3.00.0) - BREAKING CHANGE: The previous color picker API was broken
 ///                        because of conversions between float and byte color representation.
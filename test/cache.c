@@ -0,0 +1,106 @@
+/* nk_convert_cached: cached frames draw exactly what nk_convert draws, even
+ * with more windows than the cache holds and custom callbacks drawing
+ * something different for unchanged commands */
+#define NK_CONVERT_CACHE_WINDOWS 2
+#include "test.h"
+
+#define FRAMES 60
+
+static int custom_frame;
+
+static void
+test_custom(void *canvas, short x, short y, unsigned short w, unsigned short h,
+    nk_handle data)
+{
+    /* same command every frame but different geometry */
+    struct nk_draw_list *list = (struct nk_draw_list*)canvas;
+    float offset = (float)(custom_frame % (w / 2));
+    NK_UNUSED(data);
+    nk_draw_list_fill_rect(list, nk_rect(x + offset, y, w / 2, h),
+        nk_rgb(255, custom_frame & 255, 0), 0);
+}
+
+static void
+test_windows(struct nk_context *ctx, int frame)
+{
+    int i;
+    test_frame(ctx, frame);
+    for (i = 0; i < 3; ++i) {
+        char name[16];
+        sprintf(name, "static %d", i);
+        if (nk_begin(ctx, name, nk_rect(600 + i * 40, 400 + i * 30, 200, 150),
+            NK_WINDOW_TITLE|NK_WINDOW_BORDER)) {
+            nk_layout_row_dynamic(ctx, 20, 1);
+            nk_label(ctx, "unchanged", NK_TEXT_LEFT);
+            nk_button_label(ctx, "button");
+        }
+        nk_end(ctx);
+    }
+    /* background windows are drawn first and therefore always get a slot */
+    if (nk_begin(ctx, "custom", nk_rect(900, 50, 200, 200),
+        NK_WINDOW_NO_SCROLLBAR|NK_WINDOW_BACKGROUND)) {
+        struct nk_command_buffer *canvas = nk_window_get_canvas(ctx);
+        nk_push_custom(canvas, nk_rect(920, 70, 160, 120), test_custom, nk_handle_ptr(0));
+    }
+    nk_end(ctx);
+}
+
+static void
+test_cached(struct test_font *font, enum nk_draw_index_type index_type,
+    enum nk_draw_clipping clipping)
+{
+    struct nk_convert_config config;
+    struct nk_convert_cache cache;
+    struct test_output expected, cached;
+    struct nk_context ctx;
+    unsigned int reused = 0;
+    int frame;
+
+    test_convert_config(&config, font);
+    config.index_type = index_type;
+    config.clipping = clipping;
+    test_output_init(&expected);
+    test_output_init(&cached);
+    nk_convert_cache_init_default(&cache);
+    nk_init_default(&ctx, &font->font->handle);
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        custom_frame = frame;
+        test_windows(&ctx, frame);
+
+        test_output_clear(&expected);
+        TEST_CHECK(nk_convert(&ctx, &expected.cmds, &expected.vertices,
+            &expected.elements, &config) == NK_CONVERT_SUCCESS);
+        test_resolve(&ctx, &expected, &config);
+
+        /* convert the same frame again, which `nk_clear` usually resets for */
+        nk_draw_list_clear(&ctx.draw_list);
+        test_output_clear(&cached);
+        TEST_CHECK(nk_convert_cached(&ctx, &cache, &cached.cmds, &cached.vertices,
+            &cached.elements, &config) == NK_CONVERT_SUCCESS);
+        test_resolve(&ctx, &cached, &config);
+        if (frame) reused += ctx.stats.vertices_reused;
+        else TEST_CHECK(!ctx.stats.vertices_reused);
+
+        TEST_CHECK(test_output_equal(&expected, &cached));
+        nk_clear(&ctx);
+    }
+    TEST_CHECK(reused > 0);
+
+    nk_free(&ctx);
+    nk_convert_cache_free(&cache);
+    test_output_free(&expected);
+    test_output_free(&cached);
+}
+
+int
+main(void)
+{
+    struct test_font font;
+    test_font_init(&font);
+    test_cached(&font, NK_DRAW_INDEX_USHORT, NK_DRAW_CLIP_SCISSOR);
+    test_cached(&font, NK_DRAW_INDEX_UINT, NK_DRAW_CLIP_SCISSOR);
+    test_cached(&font, NK_DRAW_INDEX_USHORT, NK_DRAW_CLIP_GEOMETRY);
+    test_font_free(&font);
+    return test_result("cache");
+}
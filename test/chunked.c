@@ -0,0 +1,90 @@
+/* nk_buffer_init_chunked: a context drawing into a chunked command buffer
+ * produces, records and converts the same command stream as a context with
+ * a single contiguous buffer, even with commands spilling into new chunks */
+#include "test.h"
+
+#define FRAMES 60
+
+static void
+test_build(struct nk_context *ctx, int frame)
+{
+    int i;
+    test_motion(ctx, frame);
+    for (i = 0; i < TEST_WIDGET_WINDOWS; ++i)
+        test_widgets(ctx, frame, i);
+}
+
+static void
+test_chunked(struct test_font *font, nk_size chunk_size)
+{
+    struct nk_convert_config config;
+    struct test_output expected, output;
+    struct nk_buffer cmds, pool, recording;
+    struct nk_context ctx, chunked, replayed;
+    struct nk_allocator alloc;
+    struct nk_replay replay;
+    int frame;
+
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_buffer_init_chunked(&cmds, &alloc, chunk_size);
+    nk_buffer_init(&pool, &alloc, 4096);
+    TEST_CHECK(nk_init_custom(&chunked, &cmds, &pool, &font->font->handle));
+    nk_init_default(&ctx, &font->font->handle);
+    nk_init_default(&replayed, &font->font->handle);
+    nk_buffer_init_default(&recording);
+    test_convert_config(&config, font);
+    test_output_init(&expected);
+    test_output_init(&output);
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        nk_hash hash;
+        test_build(&ctx, frame);
+        test_build(&chunked, frame);
+        hash = test_commands_hash(&ctx);
+        TEST_CHECK(test_commands_hash(&chunked) == hash);
+
+        /* replays the recording of the chunked context */
+        nk_buffer_clear(&recording);
+        TEST_CHECK(nk_record(&chunked, &recording));
+        TEST_CHECK(nk_replay_init(&replay, nk_buffer_memory(&recording), recording.allocated));
+        TEST_CHECK(nk_replay_load(&replayed, &replay, 0));
+        TEST_CHECK(test_commands_hash(&replayed) == hash);
+        nk_clear(&replayed);
+
+        test_output_clear(&expected);
+        TEST_CHECK(nk_convert(&ctx, &expected.cmds, &expected.vertices,
+            &expected.elements, &config) == NK_CONVERT_SUCCESS);
+        test_resolve(&ctx, &expected, &config);
+        test_output_clear(&output);
+        TEST_CHECK(nk_convert(&chunked, &output.cmds, &output.vertices,
+            &output.elements, &config) == NK_CONVERT_SUCCESS);
+        test_resolve(&chunked, &output, &config);
+        TEST_CHECK(test_output_equal(&expected, &output));
+        nk_clear(&ctx);
+        nk_clear(&chunked);
+    }
+    /* the frames really spread over several chunks */
+    TEST_CHECK(chunked.memory.size > chunk_size);
+
+    nk_free(&ctx);
+    nk_free(&chunked);
+    nk_free(&replayed);
+    /* the command buffer belongs to the context and is freed by `nk_free` */
+    nk_buffer_free(&pool);
+    nk_buffer_free(&recording);
+    test_output_free(&expected);
+    test_output_free(&output);
+}
+
+int
+main(void)
+{
+    struct test_font font;
+    test_font_init(&font);
+    test_chunked(&font, 512);
+    test_chunked(&font, 4096);
+    test_font_free(&font);
+    return test_result("chunked");
+}
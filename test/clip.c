@@ -0,0 +1,57 @@
+/* geometry clipping: cutting shapes at their clipping rectangle on the CPU
+ * lets shapes with different clipping rectangles share a vertex draw
+ * command, so the demo frames need fewer draw commands than with scissor
+ * rectangles */
+#include "test.h"
+
+#define FRAMES 30
+
+static unsigned int
+test_draw_commands(struct nk_context *ctx, struct test_output *out,
+    struct nk_convert_config *config, enum nk_draw_clipping clipping)
+{
+    config->clipping = clipping;
+    nk_draw_list_clear(&ctx->draw_list);
+    test_output_clear(out);
+    TEST_CHECK(nk_convert(ctx, &out->cmds, &out->vertices, &out->elements,
+        config) == NK_CONVERT_SUCCESS);
+    test_resolve(ctx, out, config);
+    TEST_CHECK(ctx->stats.draw_commands == out->commands);
+    return ctx->stats.draw_commands;
+}
+
+int
+main(void)
+{
+    struct nk_convert_config config;
+    struct test_output scissor, geometry;
+    struct test_font font;
+    struct nk_context ctx;
+    unsigned int total_scissor = 0, total_geometry = 0;
+    int frame;
+
+    test_font_init(&font);
+    test_convert_config(&config, &font);
+    test_output_init(&scissor);
+    test_output_init(&geometry);
+    nk_init_default(&ctx, &font.font->handle);
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        unsigned int a, b;
+        test_frame(&ctx, frame);
+        a = test_draw_commands(&ctx, &scissor, &config, NK_DRAW_CLIP_SCISSOR);
+        b = test_draw_commands(&ctx, &geometry, &config, NK_DRAW_CLIP_GEOMETRY);
+        TEST_CHECK(b < a && geometry.count > 0);
+        total_scissor += a;
+        total_geometry += b;
+        nk_clear(&ctx);
+    }
+    printf("clip: %u draw commands with scissor rectangles, %u with geometry clipping\n",
+        total_scissor / FRAMES, total_geometry / FRAMES);
+
+    nk_free(&ctx);
+    test_output_free(&scissor);
+    test_output_free(&geometry);
+    test_font_free(&font);
+    return test_result("clip");
+}
@@ -0,0 +1,99 @@
+/* parallel conversion: nk_convert_begin/task/end draw exactly the same
+ * triangles as nk_convert for any number of tasks, also for frames with
+ * more vertices than 16 bit indices can address */
+#include "test.h"
+
+#define FRAMES 6
+#define TASKS 4
+#define SHAPES 16000
+
+static void
+test_heavy(struct nk_context *ctx, int frame)
+{
+    /* enough shapes to need several 16 bit draw commands */
+    if (nk_begin(ctx, "heavy", nk_rect(0, 0, 1200, 800),
+        NK_WINDOW_NO_SCROLLBAR|NK_WINDOW_BACKGROUND)) {
+        struct nk_command_buffer *canvas = nk_window_get_canvas(ctx);
+        int i;
+        for (i = 0; i < SHAPES; ++i) {
+            float x = (float)((i * 37 + frame * 11) % 1180);
+            float y = (float)((i * 53) % 780);
+            if (i % 500 == 0) nk_push_scissor(canvas, nk_rect(x - 300, y - 300, 700, 600));
+            nk_fill_circle(canvas, nk_rect(x, y, 14, 14), nk_rgb(i & 255, 128, 40));
+            nk_stroke_line(canvas, x, y, x + 20, y + 9, 2.0f, nk_rgb(40, i & 255, 40));
+            if (i % 3 == 0) nk_stroke_curve(canvas, x, y, x + 5, y - 10, x + 15, y + 10,
+                x + 20, y, 1.0f, nk_rgb(255, 255, 255));
+        }
+    }
+    nk_end(ctx);
+}
+
+static void
+test_parallel(struct test_font *font, enum nk_draw_index_type index_type,
+    enum nk_draw_clipping clipping)
+{
+    struct nk_convert_task tasks[TASKS];
+    struct nk_convert_config config;
+    struct test_output expected, joined;
+    struct nk_context ctx;
+    unsigned int max_vertices = 0;
+    int frame, i;
+
+    test_convert_config(&config, font);
+    config.index_type = index_type;
+    config.clipping = clipping;
+    test_output_init(&expected);
+    test_output_init(&joined);
+    for (i = 0; i < TASKS; ++i)
+        nk_convert_task_init_default(&tasks[i]);
+    nk_init_default(&ctx, &font->font->handle);
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        int count;
+        test_heavy(&ctx, frame);
+        test_frame(&ctx, frame);
+
+        test_output_clear(&expected);
+        TEST_CHECK(nk_convert(&ctx, &expected.cmds, &expected.vertices,
+            &expected.elements, &config) == NK_CONVERT_SUCCESS);
+        test_resolve(&ctx, &expected, &config);
+        if (ctx.draw_list.vertex_count > max_vertices)
+            max_vertices = ctx.draw_list.vertex_count;
+
+        /* one up to all tasks, converted in reverse order since tasks
+         * do not depend on each other */
+        for (count = 1; count <= TASKS; ++count) {
+            int n;
+            nk_draw_list_clear(&ctx.draw_list);
+            test_output_clear(&joined);
+            n = nk_convert_begin(&ctx, tasks, count, &config);
+            TEST_CHECK(n >= 1 && n <= count);
+            for (i = n - 1; i >= 0; --i)
+                TEST_CHECK(nk_convert_task(&ctx, &tasks[i]) == NK_CONVERT_SUCCESS);
+            TEST_CHECK(nk_convert_end(&ctx, &joined.cmds, &joined.vertices,
+                &joined.elements, tasks, n) == NK_CONVERT_SUCCESS);
+            test_resolve(&ctx, &joined, &config);
+            TEST_CHECK(test_output_equal(&expected, &joined));
+        }
+        nk_clear(&ctx);
+    }
+    TEST_CHECK(max_vertices > NK_USHORT_MAX);
+
+    nk_free(&ctx);
+    for (i = 0; i < TASKS; ++i)
+        nk_convert_task_free(&tasks[i]);
+    test_output_free(&expected);
+    test_output_free(&joined);
+}
+
+int
+main(void)
+{
+    struct test_font font;
+    test_font_init(&font);
+    test_parallel(&font, NK_DRAW_INDEX_USHORT, NK_DRAW_CLIP_SCISSOR);
+    test_parallel(&font, NK_DRAW_INDEX_UINT, NK_DRAW_CLIP_SCISSOR);
+    test_parallel(&font, NK_DRAW_INDEX_USHORT, NK_DRAW_CLIP_GEOMETRY);
+    test_font_free(&font);
+    return test_result("convert");
+}
@@ -0,0 +1,51 @@
+/* glyph lookup: the latin table and the range search built at bake time
+ * return the same glyph as a linear search through the configured ranges
+ * for every codepoint, also with merged and overlapping ranges */
+#include "test.h"
+
+#define CODEPOINTS 0x11000
+
+static void
+test_lookup(struct nk_font *font)
+{
+    nk_rune unicode;
+    TEST_CHECK(font->ranges && font->range_count > 0);
+    for (unicode = 0; unicode < CODEPOINTS; ++unicode) {
+        const struct nk_font_glyph *expected = nk_font_search_glyph(font, unicode);
+        if (!expected) expected = font->fallback;
+        TEST_CHECK(nk_font_find_glyph(font, unicode) == expected);
+    }
+}
+
+int
+main(void)
+{
+    /* overlapping each other and the cyrillic ranges of the first font */
+    static const nk_rune overlap[] = {
+        0x0100, 0x017F, 0x00C0, 0x0200, 0x0180, 0x0190,
+        0x2000, 0x206F, 0x2010, 0x2020, 0xE000, 0xE100, 0
+    };
+    static const nk_rune sparse[] = {0x0150, 0x0160, 0x3000, 0x30FF, 0x4E00, 0x4FFF, 0};
+    struct nk_font_config config = nk_font_config(13);
+    struct nk_font_atlas atlas;
+    struct nk_font *plain, *merged;
+    int width, height;
+
+    nk_font_atlas_init_default(&atlas);
+    nk_font_atlas_begin(&atlas);
+    plain = nk_font_atlas_add_default(&atlas, 13, 0);
+    config.range = nk_font_cyrillic_glyph_ranges();
+    merged = nk_font_atlas_add_default(&atlas, 14, &config);
+    config.merge_mode = nk_true;
+    config.range = overlap;
+    nk_font_atlas_add_default(&atlas, 14, &config);
+    config.range = sparse;
+    nk_font_atlas_add_default(&atlas, 14, &config);
+    TEST_CHECK(nk_font_atlas_bake(&atlas, &width, &height, NK_FONT_ATLAS_ALPHA8) != 0);
+
+    test_lookup(plain);
+    test_lookup(merged);
+    nk_font_atlas_end(&atlas, nk_handle_id(1), 0);
+    nk_font_atlas_clear(&atlas);
+    return test_result("glyph");
+}
@@ -0,0 +1,312 @@
+/* nk_convert_instanced: instance records drawn by a reference rasterizer
+ * that evaluates shapes the way the instance shader of the glfw_opengl3
+ * demo does cover the same pixels as the SDF triangles of nk_convert */
+#include "test.h"
+
+#define WIDTH 1200
+#define HEIGHT 800
+#define FRAMES 8
+
+struct test_shape_vertex {
+    float position[2];
+    float uv[2];
+    nk_byte col[4];
+    float shape[4];
+};
+
+struct test_clip {
+    int x0, y0, x1, y1;
+};
+
+static float images[2][WIDTH * HEIGHT * 3];
+
+static float
+test_texture(const struct test_font *font, float u, float v)
+{
+    int x = (int)floor(u * (float)font->width + 1e-3f);
+    int y = (int)floor(v * (float)font->height + 1e-3f);
+    x = NK_CLAMP(0, x, font->width - 1);
+    y = NK_CLAMP(0, y, font->height - 1);
+    return font->pixels[(y * font->width + x) * 4 + 3] / 255.0f;
+}
+
+static float
+test_coverage(float x, float y, const float *shape)
+{
+    /* same rounded box distance as the demo fragment shader */
+    float qx = (float)fabs(x) - shape[0] + shape[2];
+    float qy = (float)fabs(y) - shape[1] + shape[2];
+    float mx = NK_MAX(qx, 0), my = NK_MAX(qy, 0);
+    float d = (float)sqrt(mx * mx + my * my) + NK_MIN(NK_MAX(qx, qy), 0) - shape[2];
+    if (shape[3] > 0) d = (float)fabs(d) - shape[3] * 0.5f;
+    return NK_CLAMP(0.0f, 0.5f - d, 1.0f);
+}
+
+static void
+test_blend(float *image, int x, int y, const float *color, float alpha)
+{
+    int i;
+    for (i = 0; i < 3; ++i) {
+        float *c = &image[(y * WIDTH + x) * 3 + i];
+        *c = *c * (1.0f - alpha) + color[i] * alpha;
+    }
+}
+
+static float
+test_edge(const float *a, const float *b, float x, float y)
+{
+    return (b[0] - a[0]) * (y - a[1]) - (b[1] - a[1]) * (x - a[0]);
+}
+
+static int
+test_top_left(const float *a, const float *b)
+{
+    return (a[1] == b[1] && b[0] < a[0]) || b[1] < a[1];
+}
+
+static void
+test_triangle(float *image, const struct test_font *font, const struct test_clip *clip,
+    const struct test_shape_vertex *a, const struct test_shape_vertex *b,
+    const struct test_shape_vertex *c)
+{
+    const struct test_shape_vertex *v[3];
+    float area = test_edge(a->position, b->position, c->position[0], c->position[1]);
+    int x, y, x0, y0, x1, y1;
+    if (area == 0) return;
+    v[0] = a; v[1] = (area < 0) ? c : b; v[2] = (area < 0) ? b : c;
+    area = (float)fabs(area);
+
+    x0 = (int)floor(NK_MIN(a->position[0], NK_MIN(b->position[0], c->position[0])));
+    y0 = (int)floor(NK_MIN(a->position[1], NK_MIN(b->position[1], c->position[1])));
+    x1 = (int)ceil(NK_MAX(a->position[0], NK_MAX(b->position[0], c->position[0])));
+    y1 = (int)ceil(NK_MAX(a->position[1], NK_MAX(b->position[1], c->position[1])));
+    x0 = NK_MAX(x0, clip->x0); y0 = NK_MAX(y0, clip->y0);
+    x1 = NK_MIN(x1, clip->x1); y1 = NK_MIN(y1, clip->y1);
+
+    for (y = y0; y < y1; ++y) {
+        for (x = x0; x < x1; ++x) {
+            float px = (float)x + 0.5f, py = (float)y + 0.5f;
+            float w[3], u, t, alpha, color[3];
+            int i, k;
+            for (i = 0; i < 3; ++i) {
+                const float *e0 = v[(i+1)%3]->position, *e1 = v[(i+2)%3]->position;
+                w[i] = test_edge(e0, e1, px, py);
+                if (w[i] < 0 || (w[i] == 0 && !test_top_left(e0, e1))) break;
+                w[i] /= area;
+            }
+            if (i < 3) continue;
+            u = w[0] * v[0]->uv[0] + w[1] * v[1]->uv[0] + w[2] * v[2]->uv[0];
+            t = w[0] * v[0]->uv[1] + w[1] * v[1]->uv[1] + w[2] * v[2]->uv[1];
+            alpha = (w[0] * v[0]->col[3] + w[1] * v[1]->col[3] + w[2] * v[2]->col[3]) / 255.0f;
+            for (k = 0; k < 3; ++k)
+                color[k] = (w[0] * v[0]->col[k] + w[1] * v[1]->col[k] + w[2] * v[2]->col[k]) / 255.0f;
+            /* shape attributes are constant across a triangle */
+            if (v[0]->shape[0] > 0)
+                alpha *= test_coverage(u, t, v[0]->shape);
+            else alpha *= test_texture(font, u, t);
+            test_blend(image, x, y, color, alpha);
+        }
+    }
+}
+
+static void
+test_instance(float *image, const struct test_font *font, const struct test_clip *clip,
+    const struct nk_draw_instance *in)
+{
+    /* quad placement of the glfw_opengl3 instance vertex shader */
+    const int textured = in->type >= NK_DRAW_INSTANCE_GLYPH;
+    float center[2] = {0, 0}, axis[2] = {1, 0}, shape[4] = {0, 0, 0, 0};
+    float x0, y0, x1, y1, color[3];
+    int x, y, k;
+
+    for (k = 0; k < 3; ++k)
+        color[k] = in->color[k] / 255.0f;
+    if (textured) {
+        x0 = in->rect[0]; y0 = in->rect[1];
+        x1 = x0 + in->rect[2]; y1 = y0 + in->rect[3];
+    } else {
+        float pad, thickness = (in->params[1] > 0) ? NK_MAX(in->params[1], 1.0f) : 0;
+        if (in->type == NK_DRAW_INSTANCE_LINE) {
+            float dx = in->rect[2] - in->rect[0], dy = in->rect[3] - in->rect[1];
+            float len = (float)sqrt(dx * dx + dy * dy);
+            if (len <= 0) return;
+            axis[0] = dx / len; axis[1] = dy / len;
+            center[0] = (in->rect[0] + in->rect[2]) * 0.5f;
+            center[1] = (in->rect[1] + in->rect[3]) * 0.5f;
+            shape[0] = len * 0.5f;
+            shape[1] = NK_MAX(in->params[1], 1.0f) * 0.5f;
+            thickness = 0;
+        } else if (in->type == NK_DRAW_INSTANCE_CIRCLE) {
+            shape[0] = shape[1] = shape[2] = in->rect[2] * 0.5f;
+            center[0] = in->rect[0] + shape[0];
+            center[1] = in->rect[1] + in->rect[3] * 0.5f;
+        } else {
+            shape[0] = in->rect[2] * 0.5f;
+            shape[1] = in->rect[3] * 0.5f;
+            center[0] = in->rect[0] + shape[0];
+            center[1] = in->rect[1] + shape[1];
+            shape[2] = NK_CLAMP(0, in->params[0], NK_MIN(shape[0], shape[1]));
+        }
+        if (shape[0] <= 0 || shape[1] <= 0) return;
+        shape[3] = thickness;
+        /* covers the quad in any rotation */
+        pad = NK_MAX(shape[0], shape[1]) + thickness + 2.0f;
+        x0 = center[0] - pad; y0 = center[1] - pad;
+        x1 = center[0] + pad; y1 = center[1] + pad;
+    }
+
+    for (y = NK_MAX((int)floor(y0), clip->y0); y < NK_MIN((int)ceil(y1), clip->y1); ++y) {
+        for (x = NK_MAX((int)floor(x0), clip->x0); x < NK_MIN((int)ceil(x1), clip->x1); ++x) {
+            float px = (float)x + 0.5f, py = (float)y + 0.5f, alpha = in->color[3] / 255.0f;
+            if (textured) {
+                float u, v;
+                if (px < x0 || px >= x1 || py < y0 || py >= y1) continue;
+                u = in->params[0] + (in->params[2] - in->params[0]) * (px - x0) / (x1 - x0);
+                v = in->params[1] + (in->params[3] - in->params[1]) * (py - y0) / (y1 - y0);
+                alpha *= test_texture(font, u, v);
+            } else {
+                float lx = (px - center[0]) * axis[0] + (py - center[1]) * axis[1];
+                float ly = (py - center[1]) * axis[0] - (px - center[0]) * axis[1];
+                alpha *= test_coverage(lx, ly, shape);
+            }
+            test_blend(image, x, y, color, alpha);
+        }
+    }
+}
+
+static void
+test_render(struct nk_context *ctx, const struct test_font *font, float *image,
+    const struct nk_buffer *cmds, const struct nk_buffer *vertices,
+    const struct nk_buffer *elements, const struct nk_buffer *instances)
+{
+    const struct test_shape_vertex *vtx = (const struct test_shape_vertex*)nk_buffer_memory_const(vertices);
+    const nk_draw_index *idx = (const nk_draw_index*)nk_buffer_memory_const(elements);
+    const struct nk_draw_instance *records = 0;
+    const struct nk_draw_command *cmd;
+    nk_size count = 0, offset = 0;
+    unsigned int i;
+
+    if (instances) {
+        records = (const struct nk_draw_instance*)nk_buffer_memory_const(instances);
+        count = instances->allocated / sizeof(struct nk_draw_instance);
+    }
+    memset(image, 0, sizeof(images[0]));
+    nk_draw_foreach(cmd, ctx, cmds) {
+        struct test_clip clip;
+        clip.x0 = NK_MAX((int)ceil(cmd->clip_rect.x - 0.5f), 0);
+        clip.y0 = NK_MAX((int)ceil(cmd->clip_rect.y - 0.5f), 0);
+        clip.x1 = NK_MIN((int)ceil(cmd->clip_rect.x + cmd->clip_rect.w - 0.5f), WIDTH);
+        clip.y1 = NK_MIN((int)ceil(cmd->clip_rect.y + cmd->clip_rect.h - 0.5f), HEIGHT);
+        if (cmd->instance_count) {
+            /* commands have either instances or elements */
+            TEST_CHECK(records && !cmd->elem_count);
+            TEST_CHECK(cmd->instance_offset + cmd->instance_count <= count);
+            if (!records || cmd->instance_offset + cmd->instance_count > count) continue;
+            for (i = 0; i < cmd->instance_count; ++i)
+                test_instance(image, font, &clip, &records[cmd->instance_offset + i]);
+            continue;
+        }
+        if (!cmd->elem_count) continue;
+        for (i = 0; i + 2 < cmd->elem_count; i += 3) {
+            const nk_draw_index *k = &idx[offset + i];
+            test_triangle(image, font, &clip, &vtx[cmd->vertex_offset + k[0]],
+                &vtx[cmd->vertex_offset + k[1]], &vtx[cmd->vertex_offset + k[2]]);
+        }
+        offset += cmd->elem_count;
+    }
+}
+
+static void
+test_shapes(struct nk_context *ctx)
+{
+    /* every instance type with rounding, thickness and nested scissors */
+    if (nk_begin(ctx, "shapes", nk_rect(820, 420, 320, 320), NK_WINDOW_BORDER|NK_WINDOW_TITLE)) {
+        struct nk_command_buffer *canvas = nk_window_get_canvas(ctx);
+        const struct nk_rect r = nk_rect(840, 470, 140, 120);
+        nk_fill_rect(canvas, nk_rect(830, 460, 60, 40), 8, nk_rgb(200, 50, 50));
+        nk_stroke_rect(canvas, nk_rect(900, 460, 60.5f, 40.25f), 6, 3, nk_rgb(50, 200, 50));
+        nk_fill_circle(canvas, nk_rect(970, 460, 50, 50), nk_rgb(50, 50, 200));
+        nk_stroke_circle(canvas, nk_rect(1030, 460, 50, 50), 2, nk_rgba(200, 200, 50, 180));
+        nk_stroke_line(canvas, 830, 620, 1100, 700, 2.5f, nk_rgb(255, 255, 255));
+        nk_stroke_line(canvas, 830, 710, 1100, 710, 1, nk_rgb(255, 0, 255));
+        nk_draw_text(canvas, nk_rect(1000, 530, 120, 20), "instanced text", 14,
+            ctx->style.font, nk_rgb(0, 0, 0), nk_rgb(255, 255, 255));
+        nk_push_scissor(canvas, r);
+        nk_fill_circle(canvas, nk_rect(r.x + r.w - 15, r.y + 10, 30, 30), nk_rgb(255, 0, 0));
+        nk_fill_rect(canvas, nk_rect(r.x + 10, r.y + r.h - 15, 30, 30), 3, nk_rgb(255, 0, 0));
+        nk_push_scissor(canvas, nk_rect(r.x + 30, r.y + 30, 60, 60));
+        nk_fill_rect(canvas, nk_rect(r.x + 40, r.y + 40, 70, 20), 5, nk_rgb(0, 0, 255));
+    }
+    nk_end(ctx);
+}
+
+int
+main(void)
+{
+    static const struct nk_draw_vertex_layout_element layout[] = {
+        {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct test_shape_vertex, position)},
+        {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct test_shape_vertex, uv)},
+        {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct test_shape_vertex, col)},
+        {NK_VERTEX_SHAPE, NK_FORMAT_FLOAT, NK_OFFSETOF(struct test_shape_vertex, shape)},
+        {NK_VERTEX_LAYOUT_END}
+    };
+    struct nk_buffer cmds, vertices, elements, instances;
+    struct nk_convert_config config;
+    struct test_font font;
+    struct nk_context ctx;
+    int frame;
+
+    test_font_init(&font);
+    test_convert_config(&config, &font);
+    config.vertex_layout = layout;
+    config.vertex_size = sizeof(struct test_shape_vertex);
+    config.vertex_alignment = NK_ALIGNOF(struct test_shape_vertex);
+    config.shape_mode = NK_DRAW_SHAPE_SDF;
+    nk_buffer_init_default(&cmds);
+    nk_buffer_init_default(&vertices);
+    nk_buffer_init_default(&elements);
+    nk_buffer_init_default(&instances);
+    nk_init_default(&ctx, &font.font->handle);
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        nk_size bytes;
+        int i, differ = 0;
+        test_frame(&ctx, frame);
+        test_shapes(&ctx);
+
+        nk_buffer_clear(&cmds);
+        nk_buffer_clear(&vertices);
+        nk_buffer_clear(&elements);
+        TEST_CHECK(nk_convert(&ctx, &cmds, &vertices, &elements, &config) == NK_CONVERT_SUCCESS);
+        test_render(&ctx, &font, images[0], &cmds, &vertices, &elements, 0);
+        bytes = vertices.allocated + elements.allocated;
+
+        /* convert the same frame again, which `nk_clear` usually resets for */
+        nk_draw_list_clear(&ctx.draw_list);
+        nk_buffer_clear(&cmds);
+        nk_buffer_clear(&vertices);
+        nk_buffer_clear(&elements);
+        nk_buffer_clear(&instances);
+        TEST_CHECK(nk_convert_instanced(&ctx, &cmds, &vertices, &elements,
+            &instances, &config) == NK_CONVERT_SUCCESS);
+        TEST_CHECK(ctx.stats.instances > 0);
+        TEST_CHECK(ctx.stats.instances * sizeof(struct nk_draw_instance) == instances.allocated);
+        test_render(&ctx, &font, images[1], &cmds, &vertices, &elements, &instances);
+        /* one record per shape is smaller than its triangles */
+        TEST_CHECK(vertices.allocated + elements.allocated + instances.allocated < bytes);
+
+        /* only a few anti-aliased fringe pixels may round differently */
+        for (i = 0; i < WIDTH * HEIGHT * 3; ++i)
+            if (fabs(images[0][i] - images[1][i]) * 255.0f > 2.0f) differ++;
+        TEST_CHECK(differ <= 40);
+        nk_clear(&ctx);
+    }
+
+    nk_free(&ctx);
+    nk_buffer_free(&cmds);
+    nk_buffer_free(&vertices);
+    nk_buffer_free(&elements);
+    nk_buffer_free(&instances);
+    test_font_free(&font);
+    return test_result("instance");
+}
@@ -0,0 +1,86 @@
+/* NK_OCCLUSION_CULLING: windows completely below the opaque header and
+ * background of a window drawn above are skipped, while windows only partly
+ * covered or below a translucent window are still drawn */
+#define NK_OCCLUSION_CULLING
+#include "test.h"
+
+#define FRAMES 4
+
+static const struct nk_color test_bottom = {10, 20, 30, 255};
+static const struct nk_color test_partial = {40, 50, 60, 255};
+
+static void
+test_window(struct nk_context *ctx, const char *name, struct nk_rect bounds,
+    struct nk_color marker)
+{
+    /* marker colors find the commands of each window in the frame */
+    if (nk_begin(ctx, name, bounds, NK_WINDOW_BORDER|NK_WINDOW_TITLE)) {
+        struct nk_rect r = nk_window_get_content_region(ctx);
+        nk_layout_row_dynamic(ctx, 20, 1);
+        nk_label(ctx, name, NK_TEXT_LEFT);
+        nk_fill_rect(nk_window_get_canvas(ctx), nk_rect(r.x, r.y + 30, 20, 20), 0, marker);
+    }
+    nk_end(ctx);
+}
+
+static int
+test_drawn(struct nk_context *ctx, struct nk_color marker)
+{
+    const struct nk_command *cmd;
+    nk_foreach(cmd, ctx) {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled*)cmd;
+        if (cmd->type == NK_COMMAND_RECT_FILLED && !memcmp(&r->color, &marker, sizeof(marker)))
+            return nk_true;
+    }
+    return nk_false;
+}
+
+static void
+test_frame_occlusion(struct nk_context *ctx, int translucent)
+{
+    struct nk_context_stats stats;
+    struct nk_window *bottom, *partial;
+    int frame;
+
+    ctx->style.window.fixed_background.data.color.a = (nk_byte)(translucent ? 200: 255);
+    for (frame = 0; frame < FRAMES; ++frame) {
+        nk_input_begin(ctx);
+        nk_input_motion(ctx, 900, 700);
+        nk_input_end(ctx);
+        /* windows begun later are drawn above the earlier ones */
+        test_window(ctx, "bottom", nk_rect(150, 150, 100, 100), test_bottom);
+        test_window(ctx, "partial", nk_rect(400, 150, 200, 100), test_partial);
+        test_window(ctx, "top", nk_rect(100, 100, 400, 400), nk_rgb(255, 255, 255));
+
+        bottom = nk_window_find(ctx, "bottom");
+        partial = nk_window_find(ctx, "partial");
+        TEST_CHECK(test_drawn(ctx, test_partial));
+        TEST_CHECK(!(partial->flags & NK_WINDOW_OCCLUDED));
+        nk_context_info(&stats, ctx);
+        if (translucent) {
+            TEST_CHECK(test_drawn(ctx, test_bottom));
+            TEST_CHECK(!(bottom->flags & NK_WINDOW_OCCLUDED));
+            TEST_CHECK(stats.windows_occluded == 0);
+        } else {
+            TEST_CHECK(!test_drawn(ctx, test_bottom));
+            TEST_CHECK(bottom->flags & NK_WINDOW_OCCLUDED);
+            TEST_CHECK(stats.windows_occluded == 1);
+        }
+        nk_clear(ctx);
+    }
+}
+
+int
+main(void)
+{
+    struct test_font font;
+    struct nk_context ctx;
+
+    test_font_init(&font);
+    nk_init_default(&ctx, &font.font->handle);
+    test_frame_occlusion(&ctx, nk_false);
+    test_frame_occlusion(&ctx, nk_true);
+    nk_free(&ctx);
+    test_font_free(&font);
+    return test_result("occlusion");
+}
@@ -0,0 +1,108 @@
+/* nk_optimize: optimized frames draw exactly the same pixels with the
+ * software rasterizer of the rawfb demo as the frames they came from, while
+ * scissors, invisible, covered and adjacent commands are all removed.
+ * Rendering clears the context, so both rasterizers build every frame */
+#define RAWFB_RGBX_8888
+#define NK_RAWFB_IMPLEMENTATION
+#include "test.h"
+#include "../demo/x11_rawfb/nuklear_rawfb.h"
+
+#define FRAMES 60
+#define WIDTH 1200
+#define HEIGHT 800
+
+static unsigned char drawn[WIDTH * HEIGHT * 4];
+static unsigned char optimized[WIDTH * HEIGHT * 4];
+static unsigned char font_memory[2][512 * 512];
+
+static void
+test_canvas(struct nk_context *ctx, int frame)
+{
+    /* shapes for every kind of command nk_optimize removes */
+    if (nk_begin(ctx, "canvas", nk_rect(700, 420, 300, 300), NK_WINDOW_BORDER|NK_WINDOW_TITLE)) {
+        struct nk_command_buffer *out = nk_window_get_canvas(ctx);
+        struct nk_rect r = nk_window_get_content_region(ctx);
+        int i;
+        /* adjacent rectangles of the same color, transparent every third frame */
+        for (i = 0; i < 10; ++i)
+            nk_fill_rect(out, nk_rect(r.x + i * 10, r.y, 10, 20), 0,
+                nk_rgba(200, 0, 0, (frame % 3) ? 255: 120));
+        for (i = 0; i < 10; ++i)
+            nk_fill_rect(out, nk_rect(r.x, r.y + 30 + i * 8, 50, 8), 0, nk_rgba(0, 200, 0, 128));
+        /* covered by the next rectangle */
+        nk_fill_circle(out, nk_rect(r.x + 60, r.y + 40, 20, 20), nk_rgb(255, 255, 0));
+        nk_fill_rect(out, nk_rect(r.x + 55, r.y + 35, 40, 40), 0, nk_rgb(0, 0, 200));
+        /* lines are not clipped while drawing, so this one outside of the
+         * window is only removed by nk_optimize. Fully transparent shapes
+         * are left out since the rawfb rasterizer does not blend */
+        nk_stroke_line(out, r.x - 200, r.y, r.x - 150, r.y + 50, 2, nk_rgb(255, 0, 255));
+        /* scissor rectangles which are never used or change nothing */
+        nk_push_scissor(out, nk_rect(r.x, r.y, 20, 20));
+        nk_push_scissor(out, r);
+        nk_push_scissor(out, r);
+        nk_stroke_curve(out, r.x, r.y + 200, r.x + 40, r.y + 160, r.x + 80, r.y + 240,
+            r.x + 120, r.y + 200, 1, nk_rgb(255, 255, 255));
+    }
+    nk_end(ctx);
+}
+
+static unsigned int
+test_build(struct nk_context *ctx, int frame)
+{
+    const struct nk_command *cmd;
+    unsigned int count = 0;
+    int i;
+    test_motion(ctx, frame);
+    for (i = 0; i < TEST_WIDGET_WINDOWS; ++i)
+        test_widgets(ctx, frame, i);
+    test_canvas(ctx, frame);
+    nk_foreach(cmd, ctx)
+        if (cmd->type != NK_COMMAND_NOP) count++;
+    return count;
+}
+
+static void
+test_render(struct rawfb_context *rawfb, unsigned char *pixels)
+{
+    /* the full framebuffer is redrawn after resizing */
+    memset(pixels, 0, WIDTH * HEIGHT * 4);
+    nk_rawfb_resize_fb(rawfb, pixels, WIDTH, HEIGHT, WIDTH * 4);
+    nk_rawfb_render(rawfb, nk_rgb(30, 30, 30), 1);
+}
+
+int
+main(void)
+{
+    struct nk_optimize_stats total;
+    struct rawfb_context *plain, *rawfb;
+    unsigned int before = 0, after = 0;
+    int frame;
+
+    memset(&total, 0, sizeof(total));
+    plain = nk_rawfb_init(drawn, font_memory[0], WIDTH, HEIGHT, WIDTH * 4);
+    rawfb = nk_rawfb_init(optimized, font_memory[1], WIDTH, HEIGHT, WIDTH * 4);
+    TEST_CHECK(plain != 0 && rawfb != 0);
+    if (!plain || !rawfb) return test_result("optimize");
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        struct nk_optimize_stats stats;
+        before += test_build(&plain->ctx, frame);
+        test_render(plain, drawn);
+
+        test_build(&rawfb->ctx, frame);
+        nk_optimize(&rawfb->ctx, &stats);
+        test_render(rawfb, optimized);
+        TEST_CHECK(!memcmp(drawn, optimized, sizeof(drawn)));
+
+        after += stats.commands;
+        total.scissors += stats.scissors;
+        total.invisible += stats.invisible;
+        total.covered += stats.covered;
+        total.merged += stats.merged;
+    }
+    TEST_CHECK(after < before);
+    TEST_CHECK(total.scissors && total.invisible && total.covered && total.merged);
+    nk_rawfb_shutdown(plain);
+    nk_rawfb_shutdown(rawfb);
+    return test_result("optimize");
+}
@@ -0,0 +1,150 @@
+/* polylines: traces longer than a 16 bit vertex draw command can address
+ * are split across commands and draw the same triangles as with 32 bit
+ * indices, with or without geometry clipping. Line charts draw their
+ * traces as polylines */
+#include "test.h"
+
+#define POINTS 40000
+
+static float points[POINTS * 2];
+
+static struct nk_rect
+test_polyline(struct nk_context *ctx, float y, float thickness)
+{
+    /* zig-zag trace running back and forth across the window */
+    struct nk_rect bounds = nk_rect(0, 0, 0, 0);
+    int i;
+    for (i = 0; i < POINTS; ++i) {
+        points[i*2+0] = (float)((i % 600) * 2);
+        points[i*2+1] = y + (float)((i & 1) * 50 + (i / 600) % 7);
+    }
+    if (nk_begin(ctx, "polyline", nk_rect(100, 50, 300, 200), NK_WINDOW_NO_SCROLLBAR)) {
+        struct nk_command_buffer *canvas = nk_window_get_canvas(ctx);
+        bounds = nk_window_get_bounds(ctx);
+        if (y >= 0) nk_stroke_polyline(canvas, points, POINTS, thickness, nk_rgb(255, 200, 0));
+    }
+    nk_end(ctx);
+    return bounds;
+}
+
+static void
+test_convert(struct test_font *font, struct test_output *out, float y, float thickness,
+    enum nk_draw_index_type index_type, enum nk_draw_clipping clipping)
+{
+    struct nk_convert_config config;
+    struct nk_context ctx;
+    struct nk_rect bounds;
+    unsigned int i;
+
+    test_convert_config(&config, font);
+    config.index_type = index_type;
+    config.clipping = clipping;
+    nk_init_default(&ctx, &font->font->handle);
+
+    bounds = test_polyline(&ctx, y, thickness);
+    test_output_clear(out);
+    TEST_CHECK(nk_convert(&ctx, &out->cmds, &out->vertices, &out->elements,
+        &config) == NK_CONVERT_SUCCESS);
+    test_resolve(&ctx, out, &config);
+    if (clipping == NK_DRAW_CLIP_GEOMETRY) {
+        /* everything is cut at the window apart from the anti-aliased
+         * fringe of its border */
+        const float x0 = bounds.x - 1, y0 = bounds.y - 1;
+        const float x1 = bounds.x + bounds.w + 1, y1 = bounds.y + bounds.h + 1;
+        for (i = 0; i < out->count; ++i) {
+            const float *pos = out->resolved[i].vertex.position;
+            if (nk_rect_equal(out->resolved[i].clip, nk_null_rect))
+                TEST_CHECK(pos[0] >= x0 && pos[0] <= x1 && pos[1] >= y0 && pos[1] <= y1);
+        }
+    }
+    nk_free(&ctx);
+}
+
+static nk_size
+test_vertex_count(const struct test_output *out)
+{
+    return out->vertices.allocated / sizeof(struct test_vertex);
+}
+
+static void
+test_split(struct test_font *font, float thickness, enum nk_draw_clipping clipping)
+{
+    struct test_output empty, wide, split, hidden;
+    test_output_init(&empty);
+    test_output_init(&wide);
+    test_output_init(&split);
+    test_output_init(&hidden);
+
+    test_convert(font, &empty, -1, thickness, NK_DRAW_INDEX_USHORT, clipping);
+    test_convert(font, &wide, 40, thickness, NK_DRAW_INDEX_UINT, clipping);
+    test_convert(font, &split, 40, thickness, NK_DRAW_INDEX_USHORT, clipping);
+    TEST_CHECK(split.count > empty.count);
+    TEST_CHECK(test_output_equal(&wide, &split));
+    if (clipping == NK_DRAW_CLIP_SCISSOR)
+        TEST_CHECK(split.commands > 1 && test_vertex_count(&split) > NK_USHORT_MAX);
+
+    /* a trace below the window only leaves the window background */
+    test_convert(font, &hidden, 2000, thickness, NK_DRAW_INDEX_USHORT, clipping);
+    if (clipping == NK_DRAW_CLIP_GEOMETRY) {
+        TEST_CHECK(test_output_equal(&empty, &hidden));
+        TEST_CHECK(hidden.commands == empty.commands);
+        TEST_CHECK(test_vertex_count(&hidden) == test_vertex_count(&empty));
+    } else TEST_CHECK(hidden.count > empty.count);
+
+    test_output_free(&empty);
+    test_output_free(&wide);
+    test_output_free(&split);
+    test_output_free(&hidden);
+}
+
+static void
+test_chart(struct test_font *font)
+{
+    /* each slot of a line chart is drawn as one polyline through all of
+     * its values, values past the slot count continue in another one */
+    const struct nk_command *cmd;
+    struct nk_context ctx;
+    int i, polylines = 0, points = 0, lines = 0;
+
+    nk_init_default(&ctx, &font->font->handle);
+    if (nk_begin(&ctx, "chart", nk_rect(0, 0, 400, 300), NK_WINDOW_NO_SCROLLBAR)) {
+        nk_layout_row_dynamic(&ctx, 200, 1);
+        if (nk_chart_begin(&ctx, NK_CHART_LINES, 100, -1.0f, 1.0f)) {
+            nk_chart_add_slot(&ctx, NK_CHART_LINES, 50, -1.0f, 1.0f);
+            for (i = 0; i < 100; ++i) {
+                nk_chart_push_slot(&ctx, (float)sin(i * 0.1), 0);
+                if (i < 60) nk_chart_push_slot(&ctx, (float)cos(i * 0.1), 1);
+            }
+        }
+        nk_chart_end(&ctx);
+    }
+    nk_end(&ctx);
+
+    nk_foreach(cmd, &ctx) {
+        if (cmd->type == NK_COMMAND_LINE) lines++;
+        if (cmd->type == NK_COMMAND_POLYLINE) {
+            const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+            points += p->point_count;
+            polylines++;
+        }
+    }
+    TEST_CHECK(!lines);
+    TEST_CHECK(polylines == 3);
+    /* the continued polyline repeats the last point of the slot */
+    TEST_CHECK(points == 100 + 60 + 1);
+    nk_free(&ctx);
+}
+
+int
+main(void)
+{
+    struct test_font font;
+    test_font_init(&font);
+    test_split(&font, 1.0f, NK_DRAW_CLIP_SCISSOR);
+    test_split(&font, 3.0f, NK_DRAW_CLIP_SCISSOR);
+    test_split(&font, 1.0f, NK_DRAW_CLIP_GEOMETRY);
+    test_split(&font, 3.0f, NK_DRAW_CLIP_GEOMETRY);
+    test_chart(&font);
+    test_font_free(&font);
+    return test_result("polyline");
+}
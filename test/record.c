@@ -0,0 +1,156 @@
+/* nk_record/nk_replay: replayed frames draw exactly what was recorded and
+ * damaged recordings are rejected without reading outside of them */
+#include "test.h"
+
+#define FRAMES 120
+
+static nk_hash frame_hash[FRAMES];
+static nk_size frame_vertices[FRAMES];
+
+static void
+test_roundtrip(struct test_font *font, struct nk_buffer *recording)
+{
+    struct nk_convert_config config;
+    struct nk_buffer cmds, verts, elements;
+    struct nk_context ctx, replayed;
+    struct nk_replay replay;
+    int frame;
+
+    test_convert_config(&config, font);
+    nk_buffer_init_default(&cmds);
+    nk_buffer_init_default(&verts);
+    nk_buffer_init_default(&elements);
+    nk_init_default(&ctx, &font->font->handle);
+    nk_init_default(&replayed, &font->font->handle);
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        test_frame(&ctx, frame);
+        frame_hash[frame] = test_commands_hash(&ctx);
+        TEST_CHECK(nk_record(&ctx, recording));
+        nk_buffer_clear(&cmds); nk_buffer_clear(&verts); nk_buffer_clear(&elements);
+        nk_convert(&ctx, &cmds, &verts, &elements, &config);
+        frame_vertices[frame] = verts.allocated;
+        nk_clear(&ctx);
+    }
+
+    frame = 0;
+    TEST_CHECK(nk_replay_init(&replay, nk_buffer_memory(recording), recording->allocated));
+    do {
+        TEST_CHECK(nk_replay_load(&replayed, &replay, 0));
+        TEST_CHECK(test_commands_hash(&replayed) == frame_hash[frame]);
+        nk_buffer_clear(&cmds); nk_buffer_clear(&verts); nk_buffer_clear(&elements);
+        nk_convert(&replayed, &cmds, &verts, &elements, &config);
+        TEST_CHECK(verts.allocated == frame_vertices[frame]);
+        nk_clear(&replayed);
+        frame++;
+    } while (nk_replay_next(&replay));
+    TEST_CHECK(frame == FRAMES);
+
+    nk_free(&replayed);
+    nk_free(&ctx);
+    nk_buffer_free(&cmds);
+    nk_buffer_free(&verts);
+    nk_buffer_free(&elements);
+}
+
+static void
+test_truncated(const struct nk_buffer *recording)
+{
+    /* every prefix of a recording is either rejected or iterated without
+     * reading past its end, which the sanitizers catch */
+    const nk_byte *memory = (const nk_byte*)nk_buffer_memory_const(recording);
+    nk_size size, step = recording->allocated / 997 + 1;
+    for (size = 0; size < recording->allocated; size += step) {
+        void *copy = malloc(size ? size: 1);
+        struct nk_replay replay;
+        memcpy(copy, memory, size);
+        if (nk_replay_init(&replay, copy, size)) {
+            do {
+                const struct nk_command *cmd;
+                nk_replay_foreach(cmd, &replay);
+            } while (nk_replay_next(&replay));
+        }
+        free(copy);
+    }
+}
+
+static void
+test_damaged_command(struct test_font *font)
+{
+    struct nk_context ctx;
+    struct nk_buffer recording;
+    struct nk_replay replay;
+    struct nk_record_frame *frame;
+    struct nk_command *cmd;
+    nk_byte *copy;
+    nk_size first, end;
+    float points[16];
+    int i;
+
+    nk_init_default(&ctx, &font->font->handle);
+    nk_buffer_init_default(&recording);
+    for (i = 0; i < 8; ++i) {
+        points[2*i+0] = (float)(i * 10);
+        points[2*i+1] = (float)((i & 1) * 20);
+    }
+    if (nk_begin(&ctx, "record", nk_rect(0, 0, 200, 200), NK_WINDOW_NO_SCROLLBAR)) {
+        struct nk_command_buffer *canvas = nk_window_get_canvas(&ctx);
+        nk_stroke_polyline(canvas, points, 8, 1.0f, nk_rgb(255, 255, 255));
+        nk_stroke_polyline(canvas, points, 8, 1.0f, nk_rgb(255, 0, 0));
+    }
+    nk_end(&ctx);
+    TEST_CHECK(nk_record(&ctx, &recording));
+
+    copy = (nk_byte*)malloc(recording.allocated);
+    memcpy(copy, nk_buffer_memory(&recording), recording.allocated);
+    TEST_CHECK(nk_replay_init(&replay, copy, recording.allocated));
+    frame = (struct nk_record_frame*)(copy + replay.offset);
+
+    /* find the first polyline and cut the frame right behind its header */
+    first = nk_record_commands_offset(frame);
+    cmd = (struct nk_command*)((nk_byte*)frame + first);
+    while (cmd->type != NK_COMMAND_POLYLINE && cmd->next > first && cmd->next < frame->size) {
+        first = cmd->next;
+        cmd = (struct nk_command*)((nk_byte*)frame + first);
+    }
+    TEST_CHECK(cmd->type == NK_COMMAND_POLYLINE);
+    end = cmd->next;
+
+    /* misaligned links are rejected */
+    cmd->next = end + 1;
+    {
+        const struct nk_command *iter, *last = 0;
+        nk_replay_foreach(iter, &replay) last = iter;
+        TEST_CHECK(last == cmd);
+    }
+    cmd->next = end;
+
+    /* type specific fields are never read from outside of the frame */
+    {
+        nk_size size = replay.offset + first + sizeof(struct nk_command);
+        nk_byte *cut = (nk_byte*)malloc(size);
+        memcpy(cut, copy, size);
+        ((struct nk_record_frame*)(cut + replay.offset))->size =
+            (nk_uint)(first + sizeof(struct nk_command));
+        TEST_CHECK(!nk_replay_command((const struct nk_record_frame*)(cut + replay.offset), first));
+        free(cut);
+    }
+    free(copy);
+    nk_buffer_free(&recording);
+    nk_free(&ctx);
+}
+
+int
+main(void)
+{
+    struct test_font font;
+    struct nk_buffer recording;
+    test_font_init(&font);
+    nk_buffer_init_default(&recording);
+    test_roundtrip(&font, &recording);
+    test_truncated(&recording);
+    test_damaged_command(&font);
+    nk_buffer_free(&recording);
+    test_font_free(&font);
+    return test_result("record");
+}
@@ -0,0 +1,106 @@
+/* window state tables: tables used in a frame stay at the front of the
+ * table list and `nk_clear` frees exactly the tables which were not used,
+ * without losing values of keys which are used from frame to frame */
+#include "test.h"
+
+#define FRAMES 200
+#define KEYS 3000
+
+static unsigned int
+test_trie_count(const struct nk_table *tbl, unsigned int seq, unsigned int *used)
+{
+    unsigned int i, count = 1;
+    if (!tbl) return 0;
+    if (tbl->seq == seq) (*used)++;
+    for (i = 0; i < NK_VALUE_PAGE_FANOUT; ++i) {
+        if (!tbl->children[i]) continue;
+        TEST_CHECK(tbl->children[i]->parent == tbl);
+        /* parents are touched with their children */
+        TEST_CHECK(tbl->children[i]->seq != seq || tbl->seq == seq);
+        count += test_trie_count(tbl->children[i], seq, used);
+    }
+    return count;
+}
+
+static unsigned int
+test_list_check(const struct nk_window *win, unsigned int seq)
+{
+    /* used tables first and every table behind its parent */
+    const struct nk_table *it, *prev = 0;
+    unsigned int count = 0, used = 1;
+    for (it = win->tables; it; prev = it, it = it->next) {
+        const struct nk_table *p;
+        TEST_CHECK(it->prev == prev);
+        if (it->seq != seq) used = 0;
+        else TEST_CHECK(used);
+        for (p = win->tables; p != it && p != it->parent; p = p->next);
+        TEST_CHECK(!it->parent || p == it->parent);
+        count++;
+    }
+    TEST_CHECK(win->table_last == prev);
+    return count;
+}
+
+static void
+test_values(struct nk_context *ctx, int frame, int *present)
+{
+    /* a sliding range of keys with some keys used only now and then */
+    int first = (frame * 37) % KEYS, count = 200 + (frame * 131) % 1500, i;
+    if (!nk_begin(ctx, "tables", nk_rect(0, 0, 400, 400), 0)) {
+        nk_end(ctx);
+        return;
+    }
+    for (i = 0; i < KEYS; ++i) {
+        const int used = ((i - first + KEYS) % KEYS) < count || (i % 97) == frame % 97;
+        nk_hash key = nk_murmur_hash(&i, (int)sizeof(i), 0x5eed);
+        nk_uint *value;
+        if (!used) {
+            present[i] = 0;
+            continue;
+        }
+        value = nk_find_value(ctx->current, key);
+        /* keys used in the last frame keep their table */
+        TEST_CHECK(!present[i] || (value && *value == (nk_uint)i));
+        if (!value) value = nk_add_value(ctx, ctx->current, key, (nk_uint)i);
+        TEST_CHECK(value && *value == (nk_uint)i);
+        present[i] = 1;
+    }
+    nk_end(ctx);
+}
+
+int
+main(void)
+{
+    static int present[KEYS];
+    struct test_font font;
+    struct nk_context ctx;
+    unsigned int freed = 0;
+    int frame;
+
+    test_font_init(&font);
+    nk_init_default(&ctx, &font.font->handle);
+    for (frame = 0; frame < FRAMES; ++frame) {
+        struct nk_window *win;
+        unsigned int seq, used = 0, total, after = 0;
+        test_values(&ctx, frame, present);
+        win = nk_window_find(&ctx, "tables");
+        TEST_CHECK(win != 0);
+        if (!win) break;
+
+        seq = ctx.seq;
+        total = test_trie_count(win->table_root, seq, &used);
+        TEST_CHECK(total == win->table_count);
+        TEST_CHECK(test_list_check(win, seq) == total);
+        nk_clear(&ctx);
+
+        /* exactly the tables not used this frame are gone */
+        TEST_CHECK(test_trie_count(win->table_root, seq, &after) == used);
+        TEST_CHECK(after == used && win->table_count == used);
+        TEST_CHECK(test_list_check(win, seq) == used);
+        freed += total - used;
+    }
+    TEST_CHECK(freed > 0);
+    nk_free(&ctx);
+    test_font_free(&font);
+    return test_result("table");
+}
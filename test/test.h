@@ -0,0 +1,260 @@
+/* nuklear - headless tests
+ *
+ * Every test is a single translation unit that includes this header and
+ * therefore the implementation. Frames are built from the demo windows with
+ * scripted input and no backend, so all tests run without a display. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#define NK_IMPLEMENTATION
+#include "../nuklear.h"
+
+#include "../demo/calculator.c"
+#include "../demo/overview.c"
+#include "../demo/node_editor.c"
+
+/* helpers are static in every test, whether the test uses them or not */
+#if defined(__GNUC__)
+  #define TEST_API static __attribute__((unused))
+#else
+  #define TEST_API static
+#endif
+
+static int test_failures;
+
+#define TEST_CHECK(cond) do {\
+    if (!(cond)) {\
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);\
+        test_failures++;\
+    }} while (0)
+
+struct test_vertex {
+    float position[2];
+    float uv[2];
+    nk_byte col[4];
+};
+
+struct test_font {
+    struct nk_font_atlas atlas;
+    struct nk_font *font;
+    struct nk_draw_null_texture null;
+    nk_byte *pixels;
+    int width, height;
+};
+
+TEST_API void
+test_font_init(struct test_font *f)
+{
+    /* keeps a copy of the atlas image since `nk_font_atlas_end` frees it */
+    const void *image;
+    nk_font_atlas_init_default(&f->atlas);
+    nk_font_atlas_begin(&f->atlas);
+    f->font = nk_font_atlas_add_default(&f->atlas, 13, 0);
+    image = nk_font_atlas_bake(&f->atlas, &f->width, &f->height, NK_FONT_ATLAS_RGBA32);
+    f->pixels = (nk_byte*)malloc((size_t)f->width * (size_t)f->height * 4);
+    memcpy(f->pixels, image, (size_t)f->width * (size_t)f->height * 4);
+    nk_font_atlas_end(&f->atlas, nk_handle_id(1), &f->null);
+}
+
+TEST_API void
+test_font_free(struct test_font *f)
+{
+    nk_font_atlas_clear(&f->atlas);
+    free(f->pixels);
+}
+
+TEST_API void
+test_convert_config(struct nk_convert_config *config, const struct test_font *f)
+{
+    static const struct nk_draw_vertex_layout_element layout[] = {
+        {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct test_vertex, position)},
+        {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct test_vertex, uv)},
+        {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct test_vertex, col)},
+        {NK_VERTEX_LAYOUT_END}
+    };
+    NK_MEMSET(config, 0, sizeof(*config));
+    config->vertex_layout = layout;
+    config->vertex_size = sizeof(struct test_vertex);
+    config->vertex_alignment = NK_ALIGNOF(struct test_vertex);
+    config->null = f->null;
+    config->circle_segment_count = 22;
+    config->curve_segment_count = 22;
+    config->arc_segment_count = 22;
+    config->global_alpha = 1.0f;
+    config->shape_AA = NK_ANTI_ALIASING_ON;
+    config->line_AA = NK_ANTI_ALIASING_ON;
+}
+
+/* converted frame with its elements resolved in drawing order, so frames
+ * converted differently can be compared element by element */
+struct test_element {
+    struct test_vertex vertex;
+    struct nk_rect clip;
+    int texture;
+};
+
+struct test_output {
+    struct nk_buffer cmds, vertices, elements;
+    struct test_element *resolved;
+    unsigned int count;
+    unsigned int commands;
+};
+
+TEST_API void
+test_output_init(struct test_output *out)
+{
+    memset(out, 0, sizeof(*out));
+    nk_buffer_init_default(&out->cmds);
+    nk_buffer_init_default(&out->vertices);
+    nk_buffer_init_default(&out->elements);
+}
+
+TEST_API void
+test_output_clear(struct test_output *out)
+{
+    nk_buffer_clear(&out->cmds);
+    nk_buffer_clear(&out->vertices);
+    nk_buffer_clear(&out->elements);
+}
+
+TEST_API void
+test_output_free(struct test_output *out)
+{
+    nk_buffer_free(&out->cmds);
+    nk_buffer_free(&out->vertices);
+    nk_buffer_free(&out->elements);
+    free(out->resolved);
+}
+
+TEST_API void
+test_resolve(struct nk_context *ctx, struct test_output *out,
+    const struct nk_convert_config *config)
+{
+    /* elements in drawing order with everything that ends up on screen */
+    const struct test_vertex *vertices;
+    const struct nk_draw_command *cmd;
+    nk_size offset = 0, vertex_count;
+    unsigned int i;
+
+    vertices = (const struct test_vertex*)nk_buffer_memory_const(&out->vertices);
+    vertex_count = out->vertices.allocated / sizeof(struct test_vertex);
+    out->resolved = (struct test_element*)realloc(out->resolved,
+        (ctx->draw_list.element_count + 1) * sizeof(struct test_element));
+    out->count = 0;
+    out->commands = 0;
+    nk_draw_foreach(cmd, ctx, &out->cmds) {
+        for (i = 0; i < cmd->elem_count; ++i) {
+            struct test_element *e = &out->resolved[out->count++];
+            nk_uint k = (config->index_type == NK_DRAW_INDEX_UINT) ?
+                ((const nk_uint*)nk_buffer_memory_const(&out->elements))[offset + i]:
+                ((const nk_draw_index*)nk_buffer_memory_const(&out->elements))[offset + i];
+            k += cmd->vertex_offset;
+            memset(e, 0, sizeof(*e));
+            TEST_CHECK(k < vertex_count);
+            if (k < vertex_count)
+                e->vertex = vertices[k];
+            e->clip = cmd->clip_rect;
+            e->texture = cmd->texture.id;
+        }
+        offset += cmd->elem_count;
+        out->commands++;
+    }
+    TEST_CHECK(offset == ctx->draw_list.element_count);
+}
+
+TEST_API int
+test_output_equal(const struct test_output *a, const struct test_output *b)
+{
+    return a->count == b->count && !memcmp(a->resolved, b->resolved,
+        a->count * sizeof(struct test_element));
+}
+
+TEST_API void
+test_frame(struct nk_context *ctx, int frame)
+{
+    /* scripted input sweeps the mouse over all demo windows and keeps
+     * clicking so widgets change state from frame to frame */
+    int x = (frame * 7) % 1200;
+    int y = (frame * 3) % 800;
+    nk_input_begin(ctx);
+    nk_input_motion(ctx, x, y);
+    nk_input_button(ctx, NK_BUTTON_LEFT, x, y, (frame % 10) < 5);
+    nk_input_end(ctx);
+
+    calculator(ctx);
+    overview(ctx);
+    node_editor(ctx);
+}
+
+/* windows without the static state of the demo windows, so the same frame
+ * can be built in more than one context */
+#define TEST_WIDGET_WINDOWS 3
+
+TEST_API void
+test_widgets(struct nk_context *ctx, int frame, int window)
+{
+    nk_size progress = (nk_size)((frame * 5 + window * 30) % 100);
+    float values[8];
+    char name[16];
+    int i;
+    sprintf(name, "window %d", window);
+    if (nk_begin(ctx, name, nk_rect(50 + window * 120, 40 + window * 90, 320, 300),
+        NK_WINDOW_BORDER|NK_WINDOW_TITLE|NK_WINDOW_SCALABLE)) {
+        nk_layout_row_dynamic(ctx, 25, 2);
+        nk_label(ctx, "label", NK_TEXT_LEFT);
+        nk_button_label(ctx, "button");
+        nk_layout_row_dynamic(ctx, 25, 1);
+        nk_progress(ctx, &progress, 100, nk_false);
+        nk_button_color(ctx, nk_rgb(40, 120 + window * 40, 200));
+        for (i = 0; i < 8; ++i)
+            values[i] = (float)((frame + i * 3 + window) % 11);
+        nk_layout_row_dynamic(ctx, 80, 1);
+        nk_plot(ctx, NK_CHART_LINES, values, 8, 0);
+        nk_layout_row_dynamic(ctx, 80, 1);
+        nk_plot(ctx, NK_CHART_COLUMN, values, 8, 0);
+    }
+    nk_end(ctx);
+}
+
+TEST_API void
+test_motion(struct nk_context *ctx, int frame)
+{
+    /* hovers over the widget windows without changing their state */
+    nk_input_begin(ctx);
+    nk_input_motion(ctx, (frame * 17) % 1200, (frame * 11) % 800);
+    nk_input_end(ctx);
+}
+
+TEST_API nk_hash
+test_commands_hash(struct nk_context *ctx)
+{
+    const struct nk_command *cmd;
+    nk_hash hash = 0;
+    nk_foreach(cmd, ctx) {
+        if (cmd->type != NK_COMMAND_NOP)
+            hash = nk_command_hash(hash, cmd);
+    }
+    return hash;
+}
+
+TEST_API int
+test_result(const char *name)
+{
+    if (test_failures)
+        fprintf(stderr, "%s: %d checks failed\n", name, test_failures);
+    else printf("%s: ok\n", name);
+    return test_failures != 0;
+}
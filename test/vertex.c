@@ -0,0 +1,88 @@
+/* vertex writers: every vertex layout produces the same vertices as the
+ * default layout no matter which writer `nk_draw_list_setup` picks */
+#include "test.h"
+
+#define VERTEX_SIZE 24
+#define UNALIGNED_POSITION 6
+#define UNALIGNED_TEXCOORD 14
+#define UNALIGNED_COLOR 0
+
+static void
+test_draw(struct nk_draw_list *list)
+{
+    static const struct nk_vec2 points[] = {{0,0}, {40,10}, {80,0}, {120,30}, {160,5}};
+    nk_draw_list_add_clip(list, nk_rect(0, 0, 400, 400));
+    nk_draw_list_fill_circle(list, nk_vec2(100,100), 25, nk_rgb(255,255,255), 22);
+    nk_draw_list_stroke_rect(list, nk_rect(10,10,50,30), nk_rgba(255,0,0,128), 4, 2);
+    nk_draw_list_stroke_line(list, nk_vec2(1,2), nk_vec2(40,70), nk_rgb(0,0,255), 1.5f);
+    nk_draw_list_stroke_poly_line(list, points, 5, nk_rgb(0,255,0),
+        NK_STROKE_OPEN, 1.0f, NK_ANTI_ALIASING_ON);
+    nk_draw_list_fill_rect_multi_color(list, nk_rect(200,200,50,50), nk_rgb(255,0,0),
+        nk_rgb(0,255,0), nk_rgb(0,0,255), nk_rgb(255,255,0));
+}
+
+static int
+test_convert(const struct nk_draw_vertex_layout_element *layout, nk_size vertex_size,
+    nk_size alignment, struct nk_buffer *vertices)
+{
+    struct nk_convert_config config;
+    struct nk_draw_list list;
+    struct nk_buffer cmds, elements;
+    int writer;
+
+    NK_MEMSET(&config, 0, sizeof(config));
+    config.vertex_layout = layout;
+    config.vertex_size = vertex_size;
+    config.vertex_alignment = alignment;
+    config.global_alpha = 1.0f;
+    config.shape_AA = NK_ANTI_ALIASING_ON;
+    config.line_AA = NK_ANTI_ALIASING_ON;
+    nk_buffer_init_default(&cmds);
+    nk_buffer_init_default(&elements);
+    nk_buffer_init_default(vertices);
+    nk_draw_list_init(&list);
+    nk_draw_list_setup(&list, &config, &cmds, vertices, &elements,
+        config.line_AA, config.shape_AA);
+    writer = list.vertex_writer;
+    test_draw(&list);
+    nk_buffer_free(&cmds);
+    nk_buffer_free(&elements);
+    return writer;
+}
+
+int
+main(void)
+{
+    static const struct nk_draw_vertex_layout_element aligned[] = {
+        {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct test_vertex, position)},
+        {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct test_vertex, uv)},
+        {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct test_vertex, col)},
+        {NK_VERTEX_LAYOUT_END}
+    };
+    static const struct nk_draw_vertex_layout_element unaligned[] = {
+        {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, UNALIGNED_POSITION},
+        {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, UNALIGNED_TEXCOORD},
+        {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, UNALIGNED_COLOR},
+        {NK_VERTEX_LAYOUT_END}
+    };
+    struct nk_buffer expected, packed;
+    nk_size i, count;
+
+    TEST_CHECK(test_convert(aligned, sizeof(struct test_vertex),
+        NK_ALIGNOF(struct test_vertex), &expected) == NK_DRAW_VERTEX_RGBA8);
+    /* float attributes at unaligned offsets have to use the generic writer */
+    TEST_CHECK(test_convert(unaligned, VERTEX_SIZE, 4, &packed) == NK_DRAW_VERTEX_GENERIC);
+
+    count = expected.allocated / sizeof(struct test_vertex);
+    TEST_CHECK(packed.allocated == count * VERTEX_SIZE);
+    for (i = 0; i < count && packed.allocated == count * VERTEX_SIZE; ++i) {
+        const struct test_vertex *a = (const struct test_vertex*)nk_buffer_memory(&expected) + i;
+        const nk_byte *b = (const nk_byte*)nk_buffer_memory(&packed) + i * VERTEX_SIZE;
+        TEST_CHECK(!memcmp(a->position, b + UNALIGNED_POSITION, sizeof(a->position)));
+        TEST_CHECK(!memcmp(a->uv, b + UNALIGNED_TEXCOORD, sizeof(a->uv)));
+        TEST_CHECK(!memcmp(a->col, b + UNALIGNED_COLOR, sizeof(a->col)));
+    }
+    nk_buffer_free(&expected);
+    nk_buffer_free(&packed);
+    return test_result("vertex");
+}
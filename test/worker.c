@@ -0,0 +1,116 @@
+/* nk_worker_merge: windows built on worker contexts and merged into the
+ * context produce, record and convert the same command stream as the same
+ * windows built on the context itself */
+#include "test.h"
+
+#define FRAMES 60
+#define WORKERS 2
+
+static void
+test_popup(struct nk_context *ctx, int frame)
+{
+    /* popups are drawn after all windows and carried over separately */
+    if (nk_begin(ctx, "popup", nk_rect(700, 100, 300, 200), NK_WINDOW_BORDER|NK_WINDOW_TITLE)) {
+        nk_layout_row_dynamic(ctx, 25, 1);
+        nk_label(ctx, "owner", NK_TEXT_LEFT);
+        if (nk_popup_begin(ctx, NK_POPUP_STATIC, "static", 0, nk_rect(20, 40, 200, 100))) {
+            nk_layout_row_dynamic(ctx, 25, 1);
+            nk_labelf(ctx, NK_TEXT_LEFT, "frame %d", frame);
+            nk_popup_end(ctx);
+        }
+    }
+    nk_end(ctx);
+}
+
+static void
+test_single(struct nk_context *ctx, int frame)
+{
+    int i;
+    test_motion(ctx, frame);
+    for (i = 0; i < TEST_WIDGET_WINDOWS; ++i)
+        test_widgets(ctx, frame, i);
+    test_popup(ctx, frame);
+}
+
+static void
+test_merged(struct nk_context *ctx, struct nk_context *workers, int frame)
+{
+    /* the first window on the context, the others spread over the workers.
+     * New windows are stacked in merge order, which is also their order
+     * of creation here */
+    int i;
+    test_motion(ctx, frame);
+    for (i = 0; i < WORKERS; ++i)
+        nk_worker_begin(&workers[i], ctx);
+    test_widgets(ctx, frame, 0);
+    for (i = 1; i < TEST_WIDGET_WINDOWS; ++i)
+        test_widgets(&workers[(i - 1) % WORKERS], frame, i);
+    test_popup(&workers[WORKERS - 1], frame);
+    for (i = 0; i < WORKERS; ++i)
+        nk_worker_merge(ctx, &workers[i]);
+}
+
+int
+main(void)
+{
+    struct nk_convert_config config;
+    struct test_output expected, output;
+    struct nk_context single, ctx, replayed, workers[WORKERS];
+    struct nk_buffer recording;
+    struct nk_replay replay;
+    struct test_font font;
+    int frame, i;
+
+    test_font_init(&font);
+    test_convert_config(&config, &font);
+    test_output_init(&expected);
+    test_output_init(&output);
+    nk_buffer_init_default(&recording);
+    nk_init_default(&single, &font.font->handle);
+    nk_init_default(&ctx, &font.font->handle);
+    nk_init_default(&replayed, &font.font->handle);
+    for (i = 0; i < WORKERS; ++i)
+        nk_init_default(&workers[i], &font.font->handle);
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        nk_hash hash;
+        test_single(&single, frame);
+        test_merged(&ctx, workers, frame);
+        hash = test_commands_hash(&single);
+        TEST_CHECK(test_commands_hash(&ctx) == hash);
+
+        /* replays the recording of the merged context */
+        nk_buffer_clear(&recording);
+        TEST_CHECK(nk_record(&ctx, &recording));
+        TEST_CHECK(nk_replay_init(&replay, nk_buffer_memory(&recording), recording.allocated));
+        TEST_CHECK(nk_replay_load(&replayed, &replay, 0));
+        TEST_CHECK(test_commands_hash(&replayed) == hash);
+        nk_clear(&replayed);
+
+        test_output_clear(&expected);
+        TEST_CHECK(nk_convert(&single, &expected.cmds, &expected.vertices,
+            &expected.elements, &config) == NK_CONVERT_SUCCESS);
+        test_resolve(&single, &expected, &config);
+        test_output_clear(&output);
+        TEST_CHECK(nk_convert(&ctx, &output.cmds, &output.vertices,
+            &output.elements, &config) == NK_CONVERT_SUCCESS);
+        test_resolve(&ctx, &output, &config);
+        TEST_CHECK(test_output_equal(&expected, &output));
+
+        nk_clear(&single);
+        nk_clear(&ctx);
+        for (i = 0; i < WORKERS; ++i)
+            nk_clear(&workers[i]);
+    }
+
+    for (i = 0; i < WORKERS; ++i)
+        nk_free(&workers[i]);
+    nk_free(&single);
+    nk_free(&ctx);
+    nk_free(&replayed);
+    nk_buffer_free(&recording);
+    test_output_free(&expected);
+    test_output_free(&output);
+    test_font_free(&font);
+    return test_result("worker");
+}